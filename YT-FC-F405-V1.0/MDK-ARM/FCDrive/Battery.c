@@ -0,0 +1,59 @@
+#include "Battery.h"
+#include "VOFA.h"
+#if BATTERY_SOURCE == BATTERY_SOURCE_ADC
+#include "adc.h"
+#endif
+
+Battery_t g_battery;
+
+void Battery_Init(void)
+{
+    memset(&g_battery, 0, sizeof(g_battery));
+    g_battery.scale = BATTERY_DIVIDER;
+
+#if BATTERY_SOURCE == BATTERY_SOURCE_ADC
+    HAL_ADC_Start_DMA(&hadc1, (uint32_t *)g_battery.buf, BATTERY_ADC_SAMPLES);
+    // 循环缓冲由读取方求平均，不需要半满/满中断
+    __HAL_DMA_DISABLE_IT(hadc1.DMA_Handle, DMA_IT_TC | DMA_IT_HT);
+#endif
+}
+
+/* 缓冲平均 → 电压 */
+static float ReadRaw(void)
+{
+#if BATTERY_SOURCE == BATTERY_SOURCE_ADC
+    uint32_t sum = 0;
+    for (int i = 0; i < BATTERY_ADC_SAMPLES; i++) {
+        sum += g_battery.buf[i];
+    }
+    return (float)sum * (BATTERY_ADC_VREF / BATTERY_ADC_FULL / BATTERY_ADC_SAMPLES) * g_battery.scale;
+#else
+    return g_battery.host_voltage;
+#endif
+}
+
+void Battery_Update(void)
+{
+    Battery_t *b = &g_battery;
+
+    b->raw = ReadRaw();
+    if (b->raw < BATTERY_MIN_VALID) {
+        b->valid = 0;
+        b->voltage = 0.0f;
+        return;
+    }
+    // 首次有效直接取值，之后低通
+    b->voltage = b->valid ? b->voltage + BATTERY_LPF_ALPHA * (b->raw - b->voltage) : b->raw;
+    b->valid = 1;
+}
+
+float Battery_GetVoltage(void)
+{
+    return g_battery.valid ? g_battery.voltage : 0.0f;
+}
+
+void Battery_RegisterVofa(void)
+{
+    vofa_login_name("VS", &g_battery.scale, TYPE_FLOAT);
+    vofa_login_name("VB", &g_battery.host_voltage, TYPE_FLOAT);
+}
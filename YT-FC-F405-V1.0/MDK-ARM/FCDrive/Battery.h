@@ -0,0 +1,58 @@
+/**
+ * @file       Battery.h
+ * @author     lsl-sys
+ * @brief      Battery Voltage Sense (ADC1 IN10 / PC0, Circular DMA Averaging)
+ * @version    V1.0.0
+ * @date       2026-02-24
+ * @Encoding   UTF-8
+ * @note       ADC1 连续转换（480周期采样，约20kSps），DMA2_Stream0 循环写入采样缓冲，
+ *             不开DMA中断；读取时对整个缓冲求平均（约3ms窗口，滤掉电调开关纹波），
+ *             再做一阶低通得到控制用电压。
+ *             分压：电池 → 10k/1k → PC0，比例 BATTERY_DIVIDER，可经VOFA "VS" 校准。
+ *             无分压电路时（台架调试）可选 BATTERY_SOURCE_HOST，电压由上位机经VOFA "VB" 写入。
+ */
+
+#ifndef __BATTERY_H
+#define __BATTERY_H
+
+#include "main.h"
+
+/* 电压来源 */
+#define BATTERY_SOURCE_ADC      0   // ADC采样
+#define BATTERY_SOURCE_HOST     1   // 上位机写入（替代ADC）
+
+#ifndef BATTERY_SOURCE
+#define BATTERY_SOURCE          BATTERY_SOURCE_ADC
+#endif
+
+#define BATTERY_ADC_SAMPLES     64          // DMA循环缓冲长度
+#define BATTERY_ADC_VREF        3.3f        // ADC参考电压 (V)
+#define BATTERY_ADC_FULL        4095.0f     // 12位满量程
+#define BATTERY_DIVIDER         11.0f       // 分压比 (10k + 1k) / 1k
+#define BATTERY_LPF_ALPHA       0.2f        // 控制周期一阶低通系数（100Hz下时间常数约45ms）
+#define BATTERY_MIN_VALID       6.0f        // 低于该电压视为未接电池/采样无效 (V)
+
+typedef struct {
+    uint16_t buf[BATTERY_ADC_SAMPLES];  // DMA循环缓冲
+    float raw;              // 缓冲平均后的电压 (V)
+    float voltage;          // 低通后电压 (V)，无效时为0
+    float scale;            // 分压比（可校准）
+    float host_voltage;     // 上位机写入的电压（BATTERY_SOURCE_HOST）
+    uint8_t valid;
+} Battery_t;
+
+/** 启动ADC连续转换与DMA循环采样 */
+void Battery_Init(void);
+
+/** 平均采样缓冲并低通（控制周期调用） */
+void Battery_Update(void);
+
+/** 电池电压 (V)，无效返回0 */
+float Battery_GetVoltage(void);
+
+/** 注册分压校准（"VS"）与上位机电压（"VB"）到VOFA */
+void Battery_RegisterVofa(void);
+
+extern Battery_t g_battery;
+
+#endif
@@ -6,72 +6,90 @@
 #define ELRS_DMA_INSTANCE   hdma_usart6_rx
 extern DMA_HandleTypeDef hdma_usart6_rx;
 
-#define CRSF_SYNC           0xC8
-#define CRSF_TYPE_RC        0x16
-#define CRSF_PAYLOAD_LEN    22
-#define CRSF_FRAME_LEN      26          // 完整帧长度
-#define BUF_SIZE            32
+#define CRSF_LEN_MIN        2                           // 长度字节下限（类型+CRC）
+#define CRSF_LEN_MAX        (CRSF_FRAME_SIZE_MAX - 2)   // 长度字节上限（不含地址与长度字节）
+#define CRSF_RC_PAYLOAD_LEN 22                          // 16通道 × 11bit
+#define CRSF_LINK_PAYLOAD_LEN 10
+#define CRSF_EXT_HEADER_LEN 2                           // 扩展帧负载前的目标地址+源地址
 
 #define RC_MIN              172
 #define RC_MAX              1811
+#define RC_MID              ((RC_MIN + RC_MAX) * 0.5f)
+#define RC_SCALE            (200.0f / (RC_MAX - RC_MIN))    // 预计算比例：1个原始单位 ≈ 0.122
 
-bool elrs_flag_of_receive = 0;
-uint8_t elrs_rx_buf[BUF_SIZE];
-uint8_t elrs_payload[CRSF_PAYLOAD_LEN];
+static uint8_t elrs_rx_buf[CRSF_RX_BUF_SIZE];       // DMA循环缓冲区
+static uint16_t elrs_rx_pos = 0;                    // 已消费到的位置
 
-uint16_t elrs_channels[ELRS_CHAN_NUM];
+/* 滑动窗口（只在接收中断中访问） */
+static uint8_t crsf_win[CRSF_FRAME_SIZE_MAX];
+static uint8_t crsf_win_len = 0;
+
+/* 最新RC帧（中断写后序号加1，主循环按序号判断新帧并校验拷贝完整） */
+static uint16_t crsf_rc_latest[CRSF_CHAN_NUM];
+static uint32_t crsf_rc_tick;
+static uint32_t crsf_rc_cyc;
+static volatile uint32_t crsf_rc_seq = 0;
+static uint32_t crsf_rc_seq_read = 0;
+
+static uint8_t crsf_tx_buf[CRSF_FRAME_SIZE_MAX];    // 遥测发送缓冲（DMA直接读取）
+
+static uint32_t crsf_rx_cyc;                        // 本次接收事件的DWT时间戳
+static float crsf_ms_per_cyc;                       // DWT周期 → ms
+
+uint16_t elrs_channels[CRSF_CHAN_NUM];
 rc_raw_ch rc_raw_channels;
-elrs_status_t elrs_status = {0, 0, 0, 0};
+elrs_status_t elrs_status = {0, 0, 0, 0, 0};
+crsf_link_stats_t crsf_link;
+crsf_link_health_t crsf_health;
+crsf_ext_request_t crsf_ext;
+crsf_stats_t crsf_stats;
+
+/* CRC-8 查表 (多项式 0xD5) */
+static const uint8_t crsf_crc8_table[256] = {
+    0x00, 0xD5, 0x7F, 0xAA, 0xFE, 0x2B, 0x81, 0x54, 0x29, 0xFC, 0x56, 0x83, 0xD7, 0x02, 0xA8, 0x7D,
+    0x52, 0x87, 0x2D, 0xF8, 0xAC, 0x79, 0xD3, 0x06, 0x7B, 0xAE, 0x04, 0xD1, 0x85, 0x50, 0xFA, 0x2F,
+    0xA4, 0x71, 0xDB, 0x0E, 0x5A, 0x8F, 0x25, 0xF0, 0x8D, 0x58, 0xF2, 0x27, 0x73, 0xA6, 0x0C, 0xD9,
+    0xF6, 0x23, 0x89, 0x5C, 0x08, 0xDD, 0x77, 0xA2, 0xDF, 0x0A, 0xA0, 0x75, 0x21, 0xF4, 0x5E, 0x8B,
+    0x9D, 0x48, 0xE2, 0x37, 0x63, 0xB6, 0x1C, 0xC9, 0xB4, 0x61, 0xCB, 0x1E, 0x4A, 0x9F, 0x35, 0xE0,
+    0xCF, 0x1A, 0xB0, 0x65, 0x31, 0xE4, 0x4E, 0x9B, 0xE6, 0x33, 0x99, 0x4C, 0x18, 0xCD, 0x67, 0xB2,
+    0x39, 0xEC, 0x46, 0x93, 0xC7, 0x12, 0xB8, 0x6D, 0x10, 0xC5, 0x6F, 0xBA, 0xEE, 0x3B, 0x91, 0x44,
+    0x6B, 0xBE, 0x14, 0xC1, 0x95, 0x40, 0xEA, 0x3F, 0x42, 0x97, 0x3D, 0xE8, 0xBC, 0x69, 0xC3, 0x16,
+    0xEF, 0x3A, 0x90, 0x45, 0x11, 0xC4, 0x6E, 0xBB, 0xC6, 0x13, 0xB9, 0x6C, 0x38, 0xED, 0x47, 0x92,
+    0xBD, 0x68, 0xC2, 0x17, 0x43, 0x96, 0x3C, 0xE9, 0x94, 0x41, 0xEB, 0x3E, 0x6A, 0xBF, 0x15, 0xC0,
+    0x4B, 0x9E, 0x34, 0xE1, 0xB5, 0x60, 0xCA, 0x1F, 0x62, 0xB7, 0x1D, 0xC8, 0x9C, 0x49, 0xE3, 0x36,
+    0x19, 0xCC, 0x66, 0xB3, 0xE7, 0x32, 0x98, 0x4D, 0x30, 0xE5, 0x4F, 0x9A, 0xCE, 0x1B, 0xB1, 0x64,
+    0x72, 0xA7, 0x0D, 0xD8, 0x8C, 0x59, 0xF3, 0x26, 0x5B, 0x8E, 0x24, 0xF1, 0xA5, 0x70, 0xDA, 0x0F,
+    0x20, 0xF5, 0x5F, 0x8A, 0xDE, 0x0B, 0xA1, 0x74, 0x09, 0xDC, 0x76, 0xA3, 0xF7, 0x22, 0x88, 0x5D,
+    0xD6, 0x03, 0xA9, 0x7C, 0x28, 0xFD, 0x57, 0x82, 0xFF, 0x2A, 0x80, 0x55, 0x01, 0xD4, 0x7E, 0xAB,
+    0x84, 0x51, 0xFB, 0x2E, 0x7A, 0xAF, 0x05, 0xD0, 0xAD, 0x78, 0xD2, 0x07, 0x53, 0x86, 0x2C, 0xF9
+};
 
 /**
- * @brief  CRSF CRC-8 计算 (多项式 0xD5)
- * @param  type   帧类型字节
- * @param  data   负载数据指针
- * @param  len    数据长度
+ * @brief  CRSF CRC-8 计算（覆盖类型字节与负载）
+ * @param  data   类型字节起始指针
+ * @param  len    字节数
  * @return CRC 校验值
  */
-uint8_t calc_crc(uint8_t type, const uint8_t *data, uint8_t len)
+static inline uint8_t crsf_crc8(const uint8_t *data, uint8_t len)
 {
     uint8_t crc = 0;
-    crc ^= type;
-    for (uint8_t i = 0; i < 8; i++) 
-        crc = (crc & 0x80) ? ((crc << 1) ^ 0xD5) : (crc << 1);
-    
-    for (uint8_t i = 0; i < len; i++) {
-        crc ^= data[i];
-        for (uint8_t j = 0; j < 8; j++)
-            crc = (crc & 0x80) ? ((crc << 1) ^ 0xD5) : (crc << 1);
+    while (len--) {
+        crc = crsf_crc8_table[crc ^ *data++];
     }
     return crc;
 }
 
-/** @brief 将 172-1811 映射到 -100~100 *//** author : lsl-sys*/
-static int8_t remap_channel(uint16_t val)
+/** @brief 将 172-1811 映射到 -100.0~100.0（全分辨率，无整数除法） *//** author : lsl-sys*/
+static inline float remap_channel(uint16_t val)
 {
-    if (val < RC_MIN) return -100;
-    if (val > RC_MAX) return 100;
-    return (int8_t)((val - RC_MIN) * 200 / (RC_MAX - RC_MIN) - 100);
+    if (val <= RC_MIN) return -100.0f;
+    if (val >= RC_MAX) return 100.0f;
+    return ((float)val - RC_MID) * RC_SCALE;
 }
 
-/**
- * @brief  解析 10 通道数据 (11bit/通道, 共 22 字节)
- * @param  payload 22字节负载数据
- */
-static void parse_channels(const uint8_t *payload)
+/** @brief 前10通道映射到 rc_raw_channels */
+static void map_channels(void)
 {
-    uint64_t bits = 0;
-    uint8_t bit_cnt = 0, byte_idx = 0;
-    
-    for (uint8_t i = 0; i < ELRS_CHAN_NUM; i++) {
-        while (bit_cnt < 11) {
-            bits |= ((uint64_t)payload[byte_idx++] << bit_cnt);
-            bit_cnt += 8;
-        }
-        elrs_channels[i] = bits & 0x07FF;
-        bits >>= 11;
-        bit_cnt -= 11;
-    }
-    
     rc_raw_channels.ch1  = remap_channel(elrs_channels[0]);
     rc_raw_channels.ch2  = remap_channel(elrs_channels[1]);
     rc_raw_channels.ch3  = remap_channel(elrs_channels[2]);
@@ -97,85 +115,465 @@ static void enter_failsafe(void)
 #endif
 }
 
+/** @brief 回到未收敛状态（包速率切换），收敛前失控超时取上限 */
+static inline void interval_relearn(void)
+{
+    crsf_health.learned = 0;
+    crsf_health.learn_cnt = 0;
+    crsf_health.cand_cnt = 0;
+    crsf_health.rate_changes++;
+}
+
+/**
+ * @brief  RC帧间隔估计（接收中断中调用）
+ * @note   落在估计 ±CRSF_INTERVAL_BAND 内的间隔做EMA；偏离的间隔多为丢帧（整数倍），
+ *         只有连续 CRSF_RATE_RELEARN 帧与同一候选值一致时才判定包速率改变并直接采用；
+ *         未收敛时偏离的间隔直接采用，使速率切换后尽快跟上
+ */
+static void track_interval(uint32_t cyc)
+{
+    static uint32_t last_cyc = 0;
+    static uint8_t have_last = 0;
+    crsf_link_health_t *h = &crsf_health;
+
+    float dt = (float)(cyc - last_cyc) * crsf_ms_per_cyc;
+    last_cyc = cyc;
+    if (!have_last) {
+        have_last = 1;
+        return;
+    }
+    if (dt > ELRS_TIMEOUT_MAX_MS) return;    // 信号中断后的第一帧
+    if (dt < 0.5f) return;                  // 同一接收事件中的多帧（帧间无空闲），无间隔信息
+
+    float dev = (dt - h->interval_ms) / h->interval_ms;
+    if (dev > -CRSF_INTERVAL_BAND && dev < CRSF_INTERVAL_BAND) {
+        h->interval_ms += CRSF_INTERVAL_ALPHA * (dt - h->interval_ms);
+        h->cand_cnt = 0;
+        if (!h->learned && ++h->learn_cnt >= CRSF_RATE_LEARN_FRAMES) {
+            h->learned = 1;
+        }
+        return;
+    }
+
+    if (!h->learned) {
+        h->interval_ms = dt;
+        h->learn_cnt = 0;
+        return;
+    }
+
+    float cdev = (dt - h->cand_ms) / h->cand_ms;
+    if (h->cand_cnt > 0 && cdev > -CRSF_INTERVAL_BAND * 0.5f && cdev < CRSF_INTERVAL_BAND * 0.5f) {
+        if (++h->cand_cnt >= CRSF_RATE_RELEARN) {
+            interval_relearn();
+            h->interval_ms = h->cand_ms;
+        }
+    } else {
+        h->cand_ms = dt;
+        h->cand_cnt = 1;
+    }
+}
+
+/* ================= 帧类型处理（接收中断中调用） ================= */
+
+/** @brief RC帧：解码16通道 (11bit/通道, 共 22 字节) */
+static void handle_rc(const uint8_t *payload, uint8_t len, uint32_t tick)
+{
+    uint32_t bits = 0;
+    uint8_t bit_cnt = 0;
+
+    (void)len;
+    for (uint8_t i = 0; i < CRSF_CHAN_NUM; i++) {
+        while (bit_cnt < 11) {
+            bits |= ((uint32_t)*payload++ << bit_cnt);
+            bit_cnt += 8;
+        }
+        crsf_rc_latest[i] = bits & 0x07FF;
+        bits >>= 11;
+        bit_cnt -= 11;
+    }
+    crsf_rc_tick = tick;
+    crsf_rc_cyc = crsf_rx_cyc;
+    crsf_rc_seq++;
+    track_interval(crsf_rx_cyc);
+}
+
+/** @brief 链路统计帧 */
+static void handle_link(const uint8_t *payload, uint8_t len, uint32_t tick)
+{
+    (void)len;
+    // 射频模式变化即包速率切换，帧间隔重新学习
+    if (crsf_link.count > 0 && payload[5] != crsf_link.rf_mode) {
+        interval_relearn();
+    }
+    crsf_link.uplink_rssi_1   = payload[0];
+    crsf_link.uplink_rssi_2   = payload[1];
+    crsf_link.uplink_lq       = payload[2];
+    crsf_link.uplink_snr      = (int8_t)payload[3];
+    crsf_link.active_antenna  = payload[4];
+    crsf_link.rf_mode         = payload[5];
+    crsf_link.uplink_tx_power = payload[6];
+    crsf_link.downlink_rssi   = payload[7];
+    crsf_link.downlink_lq     = payload[8];
+    crsf_link.downlink_snr    = (int8_t)payload[9];
+    crsf_link.tick = tick;
+    crsf_link.count++;
+}
+
+/** @brief 扩展帧目标是否为本机 */
+static inline uint8_t ext_for_us(uint8_t dest)
+{
+    return dest == CRSF_ADDRESS_FLIGHT_CONTROLLER || dest == CRSF_ADDRESS_BROADCAST;
+}
+
+/** @brief 设备PING：记录发起方，由遥测回复设备信息 */
+static void handle_ping(const uint8_t *payload, uint8_t len, uint32_t tick)
+{
+    (void)len;
+    (void)tick;
+    if (!ext_for_us(payload[0])) return;
+    crsf_ext.ping_origin = payload[1];
+    crsf_ext.ping_pending = 1;
+}
+
+/** @brief MSP请求/写入：保存负载待上层处理（上一条未处理时丢弃新请求） */
+static void handle_msp(const uint8_t *payload, uint8_t len, uint32_t tick)
+{
+    (void)tick;
+    if (!ext_for_us(payload[0]) || crsf_ext.msp_pending) return;
+
+    len -= CRSF_EXT_HEADER_LEN;
+    if (len > CRSF_MSP_BUF_SIZE) len = CRSF_MSP_BUF_SIZE;
+    crsf_ext.msp_type = payload[-1];        // 负载前一字节为帧类型
+    crsf_ext.msp_origin = payload[1];
+    crsf_ext.msp_len = len;
+    memcpy(crsf_ext.msp_buf, &payload[CRSF_EXT_HEADER_LEN], len);
+    crsf_ext.msp_pending = 1;
+}
+
+typedef struct {
+    uint8_t type;
+    uint8_t min_len;                                        // 负载最小长度
+    void (*handler)(const uint8_t *payload, uint8_t len, uint32_t tick);   // NULL 表示只计数
+} crsf_dispatch_t;
+
+/* 分发表（按出现频率排序，RC帧在最前），顺序即 crsf_stats.type_count 下标 */
+static const crsf_dispatch_t crsf_dispatch[CRSF_TYPE_SLOTS] = {
+    {CRSF_FRAMETYPE_RC_CHANNELS_PACKED,       CRSF_RC_PAYLOAD_LEN,       handle_rc},
+    {CRSF_FRAMETYPE_LINK_STATISTICS,          CRSF_LINK_PAYLOAD_LEN,     handle_link},
+    {CRSF_FRAMETYPE_DEVICE_PING,              CRSF_EXT_HEADER_LEN,       handle_ping},
+    {CRSF_FRAMETYPE_MSP_REQ,                  CRSF_EXT_HEADER_LEN + 1,   handle_msp},
+    {CRSF_FRAMETYPE_MSP_WRITE,                CRSF_EXT_HEADER_LEN + 1,   handle_msp},
+    // 以下为下行遥测或本机不处理的类型，只计数
+    {CRSF_FRAMETYPE_GPS,                      0,                         NULL},
+    {CRSF_FRAMETYPE_BATTERY_SENSOR,           0,                         NULL},
+    {CRSF_FRAMETYPE_OPENTX_SYNC,              0,                         NULL},
+    {CRSF_FRAMETYPE_RADIO_ID,                 0,                         NULL},
+    {CRSF_FRAMETYPE_ATTITUDE,                 0,                         NULL},
+    {CRSF_FRAMETYPE_FLIGHT_MODE,              0,                         NULL},
+    {CRSF_FRAMETYPE_DEVICE_INFO,              0,                         NULL},
+    {CRSF_FRAMETYPE_PARAMETER_SETTINGS_ENTRY, 0,                         NULL},
+    {CRSF_FRAMETYPE_PARAMETER_READ,           0,                         NULL},
+    {CRSF_FRAMETYPE_PARAMETER_WRITE,          0,                         NULL},
+    {CRSF_FRAMETYPE_COMMAND,                  0,                         NULL},
+    {CRSF_FRAMETYPE_MSP_RESP,                 0,                         NULL},
+};
+
+/** @brief 校验通过的整帧按类型分发 */
+static void frame_dispatch(const uint8_t *f, uint32_t tick)
+{
+    uint8_t type = f[2];
+    uint8_t plen = f[1] - 2;                // 去掉类型与CRC
+
+    crsf_stats.frames++;
+    for (uint8_t i = 0; i < CRSF_TYPE_SLOTS; i++) {
+        if (crsf_dispatch[i].type != type) continue;
+
+        if (plen < crsf_dispatch[i].min_len) {
+            crsf_stats.short_payload++;
+            return;
+        }
+        crsf_stats.type_count[i]++;
+        if (crsf_dispatch[i].handler) {
+            crsf_dispatch[i].handler(&f[3], plen, tick);
+        }
+        return;
+    }
+    crsf_stats.unknown++;
+}
+
+/** 窗口前移n字节 */
+static inline void win_drop(uint8_t n)
+{
+    crsf_win_len -= n;
+    memmove(crsf_win, &crsf_win[n], crsf_win_len);
+}
+
+/** 帧首地址字节（接收机发往飞控为0xC8，部分发射机透传为0xEE） */
+static inline uint8_t is_sync(uint8_t b)
+{
+    return b == CRSF_ADDRESS_FLIGHT_CONTROLLER || b == CRSF_ADDRESS_CRSF_TRANSMITTER;
+}
+
+/**
+ * @brief  字节流解析：按长度字节收齐变长帧，先校验后分发
+ * @note   首字节不是地址、长度非法或CRC失败时只丢弃首字节，从下一字节继续匹配，
+ *         坏帧内部或之后的好帧仍能被找到；一帧分发后窗口内剩余字节继续解析
+ */
+static void crsf_parse_byte(uint8_t byte, uint32_t tick)
+{
+    crsf_win[crsf_win_len++] = byte;
+
+    while (crsf_win_len > 0) {
+        if (!is_sync(crsf_win[0])) {
+            win_drop(1);
+            crsf_stats.resync++;
+            continue;
+        }
+        if (crsf_win_len < 2) {
+            return;
+        }
+        uint8_t len = crsf_win[1];
+        if (len < CRSF_LEN_MIN || len > CRSF_LEN_MAX) {
+            crsf_stats.len_err++;
+            win_drop(1);
+            crsf_stats.resync++;
+            continue;
+        }
+        if (crsf_win_len < len + 2) {
+            return;                 // 等待后续字节
+        }
+
+        // CRC覆盖类型字节与负载，位于帧尾
+        if (crsf_crc8(&crsf_win[2], len - 1) == crsf_win[len + 1]) {
+            frame_dispatch(crsf_win, tick);
+            win_drop(len + 2);
+            continue;
+        }
+        crsf_stats.crc_err++;
+        win_drop(1);
+        crsf_stats.resync++;
+    }
+}
+
+/**
+ * @brief  启动DMA循环接收
+ * @note   保留半满中断：420000波特满速时帧间无空闲，空闲中断可能整圈不出现，
+ *         半满/满中断保证每半圈至少消费一次，DMA不会追上未解析的字节
+ */
+static void crsf_start_dma(void)
+{
+    elrs_rx_pos = 0;
+    crsf_win_len = 0;
+    HAL_UARTEx_ReceiveToIdle_DMA(&ELRS_HUART, elrs_rx_buf, CRSF_RX_BUF_SIZE);
+}
+
 void crsf_init(void)
 {
-    HAL_UARTEx_ReceiveToIdle_DMA(&ELRS_HUART, elrs_rx_buf, BUF_SIZE);
-    __HAL_DMA_DISABLE_IT(&ELRS_DMA_INSTANCE, DMA_IT_HT);
-    memset(elrs_rx_buf, 0, BUF_SIZE);
+    memset(elrs_rx_buf, 0, sizeof(elrs_rx_buf));
+    memset(&crsf_stats, 0, sizeof(crsf_stats));
+    memset(&crsf_link, 0, sizeof(crsf_link));
+    memset(&crsf_ext, 0, sizeof(crsf_ext));
+    memset(&crsf_health, 0, sizeof(crsf_health));
+    crsf_health.interval_ms = 1000.0f / ELRS_PACKET_RATE;     // 先验值，收到帧后按实测收敛
+    crsf_health.timeout_ms = ELRS_TIMEOUT_MAX_MS;
+
+    // DWT周期计数器给帧到达打微秒级时间戳（只开启不清零，不影响其他模块的计时）
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    crsf_ms_per_cyc = 1000.0f / (float)SystemCoreClock;
+
+    crsf_start_dma();
 }
 
 /**
- * @brief  串口接收完成回调 (在中断中调用)
+ * @brief  串口接收事件回调：消费 [elrs_rx_pos, pos) 区间的新字节（可能跨越缓冲区末尾）
+ * @param  pos DMA写指针位置，传输完成中断时等于缓冲区长度
  */
-void crsf_receive_data(void)
+void crsf_receive_data(uint16_t pos)
+{
+    uint32_t tick = HAL_GetTick();
+
+    if (pos > CRSF_RX_BUF_SIZE) return;
+    crsf_rx_cyc = DWT->CYCCNT;
+    uint32_t rc_seq = crsf_rc_seq;
+
+    while (elrs_rx_pos != pos) {
+        crsf_parse_byte(elrs_rx_buf[elrs_rx_pos], tick);
+        crsf_stats.bytes++;
+        elrs_rx_pos++;
+        if (elrs_rx_pos >= CRSF_RX_BUF_SIZE) {
+            elrs_rx_pos = 0;
+            if (pos == CRSF_RX_BUF_SIZE) break;     // 刚好写满一圈
+        }
+    }
+
+    // 收到RC帧后接收机进入等待回复的时隙
+    if (rc_seq != crsf_rc_seq) {
+        crsf_telemetry_slot();
+    }
+}
+
+__weak void crsf_telemetry_slot(void)
 {
-    HAL_UARTEx_ReceiveToIdle_DMA(&ELRS_HUART, elrs_rx_buf, BUF_SIZE);
-    __HAL_DMA_DISABLE_IT(&ELRS_DMA_INSTANCE, DMA_IT_HT);
-    elrs_flag_of_receive = 1;
+}
+
+uint8_t *crsf_tx_begin(void)
+{
+    if (ELRS_HUART.gState != HAL_UART_STATE_READY) {
+        crsf_stats.tx_busy++;
+        return NULL;
+    }
+    return &crsf_tx_buf[3];
+}
+
+uint8_t crsf_tx_commit(uint8_t type, uint8_t payload_len)
+{
+    if (payload_len > CRSF_FRAME_SIZE_MAX - 4) return 1;
+
+    crsf_tx_buf[0] = CRSF_ADDRESS_FLIGHT_CONTROLLER;
+    crsf_tx_buf[1] = payload_len + 2;                   // 类型 + 负载 + CRC
+    crsf_tx_buf[2] = type;
+    crsf_tx_buf[payload_len + 3] = crsf_crc8(&crsf_tx_buf[2], payload_len + 1);
+
+    if (HAL_UART_Transmit_DMA(&ELRS_HUART, crsf_tx_buf, payload_len + 4) != HAL_OK) {
+        crsf_stats.tx_busy++;
+        return 1;
+    }
+    crsf_stats.tx_frames++;
+    return 0;
+}
+
+/** @brief 每秒更新字节/帧速率 */
+static void update_rates(uint32_t now)
+{
+    static uint32_t rate_tick = 0;
+    static uint32_t last_bytes = 0, last_frames = 0, last_rc = 0;
+
+    if (now - rate_tick < 1000) return;
+    rate_tick = now;
+
+    crsf_stats.byte_rate  = (uint16_t)(crsf_stats.bytes - last_bytes);
+    crsf_stats.frame_rate = (uint16_t)(crsf_stats.frames - last_frames);
+    crsf_stats.rc_rate    = (uint16_t)(crsf_stats.type_count[0] - last_rc);
+    last_bytes  = crsf_stats.bytes;
+    last_frames = crsf_stats.frames;
+    last_rc     = crsf_stats.type_count[0];
+}
+
+/**
+ * @brief  链路预警等级判定
+ * @note   链路统计未过期时按上行LQ/当前天线RSSI判定，RC帧迟到帧数独立判定，取较差者；
+ *         LQ从低等级恢复时需高出阈值 CRSF_LQ_HYST；等级下降立即生效，
+ *         回升需持续 CRSF_LEVEL_HOLD_MS，避免丢帧时在 WARN/CRITICAL 间来回跳
+ */
+static void update_level(uint32_t now)
+{
+    static uint32_t better_tick = 0;
+    crsf_link_health_t *h = &crsf_health;
+    uint8_t prev = h->level;
+    uint8_t level = CRSF_LINK_OK;
+
+    h->packet_rate = (uint16_t)(1000.0f / h->interval_ms + 0.5f);
+
+    if (crsf_link.count > 0 && now - crsf_link.tick < CRSF_STATS_STALE_MS) {
+        h->lq = crsf_link.uplink_lq;
+        h->rssi_dbm = crsf_link.active_antenna ? crsf_link.uplink_rssi_2 : crsf_link.uplink_rssi_1;
+        h->snr = crsf_link.uplink_snr;
+
+        uint8_t crit_lq = CRSF_LQ_CRIT + ((prev <= CRSF_LINK_CRITICAL) ? CRSF_LQ_HYST : 0);
+        uint8_t warn_lq = CRSF_LQ_WARN + ((prev <= CRSF_LINK_WARN) ? CRSF_LQ_HYST : 0);
+        if (h->lq < crit_lq) {
+            level = CRSF_LINK_CRITICAL;
+        } else if (h->lq < warn_lq || h->rssi_dbm > CRSF_RSSI_WARN_DBM) {
+            level = CRSF_LINK_WARN;
+        }
+    } else {
+        h->lq = 0;
+        h->rssi_dbm = 0;
+        h->snr = 0;
+    }
+
+    if (h->late_frames > CRSF_LATE_CRIT_FRAMES) {
+        level = CRSF_LINK_CRITICAL;
+    } else if (h->late_frames > CRSF_LATE_WARN_FRAMES && level > CRSF_LINK_WARN) {
+        level = CRSF_LINK_WARN;
+    }
+    if (!elrs_status.is_connected) {
+        level = CRSF_LINK_LOST;
+    }
+
+    if (level > prev && prev != CRSF_LINK_LOST) {
+        if (better_tick == 0) better_tick = now;
+        if (now - better_tick < CRSF_LEVEL_HOLD_MS) return;
+    }
+    better_tick = 0;
+
+    if (level < prev) {
+        if (level == CRSF_LINK_WARN) h->warn_events++;
+        if (level == CRSF_LINK_CRITICAL) h->crit_events++;
+    }
+    h->level = level;
 }
 
 /**
  * @brief  数据解析与状态检测 (在主循环或定时器中调用)
- * @note   自动处理帧查找、CRC 校验、超时判定和失控保护
+ * @note   帧查找与CRC校验已在接收中断中完成，此处取最新RC帧并做超时判定和失控保护
  */
 void crsf_analysis_data(void)
 {
-    uint32_t now = HAL_GetTick();
-    uint8_t frame_found = 0;
-    
-    if (elrs_flag_of_receive) {
-        elrs_flag_of_receive = 0;
-        
-        // 帧头查找与 CRC 校验
-        for (uint8_t i = 0; i <= BUF_SIZE - CRSF_FRAME_LEN; i++) {
-            if (elrs_rx_buf[i] != CRSF_SYNC) continue;
-            if (elrs_rx_buf[i+1] != (CRSF_PAYLOAD_LEN + 2)) continue;
-            if (elrs_rx_buf[i+2] != CRSF_TYPE_RC) continue;
-            
-            uint8_t *p = &elrs_rx_buf[i];
-            if (calc_crc(CRSF_TYPE_RC, &p[3], CRSF_PAYLOAD_LEN) != p[25])
-                continue;
-            
-            // 校验通过，解析数据
-            memcpy(elrs_payload, &p[3], CRSF_PAYLOAD_LEN);
-            parse_channels(elrs_payload);
-            
-            elrs_status.frame_valid = 1;
-            elrs_status.last_tick = now;
-            frame_found = 1;
-            
-            if (!elrs_status.is_connected) {
-                elrs_status.is_connected = 1;
-                elrs_status.lost_count = 0;
-            }
-            
-            memset(elrs_rx_buf, 0, BUF_SIZE);
-            break;
-        }
-        
-        if (!frame_found) {
-            elrs_status.frame_valid = 0;
-        }
+    // 串口错误（ORE/FE）时HAL会中止DMA接收，此处检测并重启
+    if (ELRS_HUART.RxState == HAL_UART_STATE_READY) {
+        crsf_stats.dma_restart++;
+        crsf_start_dma();
     }
-    
-    // 超时判定
-    if (now - elrs_status.last_tick > ELRS_TIMEOUT_MS) {
-        if (elrs_status.is_connected) {
-            // 首次超时，增加丢失计数
-            elrs_status.lost_count++;
-            
-            // 只有连续超时达到容忍次数，才判定为失控
-            if (elrs_status.lost_count >= ELRS_LOST_TOLERANCE) {
-                elrs_status.is_connected = 0;
-                enter_failsafe();
-            }
+
+    uint32_t seq = crsf_rc_seq;
+    if (seq != crsf_rc_seq_read) {
+        uint32_t tick, cyc;
+        // 拷贝期间被接收中断更新则重读，保证16通道来自同一帧
+        do {
+            seq = crsf_rc_seq;
+            memcpy(elrs_channels, crsf_rc_latest, sizeof(elrs_channels));
+            tick = crsf_rc_tick;
+            cyc = crsf_rc_cyc;
+        } while (seq != crsf_rc_seq);
+        crsf_rc_seq_read = seq;
+
+        map_channels();
+        elrs_status.frame_valid = 1;
+        elrs_status.last_tick = tick;
+        elrs_status.last_cyc = cyc;
+
+        if (!elrs_status.is_connected) {
+            elrs_status.is_connected = 1;
+            elrs_status.lost_count = 0;
         }
+    } else {
+        elrs_status.frame_valid = 0;
     }
-    
-    // 清理缓冲区
-    if (!frame_found && elrs_flag_of_receive) {
-        memset(elrs_rx_buf, 0, BUF_SIZE);
+
+    uint32_t now = HAL_GetTick();   // 在取帧之后读取，帧时间戳不会晚于now
+
+    // 超时判定：超时按实测帧间隔，未收敛（包速率未知或切换中）时取上限
+    crsf_link_health_t *h = &crsf_health;
+    uint32_t since = now - elrs_status.last_tick;
+    float timeout = h->interval_ms * (ELRS_LOST_TOLERANCE + 1);
+    if (!h->learned || timeout > ELRS_TIMEOUT_MAX_MS) timeout = ELRS_TIMEOUT_MAX_MS;
+    if (timeout < ELRS_TIMEOUT_MIN_MS) timeout = ELRS_TIMEOUT_MIN_MS;
+    h->timeout_ms = (uint16_t)timeout;
+
+    float late = (float)since / h->interval_ms;
+    h->late_frames = (late > 65535.0f) ? 65535 : (uint16_t)late;
+    elrs_status.lost_count = (h->late_frames > 255) ? 255 : (uint8_t)h->late_frames;
+
+    if (since > h->timeout_ms && elrs_status.is_connected) {
+        elrs_status.is_connected = 0;
+        h->lost_events++;
+        enter_failsafe();
     }
+
+    update_level(now);
+    update_rates(now);
 }
 
 #else
@@ -186,7 +584,7 @@ void sbus_init(void)
 {
 }
 
-void sbus_receive_data(void)
+void sbus_receive_data(uint16_t pos)
 {
 }
 
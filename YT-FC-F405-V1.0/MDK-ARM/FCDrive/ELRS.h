@@ -1,10 +1,21 @@
 /**
  * @file       ELRS.h
  * @author	   lsl-sys
- * @brief      RC Receiver Driver (ELRS Protocol) Using USART DMA IDLE Line Detection
- * @version    V2.3.0
- * @date       2025-12-13 2026-1-30 2026-2-13
+ * @brief      RC Receiver Driver (ELRS Protocol) Using USART Circular DMA + IDLE Stream Parser
+ * @version    V2.5.0
+ * @date       2025-12-13 2026-1-30 2026-2-13 2026-2-24
  * @Encoding   UTF-8
+ * @note       通道值为全分辨率浮点（-100.0~100.0），11位原始值（172~1811）按预计算比例换算，
+ *             不再量化为整数（原 int8_t 约丢失3位摇杆分辨率）。
+ *             CRSF：DMA循环接收，空闲/半满/满中断中按DMA写指针增量喂入字节流状态机，
+ *             滑动窗口按长度字节收齐变长帧（4~64字节），查表CRC8（0xD5）校验通过后按帧类型分发，
+ *             失败只丢弃1字节重新同步。RC帧解码全部16通道，链路统计、设备PING、MSP等帧
+ *             保存供遥测/上层使用，其余类型只计数。
+ *             失控判定按实测RC帧间隔（DWT微秒时间戳，EMA）：超时 = 间隔 × (ELRS_LOST_TOLERANCE+1)，
+ *             包速率切换（链路统计 rf_mode 变化或连续多帧间隔一致偏离）期间取上限，避免误触发。
+ *             链路统计的上行LQ/RSSI与RC帧迟到帧数给出 OK/WARN/CRITICAL 预警等级，先于失控提示。
+ *             遥测下行：每收到一帧RC即开放一个回复时隙（crsf_telemetry_slot，弱定义），
+ *             上层在 crsf_tx_begin 返回的DMA发送缓冲中直接填负载，crsf_tx_commit 补帧头/CRC后DMA发出。
  */
  
 #ifndef __ELRS_H
@@ -26,27 +37,42 @@
 
 #define ELRS_PACKET_RATE    250         // 刷新率: 50/150/250 Hz
 
-//允许连续丢失的帧数 
+//允许连续丢失的帧数（失控超时 = 实测帧间隔 × (ELRS_LOST_TOLERANCE + 1)）
 #define ELRS_LOST_TOLERANCE 10        
 
-#if ELRS_PACKET_RATE == 250
-    #define ELRS_TIMEOUT_MS (4 * (ELRS_LOST_TOLERANCE + 1))   
-#elif ELRS_PACKET_RATE == 150
-    #define ELRS_TIMEOUT_MS (7 * (ELRS_LOST_TOLERANCE + 1))  
-#elif ELRS_PACKET_RATE == 50
-    #define ELRS_TIMEOUT_MS (20 * (ELRS_LOST_TOLERANCE + 1)) 
-#else
-    #define ELRS_TIMEOUT_MS 30
-#endif
+#define ELRS_TIMEOUT_MIN_MS 20          // 失控超时下限
+#define ELRS_TIMEOUT_MAX_MS 250         // 失控超时上限（包速率未知或切换中取此值）
+
+/* 帧间隔估计 */
+#define CRSF_INTERVAL_ALPHA     0.05f   // 帧间隔EMA系数
+#define CRSF_INTERVAL_BAND      0.5f    // 相对估计偏离小于该比例的间隔参与平均，其余视为丢帧或速率变化
+#define CRSF_RATE_LEARN_FRAMES  8       // 连续该帧数间隔落在估计范围内，判定已收敛
+#define CRSF_RATE_RELEARN       8       // 已收敛后连续该帧数间隔一致地偏离估计，判定包速率改变
+
+/* 预警阈值 */
+#define CRSF_LQ_WARN            70      // 上行LQ低于该值 → WARN (%)
+#define CRSF_LQ_CRIT            40      // 上行LQ低于该值 → CRITICAL (%)
+#define CRSF_LQ_HYST            5       // 恢复时需高出阈值的量 (%)
+#define CRSF_RSSI_WARN_DBM      100     // 当前天线RSSI弱于 -100dBm → WARN
+#define CRSF_LATE_WARN_FRAMES   2       // 超过该帧数间隔未收到RC帧 → WARN
+#define CRSF_LATE_CRIT_FRAMES   4       // 超过该帧数间隔未收到RC帧 → CRITICAL
+#define CRSF_STATS_STALE_MS     1000    // 链路统计超过该时间未更新则不参与判定
+#define CRSF_LEVEL_HOLD_MS      500     // 等级回升需持续的时间（下降立即生效）
 
 #define ELRS_FAILSAFE_MODE  2           // 0:保持最后值 1:归零 2:自定义
 
-#define ELRS_CHAN_NUM       10          // 通道数
+#define ELRS_CHAN_NUM       10          // 映射到 rc_raw_ch 的通道数
+#define CRSF_CHAN_NUM       16          // RC帧中的通道数
+
+#define CRSF_RX_BUF_SIZE    128         // DMA循环缓冲区（420000波特下约3ms，需大于中断间隔内的字节数）
+#define CRSF_FRAME_SIZE_MAX 64          // 最大帧长（地址+长度+类型+负载+CRC）
+#define CRSF_MSP_BUF_SIZE   58          // MSP帧负载上限（去掉扩展头）
+#define CRSF_TYPE_SLOTS     17          // ELRS_Def.h 列出的帧类型数
 
 typedef struct {
-    int8_t ch1, ch2, ch3, ch4;         // 摇杆: 横滚、俯仰、油门、偏航
-    int8_t ch5, ch6, ch7, ch8;         // 开关通道
-    int8_t ch9, ch10;                  // 辅助
+    float ch1, ch2, ch3, ch4;          // 摇杆: 横滚、俯仰、油门、偏航（-100.0~100.0）
+    float ch5, ch6, ch7, ch8;          // 开关通道
+    float ch9, ch10;                   // 辅助
 } rc_raw_ch;
 
 typedef struct {
@@ -54,15 +80,113 @@ typedef struct {
     uint8_t is_connected;               // 连接状态（经容忍判定后）
     uint8_t lost_count;                 // 连续丢失帧计数
     uint32_t last_tick;                 // 上次有效帧时间戳
+    uint32_t last_cyc;                  // 上次有效帧到达时刻（DWT周期计数，用于延迟统计）
 } elrs_status_t;
 
+/* 链路预警等级 */
+typedef enum {
+    CRSF_LINK_LOST = 0,                 // 已失控（超时）
+    CRSF_LINK_CRITICAL,                 // 严重：LQ很低或连续多帧未到
+    CRSF_LINK_WARN,                     // 预警：LQ/RSSI下降或帧迟到
+    CRSF_LINK_OK,
+} crsf_link_level_e;
+
+/* 链路统计（CRSF_FRAMETYPE_LINK_STATISTICS 负载） */
+typedef struct {
+    uint8_t uplink_rssi_1;              // 上行天线1 RSSI（dBm取负）
+    uint8_t uplink_rssi_2;              // 上行天线2 RSSI（dBm取负）
+    uint8_t uplink_lq;                  // 上行链路质量 (%)
+    int8_t  uplink_snr;                 // 上行信噪比 (dB)
+    uint8_t active_antenna;             // 当前天线
+    uint8_t rf_mode;                    // 射频模式（包速率档位）
+    uint8_t uplink_tx_power;            // 上行发射功率档位
+    uint8_t downlink_rssi;              // 下行 RSSI（dBm取负）
+    uint8_t downlink_lq;                // 下行链路质量 (%)
+    int8_t  downlink_snr;               // 下行信噪比 (dB)
+    uint32_t tick;                      // 收到时刻 (ms)
+    uint32_t count;                     // 收到次数（判断是否有新数据）
+} crsf_link_stats_t;
+
+/* 链路健康度（帧间隔在接收中断中更新，等级在主循环中判定） */
+typedef struct {
+    float interval_ms;                  // 实测RC帧间隔（EMA）
+    float cand_ms;                      // 偏离估计的候选间隔（判断速率是否改变）
+    uint8_t learned;                    // 间隔已收敛（包速率切换后清零）
+    uint8_t learn_cnt;                  // 连续落在估计范围内的帧数
+    uint8_t cand_cnt;                   // 连续与候选间隔一致的帧数
+    uint16_t packet_rate;               // 实测包速率 (Hz)
+    uint16_t timeout_ms;                // 当前失控超时
+    uint16_t late_frames;               // 距上次RC帧已过的帧间隔数
+    uint8_t lq;                         // 上行LQ (%)，链路统计过期时为0
+    uint8_t rssi_dbm;                   // 当前天线RSSI（取负的dBm），过期时为0
+    int8_t snr;                         // 上行信噪比 (dB)
+    uint8_t level;                      // crsf_link_level_e
+    uint16_t rate_changes;              // 包速率重新学习次数
+    uint16_t warn_events;               // 进入WARN次数
+    uint16_t crit_events;               // 进入CRITICAL次数
+    uint16_t lost_events;               // 失控次数
+} crsf_link_health_t;
+
+/* 扩展帧请求（设备PING/MSP，中断中写，遥测/上层读后清 pending） */
+typedef struct {
+    volatile uint8_t ping_pending;      // 收到发给本机或广播的PING，待回复设备信息
+    uint8_t ping_origin;                // PING发起方地址
+    volatile uint8_t msp_pending;       // 收到MSP请求/写入，待处理
+    uint8_t msp_type;                   // CRSF_FRAMETYPE_MSP_REQ / MSP_WRITE
+    uint8_t msp_origin;                 // MSP发起方地址
+    uint8_t msp_len;                    // MSP负载长度
+    uint8_t msp_buf[CRSF_MSP_BUF_SIZE]; // MSP负载
+} crsf_ext_request_t;
+
+/* 接收统计 */
+typedef struct {
+    uint32_t bytes;                     // 收到字节数
+    uint32_t frames;                    // 校验通过帧数
+    uint32_t crc_err;                   // CRC错误帧数
+    uint32_t len_err;                   // 长度字节非法（<2或>62）次数
+    uint32_t resync;                    // 重新同步丢弃的字节数
+    uint32_t unknown;                   // 未列出帧类型
+    uint32_t short_payload;             // 负载短于该类型最小长度
+    uint32_t dma_restart;               // DMA接收中断（串口错误）后重启次数
+    uint32_t tx_frames;                 // 已发送遥测帧数
+    uint32_t tx_busy;                   // 发送DMA忙而放弃的时隙数
+    uint32_t type_count[CRSF_TYPE_SLOTS]; // 按分发表顺序（与ELRS_Def.h一致）的各类型帧数
+    uint16_t byte_rate;                 // 字节速率 (B/s，每秒更新)
+    uint16_t frame_rate;                // 帧速率 (帧/s)
+    uint16_t rc_rate;                   // RC帧速率 (帧/s)
+} crsf_stats_t;
+
 /* ================= 协议选择与接口映射 ================= */
 #if ELRS_USE_CRSF
 
 void crsf_init(void);
-void crsf_receive_data(void);
+
+/**
+ * @brief  串口接收事件回调（空闲/半满/满）
+ * @param  pos DMA写指针在缓冲区中的位置（HAL回调的Size参数）
+ */
+void crsf_receive_data(uint16_t pos);
+
+/** 取出最新RC帧更新 rc_raw_channels，并做超时/失控判定（主循环调用） */
 void crsf_analysis_data(void);
 
+/**
+ * @brief  取遥测发送缓冲
+ * @return 负载起始地址（帧头之后，最多 CRSF_FRAME_SIZE_MAX-4 字节），发送DMA忙时返回NULL
+ */
+uint8_t *crsf_tx_begin(void);
+
+/**
+ * @brief  补全帧头与CRC并启动DMA发送（负载已由调用方写入 crsf_tx_begin 返回的缓冲）
+ * @param  type 帧类型
+ * @param  payload_len 负载长度
+ * @return 0-已发送，1-发送失败
+ */
+uint8_t crsf_tx_commit(uint8_t type, uint8_t payload_len);
+
+/** 遥测回复时隙：每个含RC帧的接收事件末尾在中断中调用（弱定义，由遥测模块实现） */
+void crsf_telemetry_slot(void);
+
 static inline uint8_t crsf_is_connected(void) { 
     extern elrs_status_t elrs_status;
     return elrs_status.is_connected; 
@@ -71,17 +195,22 @@ static inline uint8_t crsf_frame_valid(void) {
     extern elrs_status_t elrs_status;
     return elrs_status.frame_valid; 
 }
+static inline uint8_t crsf_link_level(void) {
+    extern crsf_link_health_t crsf_health;
+    return crsf_health.level;
+}
 
 #define elrs_init           crsf_init
 #define elrs_receive_data   crsf_receive_data
 #define elrs_analysis_data  crsf_analysis_data
 #define elrs_is_connected   crsf_is_connected
 #define elrs_frame_valid    crsf_frame_valid
+#define elrs_link_level     crsf_link_level
 
 #else
 
 void sbus_init(void);
-void sbus_receive_data(void);
+void sbus_receive_data(uint16_t pos);
 void sbus_analysis_data(void);
 
 static inline uint8_t sbus_is_connected(void) { 
@@ -90,16 +219,28 @@ static inline uint8_t sbus_is_connected(void) {
 static inline uint8_t sbus_frame_valid(void) { 
     return 0; 
 }
+static inline uint8_t sbus_link_level(void) {
+    return CRSF_LINK_LOST;
+}
 
 #define elrs_init           sbus_init
 #define elrs_receive_data   sbus_receive_data
 #define elrs_analysis_data  sbus_analysis_data
 #define elrs_is_connected   sbus_is_connected
 #define elrs_frame_valid    sbus_frame_valid
+#define elrs_link_level     sbus_link_level
 
 #endif
 
 extern rc_raw_ch rc_raw_channels;
 extern elrs_status_t elrs_status;
 
+#if ELRS_USE_CRSF
+extern uint16_t elrs_channels[CRSF_CHAN_NUM];   // 16通道11位原始值（172~1811）
+extern crsf_link_stats_t crsf_link;
+extern crsf_link_health_t crsf_health;
+extern crsf_ext_request_t crsf_ext;
+extern crsf_stats_t crsf_stats;
+#endif
+
 #endif
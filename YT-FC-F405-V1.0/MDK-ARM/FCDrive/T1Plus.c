@@ -5,101 +5,190 @@
 
 extern DMA_HandleTypeDef hdma_usart2_rx;
 
-#define T1Plus_RX_BUFFER_MAXIMUM 24
+static uint8_t t1plus_rx_buf[T1PLUS_RX_BUF_SIZE];  // DMA循环缓冲区
+static uint16_t t1plus_rx_pos = 0;                  // 已消费到的位置
 
-bool T1Plus_flag_of_receive = 0;
-uint8_t t1plus_rx_buf[T1Plus_RX_BUFFER_MAXIMUM];
-uint8_t t1plus_rx_data[T1Plus_RX_BUFFER_MAXIMUM];
+/* 滑动窗口（只在接收中断中访问） */
+static uint8_t t1plus_win[T1PLUS_FRAME_SIZE];
+static uint8_t t1plus_win_len = 0;
+
+/* 单生产者（中断）/单消费者（主循环）帧队列 */
+static t1plus_frame t1plus_fifo[T1PLUS_FIFO_LEN];
+static volatile uint8_t t1plus_fifo_head = 0;       // 中断写
+static volatile uint8_t t1plus_fifo_tail = 0;       // 主循环读
 
 t1plus t1plus_data;
-t1plus_raw_data t1plus_data_raw;
+t1plus_stats t1plus_stat;
 
-/** 初始化T1Plus DMA接收（配置USART空闲中断，禁用半传输中断） */
-void T1Plus_init(void)
+/** 启动DMA循环接收（禁用半传输中断，空闲中断与传输完成中断足以覆盖全部字节） */
+static void T1Plus_start_dma(void)
 {
-    HAL_UARTEx_ReceiveToIdle_DMA(&T1Plus_HUART, t1plus_rx_buf, T1Plus_RX_BUFFER_MAXIMUM);
+    t1plus_rx_pos = 0;
+    t1plus_win_len = 0;
+    HAL_UARTEx_ReceiveToIdle_DMA(&T1Plus_HUART, t1plus_rx_buf, T1PLUS_RX_BUF_SIZE);
     __HAL_DMA_DISABLE_IT(&T1Plus_DMA_INSTANCE, DMA_IT_HT);
+}
+
+/** 初始化T1Plus DMA循环接收 */
+void T1Plus_init(void)
+{
     memset(t1plus_rx_buf, 0, sizeof(t1plus_rx_buf));
+    memset(&t1plus_stat, 0, sizeof(t1plus_stat));
+    t1plus_fifo_head = t1plus_fifo_tail = 0;
+    T1Plus_start_dma();
 }
 
-/** 解析T1Plus数据帧（校验帧头、帧尾、校验和，计算实际位移） */
-void T1Plus_data_parse(void)
+/** 窗口前移n字节 */
+static inline void win_drop(uint8_t n)
 {
-    // 计算校验和 (3-12字节异或)
-    uint8_t checksum = t1plus_rx_data[2]; // 第3字节
-    for(uint8_t i = 3; i < 12; i++) {      // 第4-12字节
-        checksum ^= t1plus_rx_data[i];
-    }
-    
-    // 检查帧头、帧长度、校验和和帧尾
-    if(t1plus_rx_data[0] == T1PLUS_FRAME_HEADER_1 && 
-       t1plus_rx_data[1] == T1PLUS_FRAME_LENGTH && 
-       checksum == t1plus_rx_data[12] && 
-       t1plus_rx_data[13] == T1PLUS_FRAME_TAIL)
-    {
-        // 保存原始数据
-        t1plus_data_raw.flow_x_integral_L = t1plus_rx_data[2];
-        t1plus_data_raw.flow_x_integral_H = t1plus_rx_data[3];
-        t1plus_data_raw.flow_y_integral_L = t1plus_rx_data[4];
-        t1plus_data_raw.flow_y_integral_H = t1plus_rx_data[5];
-        t1plus_data_raw.integration_timespan_L = t1plus_rx_data[6];
-        t1plus_data_raw.integration_timespan_H = t1plus_rx_data[7];
-        t1plus_data_raw.laser_distance_L = t1plus_rx_data[8];
-        t1plus_data_raw.laser_distance_H = t1plus_rx_data[9];
-        t1plus_data_raw.valid = t1plus_rx_data[10];
-        t1plus_data_raw.laser_confidence = t1plus_rx_data[11];
-        t1plus_data_raw.checksum = t1plus_rx_data[12];
-        
-        // 解析光流X累加位移 (radians*10000)
-        t1plus_data.flow_x_integral = (int16_t)((t1plus_data_raw.flow_x_integral_H << 8) | t1plus_data_raw.flow_x_integral_L);
-        
-        // 解析光流Y累加位移 (radians*10000)
-        t1plus_data.flow_y_integral = (int16_t)((t1plus_data_raw.flow_y_integral_H << 8) | t1plus_data_raw.flow_y_integral_L);
-        
-        // 解析累计时间 (us)
-        t1plus_data.integration_timespan = (uint16_t)((t1plus_data_raw.integration_timespan_H << 8) | t1plus_data_raw.integration_timespan_L);
-        
-        // 解析激光测距距离 (mm)
-        t1plus_data.laser_distance = (uint16_t)((t1plus_data_raw.laser_distance_H << 8) | t1plus_data_raw.laser_distance_L);
-        
-        // 解析状态值
-        t1plus_data.valid = t1plus_data_raw.valid;
-        
-        // 解析激光测距置信度
-        t1plus_data.laser_confidence = t1plus_data_raw.laser_confidence;
-        
-        // 计算实际位移 (mm) = flow_integral / 10000 * height (mm)
-        // 注意：这里的height需要从其他传感器获取，如气压计或TOF的高度数据
-        // 这里暂时使用激光测距的高度作为示例
-        t1plus_data.actual_flow_x = (float)t1plus_data.flow_x_integral / 10000.0f * (float)t1plus_data.laser_distance;
-        t1plus_data.actual_flow_y = (float)t1plus_data.flow_y_integral / 10000.0f * (float)t1plus_data.laser_distance;
+    t1plus_win_len -= n;
+    memmove(t1plus_win, &t1plus_win[n], t1plus_win_len);
+}
+
+/** 校验通过的整帧解码入队 */
+static void frame_emit(const uint8_t *f, uint32_t tick)
+{
+    uint8_t next = (t1plus_fifo_head + 1) % T1PLUS_FIFO_LEN;
+    if (next == t1plus_fifo_tail) {
+        t1plus_stat.overrun++;      // 主循环长时间未取，丢弃最新帧
+        return;
     }
+
+    t1plus_frame *fr = &t1plus_fifo[t1plus_fifo_head];
+    fr->flow_x_integral      = (int16_t)((f[3] << 8) | f[2]);   // radians*10000
+    fr->flow_y_integral      = (int16_t)((f[5] << 8) | f[4]);
+    fr->integration_timespan = (uint16_t)((f[7] << 8) | f[6]);  // us
+    fr->laser_distance       = (uint16_t)((f[9] << 8) | f[8]);  // mm
+    fr->valid                = f[10];
+    fr->laser_confidence     = f[11];
+    fr->tick                 = tick;
+
+    t1plus_fifo_head = next;
+    t1plus_stat.frame_ok++;
 }
 
-/** 数据解析（滑动窗口查找帧头，拷贝数据并调用解析） */
-void T1Plus_analysis_data(void)
+/**
+ * @brief  字节流解析：先校验后解码
+ * @note   窗口首字节不是帧头、第二字节不是长度、或整帧校验失败时只丢弃首字节，
+ *         从下一个字节继续匹配，坏帧内部或之后的好帧仍能被找到
+ */
+static void T1Plus_parse_byte(uint8_t byte, uint32_t tick)
 {
-	  if (!T1Plus_flag_of_receive) return;
-    T1Plus_flag_of_receive = 0;
-	
-    for(uint8_t i = 0; i < T1Plus_RX_BUFFER_MAXIMUM - 13; i++)
-    {
-        if(t1plus_rx_buf[i] == T1PLUS_FRAME_HEADER_1 && t1plus_rx_buf[i+1] == T1PLUS_FRAME_LENGTH)// 找到有效帧
-        {
-            memcpy(t1plus_rx_data, &t1plus_rx_buf[i], 14);
-            memset(t1plus_rx_buf, 0, sizeof(t1plus_rx_buf));
-            break;
+    t1plus_win[t1plus_win_len++] = byte;
+
+    while (t1plus_win_len > 0) {
+        if (t1plus_win[0] != T1PLUS_FRAME_HEADER_1) {
+            win_drop(1);
+            t1plus_stat.resync++;
+            continue;
+        }
+        if (t1plus_win_len >= 2 && t1plus_win[1] != T1PLUS_FRAME_LENGTH) {
+            win_drop(1);
+            t1plus_stat.resync++;
+            continue;
+        }
+        if (t1plus_win_len < T1PLUS_FRAME_SIZE) {
+            return;                 // 等待后续字节
+        }
+
+        // 校验和：第3~12字节异或
+        uint8_t checksum = t1plus_win[2];
+        for (uint8_t i = 3; i < 12; i++) {
+            checksum ^= t1plus_win[i];
+        }
+
+        if (checksum != t1plus_win[12]) {
+            t1plus_stat.checksum_err++;
+        } else if (t1plus_win[13] != T1PLUS_FRAME_TAIL) {
+            t1plus_stat.tail_err++;
+        } else {
+            frame_emit(t1plus_win, tick);
+            t1plus_win_len = 0;
+            return;
         }
+        win_drop(1);
+        t1plus_stat.resync++;
     }
-	
-	  T1Plus_data_parse();
-    
 }
 
-/** 串口接收完成回调（重启DMA接收，置位接收标志） */
-void T1Plus_receive_data(void)
+/**
+ * @brief  串口接收事件回调：消费 [t1plus_rx_pos, pos) 区间的新字节（可能跨越缓冲区末尾）
+ * @param  pos DMA写指针位置，传输完成中断时等于缓冲区长度
+ */
+void T1Plus_receive_data(uint16_t pos)
 {
-    HAL_UARTEx_ReceiveToIdle_DMA(&T1Plus_HUART, t1plus_rx_buf, T1Plus_RX_BUFFER_MAXIMUM);
-    __HAL_DMA_DISABLE_IT(&T1Plus_DMA_INSTANCE, DMA_IT_HT);
-		T1Plus_flag_of_receive = 1;
+    uint32_t tick = HAL_GetTick();
+
+    if (pos > T1PLUS_RX_BUF_SIZE) return;
+
+    while (t1plus_rx_pos != pos) {
+        T1Plus_parse_byte(t1plus_rx_buf[t1plus_rx_pos], tick);
+        t1plus_rx_pos++;
+        if (t1plus_rx_pos >= T1PLUS_RX_BUF_SIZE) {
+            t1plus_rx_pos = 0;
+            if (pos == T1PLUS_RX_BUF_SIZE) break;   // 刚好写满一圈
+        }
+    }
 }
+
+/**
+ * @brief  取出队列中的全部新帧更新 t1plus_data
+ * @note   一个控制周期内到达多帧时，有效帧（0xF5）的积分位移与积分时间累加，测距/状态取最新有效帧，
+ *         frame_count按有效帧数累加，光流速度计算不会因合并而丢失位移；
+ *         无效帧的积分不可信，只计入 invalid 统计，整批都无效时发布最新帧（valid≠0xF5，由光流模块丢弃）
+ */
+void T1Plus_analysis_data(void)
+{
+    // 串口错误（ORE/FE）时HAL会中止DMA接收，此处检测并重启
+    if (T1Plus_HUART.RxState == HAL_UART_STATE_READY) {
+        t1plus_stat.dma_restart++;
+        T1Plus_start_dma();
+    }
+
+    uint8_t tail = t1plus_fifo_tail;
+    if (tail == t1plus_fifo_head) return;
+
+    int32_t sum_x = 0, sum_y = 0;
+    uint32_t sum_span = 0;
+    uint8_t n = 0;
+    const t1plus_frame *last = NULL;
+    const t1plus_frame *newest = NULL;
+
+    while (tail != t1plus_fifo_head) {
+        newest = &t1plus_fifo[tail];
+        tail = (tail + 1) % T1PLUS_FIFO_LEN;
+        if (newest->valid != T1PLUS_VALID_DATA) {
+            t1plus_stat.invalid++;
+            continue;
+        }
+        last = newest;
+        sum_x += last->flow_x_integral;
+        sum_y += last->flow_y_integral;
+        sum_span += last->integration_timespan;
+        n++;
+    }
+    if (last == NULL) last = newest;    // 整批无效：发布最新帧的状态，位移为0
+
+    if (sum_x > INT16_MAX) sum_x = INT16_MAX;
+    if (sum_x < INT16_MIN) sum_x = INT16_MIN;
+    if (sum_y > INT16_MAX) sum_y = INT16_MAX;
+    if (sum_y < INT16_MIN) sum_y = INT16_MIN;
+    if (sum_span > UINT16_MAX) sum_span = UINT16_MAX;
+
+    t1plus_data.flow_x_integral = (int16_t)sum_x;
+    t1plus_data.flow_y_integral = (int16_t)sum_y;
+    t1plus_data.integration_timespan = (uint16_t)sum_span;
+    t1plus_data.laser_distance = last->laser_distance;
+    t1plus_data.valid = last->valid;
+    t1plus_data.laser_confidence = last->laser_confidence;
+    t1plus_data.timestamp = last->tick;
+
+    // 计算实际位移 (mm) = flow_integral / 10000 * height (mm)
+    t1plus_data.actual_flow_x = (float)t1plus_data.flow_x_integral / 10000.0f * (float)t1plus_data.laser_distance;
+    t1plus_data.actual_flow_y = (float)t1plus_data.flow_y_integral / 10000.0f * (float)t1plus_data.laser_distance;
+
+    if (n > 1) t1plus_stat.merged += n - 1;
+    t1plus_data.frame_count += n;
+
+    t1plus_fifo_tail = tail;        // 最后释放队列位置，中断才可覆盖
+}
\ No newline at end of file
@@ -1,10 +1,14 @@
 /**
  * @file       T1Plus.h
  * @author	   lsl-sys
- * @brief      T1Plus Optical Flow Sensor Driver Using USART DMA IDLE
- * @version    V2.0.0
- * @date       2026-01-11  2026-01-30
+ * @brief      T1Plus Optical Flow Sensor Driver Using USART Circular DMA + IDLE
+ * @version    V2.1.0
+ * @date       2026-01-11  2026-01-30  2026-02-23
  * @Encoding   UTF-8 
+ * @note       DMA循环接收，空闲中断中按DMA写指针增量喂入字节流状态机：
+ *             滑动窗口先校验（帧头/长度/校验和/帧尾）再解码，失败只丢弃1字节重新同步，
+ *             跨越空闲中断的帧与坏帧之后的好帧都不会丢失。
+ *             好帧带时间戳压入FIFO，主循环取出，多帧时合并积分位移。
  */
 #ifndef __T1PLUS_H
 #define __T1PLUS_H
@@ -15,6 +19,10 @@
 #define T1PLUS_FRAME_LENGTH    0x0A        // 数据包长度
 #define T1PLUS_FRAME_TAIL      0x55        // 帧尾
 #define T1PLUS_VALID_DATA      0xF5        // 有效数据标识
+#define T1PLUS_FRAME_SIZE      14          // 整帧字节数（帧头+长度+10字节数据+校验和+帧尾）
+
+#define T1PLUS_RX_BUF_SIZE     64          // DMA循环缓冲区（115200下约5.5ms，需大于空闲中断间隔内的字节数）
+#define T1PLUS_FIFO_LEN        4           // 已解码帧队列（50Hz帧率下可容忍主循环卡顿约80ms）
 
 /* 原始数据帧结构 */
 typedef struct {
@@ -31,6 +39,29 @@ typedef struct {
     uint8_t checksum;               // 校验和(字节2-11异或)
 } t1plus_raw_data;
 
+/* 单帧解码结果（中断中生成） */
+typedef struct {
+    int16_t flow_x_integral;
+    int16_t flow_y_integral;
+    uint16_t integration_timespan;
+    uint16_t laser_distance;
+    uint8_t valid;
+    uint8_t laser_confidence;
+    uint32_t tick;                  // 帧尾到达时刻 (ms)
+} t1plus_frame;
+
+/* 接收统计 */
+typedef struct {
+    uint32_t frame_ok;              // 校验通过帧数
+    uint32_t checksum_err;          // 校验和错误
+    uint32_t tail_err;              // 帧尾错误
+    uint32_t resync;                // 重新同步丢弃的字节数
+    uint32_t overrun;               // 帧队列满丢帧数
+    uint32_t merged;                // 同一周期合并的帧数（主循环处理不及时）
+    uint32_t invalid;               // 有效标志非0xF5的帧数（不参与位移累加）
+    uint32_t dma_restart;           // DMA接收中断（串口错误）后重启次数
+} t1plus_stats;
+
 /* 解析后数据结构 */
 typedef struct {
     int16_t flow_x_integral;        // X像素累计位移 (radians*10000)
@@ -41,17 +72,23 @@ typedef struct {
     uint8_t laser_confidence;       // 测距置信度
     float actual_flow_x;            // 实际X位移(mm) = integral/10000 * height
     float actual_flow_y;            // 实际Y位移(mm)
+    uint32_t timestamp;             // 最新帧接收时刻 (ms，帧尾到达时记录，约为积分窗口结束时刻)
+    uint32_t frame_count;           // 有效帧计数（用于判断是否有新帧，合并帧时按有效帧数累加）
 } t1plus;
 
-/** 初始化T1Plus串口DMA接收（开启空闲中断） */
+/** 初始化T1Plus串口DMA循环接收（开启空闲中断） */
 void T1Plus_init(void);
 
-/** 串口接收完成回调 */
-void T1Plus_receive_data(void);
+/**
+ * @brief  串口接收事件回调（空闲/传输完成）
+ * @param  pos DMA写指针在缓冲区中的位置（HAL回调的Size参数）
+ */
+void T1Plus_receive_data(uint16_t pos);
 
-/** 数据解析与处理 */
+/** 取出队列中的新帧更新 t1plus_data（主循环调用） */
 void T1Plus_analysis_data(void);
 
 extern t1plus t1plus_data;
+extern t1plus_stats t1plus_stat;
 
 #endif
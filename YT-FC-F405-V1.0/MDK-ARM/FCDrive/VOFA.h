@@ -17,7 +17,7 @@
 #define VOFA_TYPE_DOUBLE 2
 #define VOFA_TYPE_BOOL   3
 
-#define VOFA_MAX_VARS 20
+#define VOFA_MAX_VARS 48
 
 /* 变量类型 */
 typedef enum {
@@ -12,7 +12,7 @@ extern DMA_HandleTypeDef hdma_usart3_rx;
 #define TYPE_ANGLE          0x53
 #define TYPE_MAG            0x54
 
-#define BUF_SIZE            32
+#define BUF_SIZE            64          // 容纳加速度+角速度+角度+磁场4帧(44字节)
 
 /*小端模式合成 16 位有符号数*/
 #define INT16_FROM_BYTES(l, h) ((int16_t)((uint8_t)(h) << 8 | (uint8_t)(l)))
@@ -35,6 +35,18 @@ static uint8_t calc_checksum(const uint8_t *p)
     return sum;
 }
 
+/*解析加速度帧（0x51）*/
+static void parse_acc(const uint8_t *d)
+{
+    wt901c_data_raw.AxL = d[0]; wt901c_data_raw.AxH = d[1];
+    wt901c_data_raw.AyL = d[2]; wt901c_data_raw.AyH = d[3];
+    wt901c_data_raw.AzL = d[4]; wt901c_data_raw.AzH = d[5];
+    
+    wt901c_data.ax = INT16_FROM_BYTES(d[0], d[1]) / 32768.0f * 16.0f;
+    wt901c_data.ay = INT16_FROM_BYTES(d[2], d[3]) / 32768.0f * 16.0f;
+    wt901c_data.az = INT16_FROM_BYTES(d[4], d[5]) / 32768.0f * 16.0f;
+}
+
 /*解析角速度帧（0x52）*/
 static void parse_gyro(const uint8_t *d)
 {
@@ -106,8 +118,8 @@ void wt901c_analysis_data(void)
                 valid_frame_found = 1;
                 break;
             case TYPE_ACC:   
-                /* parse_acc(payload); */  
-                valid_frame_found = 1;  // 即使未解析也标记为收到数据
+                parse_acc(payload);  
+                valid_frame_found = 1;
                 break;
             case TYPE_MAG:   
                 /* parse_mag(payload); */  
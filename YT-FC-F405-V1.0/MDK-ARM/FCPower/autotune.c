@@ -0,0 +1,193 @@
+#include "autotune.h"
+
+AutoTune_t g_autotune;
+
+#define AT_DT           (1.0f / PID_LOOP_HZ)
+#define AT_MS_TO_TICK(ms) ((uint32_t)(ms) * PID_LOOP_HZ / 1000U)
+#define AT_PI           3.14159265f
+
+static inline float Absf(float x) { return x < 0.0f ? -x : x; }
+
+static inline float Clampf(float v, float min, float max) {
+    return (v < min) ? min : ((v > max) ? max : v);
+}
+
+/* 取当前轴对应的角速度环控制器 */
+static PIDController* AxisRatePID(PID_Axis_t axis)
+{
+    switch (axis) {
+        case AXIS_PITCH: return &g_pid.attitude.rate.pitch;
+        case AXIS_ROLL:  return &g_pid.attitude.rate.roll;
+        default:         return &g_pid.attitude.rate.yaw;
+    }
+}
+
+/* 将继电器输出写入当前轴 */
+static void AxisSetOutput(PID_Axis_t axis, float out)
+{
+    switch (axis) {
+        case AXIS_PITCH: g_pid.out.pitch = out; break;
+        case AXIS_ROLL:  g_pid.out.roll  = out; break;
+        default:         g_pid.out.yaw   = out; break;
+    }
+}
+
+/* 从axis开始查找下一个待整定轴，无则返回AXIS_COUNT */
+static PID_Axis_t NextAxis(uint8_t mask, int from)
+{
+    for (int a = from; a < AXIS_COUNT; a++) {
+        if (mask & (1u << a)) return (PID_Axis_t)a;
+    }
+    return AXIS_COUNT;
+}
+
+/* 进入某轴的稳定阶段 */
+static void BeginAxis(PID_Axis_t axis)
+{
+    g_autotune.axis = axis;
+    g_autotune.state = AT_SETTLE;
+    g_autotune.tick = 0;
+    g_autotune.relay = 1;
+    g_autotune.cycles = 0;
+    g_autotune.last_rise = 0;
+    g_autotune.peak_max = -1e6f;
+    g_autotune.peak_min = 1e6f;
+    g_autotune.amp_sum = 0.0f;
+    g_autotune.period_sum = 0.0f;
+    g_autotune.measured = 0;
+}
+
+/* 结束当前轴：清除继电器期间积累的积分，转入下一轴或完成 */
+static void FinishAxis(void)
+{
+    PID_Reset(AxisRatePID(g_autotune.axis));
+
+    PID_Axis_t next = NextAxis(g_autotune.axis_mask, g_autotune.axis + 1);
+    if (next < AXIS_COUNT) {
+        BeginAxis(next);
+    } else {
+        g_autotune.state = AT_DONE;
+    }
+}
+
+/**
+ * @brief  由极限环计算整定参数并写入
+ * @note   Ku = 4d/(pi*a)，Tyreus-Luyben：Kp=Ku/2.2, Ti=2.2Tu, Td=Tu/6.3
+ *         pid_core按周期累加积分、按周期差分，故 ki=Kp*dt/Ti，kd=Kp*Td/dt
+ * @return 1-参数有效已写入，0-测量无效
+ */
+static uint8_t ComputeAndApply(void)
+{
+    PID_Axis_t axis = g_autotune.axis;
+    float amp = g_autotune.amp_sum / g_autotune.measured;
+    float tu  = g_autotune.period_sum / g_autotune.measured;
+
+    if (amp < AT_MIN_AMPLITUDE || tu < AT_MIN_PERIOD_S || tu > AT_MAX_PERIOD_S) {
+        return 0;
+    }
+
+    float ku = 4.0f * AT_RELAY_AMP / (AT_PI * amp);
+    float kp = ku / 2.2f;
+    float ti = 2.2f * tu;
+    float td = tu / 6.3f;
+
+    pidParam_t param;
+    param.kp = Clampf(kp, 0.0f, AT_MAX_KP);
+    param.ki = Clampf(kp * AT_DT / ti, 0.0f, AT_MAX_KI);
+    param.kd = Clampf(kp * td / AT_DT, 0.0f, AT_MAX_KD);
+    param.iSepThresh = AxisRatePID(axis)->iSepThresh;
+
+    g_autotune.ku[axis] = ku;
+    g_autotune.tu[axis] = tu;
+    g_autotune.result[axis] = param;
+    PID_SetRateParam(axis, &param);
+    return 1;
+}
+
+void AutoTune_Start(uint8_t axis_mask)
+{
+    PID_Axis_t first = NextAxis(axis_mask, 0);
+    if (first >= AXIS_COUNT) return;
+
+    g_autotune.axis_mask = axis_mask;
+    BeginAxis(first);
+}
+
+void AutoTune_Abort(void)
+{
+    if (AutoTune_IsActive()) {
+        PID_Reset(AxisRatePID(g_autotune.axis));
+        g_autotune.state = AT_FAILED;
+    }
+}
+
+uint8_t AutoTune_IsActive(void)
+{
+    return (g_autotune.state == AT_SETTLE || g_autotune.state == AT_RELAY);
+}
+
+void AutoTune_Update(float gyro_x, float gyro_y, float gyro_z, float meas_pitch, float meas_roll)
+{
+    if (!AutoTune_IsActive()) return;
+
+    /* 安全：倾角超限立即中止，交还自稳 */
+    if (Absf(meas_pitch) > AT_MAX_ANGLE || Absf(meas_roll) > AT_MAX_ANGLE) {
+        AutoTune_Abort();
+        return;
+    }
+
+    AutoTune_t *at = &g_autotune;
+    float gyro = (at->axis == AXIS_PITCH) ? gyro_x : ((at->axis == AXIS_ROLL) ? gyro_y : gyro_z);
+    at->tick++;
+
+    /* 稳定阶段：保持自稳输出，等待姿态平稳 */
+    if (at->state == AT_SETTLE) {
+        if (at->tick >= AT_MS_TO_TICK(AT_SETTLE_MS)) {
+            at->state = AT_RELAY;
+            at->tick = 0;
+            at->center = AxisRatePID(at->axis)->desired;
+            at->relay = (gyro > at->center) ? -1 : 1;
+        }
+        return;
+    }
+
+    /* 继电器阶段：以锁存的目标角速度为中心做滞环继电器。
+     * 自稳下外环目标随振荡姿态变化，若跟随它测到的是角度+角速度串级的极限环，而非角速度对象 */
+    float error = at->center - gyro;
+
+    if (gyro > at->peak_max) at->peak_max = gyro;
+    if (gyro < at->peak_min) at->peak_min = gyro;
+
+    if (at->relay > 0 && error < -AT_RELAY_HYST) {
+        at->relay = -1;
+    } else if (at->relay < 0 && error > AT_RELAY_HYST) {
+        at->relay = 1;
+
+        /* 正向切换视为一个周期结束 */
+        if (at->cycles > AT_SKIP_CYCLES) {
+            at->amp_sum += 0.5f * (at->peak_max - at->peak_min);
+            at->period_sum += (at->tick - at->last_rise) * AT_DT;
+            at->measured++;
+        }
+        at->cycles++;
+        at->last_rise = at->tick;
+        at->peak_max = -1e6f;
+        at->peak_min = 1e6f;
+
+        if (at->measured >= AT_MEASURE_CYCLES) {
+            if (ComputeAndApply()) {
+                FinishAxis();
+            } else {
+                AutoTune_Abort();
+            }
+            return;
+        }
+    }
+
+    if (at->tick >= AT_MS_TO_TICK(AT_AXIS_TIMEOUT_MS)) {
+        AutoTune_Abort();
+        return;
+    }
+
+    AxisSetOutput(at->axis, at->relay * AT_RELAY_AMP);
+}
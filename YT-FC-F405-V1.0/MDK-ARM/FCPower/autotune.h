@@ -0,0 +1,89 @@
+/**
+ * @file       autotune.h
+ * @author     lsl-sys
+ * @brief      Relay-feedback Rate-loop PID Autotuner (Astrom-Hagglund Limit Cycle)
+ * @version    V1.0.0
+ * @date       2026-02-22
+ * @Encoding   UTF-8
+ * @note       逐轴注入继电器振荡：测量陀螺仪极限环幅值/周期 → 临界增益Ku/临界周期Tu
+ *             → Tyreus-Luyben整定 → PID_SetRateParam写入。纯算法实现，不依赖外设，
+ *             可直接链接到主机四旋翼模型中做闭环验证。
+ */
+
+#ifndef __AUTOTUNE_H
+#define __AUTOTUNE_H
+
+#include "main.h"
+#include "pid_control.h"
+
+/* 继电器参数 */
+#define AT_RELAY_AMP            8.0f    // 继电器输出幅值（力矩量，与角速度环输出同单位）
+#define AT_RELAY_HYST           5.0f    // 继电器滞环(°/s)，防止陀螺噪声误切换
+
+/* 流程参数 */
+#define AT_SETTLE_MS            500     // 每轴开始前稳定时间
+#define AT_SKIP_CYCLES          2       // 丢弃前N个振荡周期（过渡过程）
+#define AT_MEASURE_CYCLES       4       // 参与平均的振荡周期数
+#define AT_AXIS_TIMEOUT_MS      8000    // 单轴超时（未形成稳定极限环则失败）
+
+/* 安全与有效性 */
+#define AT_MAX_ANGLE            25.0f   // 振荡过程中倾角超限立即中止
+#define AT_MIN_AMPLITUDE        10.0f   // 极限环幅值下限(°/s)，过小说明继电器幅值不足
+#define AT_MIN_PERIOD_S         0.04f   // 周期下限（4个控制周期）
+#define AT_MAX_PERIOD_S         2.0f    // 周期上限
+
+/* 整定结果限幅（离散增益，防止异常测量写入危险参数） */
+#define AT_MAX_KP               3.0f
+#define AT_MAX_KI               0.2f
+#define AT_MAX_KD               5.0f
+
+/* 轴掩码 */
+#define AT_AXIS_PITCH           (1u << AXIS_PITCH)
+#define AT_AXIS_ROLL            (1u << AXIS_ROLL)
+#define AT_AXIS_YAW             (1u << AXIS_YAW)
+
+typedef enum {
+    AT_IDLE = 0,    // 未运行
+    AT_SETTLE,      // 当前轴稳定等待
+    AT_RELAY,       // 继电器振荡与测量
+    AT_DONE,        // 全部轴完成，参数已写入
+    AT_FAILED       // 中止（倾角超限/超时/测量无效），原参数保持不变
+} AutoTuneState_t;
+
+typedef struct {
+    AutoTuneState_t state;
+    uint8_t axis_mask;          // 待整定轴
+    PID_Axis_t axis;            // 当前轴
+
+    uint32_t tick;              // 当前阶段已运行的控制周期数
+    int8_t relay;               // 继电器方向 +1/-1
+    float center;               // 继电器中心：进入RELAY时锁存的目标角速度（振荡期间不随外环变化）
+    uint16_t cycles;            // 已完成振荡周期数（以正向切换计）
+    uint32_t last_rise;         // 上次正向切换时刻（周期数）
+    float peak_max, peak_min;   // 当前周期陀螺极值
+    float amp_sum, period_sum;  // 测量累计
+    uint8_t measured;           // 已累计周期数
+
+    float ku[AXIS_COUNT];       // 临界增益（力矩/(°/s)）
+    float tu[AXIS_COUNT];       // 临界周期(s)
+    pidParam_t result[AXIS_COUNT]; // 整定结果（离散增益，与pid_core一致）
+} AutoTune_t;
+
+/** 启动自整定（axis_mask：AT_AXIS_PITCH | AT_AXIS_ROLL ...），需在已解锁悬停时调用 */
+void AutoTune_Start(uint8_t axis_mask);
+
+/** 中止自整定（已完成的轴保留新参数，当前轴不写入） */
+void AutoTune_Abort(void);
+
+/** 是否正在运行（SETTLE/RELAY） */
+uint8_t AutoTune_IsActive(void);
+
+/**
+ * @brief  控制周期调用（在PID_UpdateAttitude之后、混控之前）
+ * @note   RELAY阶段用继电器输出覆盖g_pid.out中当前轴的力矩，其余轴保持自稳
+ */
+void AutoTune_Update(float gyro_x, float gyro_y, float gyro_z, float meas_pitch, float meas_roll);
+
+extern AutoTune_t g_autotune;
+
+#endif
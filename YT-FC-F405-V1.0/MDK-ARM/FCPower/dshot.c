@@ -0,0 +1,455 @@
+#include "dshot.h"
+#include "tim.h"
+
+DShot_t g_dshot;
+
+static DShotGroup_t g_group[DSHOT_MAX_TIMERS];
+static uint8_t g_group_count = 0;
+
+#if DSHOT_BIDIR
+/* 回传采样：TIM1更新事件 → DMA2_Stream5(CH6) 读取电机端口IDR */
+static DMA_HandleTypeDef g_rx_dma;
+static uint16_t g_rx_buf[DSHOT_RX_SAMPLES_MAX];
+static GPIO_TypeDef *g_rx_port;
+static uint16_t g_rx_pin[MOTOR_COUNT];
+static uint32_t g_moder_mask;       // 电机引脚MODER位
+static uint32_t g_moder_af;         // 复用功能模式（10b）
+#endif
+
+/* 定时器更新事件对应的DMA流/通道/中断（STM32F405 DMA1请求映射） */
+static uint8_t DmaLookup(const TIM_TypeDef *tim, DMA_Stream_TypeDef **stream, uint32_t *channel, IRQn_Type *irq) {
+    if (tim == TIM2) { *stream = DMA1_Stream7; *channel = DMA_CHANNEL_3; *irq = DMA1_Stream7_IRQn; return 0; }   // Stream1被USART3_RX占用
+    if (tim == TIM4) { *stream = DMA1_Stream6; *channel = DMA_CHANNEL_2; *irq = DMA1_Stream6_IRQn; return 0; }
+    if (tim == TIM3) { *stream = DMA1_Stream2; *channel = DMA_CHANNEL_5; *irq = DMA1_Stream2_IRQn; return 0; }
+    return 1;
+}
+
+/* 命令重复次数与发完后的停转保持时间 */
+static void CommandProfile(uint8_t cmd, uint8_t *repeat, uint16_t *hold_ms) {
+    if (cmd >= DSHOT_CMD_BEEP1 && cmd <= DSHOT_CMD_BEEP5) {
+        *repeat = 1;
+        *hold_ms = 260;     // 蜂鸣期间ESC不响应新命令
+    } else if (cmd == DSHOT_CMD_ESC_INFO) {
+        *repeat = 1;
+        *hold_ms = 12;
+    } else if (cmd == DSHOT_CMD_SAVE_SETTINGS) {
+        *repeat = 10;
+        *hold_ms = 100;     // 等待ESC写Flash
+    } else {
+        *repeat = 10;       // 设置类命令需连续收到多帧才执行
+        *hold_ms = 40;
+    }
+}
+
+/* 定时器计数时钟：APB1分频不为1时定时器时钟为PCLK1的2倍 */
+static uint32_t TimerClock(void) {
+    uint32_t pclk = HAL_RCC_GetPCLK1Freq();
+    return (HAL_RCC_GetHCLKFreq() == pclk) ? pclk : pclk * 2U;
+}
+
+uint16_t DShot_EncodeFrame(uint16_t value, uint8_t telemetry) {
+    uint16_t packet = (uint16_t)(((value & 0x07FFu) << 1) | (telemetry ? 1u : 0u));
+    uint16_t crc = (packet ^ (packet >> 4) ^ (packet >> 8)) & 0x0Fu;
+#if DSHOT_BIDIR
+    crc = (~crc) & 0x0Fu;       // CRC取反：ESC据此识别双向模式并回传eRPM
+#endif
+    return (uint16_t)((packet << 4) | crc);
+}
+
+/* GCR 5位→4位（无效码为 GCR_INVALID：按0解码时落在0半字节上的无效码CRC无法发现） */
+#define GCR_INVALID 0xFFu
+static const uint8_t gcr_decode[32] = {
+    GCR_INVALID, GCR_INVALID, GCR_INVALID, GCR_INVALID, GCR_INVALID, GCR_INVALID, GCR_INVALID, GCR_INVALID,
+    GCR_INVALID, 9, 10, 11, GCR_INVALID, 13, 14, 15,
+    GCR_INVALID, GCR_INVALID, 2, 3, GCR_INVALID, 5, 6, 7,
+    GCR_INVALID, 0, 8, 1, GCR_INVALID, 4, 12, GCR_INVALID,
+};
+
+uint32_t DShot_DecodeEdges(const uint16_t *edge, uint8_t count, uint16_t ticks_per_bit) {
+    if (count == 0) return DSHOT_TELEM_INVALID;
+
+    /* 线路编码：每个1对应一次电平翻转，两次翻转之间的位数 = 间隔/位宽（四舍五入） */
+    uint32_t value = 0;
+    uint32_t bits = 0;
+    for (uint8_t i = 1; i <= count; i++) {
+        uint32_t len;
+        if (bits >= DSHOT_GCR_BITS) break;  // 之后的边沿为帧尾释放（回到空闲高电平）
+        if (i < count) {
+            len = ((uint32_t)(uint16_t)(edge[i] - edge[i - 1]) + ticks_per_bit / 2U) / ticks_per_bit;
+            if (len == 0) return DSHOT_TELEM_INVALID;
+        } else {
+            len = DSHOT_GCR_BITS - bits;    // 最后一段为高电平，延续到帧尾
+        }
+        if (bits + len > DSHOT_GCR_BITS) return DSHOT_TELEM_INVALID;
+        value = (value << len) | (1u << (len - 1U));
+        bits += len;
+    }
+    if (bits != DSHOT_GCR_BITS) return DSHOT_TELEM_INVALID;
+
+    uint8_t n0 = gcr_decode[value & 0x1Fu];
+    uint8_t n1 = gcr_decode[(value >> 5) & 0x1Fu];
+    uint8_t n2 = gcr_decode[(value >> 10) & 0x1Fu];
+    uint8_t n3 = gcr_decode[(value >> 15) & 0x1Fu];
+    if ((n0 | n1 | n2 | n3) & 0xF0u) return DSHOT_TELEM_INVALID;
+    uint32_t decoded = n0 | (uint32_t)n1 << 4 | (uint32_t)n2 << 8 | (uint32_t)n3 << 12;
+
+    /* 四个半字节异或 = 0xF（回传CRC为取反形式） */
+    uint32_t csum = decoded ^ (decoded >> 8);
+    csum ^= csum >> 4;
+    if ((csum & 0x0Fu) != 0x0Fu) return DSHOT_TELEM_INVALID;
+    return decoded >> 4;
+}
+
+uint32_t DShot_DecodeSamples(const uint16_t *samples, uint16_t n, uint16_t pin) {
+    uint16_t edge[DSHOT_GCR_BITS + 1];
+    uint8_t count = 0;
+    uint16_t i = 0;
+
+    /* 空闲为高（上拉），第一个低电平采样即起始沿 */
+    while (i < n && (samples[i] & pin)) i++;
+    if (i >= n) return DSHOT_TELEM_NONE;
+
+    uint16_t level = 0;
+    edge[count++] = i;
+    for (i++; i < n && count < DSHOT_GCR_BITS + 1; i++) {
+        uint16_t b = samples[i] & pin;
+        if ((b != 0) != (level != 0)) {
+            edge[count++] = i;
+            level = b;
+        }
+    }
+    return DShot_DecodeEdges(edge, count, DSHOT_TELEM_OVERSAMPLE);
+}
+
+uint32_t DShot_ValueToERPM(uint32_t value) {
+    if (value == 0x0FFFu) return 0;     // 停转
+    uint32_t period_us = (value & 0x01FFu) << (value >> 9);
+    if (period_us == 0) return 0;
+    return (60000000u + period_us / 2U) / period_us;
+}
+
+uint16_t DShot_SpeedToValue(float speed) {
+    if (speed <= 0.0f) return 0;
+    float v = DSHOT_THROTTLE_MIN + speed / 100.0f * (DSHOT_THROTTLE_MAX - DSHOT_THROTTLE_MIN) + 0.5f;
+    return (v >= DSHOT_THROTTLE_MAX) ? DSHOT_THROTTLE_MAX : (uint16_t)v;
+}
+
+/* 找到或新建定时器对应的电机组 */
+static int8_t GroupOf(TIM_HandleTypeDef *htim) {
+    for (uint8_t i = 0; i < g_group_count; i++) {
+        if (g_group[i].htim == htim) return (int8_t)i;
+    }
+    if (g_group_count >= DSHOT_MAX_TIMERS) return -1;
+    g_group[g_group_count].htim = htim;
+    g_group[g_group_count].first_ch = DSHOT_MAX_CHANNELS;
+    g_group[g_group_count].burst = 0;
+    return (int8_t)g_group_count++;
+}
+
+/* 定时器改为位速率，配置更新事件DMA突发写CCR */
+static uint8_t GroupSetup(DShotGroup_t *g) {
+    TIM_HandleTypeDef *htim = g->htim;
+    DMA_Stream_TypeDef *stream;
+    uint32_t channel;
+    IRQn_Type irq;
+
+    if (DmaLookup(htim->Instance, &stream, &channel, &irq)) return 1;
+
+    __HAL_TIM_DISABLE_DMA(htim, TIM_DMA_UPDATE);
+    htim->Instance->CR1 &= ~TIM_CR1_CEN;    // __HAL_TIM_DISABLE在通道已使能时不生效
+    __HAL_TIM_SET_PRESCALER(htim, 0);
+    __HAL_TIM_SET_AUTORELOAD(htim, g_dshot.bit_ticks - 1U);
+    htim->Instance->CR1 |= TIM_CR1_ARPE;
+    for (uint8_t c = 0; c < g->burst; c++) {
+        uint32_t ch = (uint32_t)(g->first_ch + c) << 2;    // TIM_CHANNEL_x = 序号*4
+        __HAL_TIM_ENABLE_OCxPRELOAD(htim, ch);
+        __HAL_TIM_SET_COMPARE(htim, ch, 0);
+#if DSHOT_BIDIR
+        htim->Instance->CCER |= (TIM_CCER_CC1P << ch);  // 输出反相：空闲为高，每位为低脉冲
+#endif
+    }
+    htim->Instance->EGR = TIM_EGR_UG;   // 立即装载预分频与重装载值
+    __HAL_TIM_SET_COUNTER(htim, 0);
+
+    g->hdma.Instance = stream;
+    g->hdma.Init.Channel = channel;
+    g->hdma.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    g->hdma.Init.PeriphInc = DMA_PINC_DISABLE;
+    g->hdma.Init.MemInc = DMA_MINC_ENABLE;
+    g->hdma.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    g->hdma.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+    g->hdma.Init.Mode = DMA_NORMAL;
+    g->hdma.Init.Priority = DMA_PRIORITY_HIGH;
+    g->hdma.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    if (HAL_DMA_Init(&g->hdma) != HAL_OK) return 1;
+    __HAL_LINKDMA(htim, hdma[TIM_DMA_ID_UPDATE], g->hdma);
+
+    stream->PAR = (uint32_t)&htim->Instance->DMAR;
+    stream->M0AR = (uint32_t)g->buf;
+#if DSHOT_BIDIR
+    /* 发完即切换接收：ESC约30us后回传，需最高优先级 */
+    __HAL_DMA_ENABLE_IT(&g->hdma, DMA_IT_TC);
+    HAL_NVIC_SetPriority(irq, 0, 0);
+    HAL_NVIC_EnableIRQ(irq);
+#else
+    (void)irq;
+#endif
+
+    /* DMAR突发：每个更新事件从first_ch的CCR起连续写burst个寄存器 */
+    htim->Instance->DCR = (TIM_DMABASE_CCR1 + g->first_ch) | ((uint32_t)(g->burst - 1U) << TIM_DCR_DBL_Pos);
+    __HAL_TIM_ENABLE_DMA(htim, TIM_DMA_UPDATE);
+    htim->Instance->CR1 |= TIM_CR1_CEN;
+    return 0;
+}
+
+#if DSHOT_BIDIR
+/* APB2定时器时钟（TIM1） */
+static uint32_t TimerClockAPB2(void) {
+    uint32_t pclk = HAL_RCC_GetPCLK2Freq();
+    return (HAL_RCC_GetHCLKFreq() == pclk) ? pclk : pclk * 2U;
+}
+
+/* 回传接收：引脚上拉、TIM1采样时钟与DMA2采样通道 */
+static uint8_t RxSetup(const MotorHandle_t motors[MOTOR_COUNT], uint32_t bitrate) {
+    g_rx_port = motors[0].port;
+    g_moder_mask = 0;
+    g_moder_af = 0;
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        if (motors[i].port != g_rx_port) return 1;     // 一次DMA只能采一个端口
+        g_rx_pin[i] = motors[i].pin;
+        for (uint32_t b = 0; b < 16; b++) {
+            if (motors[i].pin & (1u << b)) {
+                g_moder_mask |= 3u << (b * 2U);
+                g_moder_af   |= 2u << (b * 2U);
+                MODIFY_REG(g_rx_port->PUPDR, 3u << (b * 2U), 1u << (b * 2U));   // 上拉：输入期间空闲为高
+            }
+        }
+    }
+
+    uint32_t telem_rate = bitrate * 5U / 4U;
+    uint32_t sample_rate = telem_rate * DSHOT_TELEM_OVERSAMPLE;
+    uint32_t turnaround_bits = (DSHOT_TELEM_TURNAROUND_US * telem_rate + 999999U) / 1000000U;
+    uint32_t len = DSHOT_TELEM_OVERSAMPLE * (DSHOT_GCR_BITS + turnaround_bits + DSHOT_TELEM_MARGIN_BITS);
+    g_dshot.rx_len = (uint16_t)((len > DSHOT_RX_SAMPLES_MAX) ? DSHOT_RX_SAMPLES_MAX : len);
+
+    TIM_HandleTypeDef *htim = &htim1;
+    htim->Instance->CR1 &= ~TIM_CR1_CEN;
+    __HAL_TIM_SET_PRESCALER(htim, 0);
+    __HAL_TIM_SET_AUTORELOAD(htim, (TimerClockAPB2() + sample_rate / 2U) / sample_rate - 1U);
+    htim->Instance->CR1 |= TIM_CR1_ARPE;
+    htim->Instance->EGR = TIM_EGR_UG;
+    __HAL_TIM_ENABLE_DMA(htim, TIM_DMA_UPDATE);
+
+    g_rx_dma.Instance = DMA2_Stream5;
+    g_rx_dma.Init.Channel = DMA_CHANNEL_6;
+    g_rx_dma.Init.Direction = DMA_PERIPH_TO_MEMORY;
+    g_rx_dma.Init.PeriphInc = DMA_PINC_DISABLE;
+    g_rx_dma.Init.MemInc = DMA_MINC_ENABLE;
+    g_rx_dma.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    g_rx_dma.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+    g_rx_dma.Init.Mode = DMA_NORMAL;
+    g_rx_dma.Init.Priority = DMA_PRIORITY_VERY_HIGH;
+    g_rx_dma.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    if (HAL_DMA_Init(&g_rx_dma) != HAL_OK) return 1;
+    g_rx_dma.Instance->PAR = (uint32_t)&g_rx_port->IDR;
+    g_rx_dma.Instance->M0AR = (uint32_t)g_rx_buf;
+    return 0;
+}
+
+/* 停止采样并解码上一帧的回传，更新各电机转速估计 */
+static void RxProcess(void) {
+    htim1.Instance->CR1 &= ~TIM_CR1_CEN;
+    if (!g_dshot.rx_armed) return;
+    g_dshot.rx_armed = 0;
+
+    uint16_t n = (uint16_t)(g_dshot.rx_len - __HAL_DMA_GET_COUNTER(&g_rx_dma));
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        uint32_t v = DShot_DecodeSamples(g_rx_buf, n, g_rx_pin[i]);
+        if (v == DSHOT_TELEM_NONE || v == DSHOT_TELEM_INVALID) {
+            if (v == DSHOT_TELEM_NONE) g_dshot.rx_none[i]++;
+            else                       g_dshot.rx_err[i]++;
+            if (g_dshot.rpm_age[i] < 0xFF) g_dshot.rpm_age[i]++;
+            continue;
+        }
+        g_dshot.erpm[i] = DShot_ValueToERPM(v);
+        float hz = (float)g_dshot.erpm[i] / (60.0f * (DSHOT_MOTOR_POLES / 2));
+        if (g_dshot.rpm_age[i] >= DSHOT_RPM_TIMEOUT) {
+            g_dshot.motor_hz[i] = hz;       // 重新获得回传：直接采用
+        } else {
+            g_dshot.motor_hz[i] += DSHOT_RPM_LPF_ALPHA * (hz - g_dshot.motor_hz[i]);
+        }
+        g_dshot.rpm_age[i] = 0;
+        g_dshot.rx_ok[i]++;
+    }
+}
+
+/* 引脚切回定时器输出（CCR=0，反相输出为空闲高电平） */
+static inline void PinsToOutput(void) {
+    g_rx_port->MODER |= g_moder_af;
+}
+#endif
+
+void DShot_TxDoneIRQHandler(void) {
+#if DSHOT_BIDIR
+    for (uint8_t gi = 0; gi < g_group_count; gi++) {
+        DMA_HandleTypeDef *h = &g_group[gi].hdma;
+        if (__HAL_DMA_GET_FLAG(h, __HAL_DMA_GET_TC_FLAG_INDEX(h))) {
+            __HAL_DMA_CLEAR_FLAG(h, __HAL_DMA_GET_TC_FLAG_INDEX(h) | __HAL_DMA_GET_HT_FLAG_INDEX(h));
+            if (g_dshot.tx_pending) g_dshot.tx_pending--;
+        }
+    }
+    if (g_dshot.tx_pending || g_dshot.rx_armed) return;
+
+    /* 全部电机发完：引脚切为输入，启动采样 */
+    g_rx_port->MODER &= ~g_moder_mask;
+    DMA_HandleTypeDef *h = &g_rx_dma;
+    __HAL_DMA_CLEAR_FLAG(h, __HAL_DMA_GET_TC_FLAG_INDEX(h) | __HAL_DMA_GET_HT_FLAG_INDEX(h) |
+                            __HAL_DMA_GET_TE_FLAG_INDEX(h) | __HAL_DMA_GET_FE_FLAG_INDEX(h) |
+                            __HAL_DMA_GET_DME_FLAG_INDEX(h));
+    h->Instance->NDTR = g_dshot.rx_len;
+    __HAL_DMA_ENABLE(h);
+    htim1.Instance->CNT = 0;
+    htim1.Instance->CR1 |= TIM_CR1_CEN;
+    g_dshot.rx_armed = 1;
+#endif
+}
+
+uint8_t DShot_GetMotorHz(MotorID_t id, float *hz) {
+    if (id >= MOTOR_COUNT || g_dshot.rx_ok[id] == 0 || g_dshot.rpm_age[id] >= DSHOT_RPM_TIMEOUT) return 0;
+    *hz = g_dshot.motor_hz[id];
+    return 1;
+}
+
+uint8_t DShot_Init(const MotorHandle_t motors[MOTOR_COUNT], uint32_t bitrate) {
+    memset(&g_dshot, 0, sizeof(g_dshot));
+    memset(g_group, 0, sizeof(g_group));
+    g_group_count = 0;
+
+    g_dshot.bit_ticks = (uint16_t)((TimerClock() + bitrate / 2U) / bitrate);
+    g_dshot.t1h_ticks = (uint16_t)(g_dshot.bit_ticks * DSHOT_T1H_NUM / DSHOT_T1H_DEN);
+    g_dshot.t0h_ticks = (uint16_t)(g_dshot.bit_ticks * DSHOT_T0H_NUM / DSHOT_T0H_DEN);
+
+    /* 按定时器分组，突发覆盖组内最小到最大通道 */
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        int8_t gi = GroupOf(motors[i].htim);
+        if (gi < 0) return 1;
+        DShotGroup_t *g = &g_group[gi];
+        uint8_t ch = (uint8_t)(motors[i].channel >> 2);
+        uint8_t last = (g->burst == 0) ? ch : (uint8_t)(g->first_ch + g->burst - 1U);
+        if (ch < g->first_ch) g->first_ch = ch;
+        if (ch > last) last = ch;
+        g->burst = (uint8_t)(last - g->first_ch + 1U);
+        g_dshot.group[i] = (uint8_t)gi;
+    }
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        g_dshot.slot[i] = (uint8_t)((motors[i].channel >> 2) - g_group[g_dshot.group[i]].first_ch);
+    }
+
+#if DSHOT_BIDIR
+    if (RxSetup(motors, bitrate)) return 1;
+#endif
+    for (uint8_t gi = 0; gi < g_group_count; gi++) {
+        if (GroupSetup(&g_group[gi])) return 1;
+    }
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        g_dshot.rpm_age[i] = DSHOT_RPM_TIMEOUT;
+    }
+    g_dshot.ready = 1;
+    return 0;
+}
+
+void DShot_Write(MotorID_t id, uint16_t value) {
+    if (id >= MOTOR_COUNT) return;
+    g_dshot.value[id] = (value > DSHOT_THROTTLE_MAX) ? DSHOT_THROTTLE_MAX : value;
+}
+
+/* 把一帧写入缓冲中该电机的列（帧尾间隔位保持为0） */
+static void FillSlot(DShotGroup_t *g, uint8_t slot, uint16_t frame) {
+    uint32_t *p = &g->buf[slot];
+    for (int b = 0; b < DSHOT_FRAME_BITS; b++) {
+        *p = (frame & 0x8000u) ? g_dshot.t1h_ticks : g_dshot.t0h_ticks;
+        p += g->burst;
+        frame <<= 1;
+    }
+}
+
+/* 重启电机组DMA：上一帧早已发完（帧长约27~53us），正常情况下流已自动关闭 */
+static void GroupStart(DShotGroup_t *g) {
+    DMA_HandleTypeDef *h = &g->hdma;
+
+    if (h->Instance->CR & DMA_SxCR_EN) {
+        g_dshot.dma_busy++;
+        __HAL_DMA_DISABLE(h);
+        while (h->Instance->CR & DMA_SxCR_EN) {}
+    }
+    __HAL_DMA_CLEAR_FLAG(h, __HAL_DMA_GET_TC_FLAG_INDEX(h) | __HAL_DMA_GET_HT_FLAG_INDEX(h) |
+                            __HAL_DMA_GET_TE_FLAG_INDEX(h) | __HAL_DMA_GET_FE_FLAG_INDEX(h) |
+                            __HAL_DMA_GET_DME_FLAG_INDEX(h));
+    h->Instance->NDTR = (uint32_t)DSHOT_FRAME_SLOTS * g->burst;
+    __HAL_DMA_ENABLE(h);
+}
+
+void DShot_Update(void) {
+    if (!g_dshot.ready) return;
+
+#if DSHOT_BIDIR
+    RxProcess();        // 上一帧回传早已收完（控制周期远大于帧+回传时长）
+    PinsToOutput();
+#endif
+
+    uint16_t value[MOTOR_COUNT];
+    uint8_t cmd_mask = 0;
+    uint8_t stopped = 1;
+
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        value[i] = g_dshot.value[i];
+        if (value[i] != 0) stopped = 0;
+    }
+
+    /* 命令只在全部电机停转时发出，电机转动期间保留在队列中 */
+    uint32_t now = HAL_GetTick();
+    if (stopped && g_dshot.q_head != g_dshot.q_tail && (int32_t)(now - g_dshot.cmd_hold_until) >= 0) {
+        uint8_t cmd = g_dshot.queue[g_dshot.q_head].cmd;
+        uint8_t repeat;
+        uint16_t hold_ms;
+        CommandProfile(cmd, &repeat, &hold_ms);
+        if (g_dshot.cmd_repeat == 0) g_dshot.cmd_repeat = repeat;
+
+        cmd_mask = g_dshot.queue[g_dshot.q_head].mask;
+        for (int i = 0; i < MOTOR_COUNT; i++) {
+            if (cmd_mask & (1u << i)) value[i] = cmd;
+        }
+        if (--g_dshot.cmd_repeat == 0) {
+            g_dshot.q_head = (uint8_t)((g_dshot.q_head + 1U) % DSHOT_CMD_QUEUE_LEN);
+            g_dshot.cmd_hold_until = now + hold_ms;
+        }
+    }
+
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        uint8_t telemetry = (cmd_mask >> i) & 1u;   // 命令帧需置遥测位
+        FillSlot(&g_group[g_dshot.group[i]], g_dshot.slot[i], DShot_EncodeFrame(value[i], telemetry));
+    }
+    __disable_irq();    // 重启DMA时清除的完成标志不能被发送完成中断计入
+    g_dshot.tx_pending = g_group_count;
+    for (uint8_t gi = 0; gi < g_group_count; gi++) {
+        GroupStart(&g_group[gi]);
+    }
+    __enable_irq();
+    g_dshot.frames++;
+}
+
+uint8_t DShot_QueueCommand(uint8_t motor_mask, DShotCommand_t cmd) {
+    uint8_t next = (uint8_t)((g_dshot.q_tail + 1U) % DSHOT_CMD_QUEUE_LEN);
+    if (cmd == DSHOT_CMD_MOTOR_STOP || cmd > DSHOT_CMD_MAX || motor_mask == 0) return 1;
+    if (next == g_dshot.q_head) return 1;
+
+    g_dshot.queue[g_dshot.q_tail].mask = motor_mask & ((1u << MOTOR_COUNT) - 1u);
+    g_dshot.queue[g_dshot.q_tail].cmd = (uint8_t)cmd;
+    g_dshot.q_tail = next;
+    return 0;
+}
+
+uint8_t DShot_CommandIdle(void) {
+    return (g_dshot.q_head == g_dshot.q_tail) &&
+           (int32_t)(HAL_GetTick() - g_dshot.cmd_hold_until) >= 0;
+}
@@ -0,0 +1,197 @@
+/**
+ * @file       dshot.h
+ * @author     lsl-sys
+ * @brief      DShot300/600 Digital ESC Protocol (Timer Update DMA Burst, Bidirectional eRPM Telemetry)
+ * @version    V1.1.0
+ * @date       2026-02-24
+ * @Encoding   UTF-8
+ * @note       帧格式（16位，高位先发）：11位油门/命令 + 1位遥测请求 + 4位CRC
+ *             （CRC = (v ^ v>>4 ^ v>>8) & 0xF，v为前12位）。
+ *             每位由一个PWM周期表示，高电平占空比 75% 为1、37.5% 为0。
+ *             同一定时器上的电机共用一路更新事件DMA，以DMAR/DCR突发方式每个周期
+ *             依次写入各通道CCR，一帧16位加2个低电平位（帧间隔），CPU只需在控制
+ *             周期填好缓冲并重启DMA，发送期间无中断。
+ *             DMA映射（STM32F405）：TIM2_UP → DMA1_Stream7 CH3，TIM4_UP → DMA1_Stream6 CH2；
+ *             TIM2_UP 的另一路 DMA1_Stream1 已被 USART3_RX（WT901C）占用，不可使用。
+ *             数值 0 为停转，1~47 为命令，48~2047 为油门。
+ *             命令仅在电机停转（输出值为0）时发出，按命令要求重复发送并在之后保持间隔。
+ *
+ *             双向DShot（DSHOT_BIDIR=1，需ESC固件支持，如Bluejay/BLHeli_32）：
+ *             发送电平反相（空闲为高）且CRC取反；ESC在帧结束约30us后于同一根线回传
+ *             21位GCR编码的eRPM（速率为DShot速率的5/4）。
+ *             接收：发送DMA完成中断把电机引脚切为上拉输入，并启动 TIM1 更新事件驱动的
+ *             DMA2_Stream5(CH6) 以3倍位速率采样 GPIOB->IDR（DMA1无法访问AHB1上的GPIO），
+ *             四个电机同一端口一次采完；下个控制周期发送前按边沿间隔解码各电机回传。
+ *             要求全部电机引脚在同一GPIO端口（当前 PB6/PB7/PB10/PB11）。
+ */
+
+#ifndef __DSHOT_H
+#define __DSHOT_H
+
+#include "main.h"
+#include "propulsion.h"
+
+/* 协议速率 (bit/s) */
+#define DSHOT300_BITRATE        300000U
+#define DSHOT600_BITRATE        600000U
+
+/* 帧结构 */
+#define DSHOT_FRAME_BITS        16      // 有效位数
+#define DSHOT_FRAME_GAP_BITS    2       // 帧尾空闲位（CCR=0，保证帧间隔并使输出停在空闲电平）
+#define DSHOT_FRAME_SLOTS       (DSHOT_FRAME_BITS + DSHOT_FRAME_GAP_BITS)
+
+/* 占空比（分数形式，避免浮点） */
+#define DSHOT_T1H_NUM           3       // 1: 3/4 = 75%
+#define DSHOT_T1H_DEN           4
+#define DSHOT_T0H_NUM           3       // 0: 3/8 = 37.5%
+#define DSHOT_T0H_DEN           8
+
+/* 数值范围 */
+#define DSHOT_CMD_MAX           47
+#define DSHOT_THROTTLE_MIN      48
+#define DSHOT_THROTTLE_MAX      2047
+
+/* 双向DShot */
+#ifndef DSHOT_BIDIR
+#define DSHOT_BIDIR             0       // 1-启用eRPM回传（ESC不支持时电机不会响应反相信号）
+#endif
+#define DSHOT_GCR_BITS          21      // 回传帧位数（起始位 + 20位GCR）
+#define DSHOT_TELEM_OVERSAMPLE  3       // 接收采样率 = 回传位速率 × 该倍数
+#define DSHOT_TELEM_TURNAROUND_US 30    // 帧结束到回传开始的间隔
+#define DSHOT_TELEM_MARGIN_BITS 6       // 采样窗口余量（位）
+#define DSHOT_RX_SAMPLES_MAX    160     // 采样缓冲长度
+#define DSHOT_TELEM_INVALID     0xFFFFFFFFu // 解码失败（位数/GCR/CRC错误）
+#define DSHOT_TELEM_NONE        0xFFFFFFFEu // 采样窗口内无回传
+#define DSHOT_MOTOR_POLES       14      // 电机极数（X2212 12N14P），机械转速 = eRPM / (极数/2)
+#define DSHOT_RPM_TIMEOUT       10      // 连续该帧数无有效回传则转速无效
+#define DSHOT_RPM_LPF_ALPHA     0.5f    // 转速一阶低通系数
+
+#define DSHOT_MAX_TIMERS        2       // 电机使用的定时器数量上限
+#define DSHOT_MAX_CHANNELS      4       // 每个定时器的通道数
+#define DSHOT_CMD_QUEUE_LEN     8       // 命令队列长度
+
+/* 特殊命令（BLHeli_32/BLHeli_S/Bluejay 通用部分） */
+typedef enum {
+    DSHOT_CMD_MOTOR_STOP = 0,
+    DSHOT_CMD_BEEP1 = 1,                // 1~5: 蜂鸣（电机发声），发送后需间隔≥260ms
+    DSHOT_CMD_BEEP2,
+    DSHOT_CMD_BEEP3,
+    DSHOT_CMD_BEEP4,
+    DSHOT_CMD_BEEP5,
+    DSHOT_CMD_ESC_INFO = 6,
+    DSHOT_CMD_SPIN_DIRECTION_1 = 7,
+    DSHOT_CMD_SPIN_DIRECTION_2 = 8,
+    DSHOT_CMD_3D_MODE_OFF = 9,
+    DSHOT_CMD_3D_MODE_ON = 10,
+    DSHOT_CMD_SAVE_SETTINGS = 12,
+    DSHOT_CMD_SPIN_DIRECTION_NORMAL = 20,
+    DSHOT_CMD_SPIN_DIRECTION_REVERSED = 21,
+} DShotCommand_t;
+
+/* 一个定时器上的电机组：一路DMA突发写入 CCR[base..base+burst-1] */
+typedef struct {
+    TIM_HandleTypeDef *htim;
+    DMA_HandleTypeDef hdma;
+    uint8_t first_ch;                   // 突发起始通道（0~3 对应 CH1~CH4）
+    uint8_t burst;                      // 突发长度（通道数）
+    uint32_t buf[DSHOT_FRAME_SLOTS * DSHOT_MAX_CHANNELS];  // [位][通道] 交错的CCR值
+} DShotGroup_t;
+
+typedef struct {
+    uint16_t value[MOTOR_COUNT];        // 本帧各电机数值（0/48~2047）
+    uint8_t  group[MOTOR_COUNT];        // 电机所属电机组
+    uint8_t  slot[MOTOR_COUNT];         // 电机在突发中的位置
+
+    uint16_t bit_ticks;                 // 每位定时器计数
+    uint16_t t1h_ticks;
+    uint16_t t0h_ticks;
+
+    /* 命令队列 */
+    struct {
+        uint8_t mask;                   // 目标电机位图
+        uint8_t cmd;
+    } queue[DSHOT_CMD_QUEUE_LEN];
+    uint8_t q_head, q_tail;
+    uint8_t cmd_repeat;                 // 当前命令剩余发送次数
+    uint32_t cmd_hold_until;            // 命令发完后保持停转到该时刻
+
+    uint8_t ready;
+    uint32_t frames;                    // 已发送帧数
+    uint32_t dma_busy;                  // 重启时上一帧仍未发完的次数（控制周期过短）
+
+    /* 双向DShot回传 */
+    volatile uint8_t tx_pending;        // 本帧尚未发完的电机组数（发送完成中断递减）
+    volatile uint8_t rx_armed;          // 本帧已启动回传采样
+    uint16_t rx_len;                    // 采样点数
+    uint32_t erpm[MOTOR_COUNT];         // 最近一次回传eRPM
+    float motor_hz[MOTOR_COUNT];        // 机械转频估计 (Hz，低通后)
+    uint8_t rpm_age[MOTOR_COUNT];       // 距上次有效回传的帧数
+    uint32_t rx_ok[MOTOR_COUNT];        // 有效回传次数
+    uint32_t rx_err[MOTOR_COUNT];       // 解码/CRC错误次数
+    uint32_t rx_none[MOTOR_COUNT];      // 无回传次数
+} DShot_t;
+
+/**
+ * @brief  构造DShot帧（11位数值 + 遥测位 + CRC）
+ * @param  value 0~2047
+ * @param  telemetry 1-请求ESC回传遥测
+ */
+uint16_t DShot_EncodeFrame(uint16_t value, uint8_t telemetry);
+
+/**
+ * @brief  回传帧解码：由各边沿时刻（第一个为起始下降沿）还原21位GCR，查表得16位并校验CRC
+ * @param  edge 边沿时刻（任意时间单位）
+ * @param  count 边沿个数
+ * @param  ticks_per_bit 每位对应的时间单位数
+ * @return 12位数据（3位指数+9位周期尾数），失败返回DSHOT_TELEM_INVALID
+ */
+uint32_t DShot_DecodeEdges(const uint16_t *edge, uint8_t count, uint16_t ticks_per_bit);
+
+/**
+ * @brief  从端口采样序列中提取单个引脚的边沿并解码
+ * @param  pin 引脚位（GPIO_PIN_x）
+ * @return 同DShot_DecodeEdges；窗口内无回传返回DSHOT_TELEM_NONE
+ */
+uint32_t DShot_DecodeSamples(const uint16_t *samples, uint16_t n, uint16_t pin);
+
+/** 12位回传数据 → eRPM（0x0FFF为停转，返回0） */
+uint32_t DShot_ValueToERPM(uint32_t value);
+
+/**
+ * @brief  电机机械转频
+ * @return 1-有效（DSHOT_RPM_TIMEOUT帧内有有效回传），0-无效
+ */
+uint8_t DShot_GetMotorHz(MotorID_t id, float *hz);
+
+/** 发送DMA完成中断（DMA1_Stream6/7_IRQHandler中调用）：最后一组发完后切换为接收 */
+void DShot_TxDoneIRQHandler(void);
+
+/** 0~100% 转换为DShot数值：0停转，其余线性映射到 48~2047 */
+uint16_t DShot_SpeedToValue(float speed);
+
+/**
+ * @brief  把定时器改为DShot位速率并配置更新事件DMA
+ * @param  bitrate DSHOT300_BITRATE / DSHOT600_BITRATE
+ * @return 0-成功，1-定时器不支持或电机组超出上限
+ */
+uint8_t DShot_Init(const MotorHandle_t motors[MOTOR_COUNT], uint32_t bitrate);
+
+/** 设置单个电机本帧数值（0~2047，调用DShot_Update后发出） */
+void DShot_Write(MotorID_t id, uint16_t value);
+
+/** 编码所有电机并启动各定时器DMA发送（控制周期调用一次） */
+void DShot_Update(void);
+
+/**
+ * @brief  命令入队（仅停转时发出）
+ * @param  motor_mask bit0~3 对应 FL/FR/BR/BL
+ * @return 0-成功，1-队列满或命令无效
+ */
+uint8_t DShot_QueueCommand(uint8_t motor_mask, DShotCommand_t cmd);
+
+/** 命令队列是否为空（且间隔已过） */
+uint8_t DShot_CommandIdle(void);
+
+extern DShot_t g_dshot;
+
+#endif
@@ -0,0 +1,174 @@
+#include "mixer.h"
+#include "pid_core.h"
+
+Mixer_t g_mixer;
+
+/* 四轴X：与原 Propulsion_MixOutput 的 ±1 混控一致 */
+static const MixerRule_t g_mix_quad_x[] = {
+    {1.0f,  1.0f,  1.0f,  1.0f},    // FL
+    {1.0f, -1.0f,  1.0f, -1.0f},    // FR
+    {1.0f, -1.0f, -1.0f,  1.0f},    // BR
+    {1.0f,  1.0f, -1.0f, -1.0f},    // BL
+};
+
+/* 四轴+：前/右/后/左 */
+static const MixerRule_t g_mix_quad_plus[] = {
+    {1.0f,  0.0f,  1.0f,  1.0f},    // 前
+    {1.0f, -1.0f,  0.0f, -1.0f},    // 右
+    {1.0f,  0.0f, -1.0f,  1.0f},    // 后
+    {1.0f,  1.0f,  0.0f, -1.0f},    // 左
+};
+
+/* 六轴X：右前(30°)起顺时针每60°一个，相邻电机转向相反；俯仰系数按 sin30=0.5、横滚系数按 cos30 归一化 */
+static const MixerRule_t g_mix_hex_x[] = {
+    {1.0f, -0.5f,  1.0f,  1.0f},    // 右前
+    {1.0f, -1.0f,  0.0f, -1.0f},    // 右
+    {1.0f, -0.5f, -1.0f,  1.0f},    // 右后
+    {1.0f,  0.5f, -1.0f, -1.0f},    // 左后
+    {1.0f,  1.0f,  0.0f,  1.0f},    // 左
+    {1.0f,  0.5f,  1.0f, -1.0f},    // 左前
+};
+
+/* 限幅 */
+static inline float Constrain(float val, float min, float max) {
+    return (val < min) ? min : ((val > max) ? max : val);
+}
+
+/* 指令方向 → 饱和标志 */
+static inline uint8_t SatDir(float cmd) {
+    if (cmd > 0.0f) return PID_SAT_UPPER;
+    if (cmd < 0.0f) return PID_SAT_LOWER;
+    return 0;
+}
+
+uint8_t Mixer_LoadCustom(const MixerRule_t *rules, uint8_t count) {
+    if (count != MOTOR_COUNT || count > MIXER_MAX_MOTORS) return 1;
+    for (uint8_t i = 0; i < count; i++) {
+        if (rules[i].throttle <= 0.0f) return 1;
+    }
+    memcpy(g_mixer.rule, rules, count * sizeof(MixerRule_t));
+    g_mixer.count = count;
+    g_mixer.geometry = MIXER_CUSTOM;
+    return 0;
+}
+
+uint8_t Mixer_Init(uint8_t geometry) {
+    const MixerRule_t *table;
+    uint8_t count;
+
+    memset(&g_mixer, 0, sizeof(g_mixer));
+    g_mixer.torque_scale = 1.0f;
+    g_mixer.out_max = MOTOR_MAX_OUTPUT;
+
+    switch (geometry) {
+    case MIXER_QUAD_X:
+        table = g_mix_quad_x;
+        count = sizeof(g_mix_quad_x) / sizeof(g_mix_quad_x[0]);
+        break;
+    case MIXER_QUAD_PLUS:
+        table = g_mix_quad_plus;
+        count = sizeof(g_mix_quad_plus) / sizeof(g_mix_quad_plus[0]);
+        break;
+    case MIXER_HEX_X:
+        table = g_mix_hex_x;
+        count = sizeof(g_mix_hex_x) / sizeof(g_mix_hex_x[0]);
+        break;
+    default:
+        return 1;   // 自定义几何由 Mixer_LoadCustom 载入
+    }
+    if (Mixer_LoadCustom(table, count)) return 1;
+    g_mixer.geometry = geometry;
+    return 0;
+}
+
+/**
+ * @brief  给定油门下力矩可保留的最大比例
+ * @note   电机i = T_i*(thr + k*u_i)，u_i = 力矩_i / T_i，逐个电机求上下限允许的k取最小
+ */
+static float ScaleAt(const float u[MOTOR_COUNT], float thr) {
+    const Mixer_t *mx = &g_mixer;
+    float k = 1.0f;
+
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        float lim;
+        if (u[i] > 0.0f)      lim = (mx->out_max / mx->rule[i].throttle - thr) / u[i];
+        else if (u[i] < 0.0f) lim = (MOTOR_MIN_OUTPUT / mx->rule[i].throttle - thr) / u[i];
+        else continue;
+        if (lim < k) k = lim;
+    }
+    return (k < 0.0f) ? 0.0f : k;
+}
+
+void Mixer_ResetAirmode(void) {
+    g_mixer.airmode_latched = 0;
+}
+
+void Mixer_SetOutputLimit(float max) {
+    g_mixer.out_max = (max > MOTOR_MIN_OUTPUT) ? max : MOTOR_MAX_OUTPUT;
+}
+
+void Mixer_Compute(float throttle, float pitch, float roll, float yaw,
+                   float out[MOTOR_COUNT], MixSaturation_t *sat) {
+    Mixer_t *mx = &g_mixer;
+    float u[MOTOR_COUNT];
+
+    memset(sat, 0, sizeof(*sat));
+
+    // 偏航绝对上限
+    if (yaw > MIX_YAW_MAX_OUTPUT || yaw < -MIX_YAW_MAX_OUTPUT) {
+        sat->yaw = SatDir(yaw);
+        yaw = Constrain(yaw, -MIX_YAW_MAX_OUTPUT, MIX_YAW_MAX_OUTPUT);
+    }
+
+    // 力矩部分（按油门系数归一化），及各电机允许的油门区间
+    float u_min = 0.0f, u_max = 0.0f;
+    float thr_floor = -1e9f, thr_ceil = 1e9f;   // 不含力矩时油门的可行区间
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        const MixerRule_t *r = &mx->rule[i];
+        u[i] = (r->pitch * pitch + r->roll * roll + r->yaw * yaw) / r->throttle;
+        if (i == 0 || u[i] < u_min) u_min = u[i];
+        if (i == 0 || u[i] > u_max) u_max = u[i];
+        float lo = MOTOR_MIN_OUTPUT / r->throttle;
+        float hi = mx->out_max / r->throttle;
+        if (lo > thr_floor) thr_floor = lo;
+        if (hi < thr_ceil)  thr_ceil = hi;
+    }
+
+    // 力矩跨度超出输出范围：三轴同比例缩小，使油门区间刚好非空
+    float span = u_max - u_min;
+    float range = thr_ceil - thr_floor;
+    float k = (span > range) ? range / span : 1.0f;
+
+    // 平移油门到可行区间 [thr_floor - k*u_min, thr_ceil - k*u_max]
+    float thr = Constrain(throttle, thr_floor - k * u_min, thr_ceil - k * u_max);
+
+    // 油门越过起始值后锁存airmode；锁存前（地面/起飞前）与 MIXER_AIRMODE=0 一样不抬高油门
+    if (throttle >= MIXER_AIRMODE_START_THROTTLE) mx->airmode_latched = 1;
+    uint8_t airmode = MIXER_AIRMODE && mx->airmode_latched;
+
+    // 不允许抬高油门：保持原油门（不低于电机下限），缩小力矩
+    if (!airmode && thr > throttle) {
+        thr = Constrain(throttle, thr_floor, thr_ceil);
+        k = ScaleAt(u, thr);
+    }
+
+    if (k < 1.0f) {
+        sat->pitch |= SatDir(pitch);
+        sat->roll  |= SatDir(roll);
+        sat->yaw   |= SatDir(yaw);
+        mx->scaled_count++;
+    }
+    mx->torque_scale = k;
+    mx->throttle_shift = thr - throttle;
+
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        const MixerRule_t *r = &mx->rule[i];
+        float m = r->throttle * (thr + k * u[i]);
+
+        // 浮点舍入兜底限幅；达到边界的电机记入位图
+        if (m >= mx->out_max - 1e-3f || m <= MOTOR_MIN_OUTPUT + 1e-3f) {
+            sat->motor_mask |= (uint8_t)(1u << i);
+        }
+        out[i] = Constrain(m, MOTOR_MIN_OUTPUT, mx->out_max);
+    }
+}
@@ -0,0 +1,97 @@
+/**
+ * @file       mixer.h
+ * @author     lsl-sys
+ * @brief      Motor Mixer Matrix with Torque-ratio-preserving Desaturation
+ * @version    V1.0.0
+ * @date       2026-02-24
+ * @Encoding   UTF-8
+ * @note       混控矩阵：电机i输出 = T_i*油门 + P_i*俯仰 + R_i*横滚 + Y_i*偏航，
+ *             系数按机架几何给出（四轴X/+、六轴X或自定义），各轴最大系数归一化为1，
+ *             与原X型 ±1 混控量纲一致，PID输出无需重新整定。
+ *             去饱和（airmode风格）：
+ *             1. 偏航先按 MIX_YAW_MAX_OUTPUT 限幅；
+ *             2. 力矩部分的跨度不超过输出范围时，只平移油门使全部电机落在
+ *                MOTOR_MIN_OUTPUT~输出上限 内，力矩不变；
+ *             3. 跨度超过输出范围时，俯仰/横滚/偏航按同一比例缩小（三轴力矩比例不变），
+ *                油门放在正中；
+ *             4. 力矩被缩小或限幅的轴按指令方向置饱和标志，供角速度环抗积分饱和。
+ *             MIXER_AIRMODE=0 时油门只允许下移（低油门时缩小力矩而不抬高油门）。
+ *             airmode 需油门越过 MIXER_AIRMODE_START_THROTTLE 后才锁存生效（电机停转/上锁时清除）：
+ *             地面零油门时角速度环力矩（地面倾斜、陀螺零偏积分）不会把油门抬起来转动电机，
+ *             锁存前按 MIXER_AIRMODE=0 处理并置饱和标志；锁存前角速度环积分由调度层清零。
+ *             输出上限默认 MOTOR_MAX_OUTPUT，推力线性化启用时由 Mixer_SetOutputLimit 换算为推力上限。
+ */
+
+#ifndef __MIXER_H
+#define __MIXER_H
+
+#include "main.h"
+#include "propulsion.h"
+
+/* 机架几何 */
+#define MIXER_QUAD_X            0   // 四轴X（FL/FR/BR/BL）
+#define MIXER_QUAD_PLUS         1   // 四轴+（前/右/后/左）
+#define MIXER_HEX_X             2   // 六轴X（右前起顺时针）
+#define MIXER_CUSTOM            3   // 自定义（Mixer_LoadCustom）
+
+#ifndef MIXER_GEOMETRY
+#define MIXER_GEOMETRY          MIXER_QUAD_X
+#endif
+
+#ifndef MIXER_AIRMODE
+#define MIXER_AIRMODE           1   // 1-油门可上下平移（低油门保留姿态权限），0-只下移
+#endif
+
+#define MIXER_AIRMODE_START_THROTTLE 5.0f  // airmode起始油门（推力%，低于悬停推力：15%指令约7.7%推力）
+
+#define MIXER_MAX_MOTORS        8   // 自定义几何的电机数上限
+
+/* 单个电机的混控系数 */
+typedef struct {
+    float throttle;
+    float pitch;
+    float roll;
+    float yaw;
+} MixerRule_t;
+
+typedef struct {
+    MixerRule_t rule[MIXER_MAX_MOTORS];
+    uint8_t count;              // 电机数
+    uint8_t geometry;
+    float out_max;              // 输出上限（%）
+
+    float torque_scale;         // 上次混控的力矩缩放比例（1=未缩放）
+    float throttle_shift;       // 上次混控的油门平移量（%）
+    uint32_t scaled_count;      // 力矩被缩放的次数
+    uint8_t airmode_latched;    // 油门已越过airmode起始值（锁存，停转时清除；MIXER_AIRMODE=0时只用于积分门控）
+} Mixer_t;
+
+/**
+ * @brief  选择机架几何
+ * @return 0-成功，1-几何无效或电机数与 MOTOR_COUNT 不一致
+ */
+uint8_t Mixer_Init(uint8_t geometry);
+
+/**
+ * @brief  载入自定义混控系数（throttle系数须大于0）
+ * @return 0-成功，1-电机数与 MOTOR_COUNT 不一致或系数无效
+ */
+uint8_t Mixer_LoadCustom(const MixerRule_t *rules, uint8_t count);
+
+/** 清除airmode锁存（电机停转/上锁时调用） */
+void Mixer_ResetAirmode(void);
+
+/** 设置输出上限（%，<=MOTOR_MIN_OUTPUT 时恢复 MOTOR_MAX_OUTPUT） */
+void Mixer_SetOutputLimit(float max);
+
+/**
+ * @brief  混控与去饱和
+ * @param  out 各电机输出（%，已在 MOTOR_MIN_OUTPUT~输出上限 内）
+ * @param  sat 饱和状态
+ */
+void Mixer_Compute(float throttle, float pitch, float roll, float yaw,
+                   float out[MOTOR_COUNT], MixSaturation_t *sat);
+
+extern Mixer_t g_mixer;
+
+#endif
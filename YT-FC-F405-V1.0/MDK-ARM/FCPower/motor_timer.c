@@ -0,0 +1,153 @@
+#include "motor_timer.h"
+
+MotorTimer_t g_motor_timer;
+
+/* 从定时器选择主定时器作为触发源的ITR编号（STM32F405 RM0090 TIM2~5内部触发表） */
+static uint8_t SlaveTrigger(const TIM_TypeDef *slave, const TIM_TypeDef *master, uint32_t *itr) {
+    if (slave == TIM4 && master == TIM2) { *itr = TIM_TS_ITR1; return 0; }
+    if (slave == TIM2 && master == TIM4) { *itr = TIM_TS_ITR3; return 0; }
+    if (slave == TIM3 && master == TIM2) { *itr = TIM_TS_ITR1; return 0; }
+    if (slave == TIM2 && master == TIM3) { *itr = TIM_TS_ITR2; return 0; }
+    return 1;
+}
+
+/* 定时器计数时钟：APB1分频不为1时定时器时钟为PCLK1的2倍 */
+static uint32_t TimerClock(void) {
+    uint32_t pclk = HAL_RCC_GetPCLK1Freq();
+    return (HAL_RCC_GetHCLKFreq() == pclk) ? pclk : pclk * 2U;
+}
+
+/* 直接清CEN：__HAL_TIM_DISABLE在通道已使能时不会关闭计数器 */
+static inline void TimerStop(TIM_HandleTypeDef *htim) {
+    htim->Instance->CR1 &= ~TIM_CR1_CEN;
+}
+
+/* 启动：同步时只启动主定时器，从定时器由TRGO硬件触发 */
+static inline void TimerStartAll(void) {
+    MotorTimer_t *mt = &g_motor_timer;
+    if (mt->synced) {
+        mt->htim[0]->Instance->CR1 |= TIM_CR1_CEN;
+        return;
+    }
+    for (uint8_t i = 0; i < mt->count; i++) {
+        mt->htim[i]->Instance->CR1 |= TIM_CR1_CEN;
+    }
+}
+
+uint8_t MotorTimer_Init(const MotorHandle_t motors[MOTOR_COUNT]) {
+    MotorTimer_t *mt = &g_motor_timer;
+    memset(mt, 0, sizeof(*mt));
+
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        uint8_t found = 0;
+        for (uint8_t k = 0; k < mt->count; k++) {
+            if (mt->htim[k] == motors[i].htim) found = 1;
+        }
+        if (found) continue;
+        if (mt->count >= MOTOR_TIMER_MAX) return 1;
+        mt->htim[mt->count++] = motors[i].htim;
+    }
+    if (mt->count < 2) return 0;
+
+    /* 选择可作为主定时器的一方（优先第一个） */
+    uint32_t itr;
+    if (SlaveTrigger(mt->htim[1]->Instance, mt->htim[0]->Instance, &itr)) {
+        TIM_HandleTypeDef *t = mt->htim[0];
+        mt->htim[0] = mt->htim[1];
+        mt->htim[1] = t;
+        if (SlaveTrigger(mt->htim[1]->Instance, mt->htim[0]->Instance, &itr)) {
+            return 0;   // 无硬件触发连接，退化为软件依次启动
+        }
+    }
+
+    TIM_MasterConfigTypeDef master = {0};
+    master.MasterOutputTrigger = TIM_TRGO_ENABLE;           // TRGO = CEN
+    master.MasterSlaveMode = TIM_MASTERSLAVEMODE_ENABLE;
+    TIM_SlaveConfigTypeDef slave = {0};
+    slave.SlaveMode = TIM_SLAVEMODE_TRIGGER;                // 触发上升沿置CEN
+    slave.InputTrigger = itr;
+    if (HAL_TIMEx_MasterConfigSynchronization(mt->htim[0], &master) != HAL_OK) return 0;
+    if (HAL_TIM_SlaveConfigSynchro(mt->htim[1], &slave) != HAL_OK) return 0;
+
+    mt->synced = 1;
+    return 0;
+}
+
+void MotorTimer_SyncStart(void) {
+    MotorTimer_t *mt = &g_motor_timer;
+
+    for (uint8_t i = 0; i < mt->count; i++) {
+        TimerStop(mt->htim[i]);
+        __HAL_TIM_SET_COUNTER(mt->htim[i], 0);
+        mt->htim[i]->Instance->EGR = TIM_EGR_UG;    // 装载已写入的比较值
+    }
+    TimerStartAll();
+}
+
+void MotorTimer_HoldUpdate(uint8_t hold) {
+    MotorTimer_t *mt = &g_motor_timer;
+
+    for (uint8_t i = 0; i < mt->count; i++) {
+        if (hold) mt->htim[i]->Instance->CR1 |= TIM_CR1_UDIS;
+        else      mt->htim[i]->Instance->CR1 &= ~TIM_CR1_UDIS;
+    }
+}
+
+void MotorTimer_ConfigOneShot(const MotorHandle_t motors[MOTOR_COUNT], uint32_t min_ns, uint32_t max_ns) {
+    MotorTimer_t *mt = &g_motor_timer;
+    uint32_t clk = TimerClock();
+
+    mt->min_ticks = (uint32_t)((uint64_t)clk * min_ns / 1000000000ULL);
+    mt->max_ticks = (uint32_t)((uint64_t)clk * max_ns / 1000000000ULL);
+    mt->period_ticks = mt->max_ticks + (uint32_t)((uint64_t)clk * ONESHOT_LEAD_NS / 1000000000ULL);
+
+    for (uint8_t i = 0; i < mt->count; i++) {
+        TIM_HandleTypeDef *htim = mt->htim[i];
+        TimerStop(htim);
+        __HAL_TIM_SET_PRESCALER(htim, 0);
+        __HAL_TIM_SET_AUTORELOAD(htim, mt->period_ticks - 1U);
+        htim->Instance->CR1 |= TIM_CR1_OPM | TIM_CR1_ARPE;
+    }
+
+    /* PWM2：CNT<CCR为低；CCR=周期时整个计数期间为低（无脉冲） */
+    TIM_OC_InitTypeDef oc = {0};
+    oc.OCMode = TIM_OCMODE_PWM2;
+    oc.Pulse = mt->period_ticks;
+    oc.OCPolarity = TIM_OCPOLARITY_HIGH;
+    oc.OCFastMode = TIM_OCFAST_DISABLE;
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        HAL_TIM_PWM_ConfigChannel(motors[i].htim, &oc, motors[i].channel);   // 同时使能CCR预装载
+    }
+
+    for (uint8_t i = 0; i < mt->count; i++) {
+        __HAL_TIM_SET_COUNTER(mt->htim[i], 0);
+        mt->htim[i]->Instance->EGR = TIM_EGR_UG;
+    }
+}
+
+uint32_t MotorTimer_OneShotCCR(float speed) {
+    MotorTimer_t *mt = &g_motor_timer;
+
+    if (speed < 0.0f)   speed = 0.0f;
+    if (speed > 100.0f) speed = 100.0f;
+    uint32_t pulse = mt->min_ticks + (uint32_t)(speed / 100.0f * (float)(mt->max_ticks - mt->min_ticks));
+    return mt->period_ticks - pulse;
+}
+
+void MotorTimer_Trigger(void) {
+    MotorTimer_t *mt = &g_motor_timer;
+
+    /* 上一个脉冲尚未结束（控制周期远大于脉宽，正常不会发生）：本周期不触发，避免截断 */
+    for (uint8_t i = 0; i < mt->count; i++) {
+        if (mt->htim[i]->Instance->CR1 & TIM_CR1_CEN) {
+            mt->busy++;
+            return;
+        }
+    }
+
+    /* UG：预装载CCR同时转入影子寄存器、计数清零 */
+    for (uint8_t i = 0; i < mt->count; i++) {
+        mt->htim[i]->Instance->EGR = TIM_EGR_UG;
+    }
+    TimerStartAll();
+}
@@ -0,0 +1,73 @@
+/**
+ * @file       motor_timer.h
+ * @author     lsl-sys
+ * @brief      Motor Timer Synchronisation (Master/Slave Start, Glitch-free CCR Update, OneShot125/Multishot)
+ * @version    V1.0.0
+ * @date       2026-02-24
+ * @Encoding   UTF-8
+ * @note       四个电机分布在 TIM4(CH1/CH2) 与 TIM2(CH3/CH4) 上：
+ *             1. 同步启动：第一个电机所在定时器为主（TRGO=CEN），另一个为从（触发模式）：
+ *                当前 TIM4 为主，TIM2 以 ITR3 触发，两个定时器计数相位一致；
+ *             2. 无毛刺更新：写CCR期间置 CR1.UDIS 禁止预装载转移，全部写完再放开，
+ *                四个电机的新比较值在同一个周期边界生效，不会出现一半电机用新值、一半用旧值的周期；
+ *             3. OneShot125/Multishot：单脉冲模式（OPM）+ PWM2，每个控制周期触发一次。
+ *                UG装载预装载CCR后启动主定时器，从定时器同一时钟起跳；
+ *                PWM2 下 CNT<CCR 为低，脉宽 = ARR+1-CCR，计数结束自动停止且输出回到低电平。
+ */
+
+#ifndef __MOTOR_TIMER_H
+#define __MOTOR_TIMER_H
+
+#include "main.h"
+#include "propulsion.h"
+
+/* 脉宽范围 (ns) */
+#define ONESHOT125_MIN_NS       125000U
+#define ONESHOT125_MAX_NS       250000U
+#define MULTISHOT_MIN_NS        5000U
+#define MULTISHOT_MAX_NS        25000U
+#define ONESHOT_LEAD_NS         1000U   // 触发到最长脉冲上升沿的最小延时（保证CCR>0、空闲为低）
+
+#define MOTOR_TIMER_MAX         2       // 电机使用的定时器数量上限
+
+typedef struct {
+    TIM_HandleTypeDef *htim[MOTOR_TIMER_MAX];   // 去重后的定时器，[0]为主定时器
+    uint8_t count;
+    uint8_t synced;             // 1-从定时器由主定时器硬件触发启动
+
+    /* 单脉冲模式 */
+    uint32_t min_ticks;         // 最短/最长脉宽对应计数
+    uint32_t max_ticks;
+    uint32_t period_ticks;      // ARR+1
+    uint32_t busy;              // 触发时上一个脉冲尚未结束的次数
+} MotorTimer_t;
+
+/**
+ * @brief  按电机句柄收集定时器并配置主从触发
+ * @return 0-成功，1-定时器数量超限
+ */
+uint8_t MotorTimer_Init(const MotorHandle_t motors[MOTOR_COUNT]);
+
+/** 停止全部定时器、计数清零后由主定时器同步启动（连续计数模式，PWM用） */
+void MotorTimer_SyncStart(void);
+
+/**
+ * @brief  禁止/恢复更新事件：1-开始写CCR（新值暂存预装载寄存器），0-写完放开
+ */
+void MotorTimer_HoldUpdate(uint8_t hold);
+
+/**
+ * @brief  配置为单脉冲模式（OneShot125/Multishot）
+ * @param  min_ns,max_ns 0%与100%油门对应的脉宽
+ */
+void MotorTimer_ConfigOneShot(const MotorHandle_t motors[MOTOR_COUNT], uint32_t min_ns, uint32_t max_ns);
+
+/** 0~100% → 单脉冲模式CCR（写入预装载，MotorTimer_Trigger时生效） */
+uint32_t MotorTimer_OneShotCCR(float speed);
+
+/** 装载全部CCR并同时触发一次脉冲（控制周期调用一次） */
+void MotorTimer_Trigger(void);
+
+extern MotorTimer_t g_motor_timer;
+
+#endif
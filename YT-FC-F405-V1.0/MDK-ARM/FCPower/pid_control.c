@@ -1,4 +1,5 @@
 #include "pid_control.h"
+#include "pid_schedule.h"
 
 FlightPIDSystem_t g_pid;
 
@@ -8,6 +9,13 @@ static inline float Constrain(float val, float min, float max) {
     return (val < min) ? min : ((val > max) ? max : val);
 }
 
+/* 角度折算到 -180~180 */
+static inline float Wrap180(float angle) {
+    while (angle > 180.0f)   angle -= 360.0f;
+    while (angle <= -180.0f) angle += 360.0f;
+    return angle;
+}
+
 /* 系统初始化：配置串级PID参数与保护阈值 */
 void PID_InitAll(float hover_thr) {
     pidParam_t param;
@@ -26,24 +34,74 @@ void PID_InitAll(float hover_thr) {
     PID_Init(&g_pid.attitude.rate.roll, 0.0f, param);
 		PID_SetOutputLimit(&g_pid.attitude.rate.roll,20);
     
-    // 偏航（速率主控，角度环预留航向锁定）
+    // 偏航（速率主控，摇杆回中时角度环锁定航向）
     param = (pidParam_t){DEFAULT_YAW_RATE_KP, DEFAULT_YAW_RATE_KI, DEFAULT_YAW_RATE_KD, DEFAULT_YAW_RATE_ISEP};
     PID_Init(&g_pid.attitude.rate.yaw, 0.0f, param);
-    param = (pidParam_t){DEFAULT_YAW_ANGLE_KP, DEFAULT_YAW_ANGLE_KI, DEFAULT_YAW_ANGLE_KD, 0.0f};
+    PID_SetOutputLimit(&g_pid.attitude.rate.yaw, YAW_RATE_OUTPUT_LIMIT);
+    param = (pidParam_t){DEFAULT_YAW_ANGLE_KP, DEFAULT_YAW_ANGLE_KI, DEFAULT_YAW_ANGLE_KD, DEFAULT_YAW_ANGLE_ISEP};
     PID_Init(&g_pid.attitude.angle.yaw, 0.0f, param);
+    PID_SetOutputLimit(&g_pid.attitude.angle.yaw, MAX_YAW_RATE_TARGET_DPS);
+    g_pid.attitude.heading.enabled = DEFAULT_HEADING_HOLD;
+    g_pid.attitude.heading.locked = 0;
+    g_pid.attitude.heading.target = 0.0f;
     
     // 高度环
     param = (pidParam_t){DEFAULT_ALT_KP, DEFAULT_ALT_KI, DEFAULT_ALT_KD, DEFAULT_ALT_ISEP};
     PID_Init(&g_pid.altitude.alt, 0.0f, param);
+    PID_SetOutputLimit(&g_pid.altitude.alt, ALT_MAX_CLIMB_CMS);
+    param = (pidParam_t){DEFAULT_ALT_VEL_KP, DEFAULT_ALT_VEL_KI, DEFAULT_ALT_VEL_KD, DEFAULT_ALT_VEL_ISEP};
+    PID_Init(&g_pid.altitude.vel, 0.0f, param);
+    PID_SetOutputLimit(&g_pid.altitude.vel, MAX_ALT_OUTPUT);
+    PID_SetIntegralLimit(&g_pid.altitude.vel, MAX_ALT_OUTPUT / DEFAULT_ALT_VEL_KI);
     g_pid.altitude.hover_throttle = Constrain(hover_thr, 0.0f, 100.0f);
+    g_pid.altitude.enabled = 0;
+    g_pid.altitude.locked = 0;
+    
+    // 光流定点（位置环→速度环）
+    param = (pidParam_t){DEFAULT_POS_KP, DEFAULT_POS_KI, DEFAULT_POS_KD, DEFAULT_POS_ISEP};
+    PID_Init(&g_pid.position.x, 0.0f, param);
+    PID_Init(&g_pid.position.y, 0.0f, param);
+    PID_SetOutputLimit(&g_pid.position.x, POS_MAX_VEL_CMS);
+    PID_SetOutputLimit(&g_pid.position.y, POS_MAX_VEL_CMS);
+    param = (pidParam_t){DEFAULT_VEL_KP, DEFAULT_VEL_KI, DEFAULT_VEL_KD, DEFAULT_VEL_ISEP};
+    PID_Init(&g_pid.velocity.x, 0.0f, param);
+    PID_Init(&g_pid.velocity.y, 0.0f, param);
+    PID_SetOutputLimit(&g_pid.velocity.x, POS_MAX_ANGLE);
+    PID_SetOutputLimit(&g_pid.velocity.y, POS_MAX_ANGLE);
+    PID_SetIntegralLimit(&g_pid.velocity.x, (POS_MAX_ANGLE * 0.5f) / DEFAULT_VEL_KI);
+    PID_SetIntegralLimit(&g_pid.velocity.y, (POS_MAX_ANGLE * 0.5f) / DEFAULT_VEL_KI);
+    PID_SetITermRelax(&g_pid.velocity.x, POS_VEL_RELAX_ALPHA, POS_VEL_RELAX_THRESH);
+    PID_SetITermRelax(&g_pid.velocity.y, POS_VEL_RELAX_ALPHA, POS_VEL_RELAX_THRESH);
     
     g_pid.velocity.enabled = 0;
     g_pid.position.enabled = 0;
+    g_pid.position.locked = 0;
     
     g_pid.attitude.mode = MODE_ANGLE;
     g_pid.arm_flag = 0;
     g_pid.fault = 0;
     g_pid.out.pitch = g_pid.out.roll = g_pid.out.yaw = 0;
+    
+    // 前馈与抗重力（前馈平滑默认按控制周期，遥控初始化后可按帧率重设）
+    g_pid.attitude.rate.pitch.kff = DEFAULT_PITCH_RATE_FF;
+    g_pid.attitude.rate.roll.kff  = DEFAULT_ROLL_RATE_FF;
+    g_pid.attitude.rate.yaw.kff   = DEFAULT_YAW_RATE_FF;
+    PID_SetFeedForwardSmoothing(1.0f / PID_LOOP_HZ);
+    
+#if ITERM_RELAX_ENABLE
+    PID_SetITermRelax(&g_pid.attitude.rate.pitch, ITERM_RELAX_ALPHA, ITERM_RELAX_THRESH_RP);
+    PID_SetITermRelax(&g_pid.attitude.rate.roll,  ITERM_RELAX_ALPHA, ITERM_RELAX_THRESH_RP);
+    PID_SetITermRelax(&g_pid.attitude.rate.yaw,   ITERM_RELAX_ALPHA, ITERM_RELAX_THRESH_YAW);
+#endif
+    
+    g_pid.attitude.anti_gravity.gain[AXIS_PITCH] = DEFAULT_PITCH_ANTI_GRAVITY;
+    g_pid.attitude.anti_gravity.gain[AXIS_ROLL]  = DEFAULT_ROLL_ANTI_GRAVITY;
+    g_pid.attitude.anti_gravity.gain[AXIS_YAW]   = DEFAULT_YAW_ANTI_GRAVITY;
+    g_pid.attitude.anti_gravity.thr_lp = 0.0f;
+    g_pid.attitude.anti_gravity.thr_hp = 0.0f;
+    
+    // 增益调度以上述角速度环参数为基础增益
+    GainSched_Init();
 }
 
 /* 系统复位：清空积分与输出（用于急停或模式切换） */
@@ -55,11 +113,23 @@ void PID_SystemReset(void) {
     PID_Reset(&g_pid.attitude.rate.roll);
     PID_Reset(&g_pid.attitude.rate.yaw);
     PID_Reset(&g_pid.altitude.alt);
+    PID_Reset(&g_pid.altitude.vel);
+    g_pid.altitude.locked = 0;
+    PID_Reset(&g_pid.position.x);
+    PID_Reset(&g_pid.position.y);
+    PID_Reset(&g_pid.velocity.x);
+    PID_Reset(&g_pid.velocity.y);
+    g_pid.position.locked = 0;
     
     g_pid.out.pitch = 0;
     g_pid.out.roll = 0;
     g_pid.out.yaw = 0;
     g_pid.fault = 0;
+    
+    g_pid.attitude.anti_gravity.thr_lp = g_pid.out.throttle;
+    g_pid.attitude.anti_gravity.thr_hp = 0.0f;
+    
+    g_pid.attitude.heading.locked = 0; // 解锁后重新捕获航向
 }
 
 /* 切换控制模式（角度自稳/手动速率） */
@@ -67,21 +137,51 @@ void PID_SetMode(FlightMode_t mode) {
     g_pid.attitude.mode = mode;
 }
 
+/* 航向锁定开关：重新开启时按当前航向重新捕获 */
+void PID_SetHeadingHold(uint8_t enable) {
+    g_pid.attitude.heading.enabled = enable ? 1 : 0;
+    g_pid.attitude.heading.locked = 0;
+}
+
+/**
+ * @brief  偏航外环：摇杆打杆时直通角速度目标，回中且转速降下后锁定航向
+ * @note   航向误差按最短角差（±180°）计算；以"目标-折算误差"作为连续测量值，
+ *         避免航向跨越±180°时微分项（测量值微分）出现360°跳变
+ */
+static float HeadingHold_Update(float target_rate_yaw, float meas_yaw, float gyro_z) {
+    HeadingHold_t *hh = &g_pid.attitude.heading;
+    
+    if (Abs(target_rate_yaw) > HEADING_STICK_DEADBAND) {
+        hh->locked = 0;
+        return target_rate_yaw;
+    }
+    
+    if (!hh->locked) {
+        if (Abs(gyro_z) > HEADING_CAPTURE_RATE) {
+            return 0.0f; // 先由角速度环刹住，再锁定
+        }
+        hh->target = meas_yaw;
+        hh->locked = 1;
+        PID_Reset(&g_pid.attitude.angle.yaw);
+    }
+    
+    float meas_unwrapped = hh->target - Wrap180(hh->target - meas_yaw);
+    return PID_Calculate(&g_pid.attitude.angle.yaw, meas_unwrapped, hh->target);
+}
+
 /* 姿态控制主循环：串级PID计算，返回故障标志（1=倾角超限保护） */
 uint8_t PID_UpdateAttitude(float target_pitch, float target_roll, float target_yaw,
                           float meas_pitch, float meas_roll, float meas_yaw,
                           float gyro_x, float gyro_y, float gyro_z) {
     float target_rate_pitch, target_rate_roll, target_rate_yaw;
     
-    (void)meas_yaw; // 航向锁定功能预留
-    
     /* 倾角保护：超限立即置故障标志，调用方需执行电机停转 */
     if (Abs(meas_pitch) > TILT_LIMIT_DEG || Abs(meas_roll) > TILT_LIMIT_DEG) {
         g_pid.fault = 1;
         return 1;
     }
     
-    if (g_pid.attitude.mode == MODE_ANGLE)  {
+    if (g_pid.attitude.mode != MODE_RATE)  {
         /* 外环：角度误差→角速度目标（注意：测量值与陀螺仪极性必须一致，否则正反馈炸机） */
         target_rate_pitch = PID_Calculate(&g_pid.attitude.angle.pitch, meas_pitch, target_pitch);
         target_rate_roll  = PID_Calculate(&g_pid.attitude.angle.roll,  meas_roll,  target_roll);
@@ -89,12 +189,18 @@ uint8_t PID_UpdateAttitude(float target_pitch, float target_roll, float target_y
         target_rate_pitch = Constrain(target_rate_pitch, -MAX_RATE_TARGET_DPS, MAX_RATE_TARGET_DPS);
         target_rate_roll  = Constrain(target_rate_roll,  -MAX_RATE_TARGET_DPS, MAX_RATE_TARGET_DPS);
         
-        target_rate_yaw = target_yaw; 
+        if (g_pid.attitude.heading.enabled) {
+            target_rate_yaw = HeadingHold_Update(target_yaw, meas_yaw, gyro_z);
+        } else {
+            target_rate_yaw = target_yaw;
+            g_pid.attitude.heading.locked = 0; // 上位机关闭后再开启时重新捕获
+        }
     } else {
         /* 手动模式：摇杆直接映射为角速度 */
         target_rate_pitch = target_pitch;
         target_rate_roll  = target_roll;
         target_rate_yaw   = target_yaw;
+        g_pid.attitude.heading.locked = 0;
     }
     
     /* 内环：角速度误差→力矩输出（gyro_x对应pitch，极性错误会导致抬头加速抬头） */
@@ -105,6 +211,58 @@ uint8_t PID_UpdateAttitude(float target_pitch, float target_roll, float target_y
     return 0;
 }
 
+/* 前馈平滑：时间常数取若干个目标刷新周期，遥控帧率低于控制频率时避免阶梯目标产生前馈尖峰 */
+void PID_SetFeedForwardSmoothing(float rc_interval_s) {
+    const float dt = 1.0f / PID_LOOP_HZ;
+    float period = (rc_interval_s > dt) ? rc_interval_s : dt;
+    float tau = FF_SMOOTH_PERIODS * period;
+    float alpha = dt / (tau + dt);
+    
+    PID_SetFeedForward(&g_pid.attitude.rate.pitch, g_pid.attitude.rate.pitch.kff, alpha);
+    PID_SetFeedForward(&g_pid.attitude.rate.roll,  g_pid.attitude.rate.roll.kff,  alpha);
+    PID_SetFeedForward(&g_pid.attitude.rate.yaw,   g_pid.attitude.rate.yaw.kff,   alpha);
+}
+
+/* 单轴前馈增益（保留当前平滑系数） */
+void PID_SetRateFeedForward(PID_Axis_t axis, float kff) {
+    PIDController *pc = NULL;
+    switch (axis) {
+        case AXIS_PITCH: pc = &g_pid.attitude.rate.pitch; break;
+        case AXIS_ROLL:  pc = &g_pid.attitude.rate.roll;  break;
+        case AXIS_YAW:   pc = &g_pid.attitude.rate.yaw;   break;
+        default: return;
+    }
+    PID_SetFeedForward(pc, kff, pc->ffAlpha);
+}
+
+/* 抗重力：油门快速变化时姿态扰动大，临时提升积分倍率加快纠偏 */
+void PID_UpdateAntiGravity(float throttle) {
+    AntiGravity_t *ag = &g_pid.attitude.anti_gravity;
+    PIDController *rate[AXIS_COUNT] = {&g_pid.attitude.rate.pitch, &g_pid.attitude.rate.roll, &g_pid.attitude.rate.yaw};
+    
+    ag->thr_lp += ANTI_GRAVITY_LP_ALPHA * (throttle - ag->thr_lp);
+    ag->thr_hp = Abs(throttle - ag->thr_lp);
+    
+    for (int a = 0; a < AXIS_COUNT; a++) {
+        float boost = 1.0f + ag->gain[a] * ag->thr_hp;
+        PID_SetIBoost(rate[a], Constrain(boost, 1.0f, ANTI_GRAVITY_MAX_BOOST));
+    }
+}
+
+/* 起飞前清零角速度环积分：只清积分，微分/前馈历史保留 */
+void PID_ResetRateIntegral(void) {
+    g_pid.attitude.rate.pitch.integ = 0.0f;
+    g_pid.attitude.rate.roll.integ  = 0.0f;
+    g_pid.attitude.rate.yaw.integ   = 0.0f;
+}
+
+/* 混控饱和反馈：电机削顶方向上冻结内环积分（条件积分抗饱和） */
+void PID_SetRateSaturation(uint8_t sat_pitch, uint8_t sat_roll, uint8_t sat_yaw) {
+    PID_SetSaturation(&g_pid.attitude.rate.pitch, sat_pitch);
+    PID_SetSaturation(&g_pid.attitude.rate.roll,  sat_roll);
+    PID_SetSaturation(&g_pid.attitude.rate.yaw,   sat_yaw);
+}
+
 /* 获取姿态PID输出（单位：力矩/油门混合量，用于电机混控） */
 void PID_GetAttitudeOutput(float *pitch_out, float *roll_out, float *yaw_out) {
     if (pitch_out) *pitch_out = g_pid.out.pitch;
@@ -118,6 +276,146 @@ float PID_UpdateAlt(float target_alt, float meas_alt) {
     return Constrain(output, -MAX_ALT_OUTPUT, MAX_ALT_OUTPUT);
 }
 
+/* 定高开关：开启时预置爬升率环积分，使输出等于当前手动油门（无扰切换） */
+void PID_SetAltHold(uint8_t enable, float cur_throttle) {
+    AltitudePID_t *ah = &g_pid.altitude;
+    
+    PID_Reset(&ah->alt);
+    PID_Reset(&ah->vel);
+    ah->locked = 0;
+    ah->target_vel = 0.0f;
+    ah->output = Constrain(cur_throttle, 0.0f, 100.0f);
+    
+    if (enable && ah->vel.ki > 0.0f) {
+        float offset = Constrain(ah->output - ah->hover_throttle, -MAX_ALT_OUTPUT, MAX_ALT_OUTPUT);
+        ah->vel.integ = offset / ah->vel.ki;
+    }
+    ah->enabled = enable ? 1 : 0;
+}
+
+/**
+ * @brief  定高串级：高度环→爬升率环→悬停油门修正
+ * @note   油门杆出死区时直接给定爬升率并跟随当前高度，回中时锁定当前高度；
+ *         高度/爬升率由竖直互补滤波提供；测量无效时保持上次油门输出，恢复后重新锁定
+ */
+float PID_UpdateAltHold(float stick, float meas_alt, float meas_vel, uint8_t meas_valid) {
+    // 油门杆→爬升率（死区外线性映射到±ALT_MAX_CLIMB_CMS）
+    float climb = 0.0f;
+    if (stick > ALT_STICK_DEADBAND) {
+        climb = (stick - ALT_STICK_DEADBAND) / (100.0f - ALT_STICK_DEADBAND) * ALT_MAX_CLIMB_CMS;
+    } else if (stick < -ALT_STICK_DEADBAND) {
+        climb = (stick + ALT_STICK_DEADBAND) / (100.0f - ALT_STICK_DEADBAND) * ALT_MAX_CLIMB_CMS;
+    }
+    return PID_UpdateAltClimb(climb, meas_alt, meas_vel, meas_valid);
+}
+
+/* 爬升率指令定高：非零时跟踪爬升率，为零时锁定并保持当前高度 */
+float PID_UpdateAltClimb(float climb, float meas_alt, float meas_vel, uint8_t meas_valid) {
+    AltitudePID_t *ah = &g_pid.altitude;
+    
+    if (!meas_valid) {
+        ah->locked = 0;
+        return ah->output;
+    }
+    
+    climb = Constrain(climb, -ALT_MAX_CLIMB_CMS, ALT_MAX_CLIMB_CMS);
+    
+    if (climb != 0.0f) {
+        ah->locked = 0;
+        ah->target_vel = climb;
+    } else {
+        if (!ah->locked) {
+            ah->target_alt = meas_alt;
+            ah->locked = 1;
+            PID_Reset(&ah->alt);
+        }
+        ah->target_vel = PID_Calculate(&ah->alt, meas_alt, ah->target_alt);
+    }
+    
+    float correction = PID_Calculate(&ah->vel, meas_vel, ah->target_vel);
+    ah->output = Constrain(ah->hover_throttle + correction, 0.0f, 100.0f);
+    return ah->output;
+}
+
+/* 定点开关：清空级联状态，开启后先刹车再锁定位置 */
+void PID_SetPosHold(uint8_t enable) {
+    PID_Reset(&g_pid.position.x);
+    PID_Reset(&g_pid.position.y);
+    PID_Reset(&g_pid.velocity.x);
+    PID_Reset(&g_pid.velocity.y);
+    g_pid.velocity.meas_x = g_pid.velocity.meas_y = 0.0f;
+    g_pid.velocity.target_x = g_pid.velocity.target_y = 0.0f;
+    g_pid.position.locked = 0;
+    g_pid.position.enabled = enable ? 1 : 0;
+    g_pid.velocity.enabled = g_pid.position.enabled;
+}
+
+/* 摇杆→速度指令（死区外线性映射到±POS_MAX_VEL_CMS，死区内为0） */
+static float StickToVel(float stick) {
+    if (stick > POS_STICK_DEADBAND) {
+        return (stick - POS_STICK_DEADBAND) / (100.0f - POS_STICK_DEADBAND) * POS_MAX_VEL_CMS;
+    }
+    if (stick < -POS_STICK_DEADBAND) {
+        return (stick + POS_STICK_DEADBAND) / (100.0f - POS_STICK_DEADBAND) * POS_MAX_VEL_CMS;
+    }
+    return 0.0f;
+}
+
+/**
+ * @brief  光流定点：摇杆为速度指令，松杆后速度环刹停，速度降到POS_BRAKE_VEL_CMS以下锁定位置
+ * @note   光流位移为机体系累积量，航向锁定保证机头不变时位置有效；打偏航时由调用方重新开启定点
+ */
+uint8_t PID_UpdatePosHold(float stick_roll, float stick_pitch,
+                          float pos_x, float pos_y, float vel_x, float vel_y, uint8_t meas_valid,
+                          float *target_pitch, float *target_roll) {
+    PositionPID_t *pp = &g_pid.position;
+    VelocityPID_t *vp = &g_pid.velocity;
+    
+    if (!meas_valid) {
+        pp->locked = 0;
+        return 0;
+    }
+    
+    pos_x *= POS_FLOW_X_SIGN;  pos_y *= POS_FLOW_Y_SIGN;
+    vel_x *= POS_FLOW_X_SIGN;  vel_y *= POS_FLOW_Y_SIGN;
+    vp->meas_x += POS_VEL_LP_ALPHA * (vel_x - vp->meas_x);
+    vp->meas_y += POS_VEL_LP_ALPHA * (vel_y - vp->meas_y);
+    
+    float cmd_x = StickToVel(stick_roll);
+    float cmd_y = StickToVel(stick_pitch);
+    
+    if (cmd_x != 0.0f || cmd_y != 0.0f) {
+        // 打杆：速度指令直通，解除定点
+        pp->locked = 0;
+        vp->target_x = cmd_x;
+        vp->target_y = cmd_y;
+    } else {
+        if (!pp->locked) {
+            // 松杆：先以零速度刹车，刹停后锁定当前位置，避免锁点后被拉回
+            vp->target_x = vp->target_y = 0.0f;
+            if (Abs(vp->meas_x) < POS_BRAKE_VEL_CMS && Abs(vp->meas_y) < POS_BRAKE_VEL_CMS &&
+                Abs(vp->x.out) < POS_BRAKE_ANGLE && Abs(vp->y.out) < POS_BRAKE_ANGLE) {
+                pp->target_x = pos_x;
+                pp->target_y = pos_y;
+                pp->locked = 1;
+                PID_Reset(&pp->x);
+                PID_Reset(&pp->y);
+            }
+        }
+        if (pp->locked) {
+            vp->target_x = PID_Calculate(&pp->x, pos_x, pp->target_x);
+            vp->target_y = PID_Calculate(&pp->y, pos_y, pp->target_y);
+        }
+    }
+    
+    float ang_x = PID_Calculate(&vp->x, vp->meas_x, vp->target_x);
+    float ang_y = PID_Calculate(&vp->y, vp->meas_y, vp->target_y);
+    
+    if (target_roll)  *target_roll  = POS_ROLL_SIGN  * ang_x;
+    if (target_pitch) *target_pitch = POS_PITCH_SIGN * ang_y;
+    return 1;
+}
+
 /* 在线调整角度环参数（调参/自适应用） */
 void PID_SetAngleParam(PID_Axis_t axis, const pidParam_t* param) {
     if (!param) return;
@@ -148,6 +446,7 @@ void PID_SetRateParam(PID_Axis_t axis, const pidParam_t* param) {
     pc->ki = param->ki; 
     pc->kd = param->kd; 
     pc->iSepThresh = param->iSepThresh;
+    GainSched_SetBase(axis, param); // 同步调度基础增益，下个周期按油门重新缩放
 }
 
 /* 在线调整高度环参数 */
@@ -159,17 +458,29 @@ void PID_SetAltParam(const pidParam_t* param) {
     g_pid.altitude.alt.iSepThresh = param->iSepThresh;
 }
 
+/* 在线调整爬升率环参数（积分限幅随ki调整，保证积分项可覆盖MAX_ALT_OUTPUT） */
+void PID_SetAltVelParam(const pidParam_t* param) {
+    if (!param) return;
+    g_pid.altitude.vel.kp = param->kp;
+    g_pid.altitude.vel.ki = param->ki;
+    g_pid.altitude.vel.kd = param->kd;
+    g_pid.altitude.vel.iSepThresh = param->iSepThresh;
+    if (param->ki > 0.0f) {
+        PID_SetIntegralLimit(&g_pid.altitude.vel, MAX_ALT_OUTPUT / param->ki);
+    }
+}
+
 /* 倾角安全检测：超过TILT_LIMIT_DEG返回1，用于触发迫降保护 */
 uint8_t PID_CheckTilt(float pitch, float roll) {
     return (Abs(pitch) > TILT_LIMIT_DEG || Abs(roll) > TILT_LIMIT_DEG) ? 1 : 0;
 }
 
 /* 摇杆量→目标角度映射（-100~100 → -MAX_ANGLE_TARGET~MAX_ANGLE_TARGET） */
-float PID_StickToAngle(int16_t stick) {
-    return Constrain((float)stick, -100.0f, 100.0f) * (MAX_ANGLE_TARGET / 100.0f);
+float PID_StickToAngle(float stick) {
+    return Constrain(stick, -100.0f, 100.0f) * (MAX_ANGLE_TARGET / 100.0f);
 }
 
 /* 摇杆量→目标角速度映射（-100~100 → -MAX_RATE_TARGET_DPS~MAX_RATE_TARGET_DPS） */
-float PID_StickToRate(int16_t stick) {
-    return Constrain((float)stick, -100.0f, 100.0f) * (MAX_RATE_TARGET_DPS / 100.0f);
+float PID_StickToRate(float stick) {
+    return Constrain(stick, -100.0f, 100.0f) * (MAX_RATE_TARGET_DPS / 100.0f);
 }
@@ -25,8 +25,8 @@
 #define DEFAULT_ROLL_ANGLE_KD       0.00f
 #define DEFAULT_ROLL_ANGLE_ISEP     20.0f
 
-// 偏航角度环（不用）
-#define DEFAULT_YAW_ANGLE_KP        1.0f
+// 偏航角度环（航向锁定）
+#define DEFAULT_YAW_ANGLE_KP        2.0f
 #define DEFAULT_YAW_ANGLE_KI        0.0f
 #define DEFAULT_YAW_ANGLE_KD        0.0f
 #define DEFAULT_YAW_ANGLE_ISEP      0.0f
@@ -42,28 +42,96 @@
 #define DEFAULT_ROLL_RATE_KD        0.0f
 #define DEFAULT_ROLL_RATE_ISEP      0.0f
 
-#define DEFAULT_YAW_RATE_KP         0.0f
-#define DEFAULT_YAW_RATE_KI         0.0f
+#define DEFAULT_YAW_RATE_KP         0.3f
+#define DEFAULT_YAW_RATE_KI         0.005f
 #define DEFAULT_YAW_RATE_KD         0.0f
 #define DEFAULT_YAW_RATE_ISEP       0.0f
+#define YAW_RATE_OUTPUT_LIMIT       10.0f //偏航力矩限幅（反扭矩控制效率低，限幅小于俯仰/横滚）
 
-// 高度环
-#define DEFAULT_ALT_KP              1.0f
-#define DEFAULT_ALT_KI              0.3f
+// 航向锁定：摇杆回中且偏航角速度降下来后锁定当前航向
+#define DEFAULT_HEADING_HOLD        1
+#define HEADING_STICK_DEADBAND      5.0f  //偏航目标角速度死区(°/s)，超过视为打杆转向
+#define HEADING_CAPTURE_RATE        10.0f //回中后角速度低于该值才锁定航向（避免回弹）
+#define MAX_YAW_RATE_TARGET_DPS     90.0f //航向环输出角速度限幅
+
+// 角速度环目标前馈（作用于每周期目标角速度变化量）
+// 注意：出厂前馈为0、俯仰/横滚角速度环KI为0，前馈与抗重力在默认参数下均不起作用；
+// 调出KI（抗重力只放大积分）和前馈增益后再生效，仿真中的效果见 test/test_pid_core.c
+#define DEFAULT_PITCH_RATE_FF       0.0f
+#define DEFAULT_ROLL_RATE_FF        0.0f
+#define DEFAULT_YAW_RATE_FF         0.0f
+
+// 抗重力：油门突变时提升角速度环积分速度（倍率 = 1 + 增益*|油门高通量(%)|）
+#define DEFAULT_PITCH_ANTI_GRAVITY  0.15f
+#define DEFAULT_ROLL_ANTI_GRAVITY   0.15f
+#define DEFAULT_YAW_ANTI_GRAVITY    0.0f   //偏航只有KI，但油门突变主要扰动俯仰/横滚，默认不提升
+#define ANTI_GRAVITY_LP_ALPHA       0.1f  //油门低通系数（100Hz下约1.7Hz），高通=油门-低通
+#define ANTI_GRAVITY_MAX_BOOST      5.0f  //积分倍率上限
+
+// I-term relax：目标角速度高通超过阈值时暂停角速度环积分（快速翻滚回中后防回弹）
+#define ITERM_RELAX_ENABLE          1
+#define ITERM_RELAX_ALPHA           0.47f //目标低通系数（100Hz下约10Hz截止）
+#define ITERM_RELAX_THRESH_RP       40.0f //俯仰/横滚阈值(°/s)
+#define ITERM_RELAX_THRESH_YAW      20.0f //偏航阈值(°/s)
+
+// 高度环（外环：高度误差cm → 目标爬升率cm/s，积分由爬升率环承担）
+#define DEFAULT_ALT_KP              1.5f
+#define DEFAULT_ALT_KI              0.0f
 #define DEFAULT_ALT_KD              0.0f
 #define DEFAULT_ALT_ISEP            0.0f
 
+// 爬升率环（内环：爬升率误差cm/s → 油门修正%，积分学习真实悬停油门）
+#define DEFAULT_ALT_VEL_KP          0.15f
+#define DEFAULT_ALT_VEL_KI          0.004f
+#define DEFAULT_ALT_VEL_KD          0.0f
+#define DEFAULT_ALT_VEL_ISEP        0.0f
+
+// 定高
+#define ALT_MAX_CLIMB_CMS           50.0f //最大爬升/下降率(cm/s)
+#define ALT_STICK_DEADBAND          10.0f //油门杆中位死区（-100~100），死区内锁定高度
+
+// 光流定点（位置cm → 速度cm/s → 目标姿态角°）
+#define DEFAULT_POS_KP              0.6f
+#define DEFAULT_POS_KI              0.0f
+#define DEFAULT_POS_KD              0.0f
+#define DEFAULT_POS_ISEP            0.0f
+
+#define DEFAULT_VEL_KP              0.15f
+#define DEFAULT_VEL_KI              0.002f
+#define DEFAULT_VEL_KD              0.0f
+#define DEFAULT_VEL_ISEP            0.0f
+
+#define POS_MAX_VEL_CMS             50.0f //摇杆最大速度指令/位置环输出限幅(cm/s)
+#define POS_MAX_ANGLE               15.0f //速度环输出姿态角限幅（小于MAX_ANGLE_TARGET）
+#define POS_STICK_DEADBAND          10.0f //摇杆死区（-100~100），死区内刹车并定点
+#define POS_BRAKE_VEL_CMS           5.0f  //刹车速度低于该值时锁定当前位置
+#define POS_BRAKE_ANGLE             2.0f  //且刹车姿态角回落到该值以下（避免速度过零时锁点后回弹）
+#define POS_VEL_LP_ALPHA            0.3f  //光流速度低通系数
+#define POS_VEL_RELAX_ALPHA         0.05f //速度环I-term relax：目标低通系数（100Hz下约0.8Hz截止）
+#define POS_VEL_RELAX_THRESH        20.0f //目标高通超过该值(cm/s)时暂停速度环积分（松杆刹车期间不积分，刹停后不回拉）
+
+// 光流轴→机体轴映射（安装方向不同时修改符号，需实测确认：前飞时光流Y为正）
+#define POS_FLOW_X_SIGN             1.0f  //光流X（右为正）→ 横滚
+#define POS_FLOW_Y_SIGN             1.0f  //光流Y（前为正）→ 俯仰
+#define POS_PITCH_SIGN              1.0f  //正俯仰目标角产生的前向加速度方向
+#define POS_ROLL_SIGN               1.0f  //正横滚目标角产生的右向加速度方向
+
 // 保护阈值与限幅
 #define TILT_LIMIT_DEG              45.0f //倾倒保护阈值
 #define MAX_ANGLE_TARGET            30.0f //最大目标姿态角
 #define MAX_ALT_OUTPUT              30.0f //高度环输出限幅
 #define MAX_RATE_TARGET_DPS         200.0f//最大目标角速度
 
+// 控制周期与前馈平滑
+#define PID_LOOP_HZ                 100   //姿态控制频率（Loop_100Hz）
+#define FF_SMOOTH_PERIODS           1.5f  //前馈平滑时间常数（目标刷新周期的倍数）
+
 /* ========== 类型定义 ========== */
 
 typedef enum {
     MODE_ANGLE = 0, //自稳模式
     MODE_RATE,      //手动模式
+    MODE_AUTOTUNE,  //自整定模式（自稳基础上逐轴注入继电器振荡）
 } FlightMode_t;
 
 typedef enum {
@@ -85,27 +153,51 @@ typedef struct {
     PIDController yaw;
 } AnglePID_t;
 
+typedef struct {
+    float gain[AXIS_COUNT];  // 各轴抗重力增益（0表示关闭）
+    float thr_lp;            // 油门低通状态
+    float thr_hp;            // 油门高通幅值（%，调试观察）
+} AntiGravity_t;
+
+typedef struct {
+    uint8_t enabled;         // 航向锁定使能（自稳模式下生效）
+    uint8_t locked;          // 已锁定航向
+    float target;            // 锁定航向(°，-180~180)
+} HeadingHold_t;
+
 typedef struct {
     AnglePID_t angle;
     RatePID_t  rate;
+    AntiGravity_t anti_gravity;
+    HeadingHold_t heading;
     FlightMode_t mode;
 } AttitudePID_t;
 
 typedef struct {
-    PIDController alt;
-    float hover_throttle;
+    PIDController alt;       // 高度环（外环）
+    PIDController vel;       // 爬升率环（内环）
+    float hover_throttle;    // 悬停油门（%），定高输出以此为中心
+    uint8_t enabled;         // 定高使能
+    uint8_t locked;          // 已锁定目标高度（油门杆回中）
+    float target_alt;        // 目标高度(cm)
+    float target_vel;        // 目标爬升率(cm/s)
+    float output;            // 定高油门输出(%)，测量无效时保持
 } AltitudePID_t;
 
 typedef struct {
     PIDController x;
     PIDController y;
     uint8_t enabled;
+    float target_x, target_y;  // 目标速度(cm/s)
+    float meas_x, meas_y;      // 低通后光流速度(cm/s)
 } VelocityPID_t;
 
 typedef struct {
     PIDController x;
     PIDController y;
     uint8_t enabled;
+    uint8_t locked;            // 已锁定定点位置（摇杆回中且刹停）
+    float target_x, target_y;  // 定点位置(cm)
 } PositionPID_t;
 
 typedef struct {
@@ -134,29 +226,66 @@ void PID_SystemReset(void);
 // 设置飞行模式
 void PID_SetMode(FlightMode_t mode);
 
-// 姿态控制（MODE_ANGLE: target为角度；MODE_RATE: target为角速度）
+// 航向锁定开关（关闭时偏航为纯角速度控制）
+void PID_SetHeadingHold(uint8_t enable);
+
+// 姿态控制（MODE_ANGLE: target为角度；MODE_RATE: target为角速度；target_yaw始终为角速度）
 // 返回0正常，1表示触发倾角保护
 uint8_t PID_UpdateAttitude(float target_pitch, float target_roll, float target_yaw,
                           float meas_pitch, float meas_roll, float meas_yaw,
                           float gyro_x, float gyro_y, float gyro_z);
 
+// 前馈平滑：按目标刷新周期（遥控帧间隔与控制周期取大者，单位s）设置角速度环前馈低通
+void PID_SetFeedForwardSmoothing(float rc_interval_s);
+
+// 设置单轴角速度环前馈增益
+void PID_SetRateFeedForward(PID_Axis_t axis, float kff);
+
+// 抗重力：按油门(0~100)高通量提升角速度环积分倍率，在姿态更新前调用
+void PID_UpdateAntiGravity(float throttle);
+
+// 清零角速度环积分（起飞前/airmode未锁存时每周期调用，在姿态更新前调用）
+void PID_ResetRateIntegral(void);
+
+// 混控饱和反馈（PID_SAT_UPPER/PID_SAT_LOWER），在姿态更新前调用，饱和方向上暂停角速度环积分
+void PID_SetRateSaturation(uint8_t sat_pitch, uint8_t sat_roll, uint8_t sat_yaw);
+
 // 获取姿态控制输出（三个轴的力矩，范围约-100~100）
 void PID_GetAttitudeOutput(float *pitch_out, float *roll_out, float *yaw_out);
 													
 // 高度控制，返回油门修正量(需叠加到基础油门)
 float PID_UpdateAlt(float target_alt, float meas_alt);
 
+// 定高开关：cur_throttle为切换时的手动油门(%)，用于无扰切换
+void PID_SetAltHold(uint8_t enable, float cur_throttle);
+
+// 定高控制：stick为油门杆(-100~100，中位保持)，meas_alt/meas_vel为高度(cm)/爬升率(cm/s)估计，返回总油门(0~100)
+float PID_UpdateAltHold(float stick, float meas_alt, float meas_vel, uint8_t meas_valid);
+
+// 定高控制（爬升率指令）：climb为目标爬升率(cm/s)，0时锁定当前高度；供失控降落等自动控制使用
+float PID_UpdateAltClimb(float climb, float meas_alt, float meas_vel, uint8_t meas_valid);
+
+// 定点开关（位置环→速度环级联，输出目标姿态角）
+void PID_SetPosHold(uint8_t enable);
+
+// 定点控制：stick为横滚/俯仰摇杆(-100~100)，位置(cm)/速度(cm/s)为光流机体系测量
+// 输出目标俯仰/横滚角(°)，返回0表示测量无效（调用方应改用摇杆角度）
+uint8_t PID_UpdatePosHold(float stick_roll, float stick_pitch,
+                          float pos_x, float pos_y, float vel_x, float vel_y, uint8_t meas_valid,
+                          float *target_pitch, float *target_roll);
+
 // 设置PID参数（用于解锁前检查和飞行中保护）
 void PID_SetAngleParam(PID_Axis_t axis, const pidParam_t* param);
 void PID_SetRateParam(PID_Axis_t axis, const pidParam_t* param);
 void PID_SetAltParam(const pidParam_t* param);
+void PID_SetAltVelParam(const pidParam_t* param);
 
 // 检查倾角是否超限，返回1表示超限
 uint8_t PID_CheckTilt(float pitch, float roll);
 
 // 摇杆映射
-float PID_StickToAngle(int16_t stick);   // -100~100 -> -30~30度
-float PID_StickToRate(int16_t stick);    // -100~100 -> -300~300度/秒
+float PID_StickToAngle(float stick);     // -100~100 -> -30~30度
+float PID_StickToRate(float stick);      // -100~100 -> -300~300度/秒
 
 extern FlightPIDSystem_t g_pid;
 
@@ -34,6 +34,20 @@ void PID_Init(PIDController* pid, const float desired, const pidParam_t pidParam
     pid->outputLimit = DEFAULT_PID_OUTPUT_LIMIT;   // 输出限幅
     pid->deadBand = DEFAULT_PID_DEAD_BAND; // 死区范围，默认为0
     pid->maxErr = DEFAULT_PID_MAX_ERR;   // 最大误差限幅，0表示无限制
+    pid->kaw = DEFAULT_PID_AW_GAIN;      // 抗饱和增益，默认条件积分
+    pid->satFlag = PID_SAT_NONE;
+    
+    pid->kff = DEFAULT_PID_FF_GAIN;
+    pid->ffAlpha = DEFAULT_PID_FF_ALPHA;
+    pid->prevDesired = desired;
+    pid->ffDeriv = 0.0f;
+    pid->outF = 0.0f;
+    pid->iBoost = 1.0f;
+    
+    pid->relaxAlpha = 0.0f;
+    pid->relaxThresh = 0.0f;
+    pid->relaxLp = desired;
+    pid->relaxFactor = 1.0f;
 		
 		pid->firstUpdate = 1; // 标记为首次调用
 }
@@ -55,6 +69,10 @@ void PID_Reset(PIDController* pid)
     
     pid->integ = 0.0f;
     pid->deriv = 0.0f;
+    pid->satFlag = PID_SAT_NONE;
+    pid->ffDeriv = 0.0f;
+    pid->outF = 0.0f;
+    pid->relaxFactor = 1.0f;
 		
 		pid->firstUpdate = 1;  // 重置首次调用标志
 }
@@ -74,9 +92,25 @@ float PID_Calculate(PIDController* pid, float _measure, float _target)
 		// 首次调用保护,避免初始微分冲击
     if (pid->firstUpdate) {
         pid->prevMeasure = _measure;  // 初始化历史测量值
+        pid->prevDesired = _target;   // 初始化历史目标值，避免首周期前馈冲击
+        pid->relaxLp = _target;       // 初始化relax低通，避免首周期误判为快速打杆
         pid->firstUpdate = 0;
     }
     
+    // 前馈：目标值变化率经低通后直接输出，无需等待误差建立
+    pid->ffDeriv += pid->ffAlpha * ((pid->desired - pid->prevDesired) - pid->ffDeriv);
+    pid->prevDesired = pid->desired;
+    pid->outF = pid->kff * pid->ffDeriv;
+    
+    // I-term relax：目标高通量越大（打杆越快）积分衰减越多，回中后自动恢复
+    if (pid->relaxAlpha > 0.0f && pid->relaxThresh > 0.0f) {
+        pid->relaxLp += pid->relaxAlpha * (pid->desired - pid->relaxLp);
+        float hp = Absf(pid->desired - pid->relaxLp);
+        pid->relaxFactor = (hp < pid->relaxThresh) ? (1.0f - hp / pid->relaxThresh) : 0.0f;
+    } else {
+        pid->relaxFactor = 1.0f;
+    }
+    
     // 死区处理
     if (pid->deadBand > 0.0f && error > -pid->deadBand && error < pid->deadBand)
     {
@@ -101,9 +135,15 @@ float PID_Calculate(PIDController* pid, float _measure, float _target)
     pid->error = error;
     
     // 积分分离：大误差时不累积积分，防止饱和
+    float integPrev = pid->integ;
     if (pid->iSepThresh <= 0.0f || Absf(error) < pid->iSepThresh)// 如果误差大于阈值且阈值>0，则跳过积分更新（保持原值）
     {
-        pid->integ += pid->error;
+        // 条件积分：混控已在该方向削顶时，不再向同方向累积（退饱和方向照常积分）
+        if (!((pid->satFlag & PID_SAT_UPPER) && error > 0.0f) &&
+            !((pid->satFlag & PID_SAT_LOWER) && error < 0.0f))
+        {
+            pid->integ += pid->error * pid->iBoost * pid->relaxFactor;
+        }
         
         // 积分限幅
         if (pid->integ > pid->iLimit)
@@ -122,18 +162,41 @@ float PID_Calculate(PIDController* pid, float _measure, float _target)
     pid->outD = pid->kd * pid->deriv;  
     
     // 计算总输出
-    float output = pid->outP + pid->outI + pid->outD;
+    float output = pid->outP + pid->outI + pid->outD + pid->outF;
     
     // 输出限幅
     if (pid->outputLimit > 0.0f)
     {
+        float outputSat = output;
         if (output > pid->outputLimit)
         {
-            output = pid->outputLimit;
+            outputSat = pid->outputLimit;
         }
         else if (output < -pid->outputLimit)
         {
-            output = -pid->outputLimit;
+            outputSat = -pid->outputLimit;
+        }
+        
+        // 抗积分饱和：输出被限幅时处理本周期积分
+        if (outputSat != output)
+        {
+            if (pid->kaw > 0.0f && pid->ki != 0.0f)
+            {
+                // 反算法：按超出量回退积分，使积分项跟随限幅后的输出
+                pid->integ += pid->kaw * (outputSat - output) / pid->ki;
+                if (pid->integ > pid->iLimit)
+                    pid->integ = pid->iLimit;
+                else if (pid->integ < -pid->iLimit)
+                    pid->integ = -pid->iLimit;
+            }
+            else if ((output > outputSat && pid->integ > integPrev) ||
+                     (output < outputSat && pid->integ < integPrev))
+            {
+                // 条件积分：本周期积分加剧饱和，撤销
+                pid->integ = integPrev;
+            }
+            pid->outI = pid->ki * pid->integ;
+            output = outputSat;
         }
     }
     
@@ -206,3 +269,40 @@ void PID_SetISepThresh(PIDController* pid, const float thresh)
         pid->iSepThresh = thresh;
     }
 }
+
+void PID_SetAntiWindupGain(PIDController* pid, const float kaw)
+{
+    if (pid != NULL && kaw >= 0.0f) {
+        pid->kaw = kaw;
+    }
+}
+
+void PID_SetSaturation(PIDController* pid, const uint8_t satFlag)
+{
+    if (pid != NULL) {
+        pid->satFlag = satFlag;
+    }
+}
+
+void PID_SetFeedForward(PIDController* pid, const float kff, const float alpha)
+{
+    if (pid != NULL && alpha > 0.0f && alpha <= 1.0f) {
+        pid->kff = kff;
+        pid->ffAlpha = alpha;
+    }
+}
+
+void PID_SetIBoost(PIDController* pid, const float boost)
+{
+    if (pid != NULL && boost > 0.0f) {
+        pid->iBoost = boost;
+    }
+}
+
+void PID_SetITermRelax(PIDController* pid, const float alpha, const float thresh)
+{
+    if (pid != NULL && alpha >= 0.0f && alpha <= 1.0f && thresh >= 0.0f) {
+        pid->relaxAlpha = alpha;
+        pid->relaxThresh = thresh;
+    }
+}
\ No newline at end of file
@@ -24,6 +24,14 @@ typedef struct {
 #define DEFAULT_PID_OUTPUT_LIMIT       100.0f 
 #define DEFAULT_PID_DEAD_BAND          0.0f    
 #define DEFAULT_PID_MAX_ERR            0.0f    // 最大误差限幅，0表示无限制
+#define DEFAULT_PID_AW_GAIN            0.0f    // 反算抗饱和增益，0表示仅用条件积分
+#define DEFAULT_PID_FF_GAIN            0.0f    // 前馈增益，0表示禁用前馈
+#define DEFAULT_PID_FF_ALPHA           1.0f    // 前馈微分低通系数，1表示不滤波
+
+/* 执行器饱和方向标志（由混控反馈，用于抗积分饱和） */
+#define PID_SAT_NONE                   0x00
+#define PID_SAT_UPPER                  0x01    // 正向输出受限：禁止积分继续增大
+#define PID_SAT_LOWER                  0x02    // 负向输出受限：禁止积分继续减小
 
 
 typedef struct {
@@ -52,6 +60,20 @@ typedef struct {
     float maxErr;       // 最大误差限制
 		float iSepThresh;   // 积分分离阈值（运行时也可单独设置）
     
+    float kff;          // 前馈增益（作用于目标值变化率，绕过误差直接输出）
+    float ffAlpha;      // 目标值变化率低通系数（0~1，按遥控刷新率设置，抑制阶梯状目标的尖峰）
+    float prevDesired;  // 上次目标值，用于前馈微分
+    float ffDeriv;      // 滤波后的目标值变化率（每周期）
+    float outF;         // 前馈输出
+    float iBoost;       // 积分增益倍率（抗重力等外部提升，默认1）
+    
+    float relaxAlpha;   // I-term relax：目标值低通系数（0表示关闭）
+    float relaxThresh;  // I-term relax：目标高通量达到该值时积分完全暂停
+    float relaxLp;      // 目标值低通状态（高通 = 目标 - 低通）
+    float relaxFactor;  // 当前积分衰减系数（0~1，调试观察）
+    float kaw;          // 反算抗饱和增益（输出限幅时按超出量回退积分），0表示条件积分
+    
+    uint8_t satFlag;    // 外部执行器饱和方向（PID_SAT_UPPER/PID_SAT_LOWER，混控反馈）
     uint8_t firstUpdate;// 首次调用标志，用于消除初始微分冲击
 
 } PIDController;
@@ -100,5 +122,20 @@ void PID_SetMaxErr(PIDController* pid, const float maxErr);
 /** 设置积分分离阈值（|error|>阈值时暂停积分累积，改善大偏差响应） */
 void PID_SetISepThresh(PIDController* pid, const float thresh);
 
+/** 设置反算抗饱和增益（输出限幅时积分按超出量回退，0表示条件积分：饱和时冻结同向积分） */
+void PID_SetAntiWindupGain(PIDController* pid, const float kaw);
+
+/** 设置目标值前馈（kff：前馈增益；alpha：目标变化率低通系数，0~1） */
+void PID_SetFeedForward(PIDController* pid, const float kff, const float alpha);
+
+/** 设置积分增益倍率（油门突变时提升积分速度，1表示不提升） */
+void PID_SetIBoost(PIDController* pid, const float boost);
+
+/** 设置I-term relax（目标快速变化时衰减积分，抑制快打杆后的回弹；alpha=0关闭） */
+void PID_SetITermRelax(PIDController* pid, const float alpha, const float thresh);
+
+/** 设置外部执行器饱和状态（混控削顶时同向积分暂停，每个控制周期更新） */
+void PID_SetSaturation(PIDController* pid, const uint8_t satFlag);
+
 #endif
 
@@ -0,0 +1,118 @@
+#include "pid_schedule.h"
+#include "VOFA.h"
+
+GainSchedule_t g_gain_sched;
+
+/* 按断点与系数初始化表 */
+static void Table_Init(GainTable_t *t, const float *x, const float *y, uint8_t n)
+{
+    t->n = n;
+    t->seg = 0;
+    for (uint8_t i = 0; i < n; i++) {
+        t->x[i] = x[i];
+        t->y[i] = y[i];
+    }
+}
+
+/* 预计算斜率（断点非升序时该段斜率置0，避免除零） */
+static void Table_Build(GainTable_t *t)
+{
+    for (uint8_t i = 0; i + 1 < t->n; i++) {
+        float dx = t->x[i + 1] - t->x[i];
+        t->slope[i] = (dx > 0.0f) ? (t->y[i + 1] - t->y[i]) / dx : 0.0f;
+    }
+    if (t->seg + 1 >= t->n) t->seg = 0;
+}
+
+/* 查表：从上次区间出发就近移动，两端外取端点值 */
+static float Table_Lookup(GainTable_t *t, float x)
+{
+    if (t->n == 0) return 1.0f;
+    if (x <= t->x[0]) return t->y[0];
+    if (x >= t->x[t->n - 1]) return t->y[t->n - 1];
+
+    uint8_t i = t->seg;
+    while (i > 0 && x < t->x[i]) i--;
+    while (i + 2 < t->n && x >= t->x[i + 1]) i++;
+    t->seg = i;
+
+    return t->y[i] + t->slope[i] * (x - t->x[i]);
+}
+
+void GainSched_Init(void)
+{
+    const float thr_x[GS_THR_POINTS]   = GS_DEFAULT_THR_X;
+    const float thr_p[GS_THR_POINTS]   = GS_DEFAULT_THR_P;
+    const float thr_i[GS_THR_POINTS]   = GS_DEFAULT_THR_I;
+    const float thr_d[GS_THR_POINTS]   = GS_DEFAULT_THR_D;
+    const float vbat_x[GS_VBAT_POINTS] = GS_DEFAULT_VBAT_X;
+    const float vbat_k[GS_VBAT_POINTS] = GS_DEFAULT_VBAT_K;
+
+    Table_Init(&g_gain_sched.thr_p, thr_x, thr_p, GS_THR_POINTS);
+    Table_Init(&g_gain_sched.thr_i, thr_x, thr_i, GS_THR_POINTS);
+    Table_Init(&g_gain_sched.thr_d, thr_x, thr_d, GS_THR_POINTS);
+    Table_Init(&g_gain_sched.vbat, vbat_x, vbat_k, GS_VBAT_POINTS);
+    GainSched_Rebuild();
+
+    // 以当前角速度环参数作为基础增益
+    PIDController *rate[AXIS_COUNT] = {&g_pid.attitude.rate.pitch, &g_pid.attitude.rate.roll, &g_pid.attitude.rate.yaw};
+    for (int a = 0; a < AXIS_COUNT; a++) {
+        g_gain_sched.base[a] = (pidParam_t){rate[a]->kp, rate[a]->ki, rate[a]->kd, rate[a]->iSepThresh};
+    }
+
+    g_gain_sched.scale_p = g_gain_sched.scale_i = g_gain_sched.scale_d = 1.0f;
+    g_gain_sched.enabled = 1;
+}
+
+void GainSched_Rebuild(void)
+{
+    Table_Build(&g_gain_sched.thr_p);
+    Table_Build(&g_gain_sched.thr_i);
+    Table_Build(&g_gain_sched.thr_d);
+    Table_Build(&g_gain_sched.vbat);
+}
+
+void GainSched_SetBase(PID_Axis_t axis, const pidParam_t* param)
+{
+    if (!param || axis >= AXIS_COUNT) return;
+    g_gain_sched.base[axis] = *param;
+}
+
+void GainSched_Update(float throttle, float vbat)
+{
+    GainSchedule_t *gs = &g_gain_sched;
+
+    if (gs->enabled) {
+        float kv = (vbat > 0.0f) ? Table_Lookup(&gs->vbat, vbat) : 1.0f;
+        gs->scale_p = Table_Lookup(&gs->thr_p, throttle) * kv;
+        gs->scale_i = Table_Lookup(&gs->thr_i, throttle) * kv;
+        gs->scale_d = Table_Lookup(&gs->thr_d, throttle) * kv;
+    } else {
+        gs->scale_p = gs->scale_i = gs->scale_d = 1.0f;
+    }
+
+    PIDController *rate[AXIS_COUNT] = {&g_pid.attitude.rate.pitch, &g_pid.attitude.rate.roll, &g_pid.attitude.rate.yaw};
+    for (int a = 0; a < AXIS_COUNT; a++) {
+        rate[a]->kp = gs->base[a].kp * gs->scale_p;
+        rate[a]->ki = gs->base[a].ki * gs->scale_i;
+        rate[a]->kd = gs->base[a].kd * gs->scale_d;
+    }
+}
+
+void GainSched_RegisterVofa(void)
+{
+    static const char *name_p[GS_THR_POINTS]  = {"GP0", "GP1", "GP2", "GP3", "GP4"};
+    static const char *name_i[GS_THR_POINTS]  = {"GI0", "GI1", "GI2", "GI3", "GI4"};
+    static const char *name_d[GS_THR_POINTS]  = {"GD0", "GD1", "GD2", "GD3", "GD4"};
+    static const char *name_v[GS_VBAT_POINTS] = {"GV0", "GV1", "GV2"};
+
+    vofa_login_name("GS", &g_gain_sched.enabled, TYPE_BOOL);
+    for (uint8_t i = 0; i < GS_THR_POINTS; i++) {
+        vofa_login_name(name_p[i], &g_gain_sched.thr_p.y[i], TYPE_FLOAT);
+        vofa_login_name(name_i[i], &g_gain_sched.thr_i.y[i], TYPE_FLOAT);
+        vofa_login_name(name_d[i], &g_gain_sched.thr_d.y[i], TYPE_FLOAT);
+    }
+    for (uint8_t i = 0; i < GS_VBAT_POINTS; i++) {
+        vofa_login_name(name_v[i], &g_gain_sched.vbat.y[i], TYPE_FLOAT);
+    }
+}
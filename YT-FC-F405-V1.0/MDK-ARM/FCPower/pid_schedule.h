@@ -0,0 +1,66 @@
+/**
+ * @file       pid_schedule.h
+ * @author     lsl-sys
+ * @brief      Rate-loop Gain Scheduling (Throttle PID Attenuation + Battery Voltage Compensation)
+ * @version    V1.0.0
+ * @date       2026-02-22
+ * @Encoding   UTF-8
+ */
+
+#ifndef __PID_SCHEDULE_H
+#define __PID_SCHEDULE_H
+
+#include "main.h"
+#include "pid_control.h"
+
+/* 断点数量 */
+#define GS_THR_POINTS       5       // 油门断点数
+#define GS_VBAT_POINTS      3       // 电池电压断点数
+
+/* 默认油门断点（%）及增益系数（X2212高油门时等效增益增大，需衰减P/D） */
+#define GS_DEFAULT_THR_X    {0.0f, 25.0f, 50.0f, 75.0f, 100.0f}
+#define GS_DEFAULT_THR_P    {1.00f, 1.00f, 1.00f, 0.85f, 0.70f}
+#define GS_DEFAULT_THR_I    {1.00f, 1.00f, 1.00f, 1.00f, 1.00f}
+#define GS_DEFAULT_THR_D    {1.00f, 1.00f, 1.00f, 0.80f, 0.65f}
+
+/* 默认电压断点（V，3S）及整体增益系数（压降后推力下降，需补偿） */
+#define GS_DEFAULT_VBAT_X   {10.5f, 11.4f, 12.6f}
+#define GS_DEFAULT_VBAT_K   {1.15f, 1.05f, 1.00f}
+
+/* 分段线性插值表：x升序，slope为预计算斜率，查表仅需一次乘加 */
+typedef struct {
+    float x[GS_THR_POINTS];          // 断点
+    float y[GS_THR_POINTS];          // 断点处系数
+    float slope[GS_THR_POINTS - 1];  // 预计算斜率 (y[i+1]-y[i])/(x[i+1]-x[i])
+    uint8_t n;                       // 有效断点数（<=GS_THR_POINTS）
+    uint8_t seg;                     // 上次命中的区间（油门连续变化，通常无需搜索）
+} GainTable_t;
+
+typedef struct {
+    bool enabled;                    // 调度使能（关闭时恢复基础增益）
+    GainTable_t thr_p;               // 油门→P系数
+    GainTable_t thr_i;               // 油门→I系数
+    GainTable_t thr_d;               // 油门→D系数
+    GainTable_t vbat;                // 电压→整体系数（vbat<=0表示无电压数据，系数取1）
+    pidParam_t base[AXIS_COUNT];     // 基础增益（PID_SetRateParam写入，调度在此基础上缩放）
+    float scale_p, scale_i, scale_d; // 当前生效系数（调试观察）
+} GainSchedule_t;
+
+/** 初始化调度表（默认断点），并以当前角速度环参数作为基础增益 */
+void GainSched_Init(void);
+
+/** 重新计算各表斜率（断点被在线修改后调用） */
+void GainSched_Rebuild(void);
+
+/** 更新基础增益（由PID_SetRateParam调用，保证调参/自整定结果不被调度覆盖） */
+void GainSched_SetBase(PID_Axis_t axis, const pidParam_t* param);
+
+/** 按油门(0~100)与电池电压(V)刷新角速度环增益，控制周期调用 */
+void GainSched_Update(float throttle, float vbat);
+
+/** 注册调度表系数到VOFA，支持上位机在线修改 */
+void GainSched_RegisterVofa(void);
+
+extern GainSchedule_t g_gain_sched;
+
+#endif
@@ -1,9 +1,20 @@
 #include "propulsion.h"
 #include "pid_control.h"
+#include "mixer.h"
+#include "thrust_curve.h"
 #include "stdio.h"
+#if PROPULSION_PROTOCOL == PROP_PROTOCOL_DSHOT300 || PROPULSION_PROTOCOL == PROP_PROTOCOL_DSHOT600
+#define PROP_USE_DSHOT  1
+#include "dshot.h"
+#else
+#define PROP_USE_DSHOT  0
+#include "motor_timer.h"
+#endif
+#define PROP_USE_ONESHOT (PROPULSION_PROTOCOL == PROP_PROTOCOL_ONESHOT125 || PROPULSION_PROTOCOL == PROP_PROTOCOL_MULTISHOT)
 
 static MotorHandle_t g_motors[MOTOR_COUNT]; // 保存句柄
 static uint8_t       g_ready = 0;           // 就绪标志
+static MixSaturation_t g_sat = {0};        // 混控饱和状态
 
 /* 限幅 */
 static inline float Constrain(float val, float min, float max) {
@@ -15,21 +26,76 @@ static inline uint32_t SpeedToCCR(float speed) {
     return (uint32_t)(PWM_MIN_COMPARE + speed / 100.0f * (PWM_MAX_COMPARE - PWM_MIN_COMPARE));
 }
 
+/* 开始一组输出：PWM下暂停更新事件，本组CCR写完后在同一周期边界生效 */
+static inline void MotorBegin(void) {
+#if PROPULSION_PROTOCOL == PROP_PROTOCOL_PWM
+    MotorTimer_HoldUpdate(1);
+#endif
+}
+
+/* 写单个电机输出（写入预装载寄存器/DShot缓冲，由MotorFlush统一生效） */
+static inline void MotorWrite(MotorID_t id, float speed) {
+#if PROP_USE_DSHOT
+    DShot_Write(id, DShot_SpeedToValue(speed));
+#elif PROP_USE_ONESHOT
+    __HAL_TIM_SET_COMPARE(g_motors[id].htim, g_motors[id].channel, MotorTimer_OneShotCCR(speed));
+#else
+    __HAL_TIM_SET_COMPARE(g_motors[id].htim, g_motors[id].channel, SpeedToCCR(speed));
+#endif
+}
+
+/* 结束一组输出：PWM恢复更新事件；OneShot同时触发一次脉冲；DShot编码并启动DMA */
+static inline void MotorFlush(void) {
+#if PROP_USE_DSHOT
+    DShot_Update();
+#elif PROP_USE_ONESHOT
+    MotorTimer_Trigger();
+#else
+    MotorTimer_HoldUpdate(0);
+#endif
+}
+
 void Propulsion_Init(const MotorHandle_t motors[MOTOR_COUNT]) {
     // 保存句柄
     for (int i = 0; i < MOTOR_COUNT; i++) {
         g_motors[i] = motors[i];
     }
     
-    // 启动PWM
+    // 混控矩阵：几何与电机数不符时不就绪（不输出）
+    if (Mixer_Init(MIXER_GEOMETRY)) return;
+    Thrust_Init();
+    
+#if PROP_USE_DSHOT
+    // 启动PWM通道
     for (int i = 0; i < MOTOR_COUNT; i++) {
         HAL_TIM_PWM_Start(g_motors[i].htim, g_motors[i].channel);
     }
-		
-    // 解锁电调：最小油门保持2秒
+    // 定时器改为DShot位速率；电调在持续收到停转帧后自行解锁
+    uint32_t bitrate = (PROPULSION_PROTOCOL == PROP_PROTOCOL_DSHOT600) ? DSHOT600_BITRATE : DSHOT300_BITRATE;
+    if (DShot_Init(g_motors, bitrate)) return;
+#else
+    // 主从触发：两个电机定时器同步启动
+    if (MotorTimer_Init(g_motors)) return;
+#if PROP_USE_ONESHOT
+    // 单脉冲模式需在启动通道前配置（HAL配置通道时会关闭通道输出）
+    if (PROPULSION_PROTOCOL == PROP_PROTOCOL_ONESHOT125) {
+        MotorTimer_ConfigOneShot(g_motors, ONESHOT125_MIN_NS, ONESHOT125_MAX_NS);
+    } else {
+        MotorTimer_ConfigOneShot(g_motors, MULTISHOT_MIN_NS, MULTISHOT_MAX_NS);
+    }
+#endif
+    // 启动PWM通道
     for (int i = 0; i < MOTOR_COUNT; i++) {
-        __HAL_TIM_SET_COMPARE(g_motors[i].htim, g_motors[i].channel, PWM_MIN_COMPARE);
+        HAL_TIM_PWM_Start(g_motors[i].htim, g_motors[i].channel);
     }
+    // 解锁电调：最小油门（OneShot/DShot 由 FC_init 等待期间及之后的控制周期持续触发最小脉宽）
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        MotorWrite((MotorID_t)i, MOTOR_MIN_OUTPUT);
+    }
+#if PROPULSION_PROTOCOL == PROP_PROTOCOL_PWM
+    MotorTimer_SyncStart();
+#endif
+#endif
     
     g_ready = 1;
 }
@@ -47,16 +113,17 @@ void Propulsion_MixOutput(float throttle, float pitch, float roll, float yaw) {
     
 //		printf("pry:%f,%f,%f.%f\r\n",pitch,roll,yaw,throttle);
 		float m[MOTOR_COUNT];
-    m[MOTOR_FL] = throttle + pitch + roll + yaw;   // M1 前左
-    m[MOTOR_FR] = throttle - pitch + roll - yaw;   // M2 前右
-    m[MOTOR_BR] = throttle - pitch - roll + yaw;   // M3 后右
-    m[MOTOR_BL] = throttle + pitch - roll - yaw;   // M4 后左
+    // 混控以推力为单位：输出上限取 MOTOR_MAX_OUTPUT 在当前电压下对应的推力
+    Mixer_SetOutputLimit(Thrust_FromCommand(MOTOR_MAX_OUTPUT));
+    // 混控矩阵 + 去饱和（平移油门、同比例缩小力矩），饱和方向下个周期反馈给角速度环
+    Mixer_Compute(throttle, pitch, roll, yaw, m, &g_sat);
     
-    // 限幅并输出
+    // 推力 → 指令（线性化 + 电压补偿）并输出
+    MotorBegin();
     for (int i = 0; i < MOTOR_COUNT; i++) {
-        m[i] = Constrain(m[i], MOTOR_MIN_OUTPUT, MOTOR_MAX_OUTPUT);
-        __HAL_TIM_SET_COMPARE(g_motors[i].htim, g_motors[i].channel, SpeedToCCR(m[i]));
+        MotorWrite((MotorID_t)i, Thrust_ToCommand(m[i]));
     }
+    MotorFlush();
 }
 
 /* 单独设置单个电机（调试用， bypass 混控和保护） */
@@ -66,17 +133,51 @@ void Propulsion_SetSingle(MotorID_t id, float speed) {
     speed = Constrain(speed, MOTOR_MIN_OUTPUT, MOTOR_MAX_OUTPUT);
 	
 //	  printf("%d\r\n",SpeedToCCR(speed));
-    __HAL_TIM_SET_COMPARE(g_motors[id].htim, g_motors[id].channel, SpeedToCCR(speed));
+    MotorBegin();
+    MotorWrite(id, speed);
+    MotorFlush();
 }
 
 /* 紧急停止 */
 void Propulsion_Stop(void) {
+    memset(&g_sat, 0, sizeof(g_sat));
+    Mixer_ResetAirmode();   // 停转后重新起飞需再次越过airmode起始油门
+    MotorBegin();
     for (int i = 0; i < MOTOR_COUNT; i++) {
-        __HAL_TIM_SET_COMPARE(g_motors[i].htim, g_motors[i].channel, PWM_MIN_COMPARE);
+        MotorWrite((MotorID_t)i, MOTOR_MIN_OUTPUT);
     }
+    MotorFlush();
 //    g_ready = 0;
 }
 
+/* 电调命令（仅DShot，未解锁时） */
+uint8_t Propulsion_EscCommand(uint8_t motor_mask, uint8_t cmd) {
+#if !PROP_USE_DSHOT
+    (void)motor_mask;
+    (void)cmd;
+    return 1;
+#else
+    if (!g_ready || g_pid.arm_flag) return 1;
+    return DShot_QueueCommand(motor_mask, (DShotCommand_t)cmd);
+#endif
+}
+
+/* 电机转速（仅双向DShot有回传） */
+uint8_t Propulsion_GetMotorHz(MotorID_t id, float *hz) {
+#if PROP_USE_DSHOT && DSHOT_BIDIR
+    return DShot_GetMotorHz(id, hz);
+#else
+    (void)id;
+    (void)hz;
+    return 0;
+#endif
+}
+
+/* 混控饱和状态查询 */
+const MixSaturation_t* Propulsion_GetSaturation(void) {
+    return &g_sat;
+}
+
 /* 检查就绪状态（软件层面） */
 uint8_t Propulsion_IsReady(void) {
     return (g_ready && g_pid.arm_flag && !g_pid.fault);
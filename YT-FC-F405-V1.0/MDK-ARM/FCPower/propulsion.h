@@ -2,9 +2,16 @@
  * @file       propulsion.h
  * @author	   lsl-sys
  * @brief      Motor Driver (SUNNYSKY X2212 K1250)
- * @version    V3.0.0
- * @date       2025-11-23 2026-02-02
+ * @version    V3.3.0
+ * @date       2025-11-23 2026-02-24
  * @Encoding   UTF-8
+ * @note       电调协议编译期选择（PROPULSION_PROTOCOL）：50Hz PWM、OneShot125/Multishot 或 DShot300/600，
+ *             混控与保护逻辑与协议无关，仅最终输出一步不同。
+ *             PWM/OneShot 下四个电机的比较值在同一周期边界生效（见 motor_timer.h），
+ *             OneShot/Multishot 每个控制周期只触发一次脉冲。
+ *             混控系数与去饱和见 mixer.h（MIXER_GEOMETRY 选择机架几何）。
+ *             Propulsion_MixOutput 的油门/力矩以推力（%）为单位，经 thrust_curve.h 线性化与电压补偿后输出；
+ *             Propulsion_SetSingle 为原始指令，不经线性化。
  */
 
 #ifndef __PROPULSION_H
@@ -12,6 +19,17 @@
 
 #include "main.h"
 
+/* 电调协议 */
+#define PROP_PROTOCOL_PWM       0   // 50Hz 标准PWM
+#define PROP_PROTOCOL_DSHOT300  1   // DShot300（定时器更新DMA）
+#define PROP_PROTOCOL_DSHOT600  2   // DShot600
+#define PROP_PROTOCOL_ONESHOT125 3  // OneShot125（125~250us，控制周期触发）
+#define PROP_PROTOCOL_MULTISHOT 4   // Multishot（5~25us，控制周期触发）
+
+#ifndef PROPULSION_PROTOCOL
+#define PROPULSION_PROTOCOL     PROP_PROTOCOL_PWM
+#endif
+
 /* PWM配置: 50Hz标准电调频率，比较值范围2500-5000对应1000-2000us脉宽 */
 
 #define PWM_MAX_COMPARE     5000    // 对应2000us (最大油门)
@@ -21,6 +39,9 @@
 #define MOTOR_MAX_OUTPUT    70.0f   // 最大输出限制（保护电池/电机）
 #define MOTOR_MIN_OUTPUT    0.0f    // 最小输出（停转）
 
+/* 偏航权限：超出该上限的偏航指令先限幅，再参与三轴同比例去饱和 */
+#define MIX_YAW_MAX_OUTPUT  15.0f   // 偏航力矩绝对上限（%）
+
 /* 电机编号定义 (X型四旋翼布局) */
 typedef enum {
     MOTOR_FL = 0,   // 前左 (Front-Left, M1)
@@ -34,6 +55,8 @@ typedef enum {
 typedef struct {
     TIM_HandleTypeDef *htim;    // 定时器句柄
     uint32_t channel;           // PWM通道 (TIM_CHANNEL_x)
+    GPIO_TypeDef *port;         // 输出引脚（双向DShot接收时切换为输入）
+    uint16_t pin;               // GPIO_PIN_x
 } MotorHandle_t;
 
 /* 电机转速结构 (百分比 0.0-100.0) */
@@ -44,10 +67,18 @@ typedef struct {
     float m4;   // BL
 } MotorSpeed_t;
 
+/* 混控饱和状态（每次混控输出后更新，供角速度环抗积分饱和） */
+typedef struct {
+    uint8_t motor_mask; // 达到输出上/下限的电机位图：bit0~3 对应 FL/FR/BR/BL
+    uint8_t pitch;      // 俯仰力矩被缩小/限幅的方向（PID_SAT_UPPER/PID_SAT_LOWER）
+    uint8_t roll;       // 横滚轴受限方向
+    uint8_t yaw;        // 偏航轴受限方向
+} MixSaturation_t;
+
 /** 初始化电机系统（配置PWM并发送解锁信号） */
 void Propulsion_Init(const MotorHandle_t motors[MOTOR_COUNT]);
 
-/** 混控输出：油门+姿态力矩→四电机转速（自动限幅与均衡） */
+/** 混控输出：油门+姿态力矩→各电机转速（混控矩阵，平移油门/同比例缩小力矩去饱和） */
 void Propulsion_MixOutput(float throttle, float pitch, float roll, float yaw);
 
 /** 单电机强制设置（用于调试或单电机测试，绕开混控） */
@@ -56,6 +87,24 @@ void Propulsion_SetSingle(MotorID_t id, float speed);
 /** 紧急停止（所有电机置最小油门，立即执行） */
 void Propulsion_Stop(void);
 
+/**
+ * @brief  向电调发送DShot命令（蜂鸣/转向/保存设置等，DShot_QueueCommand的编号）
+ * @note   仅未解锁时接受，电机停转时按命令要求重复发送
+ * @param  motor_mask bit0~3 对应 FL/FR/BR/BL
+ * @return 0-已入队，1-PWM协议不支持/已解锁/队列满
+ */
+uint8_t Propulsion_EscCommand(uint8_t motor_mask, uint8_t cmd);
+
+/**
+ * @brief  电机转速（双向DShot eRPM回传）
+ * @param  hz 输出机械转频 (Hz)
+ * @return 1-有效，0-无回传（非双向DShot或该电机回传超时）
+ */
+uint8_t Propulsion_GetMotorHz(MotorID_t id, float *hz);
+
+/** 获取上一次混控的饱和状态（停转/未输出时全部清零） */
+const MixSaturation_t* Propulsion_GetSaturation(void);
+
 /** 系统就绪检查：返回1表示已初始化且未故障，0表示未就绪（未解锁或故障） */
 uint8_t Propulsion_IsReady(void);
 
@@ -0,0 +1,103 @@
+#include "thrust_curve.h"
+#include "propulsion.h"
+#include "VOFA.h"
+
+ThrustCurve_t g_thrust;
+
+/* 限幅 */
+static inline float Constrain(float val, float min, float max) {
+    return (val < min) ? min : ((val > max) ? max : val);
+}
+
+void Thrust_Init(void)
+{
+    const float x[THRUST_POINTS] = THRUST_DEFAULT_X;
+    const float y[THRUST_POINTS] = THRUST_DEFAULT_Y;
+
+    memset(&g_thrust, 0, sizeof(g_thrust));
+    for (uint8_t i = 0; i < THRUST_POINTS; i++) {
+        g_thrust.x[i] = x[i];
+        g_thrust.y[i] = y[i];
+    }
+    Thrust_Rebuild();
+
+    g_thrust.vcomp = 1.0f;
+    g_thrust.lin_enabled = 1;
+    g_thrust.vcomp_enabled = 1;
+}
+
+/* 预计算斜率（断点非升序时该段斜率置0，避免除零）；
+ * 在线改出的下降指令抬到前一点，保证推力→指令单调（否则该段回路增益反号） */
+void Thrust_Rebuild(void)
+{
+    ThrustCurve_t *tc = &g_thrust;
+    for (uint8_t i = 0; i + 1 < THRUST_POINTS; i++) {
+        if (tc->y[i + 1] < tc->y[i]) tc->y[i + 1] = tc->y[i];
+        float dx = tc->x[i + 1] - tc->x[i];
+        tc->slope[i] = (dx > 0.0f) ? (tc->y[i + 1] - tc->y[i]) / dx : 0.0f;
+    }
+    if (tc->seg + 1 >= THRUST_POINTS) tc->seg = 0;
+}
+
+void Thrust_SetVoltage(float vbat)
+{
+    ThrustCurve_t *tc = &g_thrust;
+    if (!tc->vcomp_enabled || vbat <= 0.0f) {
+        tc->vcomp = 1.0f;
+        return;
+    }
+    tc->vcomp = Constrain(THRUST_VREF / vbat, THRUST_VCOMP_MIN, THRUST_VCOMP_MAX);
+}
+
+/* 查表：从上次区间出发就近移动，两端外取端点值（每周期各电机推力相近，通常无需搜索） */
+static float Lookup(float t)
+{
+    ThrustCurve_t *tc = &g_thrust;
+    if (t <= tc->x[0]) return tc->y[0];
+    if (t >= tc->x[THRUST_POINTS - 1]) return tc->y[THRUST_POINTS - 1];
+
+    uint8_t i = tc->seg;
+    while (i > 0 && t < tc->x[i]) i--;
+    while (i + 2 < THRUST_POINTS && t >= tc->x[i + 1]) i++;
+    tc->seg = i;
+
+    return tc->y[i] + tc->slope[i] * (t - tc->x[i]);
+}
+
+/* 反查：指令 → 推力（y升序，斜率为0的段跳过） */
+static float LookupInverse(float c)
+{
+    const ThrustCurve_t *tc = &g_thrust;
+    if (c <= tc->y[0]) return tc->x[0];
+    if (c >= tc->y[THRUST_POINTS - 1]) return tc->x[THRUST_POINTS - 1];
+
+    for (uint8_t i = 0; i + 1 < THRUST_POINTS; i++) {
+        if (c <= tc->y[i + 1] && tc->slope[i] > 0.0f) {
+            return tc->x[i] + (c - tc->y[i]) / tc->slope[i];
+        }
+    }
+    return tc->x[THRUST_POINTS - 1];
+}
+
+float Thrust_ToCommand(float thrust)
+{
+    float cmd = g_thrust.lin_enabled ? Lookup(thrust) : thrust;
+    return Constrain(cmd * g_thrust.vcomp, MOTOR_MIN_OUTPUT, MOTOR_MAX_OUTPUT);
+}
+
+float Thrust_FromCommand(float cmd)
+{
+    cmd /= g_thrust.vcomp;
+    return g_thrust.lin_enabled ? LookupInverse(cmd) : cmd;
+}
+
+void Thrust_RegisterVofa(void)
+{
+    static const char *name_y[THRUST_POINTS] = {"TC0", "TC1", "TC2", "TC3", "TC4", "TC5"};
+
+    vofa_login_name("TL", &g_thrust.lin_enabled, TYPE_BOOL);
+    vofa_login_name("TV", &g_thrust.vcomp_enabled, TYPE_BOOL);
+    for (uint8_t i = 0; i < THRUST_POINTS; i++) {
+        vofa_login_name(name_y[i], &g_thrust.y[i], TYPE_FLOAT);
+    }
+}
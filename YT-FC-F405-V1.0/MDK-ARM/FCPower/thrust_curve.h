@@ -0,0 +1,64 @@
+/**
+ * @file       thrust_curve.h
+ * @author     lsl-sys
+ * @brief      Thrust Linearisation Curve and Battery-sag Voltage Compensation
+ * @version    V1.0.0
+ * @date       2026-02-24
+ * @Encoding   UTF-8
+ * @note       推力与油门指令近似呈二次关系，且随电池压降下降，直接混控时回路增益随油门和飞行时间变化。
+ *             混控改为以推力（0~100%）为单位：
+ *             1. 线性化：推力 → 指令，分段线性插值表（断点为推力，系数为台架测得的对应指令），
+ *                默认按 T = 0.4c + 0.6c² 取点，可经VOFA "TC0"~"TC5" 在线校准；
+ *             2. 电压补偿：电机电压 = 指令 × 电池电压，指令乘 THRUST_VREF / Vbat，
+ *                补偿系数限制在 THRUST_VCOMP_MIN~THRUST_VCOMP_MAX，无电压数据时取1；
+ *             3. 混控上限随之换算：MOTOR_MAX_OUTPUT（指令）在当前电压下对应的推力，
+ *                去饱和按该推力上限进行，输出不会在线性化后再次削顶。
+ */
+
+#ifndef __THRUST_CURVE_H
+#define __THRUST_CURVE_H
+
+#include "main.h"
+
+#define THRUST_POINTS           6           // 线性化表断点数
+
+/* 默认断点：推力（%）→ 指令（%） */
+#define THRUST_DEFAULT_X        {0.0f, 10.0f, 25.0f, 50.0f, 75.0f, 100.0f}
+#define THRUST_DEFAULT_Y        {0.0f, 19.4f, 39.3f, 63.9f, 83.3f, 100.0f}
+
+/* 电压补偿 */
+#define THRUST_VREF             11.1f       // 线性化表标定时的电池电压 (V，3S标称)
+#define THRUST_VCOMP_MIN        0.85f       // 补偿系数下限（满电）
+#define THRUST_VCOMP_MAX        1.25f       // 补偿系数上限（低电，防止过度补偿）
+
+typedef struct {
+    bool lin_enabled;                   // 线性化使能（关闭时推力=指令）
+    bool vcomp_enabled;                 // 电压补偿使能
+    float x[THRUST_POINTS];             // 推力断点（升序）
+    float y[THRUST_POINTS];             // 对应指令（升序）
+    float slope[THRUST_POINTS - 1];     // 预计算斜率
+    uint8_t seg;                        // 上次命中的区间
+    float vcomp;                        // 当前电压补偿系数
+} ThrustCurve_t;
+
+/** 初始化默认线性化表 */
+void Thrust_Init(void);
+
+/** 重新计算斜率（断点被在线修改后调用），下降的指令断点被抬到前一点 */
+void Thrust_Rebuild(void);
+
+/** 按电池电压 (V) 更新补偿系数，vbat<=0 表示无电压数据（控制周期调用） */
+void Thrust_SetVoltage(float vbat);
+
+/** 推力（%）→ 电机指令（%，已限幅在 MOTOR_MIN_OUTPUT~MOTOR_MAX_OUTPUT） */
+float Thrust_ToCommand(float thrust);
+
+/** 电机指令（%）→ 当前电压下的推力（%），用于换算混控上限与悬停油门 */
+float Thrust_FromCommand(float cmd);
+
+/** 注册线性化表与使能开关到VOFA */
+void Thrust_RegisterVofa(void);
+
+extern ThrustCurve_t g_thrust;
+
+#endif
@@ -12,7 +12,7 @@ void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
   }
 	else if(huart->Instance == USART6)
   {
-		elrs_receive_data();
+		elrs_receive_data(Size);
   }
 	else if(huart->Instance == USART3)
   {
@@ -20,7 +20,7 @@ void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
   }
 	else if(huart->Instance == USART2)
   {
-		T1Plus_receive_data();
+		T1Plus_receive_data(Size);
   }
 }
 
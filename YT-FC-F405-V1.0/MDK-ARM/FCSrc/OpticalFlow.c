@@ -6,6 +6,8 @@
  */
 
 #include "OpticalFlow.h"
+#include "imu.h"
+#include "filter.h"
 #include "math.h"
 
 optical_flow_t optflow = {0};
@@ -17,43 +19,103 @@ optical_flow_t optflow = {0};
 #define STATIC_THRESHOLD    10      
 
 #define HEIGHT_DELTA_MAX    150     
+#define HEIGHT_STEP_CONFIRM 5       // 连续N帧超限视为地面台阶，重新锚定（否则会永久冻结）
 #define LOWPASS_ALPHA       0.15f   
 
+#define DEG_TO_RAD          0.01745329f
+
 static uint32_t last_tick = 0;
 static float height_last = 0;       
+static uint32_t last_frame = 0;     // 上次处理的T1Plus帧号
+
+static hampel_filter_t height_hampel;           // 高度野值剔除
+static hampel_filter_t vel_hampel_x, vel_hampel_y; // 速度野值剔除
+static movavg_filter_t speed_avg;               // 速率滑动均值（静止判定）
+
+/** @brief 陀螺历史（环形缓冲，按光流轴映射后的角速度 °/s） */
+static struct {
+    uint32_t tick[OF_GYRO_HIST_LEN];
+    float rate_x[OF_GYRO_HIST_LEN];
+    float rate_y[OF_GYRO_HIST_LEN];
+    uint8_t head;                   // 下一个写入位置
+    uint8_t count;
+} gyro_hist;
 
 /**
- * @brief  中值滤波（3点窗口）
+ * @brief  记录本周期陀螺角速度（每个控制周期调用一次）
  */
-static float median_filter_3(float new_val)
+static void gyro_hist_push(uint32_t tick)
 {
-    static float buf[3] = {0};
-    static uint8_t idx = 0;
-    
-    buf[idx] = new_val;
-    idx = (idx + 1) % 3;
+    gyro_hist.tick[gyro_hist.head]   = tick;
+    gyro_hist.rate_x[gyro_hist.head] = OF_COMP_X_SIGN * imu.gy;
+    gyro_hist.rate_y[gyro_hist.head] = OF_COMP_Y_SIGN * imu.gx;
+    gyro_hist.head = (gyro_hist.head + 1) % OF_GYRO_HIST_LEN;
+    if (gyro_hist.count < OF_GYRO_HIST_LEN) gyro_hist.count++;
+}
+
+/**
+ * @brief  积分 [t_start, t_end] 窗口内的机体转角 (rad)
+ * @note   每个采样代表其与上一采样之间的区间（零阶保持），按重叠时长加权；
+ *         历史不足以覆盖窗口时返回0（不补偿）
+ */
+static uint8_t gyro_hist_integrate(int32_t t_start, int32_t t_end, float *ang_x, float *ang_y)
+{
+    float sum_x = 0.0f, sum_y = 0.0f;
+    uint8_t covered = 0;
     
-    float a = buf[0], b = buf[1], c = buf[2];
-    float temp;
+    *ang_x = *ang_y = 0.0f;
+    if (gyro_hist.count < 2 || t_end <= t_start) return 0;
     
-    if (a > b) { temp = a; a = b; b = temp; }
-    if (b > c) { temp = b; b = c; c = temp; }
-    if (a > b) { temp = a; a = b; b = temp; }
+    uint8_t idx = (gyro_hist.head + OF_GYRO_HIST_LEN - 1) % OF_GYRO_HIST_LEN;
+    for (uint8_t n = 0; n + 1 < gyro_hist.count; n++) {
+        uint8_t prev = (idx + OF_GYRO_HIST_LEN - 1) % OF_GYRO_HIST_LEN;
+        int32_t seg_end   = (int32_t)gyro_hist.tick[idx];
+        int32_t seg_start = (int32_t)gyro_hist.tick[prev];
+        
+        if (seg_end <= t_start) { covered = 1; break; } // 已越过窗口起点
+        
+        int32_t lo = (seg_start > t_start) ? seg_start : t_start;
+        int32_t hi = (seg_end < t_end) ? seg_end : t_end;
+        if (hi > lo) {
+            sum_x += gyro_hist.rate_x[idx] * (float)(hi - lo);
+            sum_y += gyro_hist.rate_y[idx] * (float)(hi - lo);
+        }
+        if (seg_start <= t_start) { covered = 1; break; }
+        idx = prev;
+    }
     
-    return b;  
+    if (!covered) return 0;
+    *ang_x = sum_x * 0.001f * DEG_TO_RAD;
+    *ang_y = sum_y * 0.001f * DEG_TO_RAD;
+    return 1;
+}
+
+/* 复位全部滤波器窗口（初始化/重新上线时，避免旧数据参与判定） */
+static void filters_reset(void)
+{
+    hampel_reset(&height_hampel);
+    hampel_reset(&vel_hampel_x);
+    hampel_reset(&vel_hampel_y);
+    movavg_reset(&speed_avg);
 }
 
 /**
- * @brief  高度三级滤波：中值 -> 限幅 -> 低通
+ * @brief  高度三级滤波：Hampel -> 限幅 -> 低通
+ * @note   Hampel只替换野值，正常样本不经过中值，不引入额外延时
  */
 static float filter_height(float raw_height)
 {
-    float median = median_filter_3(raw_height);
+    static uint8_t step_count = 0;
+    float median = hampel_update(&height_hampel, raw_height);
     
     float delta = median - height_last;
     if (fabsf(delta) > HEIGHT_DELTA_MAX) {
-        return height_last;  
+        if (++step_count < HEIGHT_STEP_CONFIRM) {
+            return height_last;  
+        }
+        height_last = median;
     }
+    step_count = 0;
     
     float filtered = LOWPASS_ALPHA * median + (1.0f - LOWPASS_ALPHA) * height_last;
     height_last = filtered;
@@ -61,24 +123,46 @@ static float filter_height(float raw_height)
 }
 
 /**
- * @brief  计算运动学参数（仅在数据有效时调用）
+ * @brief  计算运动学参数（仅在新的有效帧到达时调用）
+ * @note   光流角位移 = 平移/高度 + 机体转角，先扣除同一积分窗口内的陀螺转角，
+ *         再乘倾角修正后的高度得到平移量
  */
 static void calculate_motion(const t1plus *raw)
 {
     float dt_s = raw->integration_timespan / 1000000.0f;
     if (dt_s < 0.001f) dt_s = 0.01f;
     
-    float dx = raw->actual_flow_x;
-    float dy = raw->actual_flow_y;
+    float flow_x = raw->flow_x_integral / 10000.0f;  // rad
+    float flow_y = raw->flow_y_integral / 10000.0f;
+    float rot_x = 0.0f, rot_y = 0.0f;
+    
+    int32_t t_end   = (int32_t)raw->timestamp - OF_FLOW_DELAY_MS;
+    int32_t t_start = t_end - (int32_t)(raw->integration_timespan / 1000U);
+    optflow.flow_tick  = (uint32_t)((t_start + t_end) / 2);
+    optflow.range_tick = (uint32_t)t_end;
+    
+    // 窗口转角始终计算（gyro_rate_x/y 供标定补偿符号），只在开启补偿时扣除
+    gyro_hist_integrate(t_start, t_end, &rot_x, &rot_y);
+    
+    optflow.flow_rate_x = flow_x / dt_s;
+    optflow.flow_rate_y = flow_y / dt_s;
+    optflow.gyro_rate_x = rot_x / dt_s;
+    optflow.gyro_rate_y = rot_y / dt_s;
+    
+#if !OF_GYRO_COMP_ENABLE
+    rot_x = rot_y = 0.0f;
+#endif
     
-    optflow.vel_x = dx / dt_s;
-    optflow.vel_y = dy / dt_s;
+    // 单帧速度野值（纹理突变、反光）以窗口中值替代，位移按滤波后速度累加
+    optflow.vel_x = hampel_update(&vel_hampel_x, (flow_x - rot_x) * optflow.height_tilt / dt_s);
+    optflow.vel_y = hampel_update(&vel_hampel_y, (flow_y - rot_y) * optflow.height_tilt / dt_s);
+    optflow.outlier_count = height_hampel.outliers + vel_hampel_x.outliers + vel_hampel_y.outliers;
     
-    optflow.pos_x += dx;
-    optflow.pos_y += dy;
+    optflow.pos_x += optflow.vel_x * dt_s;
+    optflow.pos_y += optflow.vel_y * dt_s;
     
     float speed = sqrtf(optflow.vel_x * optflow.vel_x + optflow.vel_y * optflow.vel_y);
-    optflow.is_moving = (speed > STATIC_THRESHOLD) ? 1 : 0;
+    optflow.is_moving = (movavg_update(&speed_avg, speed) > STATIC_THRESHOLD) ? 1 : 0;
 }
 
 void optical_flow_init(void)
@@ -87,6 +171,13 @@ void optical_flow_init(void)
     T1Plus_init();
     last_tick = 0;
     height_last = 0;
+    last_frame = 0;
+    memset(&gyro_hist, 0, sizeof(gyro_hist));
+    
+    hampel_init(&height_hampel, OF_HAMPEL_K, OF_HEIGHT_MIN_SIGMA);
+    hampel_init(&vel_hampel_x, OF_HAMPEL_K, OF_VEL_MIN_SIGMA);
+    hampel_init(&vel_hampel_y, OF_HAMPEL_K, OF_VEL_MIN_SIGMA);
+    movavg_init(&speed_avg, OF_SPEED_AVG_N);
 }
 
 void optical_flow_reset(void)
@@ -105,6 +196,8 @@ void optical_flow_update(void)
     uint32_t now = HAL_GetTick();
     const t1plus *raw = &t1plus_data;
     
+    gyro_hist_push(now);  // 每周期记录陀螺，供光流帧按时间戳对齐补偿
+    
     /* ========== 步骤1：超时检测（掉线保护）========== */
     if (now - last_tick > OFFLINE_TIMEOUT) {
         // 刚掉线时清零状态
@@ -115,6 +208,7 @@ void optical_flow_update(void)
             optflow.vel_x = 0;
             optflow.vel_y = 0;
             optflow.is_moving = 0;
+            filters_reset();
         }
         // 已处于离线状态，直接返回，不再积分
         return;
@@ -144,15 +238,26 @@ void optical_flow_update(void)
         return;
     }
     
-    /* ========== 步骤4：正常数据更新 ========== */
+    /* ========== 步骤4：正常数据更新（仅处理新帧，避免同一帧被重复积分）========== */
+    if (raw->frame_count == last_frame) {
+        return;
+    }
+    last_frame = raw->frame_count;
+    
     optflow.online = 1;
     optflow.valid = 1;
     optflow.quality = raw->laser_confidence;
     optflow.height = raw_height;
-    optflow.height_filtered = filter_height(raw_height);
+    
+    // 倾角修正：激光沿机体Z轴测斜距，垂直高度 = 斜距 * cos(pitch) * cos(roll)
+    float tilt_cos = cosf(imu.pitch * DEG_TO_RAD) * cosf(imu.roll * DEG_TO_RAD);
+    if (tilt_cos < OF_TILT_COS_MIN) tilt_cos = OF_TILT_COS_MIN;
+    optflow.height_tilt = raw_height * tilt_cos;
+    optflow.height_filtered = filter_height(optflow.height_tilt);
     
     // 只有数据完全有效时才计算运动和积分
     calculate_motion(raw);
+    optflow.frame_count = last_frame;
     
     // 更新时间戳（关键：只有成功处理有效数据才刷新时间戳）
     last_tick = now;
@@ -2,8 +2,8 @@
  * @file       OpticalFlow.h
  * @author	   lsl-sys
  * @brief      T1-001plus Optical Flow Navigation with Height Filtering
- * @version    V1.2.0
- * @date       2026-02-14 2026-02-15
+ * @version    V1.4.0
+ * @date       2026-02-14 2026-02-15 2026-02-23
  * @Encoding   UTF-8 
  */
 
@@ -18,7 +18,8 @@ typedef struct {
     uint8_t valid;               // 数据有效：1-可用，0-超界/置信度不足
     
     float height;                // 原始激光高度 (mm)
-    float height_filtered;       // 滤波后高度 (mm)
+    float height_tilt;           // 倾角修正后垂直高度 (mm)
+    float height_filtered;       // 滤波后高度 (mm，基于倾角修正高度)
     uint8_t quality;             // 数据质量 0-100%
     
     float vel_x;                 // X方向速度 (mm/s)
@@ -29,8 +30,37 @@ typedef struct {
     
     uint8_t is_moving;           // 运动状态：1-移动中，0-静止
     
+    float flow_rate_x;           // 原始光流角速率 (rad/s)
+    float flow_rate_y;
+    float gyro_rate_x;           // 同一积分窗口内的机体转动角速率 (rad/s，已按光流轴映射)
+    float gyro_rate_y;
+    uint32_t frame_count;        // 已处理的光流帧号
+    uint32_t flow_tick;          // 本帧速度对应时刻（积分窗口中点，ms），供延时融合
+    uint32_t range_tick;         // 本帧高度对应时刻（ms）
+    uint32_t outlier_count;      // Hampel剔除的高度/速度野值累计数
+    
 } optical_flow_t;
 
+/* 陀螺仪旋转补偿：光流积分窗口内的机体转动会被误判为平移，需按时间戳对齐后扣除
+ * 补偿方向取决于T1Plus在机架上的安装朝向（仓库内无安装方向资料，无法由WT901C轴系推出），
+ * 符号未实测前默认关闭：符号反了补偿会把转动误差放大一倍。
+ * 实测方法：离地手持原地横滚/俯仰晃动，观察 flow_rate_x 与 gyro_rate_x（flow_rate_y 与 gyro_rate_y）
+ * 同相则符号为+1，反相改为-1；确认晃动时 vel_x/vel_y≈0 后再打开。 */
+#ifndef OF_GYRO_COMP_ENABLE
+#define OF_GYRO_COMP_ENABLE     0       // 1-开启（需先按上述方法确认 OF_COMP_X/Y_SIGN）
+#endif
+#define OF_GYRO_HIST_LEN        32      // 陀螺历史长度（100Hz下320ms，需覆盖积分时间+延时）
+#define OF_FLOW_DELAY_MS        5       // 光流帧相对接收时刻的延时（传输+处理），积分窗口整体前移
+#define OF_COMP_X_SIGN          1.0f    // 光流X ← 横滚角速度(gy)，未实测
+#define OF_COMP_Y_SIGN          1.0f    // 光流Y ← 俯仰角速度(gx)，未实测
+#define OF_TILT_COS_MIN         0.7f    // 倾角修正下限（约45°，超出后不再放大）
+
+/* 野值剔除（Hampel，5帧窗口）与静止判定 */
+#define OF_HAMPEL_K             3.0f    // 偏离中值超过3σ视为野值
+#define OF_HEIGHT_MIN_SIGMA     10.0f   // 高度σ下限 (mm)，悬停时读数几乎不变也不误剔
+#define OF_VEL_MIN_SIGMA        40.0f   // 速度σ下限 (mm/s)
+#define OF_SPEED_AVG_N          5       // 静止判定速率均值窗口（帧）
+
 void optical_flow_init(void);
 void optical_flow_update(void);
 void optical_flow_reset(void);
@@ -4,7 +4,7 @@
 /**
  * @brief 外部变量引用
  */
-extern rc_raw_ch rc_raw_channels;  /* ELRS解析后的原始遥控器数据（范围-100~100） */
+extern rc_raw_ch rc_raw_channels;  /* ELRS解析后的原始遥控器数据（范围-100.0~100.0） */
 
 /**
  * @brief 全局变量定义
@@ -38,7 +38,7 @@ static uint8_t last_connected = 1;  /* 上一帧的连接状态：1-正常，0-
  * @return 1-有效，0-无效
  * @note   按钮通道通常只有按下/松开两种状态，此处完全信任硬件
  */
-static uint8_t is_valid_button(int8_t current, int8_t last, uint8_t channel) {
+static uint8_t is_valid_button(float current, float last, uint8_t channel) {
     (void)last; (void)channel;  // 消除未使用参数警告
     return 1;  // 完全放行，不做限制
 }
@@ -51,7 +51,7 @@ static uint8_t is_valid_button(int8_t current, int8_t last, uint8_t channel) {
  * @note   自恢复按钮特性：松手自动回弹到-100，按下时为100
  *         必须允许从100自动回到-100的过程
  */
-static uint8_t is_valid_se_switch(int8_t current, int8_t last) {
+static uint8_t is_valid_se_switch(float current, float last) {
     // 松开状态：-100附近（允许±10误差）
     if (current >= -100 && current <= -90) return 1;
     
@@ -71,7 +71,7 @@ static uint8_t is_valid_se_switch(int8_t current, int8_t last) {
  * @return 1-有效，0-无效
  * @note   三状态开关只有三个合法位置：-100（下）、0（中）、100（上）
  */
-static uint8_t is_valid_three_state(int8_t current, int8_t last) {
+static uint8_t is_valid_three_state(float current, float last) {
     (void)last;
     // 三个状态位置，各允许±10的抖动范围
     if ((current >= -100 && current <= -90) ||  // 下档
@@ -90,10 +90,11 @@ static uint8_t is_valid_three_state(int8_t current, int8_t last) {
  * @note   滚轮常见异常值：-35、-65等固定尖峰
  *         正常范围应在-100~100之间
  */
-static uint8_t is_valid_roller(int8_t current, int8_t last) {
+static uint8_t is_valid_roller(float current, float last) {
     (void)last;
-    // 排除已知的异常尖峰值
-    if (current == -35 || current == -65) return 0;
+    // 排除已知的异常尖峰值（按原整数量化后的取值比较）
+    int16_t q = (int16_t)floorf(current);
+    if (q == -35 || q == -65) return 0;
     
     // 排除超界值
     if (current < -100 || current > 100) return 0;
@@ -101,6 +102,22 @@ static uint8_t is_valid_roller(int8_t current, int8_t last) {
     return 1;
 }
 
+/**
+ * @brief  摇杆通道单帧跳变阈值
+ * @return 按实测帧间隔缩放后的阈值，不低于 RC_STICK_JUMP_LIMIT，不高于 RC_STICK_JUMP_MAX
+ * @note   阈值对应固定的打杆速度：50Hz链路一帧的正常变化是250Hz的5倍，固定阈值会把快速打杆整帧丢弃
+ */
+static float stick_jump_limit(void) {
+#if ELRS_USE_CRSF
+    float limit = RC_STICK_JUMP_LIMIT * crsf_health.interval_ms / RC_STICK_JUMP_REF_MS;
+    if (limit < RC_STICK_JUMP_LIMIT) limit = RC_STICK_JUMP_LIMIT;
+    if (limit > RC_STICK_JUMP_MAX) limit = RC_STICK_JUMP_MAX;
+    return limit;
+#else
+    return RC_STICK_JUMP_LIMIT;
+#endif
+}
+
 /**
  * @brief  整帧数据一致性检查
  * @param  raw 指向原始数据的指针
@@ -115,20 +132,21 @@ static uint8_t is_valid_frame(rc_raw_ch *raw) {
     }
     
     uint8_t abnormal_count = 0;
+    float stick_limit = stick_jump_limit();
     
-    // 摇杆通道（ch1-ch4）：检测小幅跳变（>10视为异常）
+    // 摇杆通道（ch1-ch4）：检测小幅跳变（250Hz下>10视为异常，按帧间隔缩放）
     // 注意：这里是与last_valid_rc比较，不是与当前raw比较
-    if (abs(raw->ch1 - last_valid_rc.RX) > 10) abnormal_count++;
-    if (abs(raw->ch2 - last_valid_rc.RY) > 10) abnormal_count++;
-    if (abs(raw->ch3 - last_valid_rc.LY) > 10) abnormal_count++;
-    if (abs(raw->ch4 - last_valid_rc.LX) > 10) abnormal_count++;
+    if (fabsf(raw->ch1 - last_valid_rc.RX) > stick_limit) abnormal_count++;
+    if (fabsf(raw->ch2 - last_valid_rc.RY) > stick_limit) abnormal_count++;
+    if (fabsf(raw->ch3 - last_valid_rc.LY) > stick_limit) abnormal_count++;
+    if (fabsf(raw->ch4 - last_valid_rc.LX) > stick_limit) abnormal_count++;
     
     // 开关通道（ch5-ch9）：检测大幅跳变（>50视为异常）
-    if (abs(raw->ch5 - last_valid_rc.SA) > 50) abnormal_count++;
-    if (abs(raw->ch6 - last_valid_rc.SB) > 50) abnormal_count++;
-    if (abs(raw->ch7 - last_valid_rc.SC) > 50) abnormal_count++;
-    if (abs(raw->ch8 - last_valid_rc.SD) > 50) abnormal_count++;
-    if (abs(raw->ch9 - last_valid_rc.SE) > 50) abnormal_count++;
+    if (fabsf(raw->ch5 - last_valid_rc.SA) > RC_SWITCH_JUMP_LIMIT) abnormal_count++;
+    if (fabsf(raw->ch6 - last_valid_rc.SB) > RC_SWITCH_JUMP_LIMIT) abnormal_count++;
+    if (fabsf(raw->ch7 - last_valid_rc.SC) > RC_SWITCH_JUMP_LIMIT) abnormal_count++;
+    if (fabsf(raw->ch8 - last_valid_rc.SD) > RC_SWITCH_JUMP_LIMIT) abnormal_count++;
+    if (fabsf(raw->ch9 - last_valid_rc.SE) > RC_SWITCH_JUMP_LIMIT) abnormal_count++;
     
     // 如果3个及以上通道同时突变，判定为整帧错误（如DMA错位）
     if (abnormal_count >= 3) {
@@ -258,12 +276,12 @@ void rc_filter_process(void) {
     }
     
     // 缓存非摇杆通道的原始值（避免在多个检查中重复访问结构体）
-    int8_t raw_ch5 = rc_raw_channels.ch5;
-    int8_t raw_ch6 = rc_raw_channels.ch6;
-    int8_t raw_ch7 = rc_raw_channels.ch7;
-    int8_t raw_ch8 = rc_raw_channels.ch8;
-    int8_t raw_ch9 = rc_raw_channels.ch9;
-    int8_t raw_ch10 = rc_raw_channels.ch10;
+    float raw_ch5 = rc_raw_channels.ch5;
+    float raw_ch6 = rc_raw_channels.ch6;
+    float raw_ch7 = rc_raw_channels.ch7;
+    float raw_ch8 = rc_raw_channels.ch8;
+    float raw_ch9 = rc_raw_channels.ch9;
+    float raw_ch10 = rc_raw_channels.ch10;
     
     // 整帧一致性检查
     if (is_valid_frame(&rc_raw_channels)) {
@@ -278,16 +296,16 @@ void rc_filter_process(void) {
         filtered_rc.LX = rc_raw_channels.ch4;
         
         // 尖峰过滤：只允许保持或小幅变化，不允许突跳到-100
-        if (last_valid_rc.RX > -50 && filtered_rc.RX == -100) {
+        if (last_valid_rc.RX > -50 && filtered_rc.RX <= RC_CHANNEL_MIN) {
             filtered_rc.RX = last_valid_rc.RX;
         }
-        if (last_valid_rc.RY > -50 && filtered_rc.RY == -100) {
+        if (last_valid_rc.RY > -50 && filtered_rc.RY <= RC_CHANNEL_MIN) {
             filtered_rc.RY = last_valid_rc.RY;
         }
-        if (last_valid_rc.LY > -50 && filtered_rc.LY == -100) {
+        if (last_valid_rc.LY > -50 && filtered_rc.LY <= RC_CHANNEL_MIN) {
             filtered_rc.LY = last_valid_rc.LY;
         }
-        if (last_valid_rc.LX > -50 && filtered_rc.LX == -100) {
+        if (last_valid_rc.LX > -50 && filtered_rc.LX <= RC_CHANNEL_MIN) {
             filtered_rc.LX = last_valid_rc.LX;
         }
         
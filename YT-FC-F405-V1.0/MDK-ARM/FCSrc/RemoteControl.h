@@ -2,8 +2,8 @@
  * @file       RemoteControl.h
  * @author	   lsl-sys
  * @brief      遥控器数据滤波
- * @version    V1.1.0
- * @date       2026-1-11 2026-2-12
+ * @version    V1.2.0
+ * @date       2026-1-11 2026-2-12 2026-2-24
  * @Encoding   UTF-8
  */
 #ifndef __REMOTECONTROL_H
@@ -21,10 +21,14 @@
 #define CH9_PRESSED_THRESHOLD 90                  /*CH9自恢复按钮按下阈值 */
 #define THREE_STATE_VALID_VALUES { -100, 0, 100 } /*三状态开关有效取值 */
 #define ROLLER_SPIKE_THRESHOLD -30                /* 滚轮通道尖峰检测阈值 */
+#define RC_STICK_JUMP_LIMIT 10.0f                 /* 摇杆通道单帧跳变阈值（整帧检查，对应 RC_STICK_JUMP_REF_MS 帧间隔） */
+#define RC_STICK_JUMP_REF_MS 4.0f                 /* 上述阈值对应的帧间隔（250Hz），实际阈值按实测帧间隔缩放 */
+#define RC_STICK_JUMP_MAX 50.0f                   /* 缩放后阈值上限（低包速率或间隔未收敛时仍能识别错帧） */
+#define RC_SWITCH_JUMP_LIMIT 50.0f                /* 开关通道单帧跳变阈值（整帧检查） */
 
 /**
  * @brief 滤波后遥控器数据结构体
- * 包含10个通道的滤波后数据，带通道命名
+ * 包含10个通道的滤波后数据，带通道命名（全分辨率 -100.0~100.0）
  */
 typedef struct {
     float RX;    /*!< 右摇杆x轴（横滚） */
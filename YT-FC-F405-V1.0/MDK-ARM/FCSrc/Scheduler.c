@@ -20,7 +20,7 @@ static uint8_t Is_Control_Allowed(void)
     if (FState_GetState() != STATE_ARMED) return 0;
     if (!g_pid.arm_flag) return 0;
     if (!imu.online || !imu.valid) return 0;
-    if (!elrs_is_connected()) return 0;  // RC必须在线
+    // 遥控丢失不在此禁止输出，由分级失控保护接管
     
     return 1;
 }
@@ -36,13 +36,15 @@ vofa_pid_value vofa_pid = {15,0,0,20};
 
 pidParam_t param;
 
+int autotune_cmd = 0;// VOFA写入"AT:1"启动俯仰/横滚自整定，"AT:-1"中止
+
 Buzzer_HandleTypeDef buzzer = {&htim3,TIM_CHANNEL_4};
 
 const MotorHandle_t g_motors[MOTOR_COUNT] = {
-    {&htim4, TIM_CHANNEL_1},  // M1 前左 (FL)
-    {&htim2, TIM_CHANNEL_4},  // M2 前右 (FR)  
-    {&htim2, TIM_CHANNEL_3},  // M3 后右 (BR)
-    {&htim4, TIM_CHANNEL_2},  // M4 后左 (BL)
+    {&htim4, TIM_CHANNEL_1, GPIOB, GPIO_PIN_6},   // M1 前左 (FL)
+    {&htim2, TIM_CHANNEL_4, GPIOB, GPIO_PIN_11},  // M2 前右 (FR)  
+    {&htim2, TIM_CHANNEL_3, GPIOB, GPIO_PIN_10},  // M3 后右 (BR)
+    {&htim4, TIM_CHANNEL_2, GPIOB, GPIO_PIN_7},   // M4 后左 (BL)
 };
 
 void FC_init(void)
@@ -52,22 +54,50 @@ void FC_init(void)
 	
 	Propulsion_Init(g_motors);
 	
-	HAL_Delay(2000);//等待硬件与电机初始化，接收机连接遥控器
+	// 等待硬件与电机初始化，接收机连接遥控器；期间每1ms输出最小油门解锁电调
+	// （OneShot/DShot只在触发时输出脉冲，单纯延时电调收不到信号）
+	for (uint32_t t0 = HAL_GetTick(); HAL_GetTick() - t0 < 2000; ) {
+		Propulsion_Stop();
+		HAL_Delay(1);
+	}
 	
 	vofa_init();
 	vofa_login_name("KP",&vofa_pid.kp,TYPE_FLOAT);
 	vofa_login_name("KI",&vofa_pid.ki,TYPE_FLOAT);
 	vofa_login_name("KD",&vofa_pid.kd,TYPE_FLOAT);
 	vofa_login_name("ST",&vofa_pid.iSepThresh,TYPE_FLOAT);
+	GainSched_RegisterVofa();
+	Battery_RegisterVofa();
+	Thrust_RegisterVofa();
+	Telemetry_RegisterVofa();
+	RcSmooth_RegisterVofa();
 	
 	imu_init();
 	
+	Battery_Init();
+	
+	Telemetry_Init();
 	rc_init();
+	RcSmooth_Init();
 	
 	optical_flow_init();
 	
-	PID_InitAll(15.0f);
+	nav_ekf_init();
+	alt_est_init();
+	
+	PID_InitAll(Thrust_FromCommand(15.0f));// 悬停油门15%指令换算为推力
 	PID_SetMode(MODE_ANGLE);
+	FMode_Init();
+	RpmFilter_Init();
+	PID_SetFeedForwardSmoothing(1.0f / ELRS_PACKET_RATE);// 前馈平滑按遥控帧率
+	
+	vofa_login_name("FFP",&g_pid.attitude.rate.pitch.kff,TYPE_FLOAT);
+	vofa_login_name("FFR",&g_pid.attitude.rate.roll.kff,TYPE_FLOAT);
+	vofa_login_name("FFY",&g_pid.attitude.rate.yaw.kff,TYPE_FLOAT);
+	vofa_login_name("AGP",&g_pid.attitude.anti_gravity.gain[AXIS_PITCH],TYPE_FLOAT);
+	vofa_login_name("AGR",&g_pid.attitude.anti_gravity.gain[AXIS_ROLL],TYPE_FLOAT);
+	vofa_login_name("AT",&autotune_cmd,TYPE_INT);
+	vofa_login_name("HH",&g_pid.attitude.heading.enabled,TYPE_BOOL);
 
 	Scheduler_Setup();
 	
@@ -80,7 +110,9 @@ void FC_init(void)
 
 static void Loop_1000Hz(void)
 {
-
+#if RC_EVENT_DRIVEN
+    RcSmooth_Process();// 逐帧滤波并插值摇杆设定值
+#endif
 }
 
 static void Loop_500Hz(void)
@@ -95,16 +127,31 @@ static void Loop_200Hz(void)
 
 static void Loop_100Hz(void)
 {
+	  bool vofa_updated = vofa_get_flag_of_receive();
 	  vofa_analysis_data();
+	  if (vofa_updated) {
+	      GainSched_Rebuild();// 调度表可能被在线修改，重算斜率
+	      Thrust_Rebuild();
+	  }
 	  
     wt901c_analysis_data();
     imu_update();
+    RpmFilter_Update();// 按上一帧DShot回传的电机转速更新陷波
+    if (imu.valid) {
+        RpmFilter_Apply(&imu.gx, &imu.gy, &imu.gz);
+    }
+    
+#if !RC_EVENT_DRIVEN
+    RcSmooth_Process();
+#endif
     
-    elrs_analysis_data();
-    rc_filter_process();
+    Battery_Update();
+    Thrust_SetVoltage(Battery_GetVoltage());
     
     T1Plus_analysis_data();
     optical_flow_update();
+    nav_ekf_update();
+    alt_est_update();
     
     FState_Update();
     
@@ -115,8 +162,13 @@ static void Loop_100Hz(void)
         if (curr_state == STATE_ARMED) {
             Set_Arm_Flag(1);
             PID_SystemReset();// 状态变化时重置PID（防止积分累积）
+            nav_ekf_reset();// 水平位置以解锁点为原点
+            alt_est_reset();
+            FMode_Reset();// 按开关与传感器状态直接进入可用模式
+            Failsafe_Reset();
         } else {
             Set_Arm_Flag(0);
+            AutoTune_Abort();
             __disable_irq();// 退出ARMED时强制清零输出（紧急制动）
             g_pid.out.throttle = 0;
             g_pid.out.pitch = 0;
@@ -128,7 +180,7 @@ static void Loop_100Hz(void)
     }
     
     if (curr_state == STATE_ARMED) {//200Hz 紧急保护
-        if (!imu.online || !elrs_is_connected()) {// 快速检查：如果IMU或RC异常，立即强制停止（不等待100Hz）
+        if (!imu.online) {// IMU掉线立即停桨（遥控丢失走分级失控保护）
             FState_ForceEmergency();
             Set_Arm_Flag(0);
             Propulsion_Stop();
@@ -140,22 +192,82 @@ static void Loop_100Hz(void)
         return;  // 快速返回，不执行后续计算
     }
     
-    int8_t rc_ry = filtered_rc.RY;
-    int8_t rc_rx = filtered_rc.RX;
-    int8_t rc_lx = filtered_rc.LX;
-    int8_t rc_ly = filtered_rc.LY;
-    int8_t rc_sa = filtered_rc.SA;
-    int8_t rc_sd = filtered_rc.SD;
+    // 全分辨率通道值（-100.0~100.0），摇杆取按帧间隔插值后的设定值
+    float rc_rx = g_rc_smooth.out[0];
+    float rc_ry = g_rc_smooth.out[1];
+    float rc_ly = g_rc_smooth.out[2];
+    float rc_lx = g_rc_smooth.out[3];
+    float rc_sa = filtered_rc.SA;
+    float rc_sb = filtered_rc.SB;
+    float rc_sc = filtered_rc.SC;
+    float rc_sd = filtered_rc.SD;
+    
+    // 分级失控保护：遥控丢失后摇杆回中并请求定点（逐级降级），保持→受控下降→触地上锁
+    Failsafe_Update(elrs_is_connected(), rc_sa > 80 && rc_sd > 80);
+    uint8_t fs_active = Failsafe_IsActive();
+    if (g_failsafe.stage == FS_LANDED) {
+        FState_Disarm();
+        Propulsion_Stop();
+        return;
+    }
+    if (fs_active) {
+        AutoTune_Abort();
+        rc_rx = rc_ry = rc_lx = 0.0f;
+        rc_sb = 100.0f;
+        rc_sc = -100.0f;
+    }
     
-    if (abs(rc_ry) > 100 || abs(rc_rx) > 100) {// 检查摇杆有效性（防止滤波器输出异常值）
+    if (fabsf(rc_ry) > 100.0f || fabsf(rc_rx) > 100.0f) {// 检查摇杆有效性（防止滤波器输出异常值）
         FState_ForceEmergency();
         return;
     }
     
-    target_pitch = PID_StickToAngle(rc_ry);
-    target_roll  = PID_StickToAngle(rc_rx);
+    float throttle = (rc_ly + 100.0f) / 2.0f;
+    if (throttle < 0) throttle = 0;
+    if (throttle > 100) throttle = 100;
+    
+    // 模式管理：SB/SC查表选模式，检查传感器前置条件，切换时无扰衔接定高/定点/姿态外环
+    FMode_Update(rc_sb, rc_sc, throttle);
+    
+    if (FMode_Active()->attitude == MODE_RATE) {
+        target_pitch = PID_StickToRate(rc_ry);
+        target_roll  = PID_StickToRate(rc_rx);
+    } else {
+        target_pitch = PID_StickToAngle(rc_ry);
+        target_roll  = PID_StickToAngle(rc_rx);
+    }
     target_yaw   = PID_StickToRate(rc_lx);
     
+    // 定点：摇杆改为速度指令（光流短暂无效时退回摇杆角度）
+    if (g_pid.position.enabled) {
+        if (fabsf(target_yaw) > HEADING_STICK_DEADBAND) {
+            g_pid.position.locked = 0;// 转机头时机体系位移失效，转完后重新锁点
+        }
+        PID_UpdatePosHold(rc_rx, rc_ry,
+                          nav.pos[NAV_AXIS_X], nav.pos[NAV_AXIS_Y],
+                          nav.vel[NAV_AXIS_X], nav.vel[NAV_AXIS_Y], nav.horiz_valid,
+                          &target_pitch, &target_roll);
+    }
+    
+    // 定高：中位油门杆=保持高度；失控时由失控保护给定爬升率
+    if (fs_active) {
+        throttle = Failsafe_Throttle();
+    } else if (g_pid.altitude.enabled) {
+        throttle = PID_UpdateAltHold(rc_ly, alt_est.alt, alt_est.vel, alt_est.valid);
+    }
+    
+    FMode_ShapeSetpoints(&target_pitch, &target_roll, &throttle);
+    
+    // 输出端已做电压补偿时增益调度不再按电压放大，避免重复补偿
+    GainSched_Update(throttle, g_thrust.vcomp_enabled ? 0.0f : Battery_GetVoltage());
+    PID_UpdateAntiGravity(throttle);
+    if (!g_mixer.airmode_latched) {
+        PID_ResetRateIntegral();// 起飞前不积分：地面倾斜/陀螺零偏不会积分成零油门下的电机转速
+    }
+    
+    // 上周期混控削顶方向反馈给角速度环（抗积分饱和）
+    const MixSaturation_t *mix_sat = Propulsion_GetSaturation();
+    PID_SetRateSaturation(mix_sat->pitch, mix_sat->roll, mix_sat->yaw);
     
     uint8_t fault = PID_UpdateAttitude(
         target_pitch, target_roll, target_yaw,
@@ -169,22 +281,36 @@ static void Loop_100Hz(void)
         return;
     }
     
-    float throttle = (rc_ly + 100.0f) / 2.0f;
-    if (throttle < 0) throttle = 0;
-    if (throttle > 100) throttle = 100;
+    // 自整定：VOFA指令启动/中止，运行中覆盖当前轴输出，结束后回到自稳
+    if (autotune_cmd > 0 && !AutoTune_IsActive() && FMode_Active()->attitude == MODE_ANGLE) {
+        PID_SetMode(MODE_AUTOTUNE);
+        AutoTune_Start(AT_AXIS_PITCH | AT_AXIS_ROLL);
+    } else if (autotune_cmd < 0) {
+        AutoTune_Abort();
+    }
+    autotune_cmd = 0;
+    
+    if (g_pid.attitude.mode == MODE_AUTOTUNE) {
+        AutoTune_Update(imu.gx, imu.gy, imu.gz, imu.pitch, imu.roll);
+        if (!AutoTune_IsActive()) {
+            PID_SetMode(FMode_Active()->attitude);
+        }
+    }
     
     __disable_irq();
     g_pid.out.throttle = throttle;
     __enable_irq();
     
-    // SA和SD拨到高位才允许输出
-    if (rc_sa > 80 && rc_sd > 80) {
+    // SA和SD拨到高位才允许输出（失控期间沿用丢失前的开关状态）
+    uint8_t out_enable = fs_active ? g_failsafe.out_enable : (rc_sa > 80 && rc_sd > 80);
+    if (out_enable) {
         Propulsion_MixOutput(
             g_pid.out.throttle,
             g_pid.out.pitch,
             g_pid.out.roll,
-            0  // yaw输出
+            g_pid.out.yaw
         );
+        RcSmooth_MarkOutput();
     } else {
         Propulsion_Stop();// 安全开关未打开，保持怠速或停止
     }
@@ -194,8 +320,34 @@ static void Loop_50Hz(void)
 { 
 }
 
+#define LINK_ALARM_VOLUME   30      // 链路预警鸣响音量 (%)
+
+/**
+ * @brief  链路预警鸣响（非阻塞，10Hz调用）
+ * @note   WARN：每秒短鸣一次；CRITICAL：0.1s间隔连续鸣响；只在状态变化时写音量，不影响其他鸣响
+ */
+static void Link_Alarm(void)
+{
+    static uint8_t phase = 0;
+    static uint8_t last_on = 0;
+    uint8_t level = elrs_link_level();
+    uint8_t on = 0;
+
+    phase = (phase + 1) % 10;
+    if (level == CRSF_LINK_WARN) {
+        on = (phase == 0);
+    } else if (level == CRSF_LINK_CRITICAL) {
+        on = phase & 1;
+    }
+    if (on != last_on) {
+        Buzzer_SetVolume(&buzzer, on ? LINK_ALARM_VOLUME : 0);
+        last_on = on;
+    }
+}
+
 static void Loop_10Hz(void)
 {
+    Link_Alarm();
 //	printf("[RC  PRY]:%.2f,%.2f,%.2f\r\n",target_pitch,target_roll,target_yaw);	
 //	printf("[PRY]:%d,%.2f,%.2f,%.2f\r\n",wt901c_data.online,wt901c_data.pitch,wt901c_data.roll,wt901c_data.yaw);
 //	printf("[PRY]:%.2f,%.2f,%.2f\r\n",wt901c_data.pitch,wt901c_data.roll,wt901c_data.yaw);
@@ -19,10 +19,22 @@
 #include "T1Plus.h"
 #include "RemoteControl.h"
 #include "pid_control.h"
+#include "pid_schedule.h"
+#include "autotune.h"
 #include "Buzzer.h"
+#include "Battery.h"
+#include "thrust_curve.h"
+#include "mixer.h"
 #include "flight_state.h"
+#include "flight_mode.h"
+#include "failsafe.h"
 #include "OpticalFlow.h"
+#include "nav_ekf.h"
+#include "alt_estimator.h"
 #include "imu.h"
+#include "rpm_filter.h"
+#include "telemetry.h"
+#include "rc_smoothing.h"
 
 /* 系统时钟频率: 1000Hz（1ms时基） */
 #define TICK_PER_SECOND	1000
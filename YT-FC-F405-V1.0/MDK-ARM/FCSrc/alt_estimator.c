@@ -0,0 +1,152 @@
+#include "alt_estimator.h"
+#include "nav_ekf.h"
+#include "imu.h"
+#include "OpticalFlow.h"
+
+alt_est_t alt_est;
+
+#define ALT_DT_MAX          0.05f   // 单步预测最大步长(s)
+#define ALT_MEAS_DT_MAX     0.2f    // 激光修正最大间隔(s)，丢帧后避免一次修正过猛
+
+static inline float absf(float x) { return x < 0.0f ? -x : x; }
+
+/* 记录高度历史 */
+static void hist_push(uint32_t tick)
+{
+    alt_est.hist[alt_est.hist_head].tick = tick;
+    alt_est.hist[alt_est.hist_head].alt  = alt_est.alt;
+    alt_est.hist_head = (alt_est.hist_head + 1) % ALT_HIST_LEN;
+    if (alt_est.hist_count < ALT_HIST_LEN) alt_est.hist_count++;
+}
+
+/* 取不晚于tick的最近历史高度（历史不足时取最旧一条） */
+static float hist_alt_at(uint32_t tick)
+{
+    uint8_t idx = (alt_est.hist_head + ALT_HIST_LEN - 1) % ALT_HIST_LEN;
+    for (uint8_t n = 0; n + 1 < alt_est.hist_count; n++) {
+        if ((int32_t)(tick - alt_est.hist[idx].tick) >= 0) break;
+        idx = (idx + ALT_HIST_LEN - 1) % ALT_HIST_LEN;
+    }
+    return alt_est.hist[idx].alt;
+}
+
+/* 修正量同步作用于历史，避免下一帧重复修正 */
+static void hist_shift(float d)
+{
+    for (uint8_t i = 0; i < alt_est.hist_count; i++) {
+        alt_est.hist[i].alt += d;
+    }
+}
+
+/**
+ * @brief  台阶检测：连续ALT_STEP_CONFIRM帧新息都超过阈值且彼此一致时确认
+ * @return 1-本帧新息异常（台阶待确认或已重新锚定），不参与修正
+ */
+static uint8_t step_detect(float innov)
+{
+    if (absf(innov) < ALT_STEP_THRESH) {
+        if (alt_est.step_count > 0) alt_est.reject_count++; // 之前的跳变只是野值
+        alt_est.step_count = 0;
+        return 0;
+    }
+
+    if (alt_est.step_count == 0 || absf(innov - alt_est.step_first) > ALT_STEP_SPREAD) {
+        alt_est.step_first = innov;
+        alt_est.step_count = 1;
+    } else {
+        alt_est.step_count++;
+    }
+
+    if (alt_est.step_count >= ALT_STEP_CONFIRM) {
+        // 重新锚定：新息全部归因于地形变化，高度估计保持连续
+        alt_est.terrain -= innov;
+        alt_est.step_events++;
+        alt_est.step_count = 0;
+    }
+    return 1;
+}
+
+void alt_est_init(void)
+{
+    memset(&alt_est, 0, sizeof(alt_est));
+}
+
+void alt_est_reset(void)
+{
+    alt_est.initialized = 0;
+    alt_est.valid = 0;
+    alt_est.vel = 0.0f;
+    alt_est.acc_bias = 0.0f;
+    alt_est.terrain = 0.0f;
+    alt_est.step_count = 0;
+    alt_est.hist_count = 0;
+    alt_est.hist_head = 0;
+    alt_est.last_tick = 0;
+    alt_est.last_frame = optflow.frame_count;
+    alt_est.alt = optflow.valid ? optflow.height_tilt / 10.0f : 0.0f;
+    alt_est.agl = alt_est.alt;
+}
+
+void alt_est_update(void)
+{
+    uint32_t now = HAL_GetTick();
+
+    if (!imu.online || !imu.valid) {
+        alt_est.valid = 0;
+        return;
+    }
+
+    /* ========== 预测：竖直加速度积分 ========== */
+    if (alt_est.last_tick != 0) {
+        float dt = (now - alt_est.last_tick) * 0.001f;
+        if (dt > ALT_DT_MAX) dt = ALT_DT_MAX;
+
+        float acc[NAV_AXIS_COUNT];
+        nav_body_to_level(acc);
+        alt_est.acc = acc[NAV_AXIS_Z] - alt_est.acc_bias;
+
+        alt_est.alt += alt_est.vel * dt + 0.5f * alt_est.acc * dt * dt;
+        alt_est.vel += alt_est.acc * dt;
+    }
+    alt_est.last_tick = now;
+    hist_push(now);
+
+    /* ========== 修正：激光高度（每帧一次，按测量时刻对齐） ========== */
+    if (optflow.valid && optflow.frame_count != alt_est.last_frame) {
+        alt_est.last_frame = optflow.frame_count;
+        float meas = optflow.height_tilt / 10.0f;
+
+        if (!alt_est.initialized) {
+            alt_est.alt = meas;
+            alt_est.vel = 0.0f;
+            alt_est.terrain = 0.0f;
+            hist_shift(meas - hist_alt_at(now));
+            alt_est.initialized = 1;
+            alt_est.last_range_tick = now;
+        }
+
+        float dtm = (now - alt_est.last_range_tick) * 0.001f;
+        if (dtm > ALT_MEAS_DT_MAX) dtm = ALT_MEAS_DT_MAX;
+
+        alt_est.innov = meas - (hist_alt_at(optflow.range_tick) - alt_est.terrain);
+
+        if (!step_detect(alt_est.innov)) {
+            // 三阶互补滤波增益：k1=3/τ, k2=3/τ², k3=1/τ³
+            const float k1 = 3.0f / ALT_CF_TAU;
+            const float k2 = 3.0f / (ALT_CF_TAU * ALT_CF_TAU);
+            const float k3 = 1.0f / (ALT_CF_TAU * ALT_CF_TAU * ALT_CF_TAU);
+
+            float d_alt = k1 * alt_est.innov * dtm;
+            alt_est.alt += d_alt;
+            alt_est.vel += k2 * alt_est.innov * dtm;
+            alt_est.acc_bias -= k3 * alt_est.innov * dtm;
+            if (alt_est.acc_bias > ALT_BIAS_LIMIT)  alt_est.acc_bias = ALT_BIAS_LIMIT;
+            if (alt_est.acc_bias < -ALT_BIAS_LIMIT) alt_est.acc_bias = -ALT_BIAS_LIMIT;
+            hist_shift(d_alt);
+        }
+        alt_est.last_range_tick = now;
+    }
+
+    alt_est.agl = alt_est.alt - alt_est.terrain;
+    alt_est.valid = alt_est.initialized && (now - alt_est.last_range_tick < ALT_MEAS_TIMEOUT);
+}
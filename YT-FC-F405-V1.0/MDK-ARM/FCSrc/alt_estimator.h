@@ -0,0 +1,70 @@
+/**
+ * @file       alt_estimator.h
+ * @author     lsl-sys
+ * @brief      Vertical Complementary Filter (Earth-frame Z Accel + Laser Height, Terrain Step Re-anchoring)
+ * @version    V1.0.0
+ * @date       2026-02-22
+ * @Encoding   UTF-8
+ * @note       三阶互补滤波：加速度积分提供高频响应，激光高度修正低频漂移并估计加速度计零偏。
+ *             估计的是相对起飞点的绝对高度；激光读数 = 高度 - 地形偏移。
+ *             地面台阶（飞越桌面/台阶）表现为连续多帧一致的新息跳变，此时只平移地形偏移
+ *             重新锚定，高度估计保持连续，定高不会因地面变化而突然升降。
+ */
+
+#ifndef __ALT_ESTIMATOR_H
+#define __ALT_ESTIMATOR_H
+
+#include "main.h"
+
+/* 互补滤波时间常数：越小越信任激光，越大越信任加速度 */
+#define ALT_CF_TAU              0.5f    // s
+
+/* 地形台阶检测 */
+#define ALT_STEP_THRESH         12.0f   // 新息超过该值(cm)视为疑似台阶/野值
+#define ALT_STEP_CONFIRM        3       // 连续N帧一致才确认台阶（单帧跳变视为野值丢弃）
+#define ALT_STEP_SPREAD         5.0f    // 连续帧新息差异小于该值(cm)才视为一致
+
+#define ALT_HIST_LEN            16      // 高度历史（100Hz下160ms），用于激光延时对齐
+#define ALT_MEAS_TIMEOUT        300     // 无激光修正超时(ms)
+#define ALT_BIAS_LIMIT          100.0f  // 零偏限幅(cm/s^2)
+
+typedef struct {
+    uint8_t valid;              // 估计有效（近期有激光修正）
+    uint8_t initialized;        // 已由首帧激光初始化
+
+    float alt;                  // 高度估计(cm，相对起飞地面)
+    float vel;                  // 爬升率估计(cm/s)
+    float acc;                  // 去零偏的竖直加速度(cm/s^2)
+    float acc_bias;             // 竖直加速度零偏(cm/s^2)
+    float terrain;              // 地形偏移(cm)，激光读数 = alt - terrain
+    float agl;                  // 离地高度估计(cm)
+    float innov;                // 最近一次激光新息(cm)
+
+    uint8_t step_count;         // 台阶确认计数
+    float step_first;           // 首帧疑似台阶新息
+    uint16_t step_events;       // 已确认台阶次数
+    uint16_t reject_count;      // 丢弃野值次数
+
+    uint32_t last_tick;
+    uint32_t last_range_tick;
+    uint32_t last_frame;
+
+    struct {
+        uint32_t tick;
+        float alt;
+    } hist[ALT_HIST_LEN];
+    uint8_t hist_head;
+    uint8_t hist_count;
+} alt_est_t;
+
+void alt_est_init(void);
+
+/** 复位（解锁时调用，以当前激光高度为起点） */
+void alt_est_reset(void);
+
+/** 控制周期调用，需在 imu_update() 与 optical_flow_update() 之后 */
+void alt_est_update(void);
+
+extern alt_est_t alt_est;
+
+#endif
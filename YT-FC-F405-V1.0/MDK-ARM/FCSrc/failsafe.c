@@ -0,0 +1,180 @@
+#include "failsafe.h"
+#include "flight_mode.h"
+#include "alt_estimator.h"
+
+Failsafe_t g_failsafe;
+
+static inline float absf(float x) { return x < 0.0f ? -x : x; }
+
+static void stage_enter(FailsafeStage_t stage)
+{
+    g_failsafe.stage = stage;
+    g_failsafe.enter_tick = HAL_GetTick();
+    g_failsafe.touch_tick = 0;
+}
+
+/* 定高闭环可用（激光高度有效且定高已启用） */
+static inline uint8_t alt_loop_ok(void)
+{
+    return g_pid.altitude.enabled && alt_est.valid;
+}
+
+/**
+ * @brief  下降阶段触地检测
+ * @return 1-已触地
+ */
+static uint8_t touchdown_detect(uint32_t now)
+{
+    Failsafe_t *fs = &g_failsafe;
+
+    if (alt_loop_ok()) {
+        fs->blind_tick = 0;
+
+        uint8_t still = absf(alt_est.vel) < FS_TOUCHDOWN_VEL_CMS;
+        uint8_t low = (alt_est.agl < FS_TOUCHDOWN_AGL_CM) ||
+                      (g_pid.altitude.output < FS_TOUCHDOWN_THR_RATIO * fs->hover_throttle);
+        if (still && low) {
+            if (fs->touch_tick == 0) fs->touch_tick = now;
+            return (now - fs->touch_tick >= FS_TOUCHDOWN_MS);
+        }
+        fs->touch_tick = 0;
+        return 0;
+    }
+
+    /* 盲降：油门压到下限、爬升率≈0且加速度平稳持续成立才判定触地；
+     * 之前出现过冲击（低通加速度向上超阈值）时缩短确认时间。
+     * 长时间盲降后惯导爬升率带零偏漂移，"爬升率≈0"按确认窗口内爬升率不变判断 */
+    if (fs->blind_tick == 0) {
+        fs->blind_tick = now;
+        fs->impact = 0;
+        fs->touch_tick = 0;
+        fs->acc_lp = alt_est.acc;
+        fs->blind_integ = 0.0f;
+        fs->blind_corr = 0.0f;
+        if (g_pid.altitude.enabled) {
+            fs->hover_throttle = g_pid.altitude.output;    // 定高输出是更准确的悬停油门
+        }
+    }
+    fs->acc_lp += FS_ACC_LP_ALPHA * (alt_est.acc - fs->acc_lp);
+    if (fs->acc_lp > FS_IMPACT_ACC_CMS2) {
+        fs->impact = 1;
+    }
+
+    uint8_t at_floor = fs->blind_corr < -FS_BLIND_THR_DROP + FS_BLIND_FLOOR_MARGIN;
+    uint8_t still = absf(fs->acc_lp) < FS_STILL_ACC_CMS2 &&
+                    (fs->touch_tick == 0 || absf(alt_est.vel - fs->touch_vel) < FS_TOUCHDOWN_VEL_CMS);
+    if (at_floor && still) {
+        if (fs->touch_tick == 0) {
+            fs->touch_tick = now;
+            fs->touch_vel = alt_est.vel;
+        }
+        return (now - fs->touch_tick >= (fs->impact ? FS_BLIND_QUIET_MS : FS_BLIND_FLOOR_MS));
+    }
+    fs->touch_tick = 0;
+    return 0;
+}
+
+void Failsafe_Reset(void)
+{
+    uint16_t events = g_failsafe.events;
+    uint16_t recoveries = g_failsafe.recoveries;
+
+    memset(&g_failsafe, 0, sizeof(g_failsafe));
+    g_failsafe.events = events;
+    g_failsafe.recoveries = recoveries;
+}
+
+void Failsafe_Update(uint8_t rc_ok, uint8_t out_enable)
+{
+    Failsafe_t *fs = &g_failsafe;
+    uint32_t now = HAL_GetTick();
+
+    if (fs->stage == FS_IDLE) {
+        if (rc_ok) {
+            fs->last_out_enable = out_enable;   // 只记录信号正常时的开关状态
+            return;
+        }
+        // 信号丢失：沿用丢失前的输出开关，以上周期实际油门作为悬停油门估计
+        fs->out_enable = fs->last_out_enable;
+        fs->hover_throttle = g_fmode.sp_throttle;
+        fs->rc_back_tick = 0;
+        fs->blind_tick = 0;
+        fs->blind_integ = fs->blind_corr = 0.0f;
+        fs->events++;
+        stage_enter(FS_HOLD);
+        return;
+    }
+
+    if (fs->stage == FS_LANDED) return;     // 等待上锁
+
+    /* 信号恢复：持续FS_RECOVER_MS后交还遥控，设定值由模式管理斜坡衔接 */
+    if (rc_ok) {
+        if (fs->rc_back_tick == 0) fs->rc_back_tick = now;
+        if (now - fs->rc_back_tick >= FS_RECOVER_MS) {
+            fs->stage = FS_IDLE;
+            fs->recoveries++;
+            g_fmode.blend_att = 1;
+            g_fmode.blend_thr = 1;
+            return;
+        }
+    } else {
+        fs->rc_back_tick = 0;
+    }
+
+    switch (fs->stage) {
+        case FS_HOLD:
+            if (now - fs->enter_tick >= FS_HOLD_MS) {
+                stage_enter(FS_DESCEND);
+            }
+            break;
+
+        case FS_DESCEND:
+            if (touchdown_detect(now)) {
+                stage_enter(FS_LANDED);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+uint8_t Failsafe_IsActive(void)
+{
+    return g_failsafe.stage != FS_IDLE;
+}
+
+float Failsafe_Throttle(void)
+{
+    Failsafe_t *fs = &g_failsafe;
+
+    switch (fs->stage) {
+        case FS_HOLD:
+            if (g_pid.altitude.enabled) {
+                return PID_UpdateAltClimb(0.0f, alt_est.alt, alt_est.vel, alt_est.valid);
+            }
+            return fs->hover_throttle;
+
+        case FS_DESCEND:
+            if (alt_loop_ok()) {
+                float climb = (alt_est.agl > FS_SLOW_AGL_CM) ? -FS_DESCENT_CMS : -FS_LAND_CMS;
+                return PID_UpdateAltClimb(climb, alt_est.alt, alt_est.vel, alt_est.valid);
+            }
+            {
+                // 盲降：惯导爬升率比例积分修正，修正量限幅在悬停油门±FS_BLIND_THR_DROP内
+                float err = -FS_BLIND_DESCENT_CMS - alt_est.vel;
+                fs->blind_integ += FS_BLIND_VEL_KI * err / PID_LOOP_HZ;
+                if (fs->blind_integ >  FS_BLIND_THR_DROP) fs->blind_integ =  FS_BLIND_THR_DROP;
+                if (fs->blind_integ < -FS_BLIND_THR_DROP) fs->blind_integ = -FS_BLIND_THR_DROP;
+                float corr = FS_BLIND_VEL_KP * err + fs->blind_integ;
+                if (corr >  FS_BLIND_THR_DROP) corr =  FS_BLIND_THR_DROP;
+                if (corr < -FS_BLIND_THR_DROP) corr = -FS_BLIND_THR_DROP;
+                fs->blind_corr = corr;
+                float thr = fs->hover_throttle + corr;
+                return (thr > 0.0f) ? thr : 0.0f;
+            }
+
+        default:
+            return 0.0f;
+    }
+}
@@ -0,0 +1,99 @@
+/**
+ * @file       failsafe.h
+ * @author     lsl-sys
+ * @brief      Staged RC-loss Failsafe (Hold -> Controlled Descent -> Touchdown Disarm)
+ * @version    V1.0.0
+ * @date       2026-02-23
+ * @Encoding   UTF-8
+ * @note       遥控丢失不再立即停桨：
+ *             1. HOLD：摇杆回中并请求定点（不满足时逐级降为定高/自稳），保持姿态与高度等待信号恢复；
+ *             2. DESCEND：激光高度有效时按爬升率指令定高下降，接近地面减速；
+ *                高度无效时以悬停油门为基准、按惯导爬升率做比例积分修正盲降；
+ *             3. LANDED：检测到触地后上锁（盲降时须油门压到下限且爬升率≈0、加速度平稳，不按时间上锁）。
+ *             信号恢复并持续 FS_RECOVER_MS 后交还遥控（由模式管理斜坡衔接）。
+ *             立即停桨只保留倾角超限与IMU掉线两种情况。
+ */
+
+#ifndef __FAILSAFE_H
+#define __FAILSAFE_H
+
+#include "main.h"
+
+/* 阶段时间 */
+#define FS_HOLD_MS              1500    // 原地保持等待信号恢复的时间
+#define FS_RECOVER_MS           200     // 信号连续恢复该时间后退出失控保护
+
+/* 受控下降（激光高度有效） */
+#define FS_DESCENT_CMS          40.0f   // 下降速度 (cm/s)
+#define FS_LAND_CMS             20.0f   // 接近地面后的下降速度 (cm/s)
+#define FS_SLOW_AGL_CM          60.0f   // 离地低于该高度后减速
+
+/* 触地检测 */
+#define FS_TOUCHDOWN_AGL_CM     12.0f   // 离地高度低于该值
+#define FS_TOUCHDOWN_VEL_CMS    10.0f   // 且竖直速度绝对值低于该值
+#define FS_TOUCHDOWN_THR_RATIO  0.7f    // 或定高输出低于悬停油门的该比例（已被地面托住，积分持续下降）
+#define FS_TOUCHDOWN_MS         500     // 条件持续时间
+
+/* 盲降（高度无效，爬升率仅由加速度积分维持，短时可信）
+ * 触地后地面托住机体，爬升率误差持续为负，积分把油门压到下限（悬停油门-FS_BLIND_THR_DROP）；
+ * 空中油门到下限时必然加速下降，"油门在下限且爬升率不变且加速度平稳"只有落地后才会持续成立 */
+#define FS_BLIND_DESCENT_CMS    30.0f   // 目标下降速度 (cm/s)
+#define FS_BLIND_VEL_KP         0.1f    // 爬升率误差→油门 (%/(cm/s))
+#define FS_BLIND_VEL_KI         0.25f   // 爬升率误差积分 (%/(cm/s·s))，修正悬停油门估计偏差，落地后1~3s压到下限
+#define FS_BLIND_THR_DROP       8.0f    // 油门相对悬停油门的修正限幅 (%)
+#define FS_BLIND_FLOOR_MARGIN   1.0f    // 油门距下限小于该值视为已压到下限 (%)
+#define FS_ACC_LP_ALPHA         0.2f    // 竖直加速度低通系数（100Hz下约3.5Hz，单点尖峰不触发冲击）
+#define FS_IMPACT_ACC_CMS2      250.0f  // 触地冲击阈值：低通后的向上加速度 (cm/s^2)
+#define FS_STILL_ACC_CMS2       60.0f   // 平稳：低通加速度绝对值低于该值 (cm/s^2)
+#define FS_BLIND_QUIET_MS       500     // 有冲击：油门下限+平稳持续该时间判定触地
+#define FS_BLIND_FLOOR_MS       2000    // 无冲击（软着陆）：油门下限+平稳持续该时间判定触地
+
+typedef enum {
+    FS_IDLE = 0,        // 正常
+    FS_HOLD,            // 保持等待
+    FS_DESCEND,         // 受控下降
+    FS_LANDED           // 已触地，需上锁
+} FailsafeStage_t;
+
+typedef struct {
+    FailsafeStage_t stage;
+    uint32_t enter_tick;        // 进入当前阶段时刻
+    uint32_t rc_back_tick;      // 信号恢复时刻（0=未恢复）
+    uint32_t touch_tick;        // 触地条件开始满足时刻
+    float touch_vel;            // 盲降触地条件开始满足时的爬升率估计 (cm/s)
+    uint32_t blind_tick;        // 开始盲降时刻
+    uint8_t impact;             // 盲降中检测到过触地冲击
+
+    uint8_t out_enable;         // 丢失信号前的输出开关状态（失控期间沿用）
+    uint8_t last_out_enable;
+    float hover_throttle;       // 丢失信号时的油门（作为悬停油门估计）
+    float acc_lp;               // 低通竖直加速度 (cm/s^2)
+    float blind_integ;          // 盲降爬升率积分修正 (%)
+    float blind_corr;           // 盲降油门相对悬停油门的修正 (%)，触地检测用
+
+    uint16_t events;            // 失控次数
+    uint16_t recoveries;        // 恢复次数
+} Failsafe_t;
+
+/** 解锁时复位 */
+void Failsafe_Reset(void);
+
+/**
+ * @brief  阶段状态机（控制周期调用，解锁且姿态可控时）
+ * @param  rc_ok 遥控在线
+ * @param  out_enable 遥控输出开关（SA/SD）当前是否打开
+ */
+void Failsafe_Update(uint8_t rc_ok, uint8_t out_enable);
+
+/** 失控保护进行中（HOLD/DESCEND/LANDED） */
+uint8_t Failsafe_IsActive(void);
+
+/**
+ * @brief  失控期间的油门
+ * @note   定高已启用时按阶段给爬升率指令，否则保持/低于丢失信号时的油门
+ */
+float Failsafe_Throttle(void);
+
+extern Failsafe_t g_failsafe;
+
+#endif
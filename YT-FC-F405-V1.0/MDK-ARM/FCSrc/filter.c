@@ -0,0 +1,222 @@
+#include "filter.h"
+#include "math.h"
+
+/* 比较交换：保证 a <= b */
+#define SORT2(a, b) do { if ((a) > (b)) { float _t = (a); (a) = (b); (b) = _t; } } while (0)
+
+static inline float absf(float x) { return x < 0.0f ? -x : x; }
+
+float median3(float a, float b, float c)
+{
+    SORT2(a, b);
+    SORT2(b, c);
+    SORT2(a, b);
+    return b;
+}
+
+/* 5点中值选择网络（7次比较） */
+float median5(const float *v)
+{
+    float p0 = v[0], p1 = v[1], p2 = v[2], p3 = v[3], p4 = v[4];
+
+    SORT2(p0, p1);
+    SORT2(p3, p4);
+    SORT2(p0, p3);
+    SORT2(p1, p4);
+    SORT2(p1, p2);
+    SORT2(p2, p3);
+    SORT2(p1, p2);
+    return p2;
+}
+
+/* 窗口未填满时的中值（样本数1~5） */
+static float median_partial(const float *v, uint8_t count)
+{
+    switch (count) {
+        case 1: return v[0];
+        case 2: return 0.5f * (v[0] + v[1]);
+        case 3: return median3(v[0], v[1], v[2]);
+        case 4: {
+            // 偶数个取中间两数均值 = (总和 - 最大 - 最小) / 2
+            float lo = v[0], hi = v[0], sum = v[0];
+            for (uint8_t i = 1; i < 4; i++) {
+                if (v[i] < lo) lo = v[i];
+                if (v[i] > hi) hi = v[i];
+                sum += v[i];
+            }
+            return 0.5f * (sum - lo - hi);
+        }
+        default: return median5(v);
+    }
+}
+
+/* ==================== 滑动中值 ==================== */
+
+void median_filter_init(median_filter_t *f, uint8_t n)
+{
+    f->n = (n >= FILTER_MEDIAN_MAX_N) ? FILTER_MEDIAN_MAX_N : 3;
+    median_filter_reset(f);
+}
+
+void median_filter_reset(median_filter_t *f)
+{
+    f->idx = 0;
+    f->count = 0;
+}
+
+float median_filter_update(median_filter_t *f, float x)
+{
+    f->buf[f->idx] = x;
+    f->idx = (f->idx + 1 >= f->n) ? 0 : f->idx + 1;
+    if (f->count < f->n) {
+        f->count++;
+        if (f->count < f->n) return median_partial(f->buf, f->count);
+    }
+
+    return (f->n == 3) ? median3(f->buf[0], f->buf[1], f->buf[2]) : median5(f->buf);
+}
+
+/* ==================== 滑动均值/方差 ==================== */
+
+void movavg_init(movavg_filter_t *f, uint8_t n)
+{
+    if (n < 1) n = 1;
+    if (n > FILTER_MOVAVG_MAX_N) n = FILTER_MOVAVG_MAX_N;
+    f->n = n;
+    movavg_reset(f);
+}
+
+void movavg_reset(movavg_filter_t *f)
+{
+    f->idx = 0;
+    f->count = 0;
+    f->mean = 0.0f;
+    f->m2 = 0.0f;
+}
+
+/* 由窗口重新计算均值与离差平方和，消除增量更新的浮点累积误差 */
+static void movavg_resync(movavg_filter_t *f)
+{
+    float sum = 0.0f, m2 = 0.0f;
+    for (uint8_t i = 0; i < f->n; i++) sum += f->buf[i];
+    f->mean = sum / f->n;
+    for (uint8_t i = 0; i < f->n; i++) {
+        float d = f->buf[i] - f->mean;
+        m2 += d * d;
+    }
+    f->m2 = m2;
+}
+
+float movavg_update(movavg_filter_t *f, float x)
+{
+    float old_mean = f->mean;
+
+    if (f->count < f->n) {
+        // 填充阶段：标准Welford增量
+        f->count++;
+        float delta = x - old_mean;
+        f->mean += delta / f->count;
+        f->m2 += delta * (x - f->mean);
+    } else {
+        // 满窗口：新样本替换最旧样本
+        float y = f->buf[f->idx];
+        f->mean += (x - y) / f->n;
+        f->m2 += (x - y) * (x - f->mean + y - old_mean);
+        if (f->m2 < 0.0f) f->m2 = 0.0f;     // 浮点舍入保护
+    }
+
+    f->buf[f->idx] = x;
+    f->idx = (f->idx + 1 >= f->n) ? 0 : f->idx + 1;
+    if (f->idx == 0 && f->count == f->n) {
+        movavg_resync(f);                       // 每满一圈重算一次，均摊仍为O(1)
+    }
+    return f->mean;
+}
+
+float movavg_variance(const movavg_filter_t *f)
+{
+    return (f->count > 1) ? f->m2 / (f->count - 1) : 0.0f;
+}
+
+/* ==================== Hampel ==================== */
+
+void hampel_init(hampel_filter_t *f, float k, float min_sigma)
+{
+    f->k = k;
+    f->min_sigma = min_sigma;
+    f->outliers = 0;
+    hampel_reset(f);
+}
+
+void hampel_reset(hampel_filter_t *f)
+{
+    f->idx = 0;
+    f->count = 0;
+}
+
+float hampel_update(hampel_filter_t *f, float x)
+{
+    // 窗口保存原始值：真实阶跃在过半样本到达后中值随之跳变，不会被永久压制
+    f->buf[f->idx] = x;
+    f->idx = (f->idx + 1 >= FILTER_HAMPEL_N) ? 0 : f->idx + 1;
+    if (f->count < FILTER_HAMPEL_N) f->count++;
+
+    if (f->count < 3) return x;             // 样本过少无法判定
+
+    float med = median_partial(f->buf, f->count);
+
+    float dev[FILTER_HAMPEL_N];
+    for (uint8_t i = 0; i < f->count; i++) {
+        dev[i] = absf(f->buf[i] - med);
+    }
+    float sigma = FILTER_MAD_SCALE * median_partial(dev, f->count);
+    if (sigma < f->min_sigma) sigma = f->min_sigma;
+
+    if (absf(x - med) > f->k * sigma) {
+        f->outliers++;
+        return med;
+    }
+    return x;
+}
+
+/* ==================== 二阶陷波 ==================== */
+
+void biquad_notch_set(biquad_t *f, float fc, float q, float fs)
+{
+    float omega = 2.0f * 3.14159265f * fc / fs;
+    float sn = sinf(omega);
+    float cs = cosf(omega);
+    float alpha = sn / (2.0f * q);
+    float a0_inv = 1.0f / (1.0f + alpha);
+
+    f->b0 = a0_inv;
+    f->b1 = -2.0f * cs * a0_inv;
+    f->b2 = a0_inv;
+    f->a1 = f->b1;
+    f->a2 = (1.0f - alpha) * a0_inv;
+}
+
+void biquad_copy_coeff(biquad_t *dst, const biquad_t *src)
+{
+    dst->b0 = src->b0;
+    dst->b1 = src->b1;
+    dst->b2 = src->b2;
+    dst->a1 = src->a1;
+    dst->a2 = src->a2;
+}
+
+void biquad_reset(biquad_t *f, float x)
+{
+    f->x1 = f->x2 = x;
+    f->y1 = f->y2 = x;
+}
+
+float biquad_update(biquad_t *f, float x)
+{
+    float y = f->b0 * x + f->b1 * f->x1 + f->b2 * f->x2 - f->a1 * f->y1 - f->a2 * f->y2;
+    f->x2 = f->x1;
+    f->x1 = x;
+    f->y2 = f->y1;
+    f->y1 = y;
+    return y;
+}
@@ -0,0 +1,93 @@
+/**
+ * @file       filter.h
+ * @author     lsl-sys
+ * @brief      Fixed-window Filters (Sorting-network Median, Running Mean/Variance, Hampel, Biquad Notch)
+ * @version    V1.1.0
+ * @date       2026-02-23
+ * @Encoding   UTF-8
+ * @note       所有滤波器均为实例化结构体，状态不放在函数内static变量中，
+ *             同一滤波器可用于多路信号，并可随时复位。
+ *             中值采用排序网络（N=3: 3次比较，N=5: 7次比较），无分支循环；
+ *             滑动均值/方差每样本O(1)更新（窗口Welford算法）。
+ *             陷波为二阶IIR（RBJ设计，直接I型），中心频率可每周期更新而状态连续。
+ */
+
+#ifndef __FILTER_H
+#define __FILTER_H
+
+#include "main.h"
+
+#define FILTER_MEDIAN_MAX_N     5       // 中值窗口上限（支持3、5）
+#define FILTER_MOVAVG_MAX_N     16      // 滑动均值窗口上限
+#define FILTER_HAMPEL_N         5       // Hampel窗口长度
+#define FILTER_MAD_SCALE        1.4826f // MAD→标准差（高斯分布）
+
+/* 滑动中值 */
+typedef struct {
+    float buf[FILTER_MEDIAN_MAX_N];
+    uint8_t n;                  // 窗口长度（3或5）
+    uint8_t idx;                // 下一个写入位置
+    uint8_t count;              // 已填充样本数
+} median_filter_t;
+
+/* 滑动均值/方差 */
+typedef struct {
+    float buf[FILTER_MOVAVG_MAX_N];
+    uint8_t n;
+    uint8_t idx;
+    uint8_t count;
+    float mean;                 // 窗口均值
+    float m2;                   // 离差平方和
+} movavg_filter_t;
+
+/* Hampel野值滤波：新样本偏离窗口中值超过 k*σ(MAD估计) 时以中值替代 */
+typedef struct {
+    float buf[FILTER_HAMPEL_N];
+    uint8_t idx;
+    uint8_t count;
+    float k;                    // 门限（标准差倍数，常用3）
+    float min_sigma;            // σ下限，防止窗口内数据相同导致所有新值被判为野值
+    uint32_t outliers;          // 累计替换次数（复位不清零）
+} hampel_filter_t;
+
+/* 二阶IIR（直接I型：系数在线修改时输出连续） */
+typedef struct {
+    float b0, b1, b2, a1, a2;   // 归一化系数（a0=1）
+    float x1, x2, y1, y2;       // 历史输入/输出
+} biquad_t;
+
+/** 3/5点中值（排序网络，不修改输入） */
+float median3(float a, float b, float c);
+float median5(const float *v);
+
+void  median_filter_init(median_filter_t *f, uint8_t n);
+void  median_filter_reset(median_filter_t *f);
+/** 窗口未填满时按已有样本数（1/2/3/4）取中值 */
+float median_filter_update(median_filter_t *f, float x);
+
+void  movavg_init(movavg_filter_t *f, uint8_t n);
+void  movavg_reset(movavg_filter_t *f);
+/** @return 当前窗口均值 */
+float movavg_update(movavg_filter_t *f, float x);
+/** 当前窗口样本方差（样本数<2时为0） */
+float movavg_variance(const movavg_filter_t *f);
+
+void  hampel_init(hampel_filter_t *f, float k, float min_sigma);
+void  hampel_reset(hampel_filter_t *f);
+/** @return 滤波结果：正常样本原样输出（无延时），野值以窗口中值替代 */
+float hampel_update(hampel_filter_t *f, float x);
+
+/**
+ * @brief  设置陷波系数（不改动状态）
+ * @param  fc 中心频率 (Hz)，需 0 < fc < fs/2
+ * @param  q  品质因数（带宽 = fc/q）
+ * @param  fs 采样频率 (Hz)
+ */
+void  biquad_notch_set(biquad_t *f, float fc, float q, float fs);
+/** 仅复制系数（多路信号共用一组系数时避免重复计算三角函数） */
+void  biquad_copy_coeff(biquad_t *dst, const biquad_t *src);
+/** 状态置为输入x的稳态（陷波直流增益为1），启用时无跳变 */
+void  biquad_reset(biquad_t *f, float x);
+float biquad_update(biquad_t *f, float x);
+
+#endif
@@ -0,0 +1,218 @@
+#include "flight_mode.h"
+#include "autotune.h"
+#include "imu.h"
+#include "nav_ekf.h"
+#include "alt_estimator.h"
+
+FlightModeMgr_t g_fmode;
+
+#define FMODE_DT            (1.0f / PID_LOOP_HZ)
+#define FMODE_BLEND_EPS     0.2f    // 设定值与目标差小于该值时结束过渡
+
+/* ========== 传感器前置条件 ========== */
+
+static uint8_t ready_rate(void)
+{
+    return imu.online;
+}
+
+static uint8_t ready_angle(void)
+{
+    return imu.online && imu.valid;
+}
+
+static uint8_t ready_alt(void)
+{
+    return ready_angle() && alt_est.valid;
+}
+
+static uint8_t ready_pos(void)
+{
+    return ready_alt() && nav.horiz_valid;
+}
+
+/* ========== 模式表 ========== */
+
+static const FlightModeDesc_t mode_desc[FM_COUNT] = {
+    [FM_RATE]     = {"RATE",  MODE_RATE,  0, 0, FM_RATE,     ready_rate},
+    [FM_ANGLE]    = {"ANGLE", MODE_ANGLE, 0, 0, FM_ANGLE,    ready_angle},
+    [FM_ALT_HOLD] = {"ALT",   MODE_ANGLE, 1, 0, FM_ANGLE,    ready_alt},
+    [FM_POS_HOLD] = {"POS",   MODE_ANGLE, 1, 1, FM_ALT_HOLD, ready_pos},
+};
+
+/* 开关映射 [SC档位][SB档位]，档位 0-下 1-中 2-上
+ * SC下/中：SB选择 自稳/定高/定点；SC上：手动模式（不论SB） */
+static const FlightModeId_t mode_map[3][3] = {
+    {FM_ANGLE, FM_ALT_HOLD, FM_POS_HOLD},
+    {FM_ANGLE, FM_ALT_HOLD, FM_POS_HOLD},
+    {FM_RATE,  FM_RATE,     FM_RATE},
+};
+
+static inline float absf(float x) { return x < 0.0f ? -x : x; }
+
+static inline uint8_t switch_pos(float v)
+{
+    if (v < -FMODE_SWITCH_THRESH) return 0;
+    if (v >  FMODE_SWITCH_THRESH) return 2;
+    return 1;
+}
+
+/* 斜坡逼近：每周期最多变化step */
+static inline float slew(float from, float to, float step)
+{
+    float d = to - from;
+    if (d >  step) return from + step;
+    if (d < -step) return from - step;
+    return to;
+}
+
+/* 沿降级链找到前置条件满足的模式 */
+static FlightModeId_t resolve(FlightModeId_t m)
+{
+    while (!mode_desc[m].ready() && mode_desc[m].fallback != m) {
+        m = mode_desc[m].fallback;
+    }
+    return m;
+}
+
+/**
+ * @brief  从from切换到to：只对发生变化的控制器做切换
+ */
+static void transfer(FlightModeId_t from, FlightModeId_t to, float stick_throttle)
+{
+    const FlightModeDesc_t *f = &mode_desc[from];
+    const FlightModeDesc_t *t = &mode_desc[to];
+
+    /* 姿态环：角速度环积分保留（承载配平），外环从当前姿态重新开始；
+     * 自整定只在自稳下运行，姿态模式改变时先中止（继电器不能带到手动模式里） */
+    if (t->attitude != f->attitude) {
+        AutoTune_Abort();
+        PID_SetMode(t->attitude);
+        if (t->attitude == MODE_ANGLE) {
+            PID_Reset(&g_pid.attitude.angle.pitch);
+            PID_Reset(&g_pid.attitude.angle.roll);
+            PID_SetHeadingHold(g_pid.attitude.heading.enabled);
+            g_fmode.sp_pitch = imu.pitch;
+            g_fmode.sp_roll  = imu.roll;
+        }
+        g_fmode.blend_att = (t->attitude == MODE_ANGLE);
+    }
+
+    /* 定点：速度环从零开始，角度目标由过渡斜坡衔接 */
+    if (t->pos_hold != f->pos_hold) {
+        PID_SetPosHold(t->pos_hold);
+        if (t->attitude == MODE_ANGLE) g_fmode.blend_att = 1;
+    }
+
+    /* 定高：进入时以上周期实际油门预置积分（带爬升率时速度环P项仍会跳变，同样走斜坡）；
+     * 退出时油门从定高输出斜坡回到摇杆 */
+    if (t->alt_hold != f->alt_hold) {
+        if (t->alt_hold) {
+            PID_SetAltHold(1, g_fmode.sp_throttle);
+        } else {
+            g_fmode.sp_throttle = g_pid.altitude.output;
+            PID_SetAltHold(0, stick_throttle);
+        }
+        g_fmode.blend_thr = 1;
+    }
+
+    g_fmode.active = to;
+    g_fmode.enter_tick = HAL_GetTick();
+    g_fmode.lost_tick = 0;
+    g_fmode.switch_count++;
+}
+
+void FMode_Init(void)
+{
+    memset(&g_fmode, 0, sizeof(g_fmode));
+    g_fmode.requested = FM_ANGLE;
+    g_fmode.active = FM_ANGLE;
+}
+
+void FMode_Reset(void)
+{
+    FlightModeId_t m = resolve(g_fmode.requested);
+    const FlightModeDesc_t *d = &mode_desc[m];
+
+    PID_SetMode(d->attitude);
+    PID_SetAltHold(d->alt_hold, 0.0f);
+    PID_SetPosHold(d->pos_hold);
+
+    g_fmode.active = m;
+    g_fmode.degraded = (m != g_fmode.requested);
+    g_fmode.enter_tick = HAL_GetTick();
+    g_fmode.lost_tick = 0;
+    g_fmode.blend_att = g_fmode.blend_thr = 0;
+    g_fmode.sp_pitch = g_fmode.sp_roll = g_fmode.sp_throttle = 0.0f;
+}
+
+void FMode_Update(float sb, float sc, float stick_throttle)
+{
+    uint32_t now = HAL_GetTick();
+    FlightModeId_t active = g_fmode.active;
+    FlightModeId_t req = mode_map[switch_pos(sc)][switch_pos(sb)];
+    uint8_t req_changed = (req != g_fmode.requested);
+
+    g_fmode.requested = req;
+
+    /* 自整定结束后姿态模式被改回自稳，按当前模式重新同步 */
+    if (!AutoTune_IsActive() && g_pid.attitude.mode != mode_desc[active].attitude) {
+        PID_SetMode(mode_desc[active].attitude);
+    }
+
+    /* 当前模式前置条件短暂丢失：由控制器自身保持，超时才降级 */
+    if (!mode_desc[active].ready()) {
+        if (g_fmode.lost_tick == 0) g_fmode.lost_tick = now;
+        if (!req_changed && now - g_fmode.lost_tick < FMODE_LOSS_MS) return;
+    } else {
+        g_fmode.lost_tick = 0;
+    }
+
+    FlightModeId_t target = resolve(req);
+    if (target == active) {
+        g_fmode.degraded = (target != req);
+        return;
+    }
+
+    /* 降级运行中条件恢复时的自动升级需间隔FMODE_RETRY_MS；开关主动切换立即生效 */
+    if (!req_changed && g_fmode.degraded && mode_desc[active].ready() &&
+        now - g_fmode.enter_tick < FMODE_RETRY_MS) {
+        return;
+    }
+
+    g_fmode.degraded = (target != req);
+    if (g_fmode.degraded) g_fmode.fallback_count++;
+    transfer(active, target, stick_throttle);
+}
+
+void FMode_ShapeSetpoints(float *target_pitch, float *target_roll, float *throttle)
+{
+    /* 斜坡输出追上原始目标后结束过渡，此后目标直接跟随摇杆/控制器 */
+    if (g_fmode.blend_att && mode_desc[g_fmode.active].attitude == MODE_ANGLE) {
+        float step = FMODE_ANGLE_SLEW_DPS * FMODE_DT;
+        float p = slew(g_fmode.sp_pitch, *target_pitch, step);
+        float r = slew(g_fmode.sp_roll,  *target_roll,  step);
+        if (absf(p - *target_pitch) < FMODE_BLEND_EPS && absf(r - *target_roll) < FMODE_BLEND_EPS) {
+            g_fmode.blend_att = 0;
+        }
+        *target_pitch = p;
+        *target_roll  = r;
+    } else {
+        g_fmode.blend_att = 0;
+    }
+
+    if (g_fmode.blend_thr) {
+        float t = slew(g_fmode.sp_throttle, *throttle, FMODE_THR_SLEW_PCT * FMODE_DT);
+        if (absf(t - *throttle) < FMODE_BLEND_EPS) g_fmode.blend_thr = 0;
+        *throttle = t;
+    }
+
+    g_fmode.sp_pitch = *target_pitch;
+    g_fmode.sp_roll  = *target_roll;
+    g_fmode.sp_throttle = *throttle;
+}
+
+const FlightModeDesc_t* FMode_Active(void)
+{
+    return &mode_desc[g_fmode.active];
+}
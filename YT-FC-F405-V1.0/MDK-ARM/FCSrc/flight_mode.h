@@ -0,0 +1,88 @@
+/**
+ * @file       flight_mode.h
+ * @author     lsl-sys
+ * @brief      Flight Mode Manager (SB/SC Switch Table, Sensor Preconditions, Bumpless Transfer)
+ * @version    V1.0.0
+ * @date       2026-02-23
+ * @Encoding   UTF-8
+ * @note       SC/SB三段开关查表得到请求模式；每个模式声明所需的姿态模式、定高/定点开关、
+ *             传感器前置条件与降级模式。前置条件不满足时沿降级链退到可用模式，
+ *             飞行中短暂丢失传感器由各控制器自行保持，持续超时才降级。
+ *             切换时：定高以上周期实际油门预置积分，退出定高时油门从定高输出斜坡过渡到摇杆；
+ *             角度目标从上周期实际目标（手动→自稳时从当前姿态）斜坡过渡，电机输出无跳变。
+ */
+
+#ifndef __FLIGHT_MODE_H
+#define __FLIGHT_MODE_H
+
+#include "main.h"
+#include "pid_control.h"
+
+/* 模式切换参数 */
+#define FMODE_LOSS_MS           500     // 当前模式前置条件持续丢失该时间后降级
+#define FMODE_RETRY_MS          1000    // 降级后至少间隔该时间才重新升级（防止反复切换）
+#define FMODE_ANGLE_SLEW_DPS    60.0f   // 切换过渡期间角度目标最大变化率 (°/s)
+#define FMODE_THR_SLEW_PCT      50.0f   // 切换过渡期间油门最大变化率 (%/s)
+#define FMODE_SWITCH_THRESH     50      // 三段开关判定阈值（-100/0/100）
+
+typedef enum {
+    FM_RATE = 0,        // 手动（角速度）
+    FM_ANGLE,           // 自稳
+    FM_ALT_HOLD,        // 自稳 + 定高
+    FM_POS_HOLD,        // 自稳 + 定高 + 光流定点
+    FM_COUNT
+} FlightModeId_t;
+
+/* 模式描述（查表） */
+typedef struct {
+    const char *name;
+    FlightMode_t attitude;      // 姿态环模式
+    uint8_t alt_hold;           // 启用定高
+    uint8_t pos_hold;           // 启用定点
+    FlightModeId_t fallback;    // 前置条件不满足时降级到的模式
+    uint8_t (*ready)(void);     // 传感器前置条件
+} FlightModeDesc_t;
+
+typedef struct {
+    FlightModeId_t requested;   // 开关请求的模式
+    FlightModeId_t active;      // 当前生效的模式
+    uint8_t degraded;           // 1-因前置条件不满足运行在降级模式
+
+    uint32_t enter_tick;        // 进入当前模式时刻
+    uint32_t lost_tick;         // 当前模式前置条件开始丢失的时刻（0=正常）
+
+    /* 无扰切换：上周期实际下发的设定值与过渡标志 */
+    float sp_pitch;
+    float sp_roll;
+    float sp_throttle;
+    uint8_t blend_att;
+    uint8_t blend_thr;
+
+    uint16_t switch_count;      // 切换次数
+    uint16_t fallback_count;    // 降级次数
+} FlightModeMgr_t;
+
+void FMode_Init(void);
+
+/** 解锁时调用：直接进入当前开关对应的可用模式，不做过渡 */
+void FMode_Reset(void);
+
+/**
+ * @brief  按开关与传感器状态选择模式，并在切换时对控制器做无扰切换
+ * @param  sb,sc 三段开关（-100/0/100）
+ * @param  stick_throttle 摇杆油门 (0~100)，用于退出定高时的过渡起点判定
+ */
+void FMode_Update(float sb, float sc, float stick_throttle);
+
+/**
+ * @brief  切换过渡：对本周期的角度/油门目标做斜坡限制，并记录实际下发值
+ * @note   需在定高/定点计算之后、姿态环之前调用
+ */
+void FMode_ShapeSetpoints(float *target_pitch, float *target_roll, float *throttle);
+
+/** 当前模式描述 */
+const FlightModeDesc_t* FMode_Active(void);
+
+extern FlightModeMgr_t g_fmode;
+
+#endif
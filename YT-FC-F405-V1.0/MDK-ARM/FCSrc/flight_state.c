@@ -151,8 +151,8 @@ void FState_Update(void)
         /* ==================== ARMED：已解锁（飞行中）==================== */
         case STATE_ARMED:
         {
-            // 安全检查
-            if (!check_rc_online() || !imu.online || !imu.valid) {
+            // 安全检查（遥控丢失由分级失控保护处理，不在此直接停桨）
+            if (!imu.online || !imu.valid) {
                 on_state_enter(STATE_EMERGENCY);
                 return;
             }
@@ -193,6 +193,13 @@ void FState_ForceEmergency(void)
     }
 }
 
+void FState_Disarm(void)
+{
+    if (g_fstate.state == STATE_ARMED) {
+        on_state_enter(STATE_DISARMED);
+    }
+}
+
 uint8_t FState_CanArm(void)
 {
     if (!imu.online || !imu.valid) return 0;
@@ -50,6 +50,11 @@ ArmState_t FState_GetState(void);
  */
 void FState_ForceEmergency(void);
 
+/**
+ * @brief  正常上锁（失控降落触地后调用）
+ */
+void FState_Disarm(void);
+
 /**
  * @brief  检查是否满足解锁条件（水平+RC在线）
  */
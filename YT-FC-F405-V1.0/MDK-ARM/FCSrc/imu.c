@@ -35,6 +35,24 @@ static inline float lowpass_filter(float new_val, float last_val, float alpha)
     return alpha * new_val + (1.0f - alpha) * last_val;
 }
 
+/**
+ * @brief  Ƕ㵽 -180~180
+ */
+static inline float wrap_180(float angle)
+{
+    while (angle > 180.0f)   angle -= 360.0f;
+    while (angle <= -180.0f) angle += 360.0f;
+    return angle;
+}
+
+/**
+ * @brief  ǵͨԽ180ʱ̽ǲ˲˲ֵɨ0㣩
+ */
+static inline float lowpass_filter_wrap(float new_val, float last_val, float alpha)
+{
+    return wrap_180(last_val + alpha * wrap_180(new_val - last_val));
+}
+
 /** @brief ˲ʷֵ̬״̬ */
 static struct {
     float roll, pitch, yaw;
@@ -114,7 +132,7 @@ void imu_update(void)
     // alpha=0.25 壺ֵռ25%ʷֵռ75%Ч 100Hz 
     imu.roll  = lowpass_filter(wt901c_data.roll,  filter_hist.roll,  IMU_FILTER_ALPHA);
     imu.pitch = lowpass_filter(wt901c_data.pitch, filter_hist.pitch, IMU_FILTER_ALPHA);
-    imu.yaw   = lowpass_filter(wt901c_data.yaw,   filter_hist.yaw,   IMU_FILTER_ALPHA);
+    imu.yaw   = lowpass_filter_wrap(wt901c_data.yaw, filter_hist.yaw, IMU_FILTER_ALPHA);
     
     // ٶ˲ȣ PID ΢ʱƵŴ󣬽˲
     // ע⣺̬֣ alpha  0.5򲻹ˣλӳ
@@ -123,6 +141,11 @@ void imu_update(void)
     imu.gy = lowpass_filter(wt901c_data.wy, filter_hist.gy, GYRO_ALPHA);
     imu.gz = lowpass_filter(wt901c_data.wz, filter_hist.gz, GYRO_ALPHA);
     
+    // ٶȲ˲ģмȨֻͨλӳ
+    imu.ax = wt901c_data.ax;
+    imu.ay = wt901c_data.ay;
+    imu.az = wt901c_data.az;
+    
     
     // ʷֵ
     filter_hist.roll  = imu.roll;
@@ -33,6 +33,10 @@ typedef struct {
     float gy;                // ٶ Y /s
     float gz;                // ٶ Z /s
     
+    float ax;                // ٶ X g (-16~16δ˲)
+    float ay;                // ٶ Y g
+    float az;                // ٶ Z g
+    
 } imu_data_t;
 
 void imu_init(void);
@@ -0,0 +1,284 @@
+#include "nav_ekf.h"
+#include "imu.h"
+#include "OpticalFlow.h"
+
+NavEKF_t nav;
+
+#define DEG_TO_RAD          0.01745329f
+#define NAV_MEAS_TIMEOUT    300     // 超过该时间无测量修正，对应方向标记无效 (ms)
+#define NAV_DT_MAX          0.05f   // 单步预测最大步长 (s)，调度卡顿时防止发散
+
+/* 单轴初始化 */
+static void axis_init(NavAxisKF_t *kf, float pos, float vel)
+{
+    memset(kf, 0, sizeof(NavAxisKF_t));
+    kf->x[0] = pos;
+    kf->x[1] = vel;
+    kf->P[0][0] = NAV_INIT_POS_VAR;
+    kf->P[1][1] = NAV_INIT_VEL_VAR;
+    kf->P[2][2] = NAV_INIT_BIAS_VAR;
+}
+
+/**
+ * @brief  单轴预测：a = acc_meas - bias
+ * @note   F = [1 dt -dt²/2; 0 1 -dt; 0 0 1]，P = F P F' + Q（展开计算，避免通用矩阵乘）
+ */
+static void axis_predict(NavAxisKF_t *kf, float acc_meas, float dt)
+{
+    float h = 0.5f * dt * dt;
+    float a = acc_meas - kf->x[2];
+
+    kf->x[0] += kf->x[1] * dt + a * h;
+    kf->x[1] += a * dt;
+
+    float (*P)[3] = kf->P;
+
+    // FP = F * P
+    float fp00 = P[0][0] + dt * P[1][0] - h * P[2][0];
+    float fp01 = P[0][1] + dt * P[1][1] - h * P[2][1];
+    float fp02 = P[0][2] + dt * P[1][2] - h * P[2][2];
+    float fp11 = P[1][1] - dt * P[2][1];
+    float fp12 = P[1][2] - dt * P[2][2];
+
+    // P = FP * F'
+    float p00 = fp00 + dt * fp01 - h * fp02;
+    float p01 = fp01 - dt * fp02;
+    float p11 = fp11 - dt * fp12;
+    float p02 = fp02;
+    float p12 = fp12;
+
+    // Q：加速度噪声按积分链分配，零偏为随机游走
+    float qa = NAV_ACC_NOISE * NAV_ACC_NOISE;
+    float qb = NAV_BIAS_NOISE * NAV_BIAS_NOISE * dt;
+
+    P[0][0] = p00 + qa * h * h;
+    P[0][1] = P[1][0] = p01 + qa * h * dt;
+    P[1][1] = p11 + qa * dt * dt;
+    P[0][2] = P[2][0] = p02;
+    P[1][2] = P[2][1] = p12;
+    P[2][2] += qb;
+}
+
+/**
+ * @brief  单轴标量测量更新（H 只选择一个状态）
+ * @param  innov 新息（测量 - 测量时刻的状态预测）
+ * @return 1-已融合，0-超出门限被剔除
+ */
+static uint8_t axis_update(NavAxisKF_t *kf, uint8_t idx, float innov, float r)
+{
+    float (*P)[3] = kf->P;
+    float s = P[idx][idx] + r;
+
+    if (innov * innov > NAV_INNOV_GATE * NAV_INNOV_GATE * s) {
+        return 0;
+    }
+
+    float k0 = P[0][idx] / s;
+    float k1 = P[1][idx] / s;
+    float k2 = P[2][idx] / s;
+
+    kf->x[0] += k0 * innov;
+    kf->x[1] += k1 * innov;
+    kf->x[2] += k2 * innov;
+    if (kf->x[2] > NAV_BIAS_LIMIT)  kf->x[2] = NAV_BIAS_LIMIT;
+    if (kf->x[2] < -NAV_BIAS_LIMIT) kf->x[2] = -NAV_BIAS_LIMIT;
+
+    // P = (I - K H) P，保持对称
+    float r0 = P[idx][0], r1 = P[idx][1], r2 = P[idx][2];
+    P[0][0] -= k0 * r0;
+    P[0][1] -= k0 * r1;
+    P[0][2] -= k0 * r2;
+    P[1][1] -= k1 * r1;
+    P[1][2] -= k1 * r2;
+    P[2][2] -= k2 * r2;
+    P[1][0] = P[0][1];
+    P[2][0] = P[0][2];
+    P[2][1] = P[1][2];
+    return 1;
+}
+
+/**
+ * @brief  机体比力旋转到水平系并扣除重力，得到运动加速度 (cm/s^2)
+ * @note   先绕Y(前)轴横滚、再绕X(右)轴俯仰；偏航不旋转（航向对齐系）
+ */
+void nav_body_to_level(float acc[NAV_AXIS_COUNT])
+{
+    float bx = NAV_ACC_X(imu.ax, imu.ay, imu.az);
+    float by = NAV_ACC_Y(imu.ax, imu.ay, imu.az);
+    float bz = NAV_ACC_Z(imu.ax, imu.ay, imu.az);
+
+    float cr = cosf(imu.roll * DEG_TO_RAD),  sr = sinf(imu.roll * DEG_TO_RAD);
+    float cp = cosf(imu.pitch * DEG_TO_RAD), sp = sinf(imu.pitch * DEG_TO_RAD);
+
+    // 横滚（绕Y）
+    float x1 = bx * cr + bz * sr;
+    float z1 = -bx * sr + bz * cr;
+    // 俯仰（绕X）
+    float y2 = by * cp - z1 * sp;
+    float z2 = by * sp + z1 * cp;
+
+    acc[NAV_AXIS_X] = x1 * NAV_GRAVITY_CMS2;
+    acc[NAV_AXIS_Y] = y2 * NAV_GRAVITY_CMS2;
+    acc[NAV_AXIS_Z] = (z2 - 1.0f) * NAV_GRAVITY_CMS2;
+}
+
+/* 记录当前位置/速度到历史 */
+static void hist_push(uint32_t tick)
+{
+    NavHist_t *h = &nav.hist[nav.hist_head];
+    h->tick = tick;
+    for (int a = 0; a < NAV_AXIS_COUNT; a++) {
+        h->pos[a] = nav.axis[a].x[0];
+        h->vel[a] = nav.axis[a].x[1];
+    }
+    nav.hist_head = (nav.hist_head + 1) % NAV_HIST_LEN;
+    if (nav.hist_count < NAV_HIST_LEN) nav.hist_count++;
+}
+
+/**
+ * @brief  查找不晚于测量时刻的最近历史状态
+ * @return 历史不足以覆盖时返回最旧一条（延时超出缓冲时退化为近似融合）
+ */
+static const NavHist_t* hist_find(uint32_t tick)
+{
+    if (nav.hist_count == 0) return NULL;
+
+    uint8_t idx = (nav.hist_head + NAV_HIST_LEN - 1) % NAV_HIST_LEN;
+    for (uint8_t n = 0; n < nav.hist_count; n++) {
+        if ((int32_t)(tick - nav.hist[idx].tick) >= 0) {
+            return &nav.hist[idx];
+        }
+        if (n + 1 < nav.hist_count) {
+            idx = (idx + NAV_HIST_LEN - 1) % NAV_HIST_LEN;
+        }
+    }
+    return &nav.hist[idx];
+}
+
+/**
+ * @brief  延时融合：新息取自测量时刻的历史状态，修正量作用于当前状态，
+ *         并同步平移历史状态，避免下一次测量再次对同一误差重复修正
+ */
+static uint8_t fuse(NavAxis_t axis, uint8_t idx, float meas, const NavHist_t *h, float r)
+{
+    NavAxisKF_t *kf = &nav.axis[axis];
+    float hist_val = (idx == 0) ? h->pos[axis] : h->vel[axis];
+    float pos0 = kf->x[0], vel0 = kf->x[1];
+
+    if (!axis_update(kf, idx, meas - hist_val, r)) {
+        return 0;
+    }
+
+    float dpos = kf->x[0] - pos0;
+    float dvel = kf->x[1] - vel0;
+    for (uint8_t i = 0; i < nav.hist_count; i++) {
+        nav.hist[i].pos[axis] += dpos;
+        nav.hist[i].vel[axis] += dvel;
+    }
+    return 1;
+}
+
+/* 输出拷贝 */
+static void publish(void)
+{
+    for (int a = 0; a < NAV_AXIS_COUNT; a++) {
+        nav.pos[a]  = nav.axis[a].x[0];
+        nav.vel[a]  = nav.axis[a].x[1];
+        nav.bias[a] = nav.axis[a].x[2];
+    }
+}
+
+void nav_ekf_init(void)
+{
+#if NAV_EKF_PROFILE
+    // 只开启不清零：ELRS帧时间戳与遥控插值同样使用CYCCNT差值，清零会打断其计时
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+    memset(&nav, 0, sizeof(nav));
+    nav_ekf_reset();
+}
+
+void nav_ekf_reset(void)
+{
+    float height = optflow.valid ? optflow.height_tilt / 10.0f : 0.0f;
+
+    axis_init(&nav.axis[NAV_AXIS_X], 0.0f, 0.0f);
+    axis_init(&nav.axis[NAV_AXIS_Y], 0.0f, 0.0f);
+    axis_init(&nav.axis[NAV_AXIS_Z], height, 0.0f);
+
+    nav.initialized = 0;
+    nav.horiz_valid = 0;
+    nav.vert_valid = 0;
+    nav.last_tick = 0;
+    nav.last_frame = optflow.frame_count;
+    nav.reject_count = 0;
+    nav.hist_head = 0;
+    nav.hist_count = 0;
+    publish();
+}
+
+void nav_ekf_update(void)
+{
+#if NAV_EKF_PROFILE
+    uint32_t cyc_start = DWT->CYCCNT;
+#endif
+    uint32_t now = HAL_GetTick();
+
+    if (!imu.online || !imu.valid) {
+        nav.horiz_valid = nav.vert_valid = 0;
+        return;
+    }
+
+    /* ========== 预测 ========== */
+    if (nav.last_tick != 0) {
+        float dt = (now - nav.last_tick) * 0.001f;
+        if (dt > NAV_DT_MAX) dt = NAV_DT_MAX;
+
+        nav_body_to_level(nav.acc);
+        for (int a = 0; a < NAV_AXIS_COUNT; a++) {
+            axis_predict(&nav.axis[a], nav.acc[a], dt);
+            nav.acc[a] -= nav.axis[a].x[2];
+        }
+    }
+    nav.last_tick = now;
+    hist_push(now);
+
+    /* ========== 光流速度 + 激光高度（每帧融合一次，按测量时刻取历史状态） ========== */
+    if (optflow.valid && optflow.frame_count != nav.last_frame) {
+        nav.last_frame = optflow.frame_count;
+
+        if (!nav.initialized) {
+            nav.axis[NAV_AXIS_Z].x[0] = optflow.height_tilt / 10.0f;
+            nav.initialized = 1;
+        }
+
+        const NavHist_t *hf = hist_find(optflow.flow_tick);
+        const NavHist_t *hr = hist_find(optflow.range_tick);
+        float r_vel = NAV_FLOW_VEL_NOISE * NAV_FLOW_VEL_NOISE;
+        float r_rng = NAV_RANGE_NOISE * NAV_RANGE_NOISE;
+
+        if (hf) {
+            uint8_t ok = fuse(NAV_AXIS_X, 1, optflow.vel_x / 10.0f, hf, r_vel);
+            ok &= fuse(NAV_AXIS_Y, 1, optflow.vel_y / 10.0f, hf, r_vel);
+            if (ok) nav.last_flow_tick = now;
+            else    nav.reject_count++;
+        }
+        if (hr) {
+            if (fuse(NAV_AXIS_Z, 0, optflow.height_tilt / 10.0f, hr, r_rng)) {
+                nav.last_range_tick = now;
+            } else {
+                nav.reject_count++;
+            }
+        }
+    }
+
+    nav.horiz_valid = nav.initialized && (now - nav.last_flow_tick < NAV_MEAS_TIMEOUT);
+    nav.vert_valid  = nav.initialized && (now - nav.last_range_tick < NAV_MEAS_TIMEOUT);
+    publish();
+
+#if NAV_EKF_PROFILE
+    nav.cycles = DWT->CYCCNT - cyc_start;
+    if (nav.cycles > nav.cycles_max) nav.cycles_max = nav.cycles;
+#endif
+}
@@ -0,0 +1,109 @@
+/**
+ * @file       nav_ekf.h
+ * @author     lsl-sys
+ * @brief      Navigation Kalman Filter (Position / Velocity / Accelerometer Bias, Delayed Fusion)
+ * @version    V1.0.0
+ * @date       2026-02-22
+ * @Encoding   UTF-8
+ * @note       姿态由WT901C直接给出，比力在滤波外旋转到水平系后，各轴解耦为
+ *             [位置, 速度, 加速度计零偏] 三状态线性模型（等价于以姿态为已知输入的EKF），
+ *             每轴仅3x3协方差，100~200Hz下计算量可忽略。
+ *             光流/激光测量带传输与积分延时，按测量时刻在状态历史中取对应状态计算新息，
+ *             再以当前协方差修正当前状态（延时融合）。
+ *             导航系与光流一致：X右、Y前、Z上；水平为航向对齐系（不含偏航旋转）。
+ */
+
+#ifndef __NAV_EKF_H
+#define __NAV_EKF_H
+
+#include "main.h"
+
+/* 加速度计轴→导航系映射（WT901C安装方向不同时修改，需实测：水平静止时 NAV_ACC_Z≈+1g） */
+#define NAV_ACC_X(ax, ay, az)   (ax)
+#define NAV_ACC_Y(ax, ay, az)   (ay)
+#define NAV_ACC_Z(ax, ay, az)   (az)
+
+/* 噪声参数（单位cm、s） */
+#define NAV_ACC_NOISE           35.0f   // 加速度计噪声 (cm/s^2)
+#define NAV_BIAS_NOISE          0.5f    // 零偏随机游走 (cm/s^2/√s)
+#define NAV_FLOW_VEL_NOISE      8.0f    // 光流速度噪声 (cm/s)
+#define NAV_RANGE_NOISE         1.5f    // 激光高度噪声 (cm)
+#define NAV_INNOV_GATE          5.0f    // 新息门限（标准差倍数），超出视为野值
+
+/* 初始不确定度 */
+#define NAV_INIT_POS_VAR        100.0f
+#define NAV_INIT_VEL_VAR        100.0f
+#define NAV_INIT_BIAS_VAR       400.0f
+#define NAV_BIAS_LIMIT          100.0f  // 零偏估计限幅 (cm/s^2，约0.1g)
+
+/* 延时融合 */
+#define NAV_HIST_LEN            24      // 状态历史长度（100Hz下240ms，需覆盖最大测量延时）
+
+#define NAV_EKF_PROFILE         1       // 1：用DWT周期计数器统计单次更新耗时
+
+#define NAV_GRAVITY_CMS2        980.665f
+
+typedef enum {
+    NAV_AXIS_X = 0,
+    NAV_AXIS_Y,
+    NAV_AXIS_Z,
+    NAV_AXIS_COUNT
+} NavAxis_t;
+
+/* 单轴卡尔曼滤波器：x = [位置, 速度, 零偏] */
+typedef struct {
+    float x[3];
+    float P[3][3];
+} NavAxisKF_t;
+
+/* 历史状态（仅位置/速度，用于延时测量新息） */
+typedef struct {
+    uint32_t tick;
+    float pos[NAV_AXIS_COUNT];
+    float vel[NAV_AXIS_COUNT];
+} NavHist_t;
+
+typedef struct {
+    uint8_t initialized;            // 已由首个测量初始化
+    uint8_t horiz_valid;            // 水平速度近期有光流修正
+    uint8_t vert_valid;             // 高度近期有激光修正
+
+    NavAxisKF_t axis[NAV_AXIS_COUNT];
+
+    float pos[NAV_AXIS_COUNT];      // 位置估计 (cm)
+    float vel[NAV_AXIS_COUNT];      // 速度估计 (cm/s)
+    float acc[NAV_AXIS_COUNT];      // 去零偏后的运动加速度 (cm/s^2)
+    float bias[NAV_AXIS_COUNT];     // 加速度计零偏 (cm/s^2)
+
+    uint32_t last_tick;             // 上次预测时刻 (ms)
+    uint32_t last_flow_tick;        // 上次光流融合时刻
+    uint32_t last_range_tick;       // 上次激光融合时刻
+    uint32_t last_frame;            // 已融合的光流帧号
+    uint16_t reject_count;          // 门限剔除计数
+
+    NavHist_t hist[NAV_HIST_LEN];
+    uint8_t hist_head;
+    uint8_t hist_count;
+
+    uint32_t cycles;                // 最近一次更新耗时（CPU周期）
+    uint32_t cycles_max;            // 最大耗时
+} NavEKF_t;
+
+/** 初始化（开启DWT计数器用于耗时统计） */
+void nav_ekf_init(void);
+
+/** 复位状态（解锁/重新定点时调用，位置清零） */
+void nav_ekf_reset(void);
+
+/**
+ * @brief  控制周期调用：加速度预测 + 光流速度/激光高度延时融合
+ * @note   需在 imu_update() 与 optical_flow_update() 之后调用
+ */
+void nav_ekf_update(void);
+
+/** 当前姿态下机体加速度转水平系并扣除重力 (cm/s^2)，供其他估计器复用 */
+void nav_body_to_level(float acc[NAV_AXIS_COUNT]);
+
+extern NavEKF_t nav;
+
+#endif
@@ -0,0 +1,127 @@
+#include "rc_smoothing.h"
+#include "ELRS.h"
+#include "pid_control.h"
+#include "VOFA.h"
+
+RcSmooth_t g_rc_smooth;
+RcLatency_t g_rc_latency;
+
+/* 滤波后摇杆 → 插值通道（与 out[] 顺序一致） */
+static inline void ReadSticks(float v[RC_SMOOTH_AXES])
+{
+    v[0] = filtered_rc.RX;
+    v[1] = filtered_rc.RY;
+    v[2] = filtered_rc.LY;
+    v[3] = filtered_rc.LX;
+}
+
+/* 实测帧间隔 (ms)，未收敛时为按 ELRS_PACKET_RATE 的先验值 */
+static inline float FrameIntervalMs(void)
+{
+#if ELRS_USE_CRSF
+    return crsf_health.interval_ms;
+#else
+    return 1000.0f / ELRS_PACKET_RATE;
+#endif
+}
+
+static void Snap(RcSmooth_t *s)
+{
+    ReadSticks(s->to);
+    for (uint8_t i = 0; i < RC_SMOOTH_AXES; i++) {
+        s->out[i] = s->from[i] = s->to[i];
+    }
+    s->ramping = 0;
+}
+
+/* 帧间隔明显变化时重设前馈平滑（包速率切换后） */
+static void UpdateFeedForward(RcSmooth_t *s, float interval_ms)
+{
+    float diff = fabsf(interval_ms - s->ff_interval_ms);
+    if (diff > s->ff_interval_ms * RC_FF_UPDATE_RATIO) {
+        s->ff_interval_ms = interval_ms;
+        PID_SetFeedForwardSmoothing(interval_ms * 0.001f);
+    }
+}
+
+void RcSmooth_Init(void)
+{
+    memset(&g_rc_smooth, 0, sizeof(g_rc_smooth));
+    memset(&g_rc_latency, 0, sizeof(g_rc_latency));
+    g_rc_smooth.enabled = RC_SMOOTH_ENABLE;
+    g_rc_smooth.ff_interval_ms = 1000.0f / ELRS_PACKET_RATE;   // 与 FC_init 中的初值一致
+    Snap(&g_rc_smooth);
+}
+
+/* 按DWT时间推进插值 */
+static void Advance(RcSmooth_t *s)
+{
+    uint32_t t = DWT->CYCCNT - s->start_cyc;
+    if (t >= s->span_cyc) {
+        for (uint8_t i = 0; i < RC_SMOOTH_AXES; i++) s->out[i] = s->to[i];
+        s->ramping = 0;
+        return;
+    }
+    float k = (float)t / (float)s->span_cyc;
+    for (uint8_t i = 0; i < RC_SMOOTH_AXES; i++) {
+        s->out[i] = s->from[i] + (s->to[i] - s->from[i]) * k;
+    }
+}
+
+void RcSmooth_Process(void)
+{
+    RcSmooth_t *s = &g_rc_smooth;
+
+    elrs_analysis_data();
+    uint8_t connected = elrs_is_connected();
+    uint8_t new_frame = elrs_frame_valid();
+
+    // 只在新帧到达或失控时滤波，滤波器的历史值与计数按帧推进
+    if (new_frame || !connected) {
+        rc_filter_process();
+
+        if (new_frame) {
+            s->frames++;
+            g_rc_latency.frame_cyc = elrs_status.last_cyc;
+            g_rc_latency.pending = 1;
+        }
+
+        float interval = FrameIntervalMs();
+        if (interval > RC_SMOOTH_MAX_MS) interval = RC_SMOOTH_MAX_MS;
+        if (connected) UpdateFeedForward(s, interval);
+
+        // 失控、刚恢复、关闭插值，或帧率不低于控制频率（控制周期内总有新帧，插值只增加延迟）：直接采用滤波结果
+        if (!connected || !s->connected || !s->enabled || interval <= 1000.0f / PID_LOOP_HZ) {
+            s->connected = connected;
+            Snap(s);
+            return;
+        }
+
+        // 新帧：从当前输出出发，在一个帧间隔内走到新值（进度从帧到达时刻起算）
+        for (uint8_t i = 0; i < RC_SMOOTH_AXES; i++) s->from[i] = s->out[i];
+        ReadSticks(s->to);
+        s->start_cyc = elrs_status.last_cyc;
+        s->span_cyc = (uint32_t)(interval * (SystemCoreClock / 1000U));
+        s->ramping = 1;
+    }
+
+    if (s->ramping) Advance(s);
+}
+
+void RcSmooth_MarkOutput(void)
+{
+    RcLatency_t *l = &g_rc_latency;
+    if (!l->pending) return;
+    l->pending = 0;
+
+    float us = (float)(DWT->CYCCNT - l->frame_cyc) / (float)(SystemCoreClock / 1000000U);
+    l->last_us = us;
+    l->avg_us = l->samples ? l->avg_us + RC_LATENCY_ALPHA * (us - l->avg_us) : us;
+    if (us > l->max_us) l->max_us = us;
+    l->samples++;
+}
+
+void RcSmooth_RegisterVofa(void)
+{
+    vofa_login_name("RSM", &g_rc_smooth.enabled, TYPE_BOOL);
+}
@@ -0,0 +1,81 @@
+/**
+ * @file       rc_smoothing.h
+ * @author     lsl-sys
+ * @brief      Event-driven RC Frame Processing and Setpoint Interpolation
+ * @version    V1.0.0
+ * @date       2026-02-24
+ * @Encoding   UTF-8
+ * @note       原先遥控随100Hz控制周期轮询：250Hz链路下每次只取最新一帧，其余帧从未经过滤波，
+ *             整帧跳变检查比较的是相隔10ms的两帧（快速多轴打杆时整帧被误判丢弃）。
+ *             改为在1kHz时隙逐帧处理（RC_EVENT_DRIVEN）：
+ *             1. 每个时隙取接收中断交接的最新帧，有新帧（或失控）才调用 rc_filter_process，
+ *                滤波器按真实帧序工作；
+ *             2. 帧间隔长于控制周期时（如50Hz链路），摇杆设定值按实测帧间隔（crsf_health.interval_ms）
+ *                从当前输出线性插值到新帧，插值进度按DWT时间推进，控制周期不再看到阶梯（代价约半个帧间隔延迟）；
+ *                帧率不低于控制频率时每个控制周期都有新帧，插值只会增加延迟，直接取最新帧；
+ *                失控/恢复时直接跳到目标，不做插值；
+ *             3. 帧间隔变化时同步更新前馈平滑时间常数；
+ *             4. 延迟统计：帧到达（接收中断DWT时间戳）到首次进入混控输出的时间，经 g_rc_latency 观察。
+ *             开关通道不插值，仍取 filtered_rc。
+ */
+
+#ifndef __RC_SMOOTHING_H
+#define __RC_SMOOTHING_H
+
+#include "main.h"
+#include "RemoteControl.h"
+
+#ifndef RC_EVENT_DRIVEN
+#define RC_EVENT_DRIVEN         1       // 1-1kHz时隙逐帧处理，0-随100Hz控制周期轮询（旧路径，用于延迟对比）
+#endif
+
+#ifndef RC_SMOOTH_ENABLE
+#define RC_SMOOTH_ENABLE        1       // 摇杆设定值按帧间隔插值（可经VOFA "RSM" 开关）
+#endif
+
+#define RC_SMOOTH_AXES          4       // 插值的摇杆通道：RX/RY/LY/LX
+#define RC_SMOOTH_MAX_MS        50.0f   // 插值时长上限（链路异常时不拖长设定值）
+#define RC_FF_UPDATE_RATIO      0.1f    // 帧间隔变化超过该比例才重设前馈平滑
+#define RC_LATENCY_ALPHA        0.02f   // 平均延迟EMA系数
+
+typedef struct {
+    bool enabled;                       // 插值使能
+    float out[RC_SMOOTH_AXES];          // 插值后的摇杆设定值（-100.0~100.0）
+    float from[RC_SMOOTH_AXES];         // 插值起点
+    float to[RC_SMOOTH_AXES];           // 插值终点（最新帧滤波结果）
+    uint32_t start_cyc;                 // 插值起始时刻（DWT周期）
+    uint32_t span_cyc;                  // 插值时长（DWT周期）
+    uint8_t ramping;                    // 插值进行中
+    uint8_t connected;                  // 上次处理时的连接状态
+    float ff_interval_ms;               // 前馈平滑当前使用的帧间隔
+    uint32_t frames;                    // 处理的帧数
+} RcSmooth_t;
+
+typedef struct {
+    uint32_t frame_cyc;                 // 当前帧到达时刻（DWT周期）
+    uint8_t pending;                    // 当前帧尚未进入混控输出
+    float last_us;                      // 最近一帧 到达→混控输出 延迟 (us)
+    float avg_us;                       // 平均延迟 (us)
+    float max_us;                       // 最大延迟 (us)
+    uint32_t samples;
+} RcLatency_t;
+
+/** 初始化插值状态 */
+void RcSmooth_Init(void);
+
+/**
+ * @brief  取帧、滤波与设定值插值（RC_EVENT_DRIVEN=1 时1kHz调用，否则控制周期调用）
+ * @note   内部调用 elrs_analysis_data，调用方不再单独调用
+ */
+void RcSmooth_Process(void);
+
+/** 混控输出后调用，记录当前帧首次输出的延迟 */
+void RcSmooth_MarkOutput(void);
+
+/** 注册插值开关（"RSM"）到VOFA */
+void RcSmooth_RegisterVofa(void);
+
+extern RcSmooth_t g_rc_smooth;
+extern RcLatency_t g_rc_latency;
+
+#endif
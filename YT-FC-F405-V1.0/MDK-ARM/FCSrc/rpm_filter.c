@@ -0,0 +1,73 @@
+#include "rpm_filter.h"
+
+RpmFilter_t g_rpm_filter;
+
+/* 频率折叠到 0~fs/2（采样后该振动实际出现的频率） */
+static inline float fold_alias(float f, float fs)
+{
+#if RPM_FILTER_FOLD_ALIAS
+    f -= fs * (float)(int32_t)(f / fs);
+    return (f > 0.5f * fs) ? fs - f : f;
+#else
+    (void)fs;
+    return f;
+#endif
+}
+
+void RpmFilter_Init(void)
+{
+    memset(&g_rpm_filter, 0, sizeof(g_rpm_filter));
+    g_rpm_filter.enabled = 1;
+}
+
+void RpmFilter_Update(void)
+{
+    RpmFilter_t *rf = &g_rpm_filter;
+    const float fs = RPM_FILTER_FS;
+    uint8_t count = 0;
+
+    for (int m = 0; m < MOTOR_COUNT; m++) {
+        float hz = 0.0f;
+        uint8_t valid = rf->enabled && Propulsion_GetMotorHz((MotorID_t)m, &hz);
+
+        for (int h = 0; h < RPM_FILTER_HARMONICS; h++) {
+            float fc = valid ? fold_alias(hz * (float)(h + 1), fs) : 0.0f;
+            if (fc < RPM_FILTER_MIN_HZ || fc > RPM_FILTER_MAX_RATIO * fs) {
+                rf->center_hz[m][h] = 0.0f;
+                continue;
+            }
+            if (rf->center_hz[m][h] == 0.0f) rf->fresh[m][h] = 1;
+            rf->center_hz[m][h] = fc;
+
+            biquad_t *n = rf->notch[m][h];
+            biquad_notch_set(&n[0], fc, RPM_FILTER_Q, fs);
+            biquad_copy_coeff(&n[1], &n[0]);
+            biquad_copy_coeff(&n[2], &n[0]);
+            count++;
+        }
+    }
+    rf->active_count = count;
+}
+
+void RpmFilter_Apply(float *gx, float *gy, float *gz)
+{
+    RpmFilter_t *rf = &g_rpm_filter;
+    if (rf->active_count == 0) return;
+
+    float v[3] = {*gx, *gy, *gz};
+    for (int m = 0; m < MOTOR_COUNT; m++) {
+        for (int h = 0; h < RPM_FILTER_HARMONICS; h++) {
+            if (rf->center_hz[m][h] == 0.0f) continue;
+
+            biquad_t *n = rf->notch[m][h];
+            if (rf->fresh[m][h]) {
+                for (int a = 0; a < 3; a++) biquad_reset(&n[a], v[a]);
+                rf->fresh[m][h] = 0;
+            }
+            for (int a = 0; a < 3; a++) v[a] = biquad_update(&n[a], v[a]);
+        }
+    }
+    *gx = v[0];
+    *gy = v[1];
+    *gz = v[2];
+}
@@ -0,0 +1,50 @@
+/**
+ * @file       rpm_filter.h
+ * @author     lsl-sys
+ * @brief      RPM-tracking Harmonic Notch Bank on the Gyro Path (Bidirectional DShot eRPM)
+ * @version    V1.0.0
+ * @date       2026-02-24
+ * @Encoding   UTF-8
+ * @note       每个电机的基频及其谐波各一个二阶陷波，中心频率每个控制周期按电机转速更新，
+ *             三个轴共用一组系数（每周期每个陷波只算一次三角函数）。
+ *             陀螺在控制周期采样（PID_LOOP_HZ），电机频率通常高于奈奎斯特频率：
+ *             WT901C 输出经控制周期抽取后，振动以混叠频率 |f - k*fs| 出现在陀螺数据中，
+ *             因此中心频率按采样率折叠到 0~fs/2 内（RPM_FILTER_FOLD_ALIAS）。
+ *             折叠后低于 RPM_FILTER_MIN_HZ（会侵占姿态控制带宽）或贴近奈奎斯特频率的陷波不启用；
+ *             电机无转速回传时该电机的陷波全部旁路，重新启用时状态置为当前输入稳态，无跳变。
+ */
+
+#ifndef __RPM_FILTER_H
+#define __RPM_FILTER_H
+
+#include "main.h"
+#include "filter.h"
+#include "propulsion.h"
+#include "pid_control.h"
+
+#define RPM_FILTER_HARMONICS    3           // 每个电机的谐波数（基频、2倍、3倍）
+#define RPM_FILTER_Q            5.0f        // 陷波品质因数
+#define RPM_FILTER_FS           ((float)PID_LOOP_HZ)    // 陀螺采样率（控制周期）
+#define RPM_FILTER_MIN_HZ       20.0f       // 陷波中心下限（保护姿态控制带宽）
+#define RPM_FILTER_MAX_RATIO    0.45f       // 陷波中心上限 = 该比例 × 采样率（留出奈奎斯特余量）
+#define RPM_FILTER_FOLD_ALIAS   1           // 1-中心频率按采样率折叠（混叠）
+
+typedef struct {
+    uint8_t enabled;
+    biquad_t notch[MOTOR_COUNT][RPM_FILTER_HARMONICS][3];  // [电机][谐波][轴 x/y/z]
+    float center_hz[MOTOR_COUNT][RPM_FILTER_HARMONICS];    // 当前中心频率（折叠后），0=旁路
+    uint8_t fresh[MOTOR_COUNT][RPM_FILTER_HARMONICS];      // 刚启用，下次滤波前复位状态
+    uint8_t active_count;                                  // 启用中的陷波数
+} RpmFilter_t;
+
+void RpmFilter_Init(void);
+
+/** 按各电机转速更新陷波中心频率（控制周期、滤波前调用） */
+void RpmFilter_Update(void);
+
+/** 对角速度做陷波（原地修改） */
+void RpmFilter_Apply(float *gx, float *gy, float *gz);
+
+extern RpmFilter_t g_rpm_filter;
+
+#endif
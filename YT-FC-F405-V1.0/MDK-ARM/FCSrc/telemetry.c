@@ -0,0 +1,181 @@
+#include "telemetry.h"
+#include "imu.h"
+#include "Battery.h"
+#include "flight_state.h"
+#include "flight_mode.h"
+#include "failsafe.h"
+#include "VOFA.h"
+
+#if ELRS_USE_CRSF
+
+#define DEG_TO_RAD_E4       (3.14159265f / 180.0f * 10000.0f)  // 度 → 弧度×10000
+
+Telemetry_t g_telemetry;
+
+/* 大端写入 */
+static inline uint8_t *put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)(v >> 8);
+    p[1] = (uint8_t)v;
+    return p + 2;
+}
+
+static inline uint8_t *put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+    return p + 4;
+}
+
+/* 以下构帧函数直接写DMA发送缓冲，返回负载长度 */
+
+/** 姿态：俯仰/横滚/偏航 int16，弧度×10000 */
+static uint8_t build_attitude(uint8_t *p)
+{
+    put_u16(p,     (uint16_t)(int16_t)(imu.pitch * DEG_TO_RAD_E4));
+    put_u16(p + 2, (uint16_t)(int16_t)(imu.roll * DEG_TO_RAD_E4));
+    put_u16(p + 4, (uint16_t)(int16_t)(imu.yaw * DEG_TO_RAD_E4));
+    return 6;
+}
+
+/** 电池：电压 0.1V、电流 0.1A、已用容量 mAh（24位）、剩余 % */
+static uint8_t build_battery(uint8_t *p)
+{
+    float v = Battery_GetVoltage();
+    uint8_t remaining = 0;
+
+    if (v > 0.0f) {
+        uint8_t cells = (uint8_t)(v / TLM_CELL_DETECT_V) + 1;
+        float pct = (v / cells - TLM_CELL_EMPTY_V) / (TLM_CELL_FULL_V - TLM_CELL_EMPTY_V) * 100.0f;
+        remaining = (pct <= 0.0f) ? 0 : (pct >= 100.0f) ? 100 : (uint8_t)pct;
+    }
+
+    put_u16(p, (uint16_t)(v * 10.0f + 0.5f));
+    put_u16(p + 2, 0);              // 无电流计
+    p[4] = p[5] = p[6] = 0;
+    p[7] = remaining;
+    return 8;
+}
+
+/** 飞行模式：以0结尾的字符串，失控保护中为 "!FS!"，未解锁时模式名后加 '*' */
+static uint8_t build_flight_mode(uint8_t *p)
+{
+    const char *name = Failsafe_IsActive() ? "!FS!" : FMode_Active()->name;
+    uint8_t n = 0;
+
+    while (name[n] && n < 12) {
+        p[n] = (uint8_t)name[n];
+        n++;
+    }
+    if (FState_GetState() != STATE_ARMED && !Failsafe_IsActive()) {
+        p[n++] = '*';
+    }
+    p[n++] = 0;
+    return n;
+}
+
+/** 设备信息（扩展帧）：目标/源地址、名称、序列号、硬件/固件ID、参数个数、参数协议版本 */
+static uint8_t build_device_info(uint8_t *p)
+{
+    const char *name = TLM_DEVICE_NAME;
+    uint8_t n = 0;
+
+    p[n++] = crsf_ext.ping_origin;
+    p[n++] = CRSF_ADDRESS_FLIGHT_CONTROLLER;
+    while (*name) p[n++] = (uint8_t)*name++;
+    p[n++] = 0;
+    put_u32(&p[n], 0x59544643);     // 序列号 "YTFC"
+    n += 4;
+    put_u32(&p[n], 0);              // 硬件ID
+    n += 4;
+    put_u32(&p[n], 0x00010000);     // 固件ID V1.0.0
+    n += 4;
+    p[n++] = 0;                     // 无可遥控调整的参数
+    p[n++] = 0;
+    return n;
+}
+
+typedef struct {
+    uint8_t type;
+    uint16_t period_ms;
+    uint8_t (*build)(uint8_t *payload);
+} tlm_item_t;
+
+static const tlm_item_t tlm_items[] = {
+    {CRSF_FRAMETYPE_ATTITUDE,       TLM_ATTITUDE_MS,    build_attitude},
+    {CRSF_FRAMETYPE_BATTERY_SENSOR, TLM_BATTERY_MS,     build_battery},
+    {CRSF_FRAMETYPE_FLIGHT_MODE,    TLM_FLIGHT_MODE_MS, build_flight_mode},
+};
+#define TLM_ITEM_NUM    (sizeof(tlm_items) / sizeof(tlm_items[0]))
+
+static uint32_t tlm_last[TLM_ITEM_NUM];    // 各帧上次发送时刻
+
+void Telemetry_Init(void)
+{
+    memset(&g_telemetry, 0, sizeof(g_telemetry));
+    memset(tlm_last, 0, sizeof(tlm_last));
+    g_telemetry.enabled = 1;
+}
+
+void Telemetry_RegisterVofa(void)
+{
+    vofa_login_name("TLM", &g_telemetry.enabled, TYPE_BOOL);
+}
+
+/**
+ * @brief  回复时隙（接收中断中调用，覆盖ELRS驱动中的弱定义）
+ * @note   每个时隙最多发一帧：设备PING优先，其余取超期最多的到期帧
+ */
+void crsf_telemetry_slot(void)
+{
+    Telemetry_t *t = &g_telemetry;
+    if (!t->enabled) return;
+    t->slots++;
+
+    uint32_t now = HAL_GetTick();
+    int8_t pick = -1;
+    uint32_t most_late = 0;
+
+    if (!crsf_ext.ping_pending) {
+        for (uint8_t i = 0; i < TLM_ITEM_NUM; i++) {
+            uint32_t since = now - tlm_last[i];
+            if (since >= tlm_items[i].period_ms && since - tlm_items[i].period_ms >= most_late) {
+                most_late = since - tlm_items[i].period_ms;
+                pick = i;
+            }
+        }
+        if (pick < 0) return;
+    }
+
+    uint8_t *payload = crsf_tx_begin();
+    if (payload == NULL) return;
+
+    if (crsf_ext.ping_pending) {
+        if (crsf_tx_commit(CRSF_FRAMETYPE_DEVICE_INFO, build_device_info(payload)) == 0) {
+            crsf_ext.ping_pending = 0;
+            t->sent[TLM_ITEM_NUM]++;
+        }
+        return;
+    }
+
+    if (crsf_tx_commit(tlm_items[pick].type, tlm_items[pick].build(payload)) == 0) {
+        tlm_last[pick] = now;
+        t->sent[pick]++;
+    }
+}
+
+#else
+
+Telemetry_t g_telemetry;
+
+void Telemetry_Init(void)
+{
+}
+
+void Telemetry_RegisterVofa(void)
+{
+}
+
+#endif
@@ -0,0 +1,48 @@
+/**
+ * @file       telemetry.h
+ * @author     lsl-sys
+ * @brief      CRSF Telemetry Downlink (Attitude / Battery / Flight Mode / Device Info)
+ * @version    V1.0.0
+ * @date       2026-02-24
+ * @Encoding   UTF-8
+ * @note       接收机每送来一帧RC即开放一个回复时隙，本模块在时隙中（接收中断内）最多发一帧：
+ *             1. 有待回复的设备PING时优先回复 DEVICE_INFO（遥控器Lua/设备列表可识别飞控）；
+ *             2. 其余按各帧周期轮询，取最久未发的到期帧；
+ *             负载直接写入 crsf_tx_begin 返回的DMA发送缓冲（大端），不经中间拷贝。
+ *             链路统计由接收机自行下发，飞控不重复发送。
+ *             遥测可经VOFA "TLM" 开关（关闭后USART6只收不发）。
+ */
+
+#ifndef __TELEMETRY_H
+#define __TELEMETRY_H
+
+#include "main.h"
+#include "ELRS.h"
+
+/* 各帧发送周期 */
+#define TLM_ATTITUDE_MS         100     // 姿态 10Hz
+#define TLM_BATTERY_MS          500     // 电池 2Hz
+#define TLM_FLIGHT_MODE_MS      500     // 飞行模式 2Hz
+
+/* 剩余电量估算（无电流计，按单节电压线性估算） */
+#define TLM_CELL_FULL_V         4.2f
+#define TLM_CELL_EMPTY_V        3.3f
+#define TLM_CELL_DETECT_V       4.35f   // 节数 = 电压 / 该值 + 1（满电到低电都能判对）
+
+#define TLM_DEVICE_NAME         "YT-FC"
+
+typedef struct {
+    uint8_t enabled;                    // 遥测使能
+    uint32_t slots;                     // 收到的回复时隙数
+    uint32_t sent[4];                   // 各帧发送次数（姿态/电池/模式/设备信息）
+} Telemetry_t;
+
+/** 初始化发送计时 */
+void Telemetry_Init(void);
+
+/** 注册遥测开关（"TLM"）到VOFA */
+void Telemetry_RegisterVofa(void);
+
+extern Telemetry_t g_telemetry;
+
+#endif
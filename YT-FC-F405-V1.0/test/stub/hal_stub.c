@@ -0,0 +1,99 @@
+#include "main.h"
+#include "adc.h"
+
+/* 时钟与计时：与 main.c SystemClock_Config 一致（HCLK 160MHz，APB1 /4，APB2 /2） */
+uint32_t SystemCoreClock = 160000000u;
+uint32_t hal_stub_tick = 0;
+
+static DWT_Type dwt;
+static CoreDebug_Type core_debug;
+DWT_Type *DWT = &dwt;
+CoreDebug_Type *CoreDebug = &core_debug;
+
+/* 外设寄存器（普通内存） */
+static TIM_TypeDef tim[4];
+TIM_TypeDef *TIM1 = &tim[0], *TIM2 = &tim[1], *TIM3 = &tim[2], *TIM4 = &tim[3];
+GPIO_TypeDef hal_stub_gpio[4];
+
+static DMA_Stream_TypeDef dma_stream[16];
+DMA_Stream_TypeDef *DMA1_Stream0 = &dma_stream[0],  *DMA1_Stream1 = &dma_stream[1],
+                   *DMA1_Stream2 = &dma_stream[2],  *DMA1_Stream3 = &dma_stream[3],
+                   *DMA1_Stream4 = &dma_stream[4],  *DMA1_Stream5 = &dma_stream[5],
+                   *DMA1_Stream6 = &dma_stream[6],  *DMA1_Stream7 = &dma_stream[7],
+                   *DMA2_Stream0 = &dma_stream[8],  *DMA2_Stream1 = &dma_stream[9],
+                   *DMA2_Stream2 = &dma_stream[10], *DMA2_Stream3 = &dma_stream[11],
+                   *DMA2_Stream4 = &dma_stream[12], *DMA2_Stream5 = &dma_stream[13],
+                   *DMA2_Stream6 = &dma_stream[14], *DMA2_Stream7 = &dma_stream[15];
+
+/* CubeMX 生成的句柄（tim.c / usart.c / adc.c） */
+TIM_HandleTypeDef htim1 = {.Instance = &tim[0]};
+TIM_HandleTypeDef htim2 = {.Instance = &tim[1]};
+TIM_HandleTypeDef htim3 = {.Instance = &tim[2]};
+TIM_HandleTypeDef htim4 = {.Instance = &tim[3]};
+UART_HandleTypeDef huart1, huart2, huart3, huart5, huart6;
+DMA_HandleTypeDef hdma_usart1_rx, hdma_usart2_rx, hdma_usart3_rx, hdma_usart6_rx, hdma_usart6_tx;
+ADC_HandleTypeDef hadc1;
+
+uint32_t HAL_GetTick(void) { return hal_stub_tick; }
+void HAL_Delay(uint32_t ms) { hal_stub_tick += ms; }
+uint32_t HAL_RCC_GetHCLKFreq(void) { return 160000000u; }
+uint32_t HAL_RCC_GetPCLK1Freq(void) { return 40000000u; }
+uint32_t HAL_RCC_GetPCLK2Freq(void) { return 80000000u; }
+void HAL_NVIC_SetPriority(IRQn_Type irq, uint32_t pre, uint32_t sub) { (void)irq; (void)pre; (void)sub; }
+void HAL_NVIC_EnableIRQ(IRQn_Type irq) { (void)irq; }
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma) { (void)hdma; return HAL_OK; }
+HAL_StatusTypeDef HAL_DMA_DeInit(DMA_HandleTypeDef *hdma) { (void)hdma; return HAL_OK; }
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma) { (void)hdma; return HAL_OK; }
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma) { (void)hdma; }
+
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t ch) { (void)htim; (void)ch; return HAL_OK; }
+HAL_StatusTypeDef HAL_TIM_PWM_Stop(TIM_HandleTypeDef *htim, uint32_t ch) { (void)htim; (void)ch; return HAL_OK; }
+
+/* 定时器配置：按参考手册位域写寄存器（与HAL相同，配置通道时关闭该通道输出并使能CCR预装载） */
+HAL_StatusTypeDef HAL_TIM_PWM_ConfigChannel(TIM_HandleTypeDef *htim, const TIM_OC_InitTypeDef *oc, uint32_t ch) {
+    TIM_TypeDef *t = htim->Instance;
+    volatile uint32_t *ccmr = (ch < TIM_CHANNEL_3) ? &t->CCMR1 : &t->CCMR2;
+    uint32_t shift = (ch & 0x04u) ? 8u : 0u;
+
+    t->CCER &= ~(TIM_CCER_CC1E << ch);
+    *ccmr = (*ccmr & ~((TIM_CCMR1_OC1M | TIM_CCMR1_OC1PE) << shift)) | ((oc->OCMode | TIM_CCMR1_OC1PE) << shift);
+    t->CCER = (t->CCER & ~(TIM_CCER_CC1P << ch)) | (oc->OCPolarity << ch);
+    __HAL_TIM_SET_COMPARE(htim, ch, oc->Pulse);
+    return HAL_OK;
+}
+HAL_StatusTypeDef HAL_TIMEx_MasterConfigSynchronization(TIM_HandleTypeDef *htim, const TIM_MasterConfigTypeDef *cfg) {
+    TIM_TypeDef *t = htim->Instance;
+    t->CR2 = (t->CR2 & ~TIM_CR2_MMS) | cfg->MasterOutputTrigger;
+    t->SMCR = (t->SMCR & ~TIM_SMCR_MSM) | cfg->MasterSlaveMode;
+    return HAL_OK;
+}
+HAL_StatusTypeDef HAL_TIM_SlaveConfigSynchro(TIM_HandleTypeDef *htim, const TIM_SlaveConfigTypeDef *cfg) {
+    TIM_TypeDef *t = htim->Instance;
+    t->SMCR = (t->SMCR & ~(TIM_SMCR_TS | TIM_SMCR_SMS)) | cfg->InputTrigger | cfg->SlaveMode;
+    return HAL_OK;
+}
+
+/* 接收：只置忙状态，数据由测试直接写入DMA缓冲 */
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_t *buf, uint16_t size) {
+    (void)buf; (void)size;
+    huart->RxState = HAL_UART_STATE_BUSY_RX;
+    return HAL_OK;
+}
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *buf, uint16_t size, uint32_t timeout) {
+    (void)huart; (void)buf; (void)size; (void)timeout;
+    return HAL_OK;
+}
+__weak HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *buf, uint16_t size) {
+    (void)huart; (void)buf; (void)size;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *buf, uint32_t len) {
+    (void)hadc; (void)buf; (void)len;
+    return HAL_OK;
+}
+
+void Error_Handler(void) {
+    abort();
+}
@@ -0,0 +1,237 @@
+/**
+ * @file       stm32f4xx_hal.h
+ * @author     lsl-sys
+ * @brief      Host Stand-in for the STM32F4 HAL (Host Tests Only)
+ * @version    V1.0.0
+ * @date       2026-02-24
+ * @Encoding   UTF-8
+ * @note       主机测试用：只提供被测模块用到的HAL类型、寄存器结构、宏与函数声明，
+ *             外设实例与函数定义在 hal_stub.c（寄存器为普通内存，函数为空操作）。
+ *             Core/Inc/main.h 原样使用，经本文件替代真实HAL。
+ *             HAL_GetTick 返回 hal_stub_tick，DWT->CYCCNT 为普通变量，测试自行推进时间。
+ */
+
+#ifndef __STM32F4XX_HAL_H
+#define __STM32F4XX_HAL_H
+
+#include <stdint.h>
+
+#define __IO    volatile
+#define __weak  __attribute__((weak))
+
+typedef enum { HAL_OK = 0, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT } HAL_StatusTypeDef;
+typedef int IRQn_Type;
+
+/* ================= 寄存器结构 ================= */
+typedef struct { __IO uint32_t CR1, CR2, SMCR, DIER, SR, EGR, CCMR1, CCMR2, CCER, CNT, PSC, ARR, RCR,
+                 CCR1, CCR2, CCR3, CCR4, BDTR, DCR, DMAR; } TIM_TypeDef;
+typedef struct { __IO uint32_t CR, NDTR, PAR, M0AR, M1AR, FCR; } DMA_Stream_TypeDef;
+typedef struct { __IO uint32_t SR, DR, BRR, CR1, CR2, CR3, GTPR; } USART_TypeDef;
+typedef struct { __IO uint32_t SR, CR1, CR2, SMPR1, SMPR2, JOFR1, JOFR2, JOFR3, JOFR4, HTR, LTR,
+                 SQR1, SQR2, SQR3, JSQR, JDR1, JDR2, JDR3, JDR4, DR; } ADC_TypeDef;
+typedef struct { __IO uint32_t MODER, OTYPER, OSPEEDR, PUPDR, IDR, ODR, BSRR, LCKR, AFR[2]; } GPIO_TypeDef;
+typedef struct { __IO uint32_t CTRL, CYCCNT; } DWT_Type;
+typedef struct { __IO uint32_t DEMCR; } CoreDebug_Type;
+
+/* ================= 句柄 ================= */
+typedef struct { uint32_t Channel, Direction, PeriphInc, MemInc, PeriphDataAlignment, MemDataAlignment,
+                 Mode, Priority, FIFOMode, FIFOThreshold, MemBurst, PeriphBurst; } DMA_InitTypeDef;
+typedef struct __DMA_HandleTypeDef { DMA_Stream_TypeDef *Instance; DMA_InitTypeDef Init; void *Parent; } DMA_HandleTypeDef;
+
+typedef struct { uint32_t Prescaler, CounterMode, Period, ClockDivision, RepetitionCounter, AutoReloadPreload; } TIM_Base_InitTypeDef;
+typedef struct { TIM_TypeDef *Instance; TIM_Base_InitTypeDef Init; DMA_HandleTypeDef *hdma[7]; } TIM_HandleTypeDef;
+typedef struct { uint32_t OCMode, Pulse, OCPolarity, OCNPolarity, OCFastMode, OCIdleState, OCNIdleState; } TIM_OC_InitTypeDef;
+typedef struct { uint32_t MasterOutputTrigger, MasterSlaveMode; } TIM_MasterConfigTypeDef;
+typedef struct { uint32_t SlaveMode, InputTrigger, TriggerPolarity, TriggerPrescaler, TriggerFilter; } TIM_SlaveConfigTypeDef;
+
+typedef struct { uint32_t BaudRate, WordLength, StopBits, Parity, Mode, HwFlowCtl, OverSampling; } UART_InitTypeDef;
+typedef struct { USART_TypeDef *Instance; UART_InitTypeDef Init; DMA_HandleTypeDef *hdmarx, *hdmatx;
+                 __IO uint32_t gState, RxState; } UART_HandleTypeDef;
+
+typedef struct { uint32_t ClockPrescaler, Resolution, DataAlign, ScanConvMode, EOCSelection, ContinuousConvMode,
+                 NbrOfConversion, DiscontinuousConvMode, NbrOfDiscConversion, ExternalTrigConv,
+                 ExternalTrigConvEdge, DMAContinuousRequests; } ADC_InitTypeDef;
+typedef struct { ADC_TypeDef *Instance; ADC_InitTypeDef Init; DMA_HandleTypeDef *DMA_Handle; } ADC_HandleTypeDef;
+
+typedef enum { GPIO_PIN_RESET = 0, GPIO_PIN_SET } GPIO_PinState;
+
+/* ================= 外设实例（hal_stub.c） ================= */
+extern DWT_Type *DWT;
+extern CoreDebug_Type *CoreDebug;
+extern TIM_TypeDef *TIM1, *TIM2, *TIM3, *TIM4;
+extern GPIO_TypeDef hal_stub_gpio[4];
+extern DMA_Stream_TypeDef *DMA1_Stream0, *DMA1_Stream1, *DMA1_Stream2, *DMA1_Stream3,
+                          *DMA1_Stream4, *DMA1_Stream5, *DMA1_Stream6, *DMA1_Stream7,
+                          *DMA2_Stream0, *DMA2_Stream1, *DMA2_Stream2, *DMA2_Stream3,
+                          *DMA2_Stream4, *DMA2_Stream5, *DMA2_Stream6, *DMA2_Stream7;
+extern uint32_t SystemCoreClock;
+extern uint32_t hal_stub_tick;
+
+#define GPIOA   (&hal_stub_gpio[0])
+#define GPIOB   (&hal_stub_gpio[1])
+#define GPIOC   (&hal_stub_gpio[2])
+#define GPIOD   (&hal_stub_gpio[3])
+
+enum {
+    DMA1_Stream0_IRQn = 11, DMA1_Stream1_IRQn, DMA1_Stream2_IRQn, DMA1_Stream3_IRQn,
+    DMA1_Stream4_IRQn, DMA1_Stream5_IRQn, DMA1_Stream6_IRQn, DMA1_Stream7_IRQn = 47,
+    DMA2_Stream0_IRQn = 56, DMA2_Stream1_IRQn, DMA2_Stream2_IRQn, DMA2_Stream3_IRQn,
+    DMA2_Stream4_IRQn, DMA2_Stream5_IRQn = 68, DMA2_Stream6_IRQn, DMA2_Stream7_IRQn,
+};
+
+/* ================= 常量 ================= */
+#define GPIO_PIN_0                  0x0001u
+#define GPIO_PIN_1                  0x0002u
+#define GPIO_PIN_2                  0x0004u
+#define GPIO_PIN_3                  0x0008u
+#define GPIO_PIN_4                  0x0010u
+#define GPIO_PIN_5                  0x0020u
+#define GPIO_PIN_6                  0x0040u
+#define GPIO_PIN_7                  0x0080u
+#define GPIO_PIN_8                  0x0100u
+#define GPIO_PIN_9                  0x0200u
+#define GPIO_PIN_10                 0x0400u
+#define GPIO_PIN_11                 0x0800u
+#define GPIO_PIN_12                 0x1000u
+
+#define TIM_CHANNEL_1               0x00u
+#define TIM_CHANNEL_2               0x04u
+#define TIM_CHANNEL_3               0x08u
+#define TIM_CHANNEL_4               0x0Cu
+#define TIM_CR1_CEN                 0x0001u
+#define TIM_CR1_UDIS                0x0002u
+#define TIM_CR1_URS                 0x0004u
+#define TIM_CR1_OPM                 0x0008u
+#define TIM_CR1_ARPE                0x0080u
+#define TIM_EGR_UG                  0x0001u
+#define TIM_SR_UIF                  0x0001u
+#define TIM_DIER_UDE                0x0100u
+#define TIM_CCER_CC1E               0x0001u
+#define TIM_CCER_CC1P               0x0002u
+#define TIM_CCMR1_OC1M              0x0070u
+#define TIM_CCMR1_OC1PE             0x0008u
+#define TIM_CCMR1_OC2PE             0x0800u
+#define TIM_CCMR2_OC3PE             0x0008u
+#define TIM_CCMR2_OC4PE             0x0800u
+#define TIM_DCR_DBL_Pos             8
+#define TIM_DMABASE_CCR1            0x0Du
+#define TIM_DMA_UPDATE              TIM_DIER_UDE
+#define TIM_DMA_ID_UPDATE           0
+#define TIM_CR2_MMS                 0x0070u
+#define TIM_SMCR_SMS                0x0007u
+#define TIM_SMCR_TS                 0x0070u
+#define TIM_SMCR_MSM                0x0080u
+#define TIM_TRGO_ENABLE             0x0010u
+#define TIM_MASTERSLAVEMODE_ENABLE  0x0080u
+#define TIM_SLAVEMODE_TRIGGER       0x0006u
+#define TIM_TS_ITR0                 0x0000u
+#define TIM_TS_ITR1                 0x0010u
+#define TIM_TS_ITR2                 0x0020u
+#define TIM_TS_ITR3                 0x0030u
+#define TIM_OCMODE_PWM1             0x0060u
+#define TIM_OCMODE_PWM2             0x0070u
+#define TIM_OCPOLARITY_HIGH         0x0000u
+#define TIM_OCFAST_DISABLE          0x0000u
+
+#define DMA_SxCR_EN                 0x0001u
+#define DMA_CHANNEL_0               0x00000000u
+#define DMA_CHANNEL_2               0x04000000u
+#define DMA_CHANNEL_3               0x06000000u
+#define DMA_CHANNEL_5               0x0A000000u
+#define DMA_CHANNEL_6               0x0C000000u
+#define DMA_PERIPH_TO_MEMORY        0x00u
+#define DMA_MEMORY_TO_PERIPH        0x40u
+#define DMA_PINC_DISABLE            0x00u
+#define DMA_MINC_ENABLE             0x400u
+#define DMA_PDATAALIGN_HALFWORD     0x0800u
+#define DMA_PDATAALIGN_WORD         0x1000u
+#define DMA_MDATAALIGN_HALFWORD     0x2000u
+#define DMA_MDATAALIGN_WORD         0x4000u
+#define DMA_NORMAL                  0x00u
+#define DMA_CIRCULAR                0x100u
+#define DMA_PRIORITY_LOW            0x00000u
+#define DMA_PRIORITY_HIGH           0x20000u
+#define DMA_PRIORITY_VERY_HIGH      0x30000u
+#define DMA_FIFOMODE_DISABLE        0x00u
+#define DMA_IT_HT                   0x08u
+#define DMA_IT_TC                   0x10u
+
+#define HAL_UART_STATE_READY        0x20u
+#define HAL_UART_STATE_BUSY_RX      0x22u
+#define UART_IT_IDLE                0x10u
+
+#define DWT_CTRL_CYCCNTENA_Msk      0x00000001u
+#define CoreDebug_DEMCR_TRCENA_Msk  0x01000000u
+
+#define ENABLE                      1
+#define DISABLE                     0
+
+/* ================= 宏（寄存器为普通内存，标志类读回0） ================= */
+#define UNUSED(x)                               ((void)(x))
+#define READ_REG(r)                             (r)
+#define WRITE_REG(r, v)                         ((r) = (v))
+#define SET_BIT(r, b)                           ((r) |= (b))
+#define CLEAR_BIT(r, b)                         ((r) &= ~(b))
+#define MODIFY_REG(r, c, s)                     ((r) = (((r) & ~(c)) | (s)))
+
+#define __HAL_TIM_SET_COMPARE(h, c, v)          (*(&(h)->Instance->CCR1 + ((c) >> 2)) = (v))
+#define __HAL_TIM_GET_COMPARE(h, c)             (*(&(h)->Instance->CCR1 + ((c) >> 2)))
+#define __HAL_TIM_GET_AUTORELOAD(h)             ((h)->Instance->ARR)
+#define __HAL_TIM_SET_AUTORELOAD(h, v)          ((h)->Instance->ARR = (v))
+#define __HAL_TIM_SET_PRESCALER(h, v)           ((h)->Instance->PSC = (v))
+#define __HAL_TIM_SET_COUNTER(h, v)             ((h)->Instance->CNT = (v))
+#define __HAL_TIM_GET_COUNTER(h)                ((h)->Instance->CNT)
+#define __HAL_TIM_ENABLE(h)                     ((h)->Instance->CR1 |= TIM_CR1_CEN)
+#define __HAL_TIM_DISABLE(h)                    ((h)->Instance->CR1 &= ~TIM_CR1_CEN)
+#define __HAL_TIM_ENABLE_DMA(h, d)              ((h)->Instance->DIER |= (d))
+#define __HAL_TIM_DISABLE_DMA(h, d)             ((h)->Instance->DIER &= ~(d))
+#define __HAL_TIM_ENABLE_OCxPRELOAD(h, c)       ((void)(h), (void)(c))
+#define __HAL_TIM_DISABLE_OCxPRELOAD(h, c)      ((void)(h), (void)(c))
+
+#define __HAL_DMA_ENABLE(h)                     ((h)->Instance->CR |= DMA_SxCR_EN)
+#define __HAL_DMA_DISABLE(h)                    ((h)->Instance->CR &= ~DMA_SxCR_EN)
+#define __HAL_DMA_ENABLE_IT(h, i)               ((void)(h), (void)(i))
+#define __HAL_DMA_DISABLE_IT(h, i)              ((void)(h), (void)(i))
+#define __HAL_DMA_GET_COUNTER(h)                ((h)->Instance->NDTR)
+#define __HAL_DMA_GET_FLAG(h, f)                ((void)(h), (void)(f), 0u)
+#define __HAL_DMA_CLEAR_FLAG(h, f)              ((void)(h), (void)(f))
+#define __HAL_DMA_GET_TC_FLAG_INDEX(h)          0x20u
+#define __HAL_DMA_GET_HT_FLAG_INDEX(h)          0x10u
+#define __HAL_DMA_GET_TE_FLAG_INDEX(h)          0x08u
+#define __HAL_DMA_GET_FE_FLAG_INDEX(h)          0x01u
+#define __HAL_DMA_GET_DME_FLAG_INDEX(h)         0x04u
+#define __HAL_LINKDMA(h, f, d)                  do { (h)->f = &(d); (d).Parent = (h); } while (0)
+#define __HAL_UART_ENABLE_IT(h, i)              ((void)(h), (void)(i))
+
+static inline void __disable_irq(void) {}
+static inline void __enable_irq(void) {}
+static inline void __DSB(void) {}
+static inline void __NOP(void) {}
+
+/* ================= 函数（hal_stub.c，空操作） ================= */
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t ms);
+uint32_t HAL_RCC_GetHCLKFreq(void);
+uint32_t HAL_RCC_GetPCLK1Freq(void);
+uint32_t HAL_RCC_GetPCLK2Freq(void);
+void HAL_NVIC_SetPriority(IRQn_Type irq, uint32_t pre, uint32_t sub);
+void HAL_NVIC_EnableIRQ(IRQn_Type irq);
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma);
+HAL_StatusTypeDef HAL_DMA_DeInit(DMA_HandleTypeDef *hdma);
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma);
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma);
+
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t ch);
+HAL_StatusTypeDef HAL_TIM_PWM_Stop(TIM_HandleTypeDef *htim, uint32_t ch);
+HAL_StatusTypeDef HAL_TIM_PWM_ConfigChannel(TIM_HandleTypeDef *htim, const TIM_OC_InitTypeDef *oc, uint32_t ch);
+HAL_StatusTypeDef HAL_TIMEx_MasterConfigSynchronization(TIM_HandleTypeDef *htim, const TIM_MasterConfigTypeDef *cfg);
+HAL_StatusTypeDef HAL_TIM_SlaveConfigSynchro(TIM_HandleTypeDef *htim, const TIM_SlaveConfigTypeDef *cfg);
+
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_t *buf, uint16_t size);
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *buf, uint16_t size, uint32_t timeout);
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *buf, uint16_t size);
+
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *buf, uint32_t len);
+
+#endif
@@ -0,0 +1,169 @@
+/**
+ * @file       test_alt_hold.c
+ * @author     lsl-sys
+ * @brief      Altitude-hold Cascade Tests (Height → Climb Rate → Throttle)
+ * @version    V1.0.0
+ * @date       2026-02-24
+ * @Encoding   UTF-8
+ * @note       竖直对象：加速度与（油门 - 真实悬停油门）成正比，真实悬停油门与 PID_InitAll 给定值不同，
+ *             由爬升率环积分学习。控制周期与 Loop_100Hz 一致，测量直接取对象高度/速度。
+ *             检查：油门杆死区与爬升率映射、开启定高时积分预置（无扰切换）、
+ *             松杆锁定与再次锁定（锁在松杆时刻高度并保持）、测量无效时保持油门并在恢复后重新锁定。
+ */
+
+#include "pid_control.h"
+#include "test_util.h"
+
+#define HOVER_INIT      40.0f       // PID_InitAll 给定的悬停油门
+#define HOVER_TRUE      46.0f       // 对象真实悬停油门
+#define THR_ACCEL       20.0f       // 每1%油门偏差的竖直加速度 (cm/s²)
+#define DT              (1.0f / PID_LOOP_HZ)
+
+static float alt, vel;
+
+static float Step(float stick, uint8_t valid)
+{
+    float thr = PID_UpdateAltHold(stick, alt, vel, valid);
+    vel += (thr - HOVER_TRUE) * THR_ACCEL * DT;
+    alt += vel * DT;
+    return thr;
+}
+
+static void Run(float stick, float seconds)
+{
+    for (int k = 0; k < (int)(seconds * PID_LOOP_HZ); k++) Step(stick, 1);
+}
+
+/* 死区内锁高，死区外线性映射到 ±ALT_MAX_CLIMB_CMS */
+static void TestStickDeadband(void)
+{
+    static const float stick[] = {0.0f, 9.9f, -9.9f, 10.0f, 55.0f, -55.0f, 100.0f, -100.0f};
+    static const float climb[] = {0.0f, 0.0f, 0.0f, 0.0f, 25.0f, -25.0f, ALT_MAX_CLIMB_CMS, -ALT_MAX_CLIMB_CMS};
+
+    PID_InitAll(HOVER_INIT);
+    PID_SetAltHold(1, HOVER_INIT);
+    for (size_t i = 0; i < sizeof(stick) / sizeof(stick[0]); i++) {
+        PID_UpdateAltHold(stick[i], 100.0f, 0.0f, 1);
+        if (climb[i] == 0.0f) {
+            CHECK(g_pid.altitude.locked == 1);
+            CHECK_NEAR(g_pid.altitude.target_alt, 100.0f, 1e-4f);
+        } else {
+            CHECK(g_pid.altitude.locked == 0);
+            CHECK_NEAR(g_pid.altitude.target_vel, climb[i], 1e-4f);
+        }
+    }
+}
+
+/* 开启定高：积分预置为（当前手动油门 - 悬停油门），首周期输出等于手动油门 */
+static void TestEntryPreset(void)
+{
+    PID_InitAll(HOVER_INIT);
+    PID_SetAltHold(1, 55.0f);
+    CHECK_NEAR(g_pid.altitude.vel.ki * g_pid.altitude.vel.integ, 55.0f - HOVER_INIT, 1e-3f);
+    float out = PID_UpdateAltHold(0.0f, 120.0f, 0.0f, 1);
+    CHECK_NEAR(out, 55.0f, 0.05f);
+
+    // 预置限幅在 ±MAX_ALT_OUTPUT 内
+    PID_InitAll(HOVER_INIT);
+    PID_SetAltHold(1, 95.0f);
+    CHECK_NEAR(g_pid.altitude.vel.ki * g_pid.altitude.vel.integ, MAX_ALT_OUTPUT, 1e-3f);
+
+    // 关闭定高不预置
+    PID_SetAltHold(0, 55.0f);
+    CHECK(g_pid.altitude.enabled == 0);
+    CHECK_NEAR(g_pid.altitude.vel.integ, 0.0f, 1e-6f);
+}
+
+/* 悬停锁定 → 推杆爬升 → 松杆在松杆时刻高度重新锁定并保持 */
+static void TestLockRelock(void)
+{
+    PID_InitAll(HOVER_INIT);
+    alt = 100.0f;
+    vel = 0.0f;
+    PID_SetAltHold(1, HOVER_TRUE);          // 手动悬停时开启：预置积分即真实悬停油门
+
+    Run(0.0f, 3.0f);
+    printf("hold: alt %.2f cm (locked at %.2f)\n", alt, g_pid.altitude.target_alt);
+    CHECK(g_pid.altitude.locked == 1);
+    CHECK_NEAR(g_pid.altitude.target_alt, 100.0f, 1e-4f);
+    CHECK_NEAR(alt, 100.0f, 0.5f);
+
+    // 满杆爬升2s：爬升率跟踪 ALT_MAX_CLIMB_CMS
+    Run(100.0f, 2.0f);
+    CHECK(g_pid.altitude.locked == 0);
+    CHECK_NEAR(vel, ALT_MAX_CLIMB_CMS, 5.0f);
+
+    // 松杆：锁在松杆时刻高度，刹车过冲后回到该高度
+    float release = alt;
+    float peak = alt;
+    for (int k = 0; k < 5 * PID_LOOP_HZ; k++) {
+        Step(0.0f, 1);
+        if (alt > peak) peak = alt;
+    }
+    printf("relock: release %.1f cm, target %.1f, overshoot %.1f, final %.2f\n",
+           release, g_pid.altitude.target_alt, peak - release, alt);
+    CHECK(g_pid.altitude.locked == 1);
+    CHECK_NEAR(g_pid.altitude.target_alt, release, 1.0f);
+    CHECK_NEAR(alt, g_pid.altitude.target_alt, 1.0f);
+    CHECK(peak - release < 30.0f);
+
+    // 下降同理
+    Run(-100.0f, 1.0f);
+    CHECK(vel < -0.8f * ALT_MAX_CLIMB_CMS);
+    release = alt;
+    Run(0.0f, 5.0f);
+    CHECK_NEAR(g_pid.altitude.target_alt, release, 1.0f);
+    CHECK_NEAR(alt, g_pid.altitude.target_alt, 1.0f);
+}
+
+/* 悬停油门估计偏差：积分学习真实悬停油门，锁高不掉高 */
+static void TestHoverLearning(void)
+{
+    PID_InitAll(HOVER_INIT);
+    alt = 80.0f;
+    vel = 0.0f;
+    PID_SetAltHold(1, HOVER_INIT);          // 手动油门即错误的悬停值，开启后先掉高
+
+    float low = alt;
+    for (int k = 0; k < 20 * PID_LOOP_HZ; k++) {
+        Step(0.0f, 1);
+        if (alt < low) low = alt;
+    }
+    float learned = HOVER_INIT + g_pid.altitude.vel.ki * g_pid.altitude.vel.integ;
+    printf("hover learning: sag %.1f cm, learned hover %.2f%% (true %.1f), final alt %.2f\n",
+           80.0f - low, learned, HOVER_TRUE, alt);
+    CHECK_NEAR(learned, HOVER_TRUE, 0.2f);
+    CHECK_NEAR(alt, 80.0f, 1.0f);
+}
+
+/* 测量无效：保持上次油门并解除锁定；恢复后在新高度重新锁定 */
+static void TestInvalidMeasurement(void)
+{
+    PID_InitAll(HOVER_INIT);
+    alt = 100.0f;
+    vel = 0.0f;
+    PID_SetAltHold(1, HOVER_TRUE);
+    Run(0.0f, 1.0f);
+
+    float held = g_pid.altitude.output;
+    float out = PID_UpdateAltHold(0.0f, 500.0f, -80.0f, 0);     // 无效测量不参与计算
+    CHECK_NEAR(out, held, 1e-6f);
+    CHECK(g_pid.altitude.locked == 0);
+
+    alt = 130.0f;                                               // 无效期间漂到新高度
+    vel = 0.0f;
+    Run(0.0f, 3.0f);
+    CHECK(g_pid.altitude.locked == 1);
+    CHECK_NEAR(g_pid.altitude.target_alt, 130.0f, 1e-3f);
+    CHECK_NEAR(alt, 130.0f, 0.5f);
+}
+
+int main(void)
+{
+    TestStickDeadband();
+    TestEntryPreset();
+    TestLockRelock();
+    TestHoverLearning();
+    TestInvalidMeasurement();
+    return TEST_RESULT();
+}
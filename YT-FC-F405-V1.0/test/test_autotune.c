@@ -0,0 +1,255 @@
+/**
+ * @file       test_autotune.c
+ * @author     lsl-sys
+ * @brief      Relay Autotuner Closed-loop Tests Against a Host Rate Plant
+ * @version    V1.0.0
+ * @date       2026-02-24
+ * @Encoding   UTF-8
+ * @note       每轴对象：2个控制周期传输延迟（计算+电调）→ 电机一阶滞后 → 角速度（带阻尼）→ 角度积分。
+ *             极限环的Ku/Tu由对象离散频率响应按滞环继电器描述函数解析求出，与自整定测量值比较；
+ *             控制顺序与 Loop_100Hz 一致：PID_UpdateAttitude（MODE_AUTOTUNE，按自稳）→ AutoTune_Update → 对象。
+ *             检查：Ku/Tu、经 PID_SetRateParam 写入的增益、继电器中心在RELAY期间锁存、
+ *             倾角超限中止（已完成轴保留新参数）、无极限环时超时中止（参数不变）。
+ */
+
+#include "autotune.h"
+#include "test_util.h"
+#include <complex.h>
+
+#define PLANT_DELAY     2           // 传输延迟（控制周期）
+#define PLANT_ACT       0.2f        // 电机一阶滞后系数
+#define PLANT_DAMP      0.02f       // 空气阻尼
+#define PITCH_GAIN      1.0f        // 力矩 → 每周期角速度增量
+#define ROLL_GAIN       1.5f
+
+typedef struct {
+    float gain;
+    float u_hist[PLANT_DELAY];
+    float act, rate, angle;
+} Plant_t;
+
+static void Plant_Init(Plant_t *p, float gain)
+{
+    memset(p, 0, sizeof(*p));
+    p->gain = gain;
+}
+
+/* 一个控制周期：u 为本周期力矩输出，disturb 为外部扰动力矩 */
+static void Plant_Step(Plant_t *p, float u, float disturb)
+{
+    float u_del = p->u_hist[0];
+    for (int i = 0; i < PLANT_DELAY - 1; i++) p->u_hist[i] = p->u_hist[i + 1];
+    p->u_hist[PLANT_DELAY - 1] = u;
+
+    p->act += PLANT_ACT * (u_del + disturb - p->act);
+    p->rate = (1.0f - PLANT_DAMP) * p->rate + p->gain * p->act;
+    p->angle += p->rate / PID_LOOP_HZ;
+}
+
+/* 对象离散频率响应 G(e^jw)：rate/u = g*A*z / ((z-(1-A))(z-(1-D))) * z^-L */
+static double complex PlantResponse(double gain, double w)
+{
+    double complex z = cexp(I * w);
+    return gain * PLANT_ACT * z / ((z - (1.0 - PLANT_ACT)) * (z - (1.0 - PLANT_DAMP))) * cpow(z, -PLANT_DELAY);
+}
+
+/**
+ * @brief 继电器极限环预测（描述函数）
+ * @note  滞环继电器 -1/N(a) = -(πa/4d)·(√(1-(ε/a)²) + jε/a)：振荡点在对象相位 -180°+asin(ε/a) 处，
+ *        幅值 a = 4d|G|/π。此时 Ku = 4d/(πa) = 1/|G| 正是自整定按幅值计算的值。
+ *        继电器按采样判定切换，越过滞环到切换平均滞后半个周期，预测中计入 e^(-jw/2)；
+ *        滞环使该点低于对象相位交越频率，与理想继电器（对象 -180° 处，ideal_*）的偏差只打印
+ */
+static void RelayPoint(double gain, double *ku, double *tu, double *ideal_ku, double *ideal_tu)
+{
+    double prev = carg(PlantResponse(gain, 1e-4)), unwrapped = prev;
+    int found = 0;
+    *ku = *tu = *ideal_ku = *ideal_tu = 0.0;
+    for (int i = 1; i <= 100000 && found < 2; i++) {
+        double w = M_PI * i / 100000.0;
+        double complex g = PlantResponse(gain, w) * cexp(-0.5 * I * w);
+        double ph = carg(g);
+        double d = ph - prev;
+        if (d > M_PI) d -= 2.0 * M_PI;
+        if (d < -M_PI) d += 2.0 * M_PI;
+        unwrapped += d;
+        prev = ph;
+
+        double a = 4.0 * AT_RELAY_AMP * cabs(g) / M_PI;
+        double lag = (a > AT_RELAY_HYST) ? asin(AT_RELAY_HYST / a) : M_PI / 2.0;
+        if (*ku == 0.0 && unwrapped <= -M_PI + lag) {
+            *ku = 1.0 / cabs(g);
+            *tu = 2.0 * M_PI / w / PID_LOOP_HZ;
+            found++;
+        }
+        if (*ideal_ku == 0.0 && unwrapped + 0.5 * w <= -M_PI) {
+            *ideal_ku = 1.0 / cabs(g);
+            *ideal_tu = 2.0 * M_PI / w / PID_LOOP_HZ;
+            found++;
+        }
+    }
+}
+
+static Plant_t pitch, roll;
+static float center_min, center_max;    // RELAY期间继电器中心的范围
+
+/**
+ * @brief 运行至自整定结束或超时
+ * @param gust_axis 在该轴的RELAY阶段施加阵风扰动（AXIS_COUNT 表示无）
+ * @return 运行的控制周期数
+ */
+static int RunTune(uint8_t mask, PID_Axis_t gust_axis, int max_cycles)
+{
+    int k, gust = 0;
+    center_min = 1e6f;
+    center_max = -1e6f;
+
+    PID_SetMode(MODE_AUTOTUNE);
+    AutoTune_Start(mask);
+    for (k = 0; k < max_cycles && AutoTune_IsActive(); k++) {
+        PID_UpdateAttitude(0.0f, 0.0f, 0.0f, pitch.angle, roll.angle, 0.0f, pitch.rate, roll.rate, 0.0f);
+        AutoTune_Update(pitch.rate, roll.rate, 0.0f, pitch.angle, roll.angle);
+
+        float d_pitch = 0.0f, d_roll = 0.0f;
+        if (g_autotune.state == AT_RELAY) {
+            if (g_autotune.center < center_min) center_min = g_autotune.center;
+            if (g_autotune.center > center_max) center_max = g_autotune.center;
+            // 阵风：RELAY 1s后持续0.5s的单向力矩，大于继电器幅值
+            if (g_autotune.axis == gust_axis && g_autotune.tick > PID_LOOP_HZ && gust < PID_LOOP_HZ / 2) {
+                gust++;
+                if (gust_axis == AXIS_PITCH) d_pitch = 3.0f * AT_RELAY_AMP;
+                else d_roll = 3.0f * AT_RELAY_AMP;
+            }
+        }
+        Plant_Step(&pitch, g_pid.out.pitch, d_pitch);
+        Plant_Step(&roll, g_pid.out.roll, d_roll);
+    }
+    return k;
+}
+
+/* Tyreus-Luyben（pid_core离散增益）由 Ku/Tu 计算，与写入值比较 */
+static void CheckWrittenGains(PID_Axis_t axis, const PIDController *pc)
+{
+    float ku = g_autotune.ku[axis], tu = g_autotune.tu[axis];
+    float kp = ku / 2.2f;
+    float ki = kp * (1.0f / PID_LOOP_HZ) / (2.2f * tu);
+    float kd = kp * (tu / 6.3f) * PID_LOOP_HZ;
+
+    CHECK_NEAR(g_autotune.result[axis].kp, kp, 1e-5f);
+    CHECK_NEAR(g_autotune.result[axis].ki, ki, 1e-6f);
+    CHECK_NEAR(g_autotune.result[axis].kd, kd, 1e-4f);
+    // 经 PID_SetRateParam 写入角速度环
+    CHECK_NEAR(pc->kp, g_autotune.result[axis].kp, 1e-6f);
+    CHECK_NEAR(pc->ki, g_autotune.result[axis].ki, 1e-6f);
+    CHECK_NEAR(pc->kd, g_autotune.result[axis].kd, 1e-6f);
+}
+
+static void TestTuneRatePlant(void)
+{
+    double ku_p, tu_p, ku_r, tu_r, ideal_ku, ideal_tu;
+    RelayPoint(PITCH_GAIN, &ku_p, &tu_p, &ideal_ku, &ideal_tu);
+    printf("pitch plant: ideal relay Ku %.3f Tu %.3f s, with %.0f dps hysteresis Ku %.3f Tu %.3f s\n",
+           ideal_ku, ideal_tu, AT_RELAY_HYST, ku_p, tu_p);
+    RelayPoint(ROLL_GAIN, &ku_r, &tu_r, &ideal_ku, &ideal_tu);
+
+    PID_InitAll(40.0f);
+    memset(&g_autotune, 0, sizeof(g_autotune));
+    Plant_Init(&pitch, PITCH_GAIN);
+    Plant_Init(&roll, ROLL_GAIN);
+    int cycles = RunTune(AT_AXIS_PITCH | AT_AXIS_ROLL, AXIS_COUNT, 30 * PID_LOOP_HZ);
+
+    printf("pitch: Ku %.3f (predicted %.3f) Tu %.3f s (predicted %.3f)\n", g_autotune.ku[AXIS_PITCH], ku_p,
+           g_autotune.tu[AXIS_PITCH], tu_p);
+    printf("roll:  Ku %.3f (predicted %.3f) Tu %.3f s (predicted %.3f)\n", g_autotune.ku[AXIS_ROLL], ku_r,
+           g_autotune.tu[AXIS_ROLL], tu_r);
+    printf("gains pitch kp %.3f ki %.4f kd %.3f, roll kp %.3f ki %.4f kd %.3f, %.1f s\n",
+           g_pid.attitude.rate.pitch.kp, g_pid.attitude.rate.pitch.ki, g_pid.attitude.rate.pitch.kd,
+           g_pid.attitude.rate.roll.kp, g_pid.attitude.rate.roll.ki, g_pid.attitude.rate.roll.kd,
+           (float)cycles / PID_LOOP_HZ);
+
+    CHECK(g_autotune.state == AT_DONE);
+    // 与描述函数预测的极限环比较（周期按控制周期量化，峰值为采样值）
+    CHECK(fabs(g_autotune.ku[AXIS_PITCH] - ku_p) < 0.1 * ku_p);
+    CHECK(fabs(g_autotune.tu[AXIS_PITCH] - tu_p) < 0.1 * tu_p);
+    CHECK(fabs(g_autotune.ku[AXIS_ROLL] - ku_r) < 0.1 * ku_r);
+    CHECK(fabs(g_autotune.tu[AXIS_ROLL] - tu_r) < 0.1 * tu_r);
+    // 对象增益1.5倍 → 临界增益约为2/3
+    CHECK_NEAR(g_autotune.ku[AXIS_ROLL] / g_autotune.ku[AXIS_PITCH], PITCH_GAIN / ROLL_GAIN, 0.1);
+
+    CheckWrittenGains(AXIS_PITCH, &g_pid.attitude.rate.pitch);
+    CheckWrittenGains(AXIS_ROLL, &g_pid.attitude.rate.roll);
+    // 偏航未整定
+    CHECK_NEAR(g_pid.attitude.rate.yaw.kp, DEFAULT_YAW_RATE_KP, 1e-6f);
+
+    // 自稳下外环目标随振荡姿态摆动，继电器中心在RELAY期间保持进入时的值
+    CHECK(center_max - center_min < 1e-6f);
+}
+
+/* 硬角度环（外环目标随振荡姿态明显摆动）：测量值仍是角速度对象的极限环 */
+static void TestStiffAngleLoop(void)
+{
+    double ku, tu, ideal_ku, ideal_tu;
+    RelayPoint(PITCH_GAIN, &ku, &tu, &ideal_ku, &ideal_tu);
+
+    PID_InitAll(40.0f);
+    memset(&g_autotune, 0, sizeof(g_autotune));
+    pidParam_t angle = {6.0f, 0.0f, 0.0f, 0.0f};
+    PID_SetAngleParam(AXIS_PITCH, &angle);
+    Plant_Init(&pitch, PITCH_GAIN);
+    Plant_Init(&roll, ROLL_GAIN);
+    RunTune(AT_AXIS_PITCH, AXIS_COUNT, 30 * PID_LOOP_HZ);
+
+    printf("angle kp 6: Ku %.3f Tu %.3f s (rate plant %.3f / %.3f)\n",
+           g_autotune.ku[AXIS_PITCH], g_autotune.tu[AXIS_PITCH], ku, tu);
+    CHECK(g_autotune.state == AT_DONE);
+    CHECK(fabs(g_autotune.ku[AXIS_PITCH] - ku) < 0.1 * ku);
+    CHECK(fabs(g_autotune.tu[AXIS_PITCH] - tu) < 0.1 * tu);
+    CHECK(center_max - center_min < 1e-6f);
+}
+
+/* 阵风使倾角超限：中止，已完成的俯仰保留新参数，横滚保持原参数 */
+static void TestAbortOnTilt(void)
+{
+    PID_InitAll(40.0f);
+    memset(&g_autotune, 0, sizeof(g_autotune));
+    Plant_Init(&pitch, PITCH_GAIN);
+    Plant_Init(&roll, ROLL_GAIN);
+    RunTune(AT_AXIS_PITCH | AT_AXIS_ROLL, AXIS_ROLL, 30 * PID_LOOP_HZ);
+
+    printf("tilt abort: state %d, roll angle %.1f deg\n", g_autotune.state, roll.angle);
+    CHECK(g_autotune.state == AT_FAILED);
+    CHECK(g_autotune.axis == AXIS_ROLL);
+    CHECK(fabsf(roll.angle) > AT_MAX_ANGLE);
+    CHECK(fabsf(roll.angle) < AT_MAX_ANGLE + 10.0f);        // 越限当周期中止
+    CHECK(g_pid.attitude.rate.pitch.kp != DEFAULT_PITCH_RATE_KP);
+    CHECK_NEAR(g_pid.attitude.rate.roll.kp, DEFAULT_ROLL_RATE_KP, 1e-6f);
+    CHECK_NEAR(g_pid.attitude.rate.roll.ki, DEFAULT_ROLL_RATE_KI, 1e-6f);
+    CHECK_NEAR(g_pid.attitude.rate.roll.integ, 0.0f, 1e-6f);
+}
+
+/* 对象增益过小，角速度振荡达不到继电器滞环：不形成极限环，单轴超时中止 */
+static void TestAbortOnTimeout(void)
+{
+    PID_InitAll(40.0f);
+    memset(&g_autotune, 0, sizeof(g_autotune));
+    Plant_Init(&pitch, 0.005f);
+    Plant_Init(&roll, ROLL_GAIN);
+    int cycles = RunTune(AT_AXIS_PITCH, AXIS_COUNT, 30 * PID_LOOP_HZ);
+
+    int expect = (AT_SETTLE_MS + AT_AXIS_TIMEOUT_MS) * PID_LOOP_HZ / 1000;
+    printf("timeout abort after %d cycles (expected %d)\n", cycles, expect);
+    CHECK(g_autotune.state == AT_FAILED);
+    CHECK(g_autotune.measured < AT_MEASURE_CYCLES);
+    CHECK(abs(cycles - expect) <= 1);
+    CHECK_NEAR(g_pid.attitude.rate.pitch.kp, DEFAULT_PITCH_RATE_KP, 1e-6f);
+    CHECK_NEAR(g_pid.attitude.rate.pitch.kd, DEFAULT_PITCH_RATE_KD, 1e-6f);
+}
+
+int main(void)
+{
+    TestTuneRatePlant();
+    TestStiffAngleLoop();
+    TestAbortOnTilt();
+    TestAbortOnTimeout();
+    return TEST_RESULT();
+}
@@ -0,0 +1,1014 @@
+/**
+ * @file       test_crsf.c
+ * @author     lsl-sys
+ * @brief      CRSF Byte-stream Replay and Parser Benchmark
+ * @version    V1.0.0
+ * @date       2026-02-24
+ * @Encoding   UTF-8
+ * @note       直接包含 ELRS.c 以访问DMA循环缓冲与解析器（elrs_rx_buf、crsf_parse_byte、crsf_crc8）。
+ *             DMA模拟：字节按写指针写入 elrs_rx_buf，与硬件相同在半满/满（回绕）与空闲（每段末尾）时
+ *             调用 crsf_receive_data，帧可在任意位置跨越缓冲区末尾。
+ *             回放：按协议构造的混合帧流（RC/链路统计/PING/MSP/只计数类型/未知类型 + 帧间杂字节），
+ *             随机分段；逐偏移的回绕切分；CRC损坏帧与非法长度后的重新同步。
+ *             链路健康度：按包速率准时送帧（250→50→500 Hz），检查帧间隔重新学习、失控超时限幅、
+ *             LQ预警等级与回差/保持、完全丢失后的失控时延。
+ *             遥测：截获发送DMA，解码各帧负载并检查CRC，发出的帧再送回本机解析器；
+ *             RC帧驱动回复时隙，逐时隙比对超期调度与DMA忙补发。
+ *             基准：420000波特满速（10位/字节，42000 B/s）下解析器主机耗时与CPU占用，只打印。
+ */
+
+#include "ELRS.c"
+#include "telemetry.h"
+#include "imu.h"
+#include "flight_mode.h"
+#include "flight_state.h"
+#include "failsafe.h"
+#include "test_util.h"
+#include <stdlib.h>
+
+#define STREAM_MAX      200000
+
+static uint16_t dma_pos;                    // 模拟DMA写指针
+static uint8_t stream[STREAM_MAX];
+static uint32_t rng = 12345u;
+
+static uint32_t Rand(void)
+{
+    rng = rng * 1664525u + 1013904223u;
+    return rng >> 8;
+}
+
+static void Reset(void)
+{
+    crsf_init();
+    dma_pos = 0;
+    memset(crsf_rc_latest, 0, sizeof(crsf_rc_latest));
+}
+
+/* 协议定义的CRC8（多项式0xD5，逐位计算），与查表实现对照 */
+static uint8_t ReferenceCrc8(const uint8_t *d, int n)
+{
+    uint8_t crc = 0;
+    while (n--) {
+        crc ^= *d++;
+        for (int b = 0; b < 8; b++) crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0xD5) : (uint8_t)(crc << 1);
+    }
+    return crc;
+}
+
+/* [地址, 长度=负载+2, 类型, 负载, CRC(类型+负载)]，返回帧长 */
+static int BuildFrame(uint8_t *f, uint8_t addr, uint8_t type, const uint8_t *payload, int plen)
+{
+    f[0] = addr;
+    f[1] = (uint8_t)(plen + 2);
+    f[2] = type;
+    memcpy(&f[3], payload, plen);
+    f[plen + 3] = ReferenceCrc8(&f[2], plen + 1);
+    return plen + 4;
+}
+
+/* 16通道 × 11bit 打包（低位在前） */
+static void PackChannels(uint8_t p[CRSF_RC_PAYLOAD_LEN], const uint16_t ch[CRSF_CHAN_NUM])
+{
+    uint32_t bits = 0;
+    int n = 0, k = 0;
+    memset(p, 0, CRSF_RC_PAYLOAD_LEN);
+    for (int i = 0; i < CRSF_CHAN_NUM; i++) {
+        bits |= (uint32_t)(ch[i] & 0x7FF) << n;
+        n += 11;
+        while (n >= 8) {
+            p[k++] = (uint8_t)bits;
+            bits >>= 8;
+            n -= 8;
+        }
+    }
+}
+
+static int BuildRc(uint8_t *f, const uint16_t ch[CRSF_CHAN_NUM])
+{
+    uint8_t p[CRSF_RC_PAYLOAD_LEN];
+    PackChannels(p, ch);
+    return BuildFrame(f, CRSF_ADDRESS_FLIGHT_CONTROLLER, CRSF_FRAMETYPE_RC_CHANNELS_PACKED, p, CRSF_RC_PAYLOAD_LEN);
+}
+
+/* 除地址外不含同步字节（0xC8/0xEE）：CRC失败后只能在下一帧帧首重新同步，期望计数确定 */
+static int SyncFree(const uint8_t *f, int n)
+{
+    for (int i = 1; i < n; i++) if (is_sync(f[i])) return 0;
+    return 1;
+}
+
+/**
+ * @brief 模拟DMA接收：逐字节写入循环缓冲，半满/满与每段末尾（空闲）触发接收事件
+ * @param chunk 空闲事件间的字节数，0 表示随机 1~40
+ */
+static void Deliver(const uint8_t *d, int n, int chunk)
+{
+    int left = chunk ? chunk : (int)(Rand() % 40) + 1;
+    for (int i = 0; i < n; i++) {
+        elrs_rx_buf[dma_pos++] = d[i];
+        uint8_t event = 0;
+        if (dma_pos == CRSF_RX_BUF_SIZE / 2) event = 1;
+        if (dma_pos == CRSF_RX_BUF_SIZE) event = 1;
+        if (--left == 0) {
+            event = 1;
+            left = chunk ? chunk : (int)(Rand() % 40) + 1;
+        }
+        if (event) {
+            DWT->CYCCNT += SystemCoreClock / 1000;      // 事件间隔按1ms推进时间戳
+            crsf_receive_data(dma_pos);
+        }
+        if (dma_pos == CRSF_RX_BUF_SIZE) dma_pos = 0;
+    }
+}
+
+/* 末尾未整段的字节：补一次空闲事件（写指针刚回绕时已在满中断中消费） */
+static void Flush(void)
+{
+    if (dma_pos != 0) crsf_receive_data(dma_pos);
+}
+
+/* ==================== CRC ==================== */
+
+static void TestCrc(void)
+{
+    const uint8_t check[] = "123456789";
+    CHECK(crsf_crc8(check, 9) == 0xBC);             // CRC-8/DVB-S2 校验值
+    CHECK(ReferenceCrc8(check, 9) == 0xBC);
+
+    uint8_t buf[CRSF_LEN_MAX];
+    int bad = 0;
+    for (int t = 0; t < 2000; t++) {
+        int n = (int)(Rand() % CRSF_LEN_MAX) + 1;
+        for (int i = 0; i < n; i++) buf[i] = (uint8_t)Rand();
+        if (crsf_crc8(buf, (uint8_t)n) != ReferenceCrc8(buf, n)) bad++;
+    }
+    CHECK(bad == 0);
+}
+
+/* ==================== RC帧解码 ==================== */
+
+static void TestRcDecode(void)
+{
+    static const uint16_t ch[CRSF_CHAN_NUM] = {
+        172, 992, 1811, 500, 1500, 173, 1810, 991, 993, 1000, 0, 2047, 1, 1024, 1234, 1777
+    };
+    uint8_t f[CRSF_FRAME_SIZE_MAX];
+    int n = BuildRc(f, ch);
+    CHECK(n == 26);
+
+    Reset();
+    Deliver(f, n, n);
+    CHECK(crsf_stats.frames == 1);
+    CHECK(crsf_stats.type_count[0] == 1);
+    int bad = 0;
+    for (int i = 0; i < CRSF_CHAN_NUM; i++) if (crsf_rc_latest[i] != ch[i]) bad++;
+    CHECK(bad == 0);
+
+    crsf_analysis_data();
+    CHECK(elrs_status.frame_valid == 1);
+    CHECK(elrs_status.is_connected == 1);
+    CHECK_NEAR(rc_raw_channels.ch1, -100.0f, 1e-4f);
+    CHECK_NEAR(rc_raw_channels.ch3, 100.0f, 1e-4f);
+    CHECK_NEAR(rc_raw_channels.ch2, (992.0f - RC_MID) * RC_SCALE, 1e-4f);
+    CHECK_NEAR(rc_raw_channels.ch6, (173.0f - RC_MID) * RC_SCALE, 1e-4f);
+}
+
+/* ==================== 混合帧流回放 ==================== */
+
+typedef struct {
+    int rc, link, ping, msp, counted, unknown, crc_bad, len_bad;
+    uint16_t last_ch[CRSF_CHAN_NUM];
+    uint8_t last_link[CRSF_LINK_PAYLOAD_LEN];
+} Expect_t;
+
+/*
+ * 生成一帧：约一半RC，其余为链路统计/PING/MSP/只计数类型/未知类型；
+ * corrupt_pct 概率翻转负载中一位（CRC失败），len_pct 概率插入非法长度的伪帧首
+ */
+static int GenFrame(uint8_t *f, Expect_t *e, int corrupt_pct, int len_pct)
+{
+    uint8_t p[CRSF_LEN_MAX];
+    uint16_t ch[CRSF_CHAN_NUM];
+    int n, kind;
+
+    do {
+        kind = (int)(Rand() % 10);
+        if (kind < 5) {
+            for (int i = 0; i < CRSF_CHAN_NUM; i++) ch[i] = (uint16_t)(RC_MIN + Rand() % (RC_MAX - RC_MIN + 1));
+            n = BuildRc(f, ch);
+        } else if (kind == 5) {
+            for (int i = 0; i < CRSF_LINK_PAYLOAD_LEN; i++) p[i] = (uint8_t)(Rand() % 100);
+            n = BuildFrame(f, CRSF_ADDRESS_FLIGHT_CONTROLLER, CRSF_FRAMETYPE_LINK_STATISTICS, p, CRSF_LINK_PAYLOAD_LEN);
+        } else if (kind == 6) {
+            p[0] = CRSF_ADDRESS_BROADCAST;                  // 目标写0xC8会被当作伪帧首，回放用广播地址
+            p[1] = CRSF_ADDRESS_RADIO_TRANSMITTER;
+            n = BuildFrame(f, CRSF_ADDRESS_CRSF_TRANSMITTER, CRSF_FRAMETYPE_DEVICE_PING, p, 2);
+        } else if (kind == 7) {
+            int len = (int)(Rand() % 20) + 1;
+            p[0] = CRSF_ADDRESS_BROADCAST;
+            p[1] = CRSF_ADDRESS_RADIO_TRANSMITTER;
+            for (int i = 0; i < len; i++) p[2 + i] = (uint8_t)(Rand() % 0x80);
+            n = BuildFrame(f, CRSF_ADDRESS_FLIGHT_CONTROLLER, CRSF_FRAMETYPE_MSP_REQ, p, len + 2);
+        } else if (kind == 8) {
+            static const uint8_t counted[] = {
+                CRSF_FRAMETYPE_GPS, CRSF_FRAMETYPE_BATTERY_SENSOR, CRSF_FRAMETYPE_ATTITUDE, CRSF_FRAMETYPE_FLIGHT_MODE
+            };
+            int len = (int)(Rand() % 40) + 1;
+            for (int i = 0; i < len; i++) p[i] = (uint8_t)(Rand() % 0x80);
+            n = BuildFrame(f, CRSF_ADDRESS_FLIGHT_CONTROLLER, counted[Rand() % 4], p, len);
+        } else {
+            int len = (int)(Rand() % (CRSF_LEN_MAX - 2)) + 1;
+            for (int i = 0; i < len; i++) p[i] = (uint8_t)(Rand() % 0x80);
+            n = BuildFrame(f, CRSF_ADDRESS_FLIGHT_CONTROLLER, 0x55, p, len);
+        }
+    } while (!SyncFree(f, n));
+
+    if ((int)(Rand() % 100) < corrupt_pct) {
+        uint8_t save;
+        int at;
+        do {
+            at = 3 + (int)(Rand() % (n - 4));
+            save = f[at];
+            f[at] ^= (uint8_t)(1u << (Rand() % 8));
+            if (is_sync(f[at])) f[at] = save;
+        } while (f[at] == save);
+        e->crc_bad++;
+        return n;
+    }
+
+    switch (kind) {
+    case 0: case 1: case 2: case 3: case 4:
+        e->rc++;
+        memcpy(e->last_ch, ch, sizeof(ch));
+        break;
+    case 5:
+        e->link++;
+        memcpy(e->last_link, &f[3], CRSF_LINK_PAYLOAD_LEN);
+        break;
+    case 6: e->ping++; break;
+    case 7: e->msp++; break;
+    case 8: e->counted++; break;
+    default: e->unknown++; break;
+    }
+
+    // 非法长度的伪帧首放在帧前：地址后跟0或>62的长度
+    if ((int)(Rand() % 100) < len_pct) {
+        memmove(&f[2], f, n);
+        f[0] = CRSF_ADDRESS_FLIGHT_CONTROLLER;
+        f[1] = (Rand() & 1) ? 0x00 : (uint8_t)(CRSF_LEN_MAX + 1 + Rand() % 0x40);
+        e->len_bad++;
+        n += 2;
+    }
+    return n;
+}
+
+/* 生成帧流，帧间插入0~3个非同步杂字节 */
+static int GenStream(int frames, Expect_t *e, int corrupt_pct, int len_pct, int *junk)
+{
+    int n = 0;
+    memset(e, 0, sizeof(*e));
+    *junk = 0;
+    for (int k = 0; k < frames; k++) {
+        int gap = (int)(Rand() % 4);
+        for (int g = 0; g < gap; g++) stream[n++] = (uint8_t)(Rand() % 0x80);
+        *junk += gap;
+        n += GenFrame(&stream[n], e, corrupt_pct, len_pct);
+    }
+    return n;
+}
+
+static void CheckCounts(const Expect_t *e)
+{
+    CHECK(crsf_stats.type_count[0] == (uint32_t)e->rc);
+    CHECK(crsf_stats.type_count[1] == (uint32_t)e->link);
+    CHECK(crsf_stats.type_count[2] == (uint32_t)e->ping);
+    CHECK(crsf_stats.type_count[3] == (uint32_t)e->msp);
+    CHECK(crsf_stats.unknown == (uint32_t)e->unknown);
+    CHECK(crsf_stats.crc_err == (uint32_t)e->crc_bad);
+    CHECK(crsf_stats.len_err == (uint32_t)e->len_bad);
+    CHECK(crsf_stats.frames == (uint32_t)(e->rc + e->link + e->ping + e->msp + e->counted + e->unknown));
+
+    int bad = 0;
+    for (int i = 0; i < CRSF_CHAN_NUM; i++) if (crsf_rc_latest[i] != e->last_ch[i]) bad++;
+    CHECK(bad == 0);
+    if (e->link) CHECK(memcmp(&crsf_link.uplink_rssi_1, e->last_link, 3) == 0 && crsf_link.rf_mode == e->last_link[5]);
+}
+
+static void TestMixedStream(void)
+{
+    Expect_t e;
+    int junk;
+
+    // 无损坏：随机分段，每段都可能跨越回绕
+    Reset();
+    int n = GenStream(3000, &e, 0, 0, &junk);
+    Deliver(stream, n, 0);
+    Flush();
+    printf("mixed: %d bytes, rc %d link %d ping %d msp %d counted %d unknown %d\n",
+           n, e.rc, e.link, e.ping, e.msp, e.counted, e.unknown);
+    CHECK(crsf_stats.bytes == (uint32_t)n);
+    CHECK(crsf_stats.resync == (uint32_t)junk);
+    CheckCounts(&e);
+    CHECK(crsf_ext.ping_pending == (e.ping > 0));
+    CHECK(crsf_ext.msp_pending == (e.msp > 0));
+
+    // 每字节一个事件、整帧一个事件、只有半满/满中断（帧间无空闲）
+    static const int chunks[] = {1, 26, 1 << 30};
+    for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); c++) {
+        Reset();
+        n = GenStream(1000, &e, 0, 0, &junk);
+        Deliver(stream, n, chunks[c]);
+        Flush();
+        CHECK(crsf_stats.bytes == (uint32_t)n);
+        CheckCounts(&e);
+    }
+}
+
+/* ==================== 回绕切分 ==================== */
+
+/* RC帧起点逐个偏移，使缓冲末尾落在帧内每一个字节之后 */
+static void TestRingWrapSplit(void)
+{
+    uint16_t ch[CRSF_CHAN_NUM];
+    uint8_t f[CRSF_FRAME_SIZE_MAX], pad[CRSF_RX_BUF_SIZE];
+    int fails = 0;
+
+    memset(pad, 0x00, sizeof(pad));
+    for (int i = 0; i < CRSF_CHAN_NUM; i++) ch[i] = (uint16_t)(RC_MIN + 97 * i);
+    int n = BuildRc(f, ch);
+
+    for (int split = 0; split <= n; split++) {
+        Reset();
+        int start = CRSF_RX_BUF_SIZE - split;
+        // 杂字节推到帧起点，再整帧一段送入：满中断在帧内第split字节后，余下在空闲中断
+        Deliver(pad, start, start);
+        uint32_t junk_resync = crsf_stats.resync;
+        Deliver(f, n, n);
+        Flush();
+
+        int ok = crsf_stats.frames == 1 && crsf_stats.crc_err == 0 && junk_resync == (uint32_t)start
+                 && crsf_stats.resync == (uint32_t)start;
+        for (int i = 0; i < CRSF_CHAN_NUM; i++) ok &= crsf_rc_latest[i] == ch[i];
+        if (!ok) {
+            printf("wrap split %d: frames %u crc_err %u\n", split, crsf_stats.frames, crsf_stats.crc_err);
+            fails++;
+        }
+    }
+    CHECK(fails == 0);
+
+    // 帧跨越半满点与回绕点各一次的连续两帧
+    Reset();
+    Deliver(pad, 50, 50);
+    for (int k = 0; k < 4; k++) {
+        ch[0] = (uint16_t)(RC_MIN + k);
+        n = BuildRc(f, ch);
+        Deliver(f, n, n);
+    }
+    Flush();
+    CHECK(crsf_stats.frames == 4);
+    CHECK(crsf_rc_latest[0] == RC_MIN + 3);
+}
+
+/* ==================== CRC损坏与重新同步 ==================== */
+
+static void TestCorrupted(void)
+{
+    uint16_t ch[CRSF_CHAN_NUM];
+    uint8_t good[CRSF_FRAME_SIZE_MAX], bad[CRSF_FRAME_SIZE_MAX];
+
+    for (int i = 0; i < CRSF_CHAN_NUM; i++) ch[i] = (uint16_t)(1000 + i);
+    int n = BuildRc(good, ch);
+
+    // CRC字节错误后紧跟好帧（帧间无空闲）
+    Reset();
+    memcpy(bad, good, n);
+    bad[n - 1] ^= 0x01;
+    Deliver(bad, n, 1 << 30);
+    Deliver(good, n, 1 << 30);
+    Flush();
+    CHECK(crsf_stats.crc_err == 1);
+    CHECK(crsf_stats.frames == 1);
+    CHECK(crsf_rc_latest[5] == 1005);
+
+    // 负载中含同步字节的坏帧：伪帧首在坏帧内部，好帧仍在其后被找到
+    Reset();
+    memcpy(bad, good, n);
+    bad[5] = CRSF_ADDRESS_FLIGHT_CONTROLLER;
+    bad[6] = 0x10;                                  // 伪长度：覆盖到好帧内部
+    Deliver(bad, n, 7);
+    Deliver(good, n, 7);
+    Flush();
+    CHECK(crsf_stats.crc_err >= 1);
+    CHECK(crsf_stats.type_count[0] == 1);
+    CHECK(crsf_rc_latest[15] == 1015);
+
+    // 截断帧（只有前半）后接好帧
+    Reset();
+    Deliver(good, n / 2, n / 2);
+    Deliver(good, n, n);
+    Flush();
+    CHECK(crsf_stats.type_count[0] == 1);
+
+    // 随机：约10%帧损坏、5%前置非法长度，计数与最后一帧通道严格一致
+    Expect_t e;
+    int junk;
+    Reset();
+    n = GenStream(5000, &e, 10, 5, &junk);
+    Deliver(stream, n, 0);
+    Flush();
+    printf("corrupted: %d frames crc-bad, %d bad length, %u resync bytes\n", e.crc_bad, e.len_bad, crsf_stats.resync);
+    CHECK(e.crc_bad > 300);
+    CheckCounts(&e);
+}
+
+/* ==================== 链路健康度 ==================== */
+
+/*
+ * 时间仿真：sim_us 同时推进 HAL_GetTick 与 DWT->CYCCNT，帧按包速率准时到达，
+ * 每1ms调用一次 crsf_analysis_data（与 RC_EVENT_DRIVEN 下 Loop_1000Hz 相同）
+ */
+static uint32_t sim_us;
+static uint32_t next_rc_us, next_link_us, last_rc_us;
+
+typedef struct {
+    uint16_t rate_hz;           // 0 表示不再收到任何帧（完全丢失）
+    uint8_t lq;                 // 链路统计中的上行LQ
+    uint8_t rf_mode;            // 链路统计中的射频模式
+} LinkSim_t;
+
+typedef struct {
+    uint8_t min_connected;      // 期间是否出现过失控
+    uint8_t min_level;          // 期间最差等级
+    uint16_t max_timeout;       // 期间最大失控超时
+    uint32_t lost_us;           // 失控时刻（0 未失控）
+} LinkTrace_t;
+
+static void SimSetTime(uint32_t us)
+{
+    sim_us = us;
+    hal_stub_tick = us / 1000u;
+    DWT->CYCCNT = (uint32_t)((uint64_t)us * (SystemCoreClock / 1000000u));
+}
+
+/* 一帧在当前时刻整帧到达（一个空闲事件，跨越缓冲区末尾时先有满中断） */
+static void RxNow(const uint8_t *f, int n)
+{
+    for (int i = 0; i < n; i++) {
+        elrs_rx_buf[dma_pos++] = f[i];
+        if (dma_pos == CRSF_RX_BUF_SIZE) {
+            crsf_receive_data(dma_pos);
+            dma_pos = 0;
+        }
+    }
+    if (dma_pos != 0) crsf_receive_data(dma_pos);
+}
+
+static void SendLink(uint8_t lq, uint8_t rf_mode)
+{
+    uint8_t p[CRSF_LINK_PAYLOAD_LEN] = {50, 60, lq, 10, 0, rf_mode, 3, 55, 100, 8};
+    uint8_t f[CRSF_FRAME_SIZE_MAX];
+    RxNow(f, BuildFrame(f, CRSF_ADDRESS_FLIGHT_CONTROLLER, CRSF_FRAMETYPE_LINK_STATISTICS, p, CRSF_LINK_PAYLOAD_LEN));
+}
+
+static void LinkReset(void)
+{
+    Reset();
+    memset(&elrs_status, 0, sizeof(elrs_status));
+    SimSetTime(1000000u);                           // 与前面测试的时间戳不连续：第一帧不计间隔
+    next_rc_us = sim_us + 1000u;
+    next_link_us = next_rc_us;
+}
+
+/**
+ * @brief 按 sim 的包速率运行 ms 毫秒；链路统计在参数改变后第一帧立即发送，之后每100ms一帧
+ */
+static void SimRun(const LinkSim_t *sim, uint32_t ms, LinkTrace_t *tr)
+{
+    static LinkSim_t last;
+    uint16_t ch[CRSF_CHAN_NUM];
+    uint8_t f[CRSF_FRAME_SIZE_MAX];
+    int n;
+
+    for (int i = 0; i < CRSF_CHAN_NUM; i++) ch[i] = RC_MID;
+    n = BuildRc(f, ch);
+    if (sim->lq != last.lq || sim->rf_mode != last.rf_mode) next_link_us = 0;
+    last = *sim;
+
+    tr->min_connected = 1;
+    tr->min_level = CRSF_LINK_OK;
+    tr->max_timeout = 0;
+    tr->lost_us = 0;
+    uint32_t period = sim->rate_hz ? 1000000u / sim->rate_hz : 0;
+    if (period && next_rc_us < sim_us) next_rc_us = sim_us;
+
+    for (uint32_t k = 0; k < ms; k++) {
+        uint32_t t_end = sim_us + 1000u;
+        while (period && next_rc_us <= t_end) {
+            SimSetTime(next_rc_us);
+            if (next_link_us <= next_rc_us) {
+                SendLink(sim->lq, sim->rf_mode);
+                next_link_us = next_rc_us + 100000u;
+            }
+            RxNow(f, n);
+            last_rc_us = next_rc_us;
+            next_rc_us += period;
+        }
+        SimSetTime(t_end);
+        uint8_t was = elrs_status.is_connected;
+        crsf_analysis_data();
+        if (was && !elrs_status.is_connected && tr->lost_us == 0) tr->lost_us = sim_us;
+        if (!elrs_status.is_connected) tr->min_connected = 0;
+        if (crsf_health.level < tr->min_level) tr->min_level = crsf_health.level;
+        if (crsf_health.timeout_ms > tr->max_timeout) tr->max_timeout = crsf_health.timeout_ms;
+    }
+}
+
+static void PrintHealth(const char *name, const LinkTrace_t *tr)
+{
+    printf("%-18s interval %.2f ms (%u Hz), timeout %u ms, level %u (worst %u), relearn %u, lost %u\n",
+           name, crsf_health.interval_ms, crsf_health.packet_rate, crsf_health.timeout_ms,
+           crsf_health.level, tr->min_level, crsf_health.rate_changes, crsf_health.lost_events);
+}
+
+/* 250 → 50 Hz（只靠帧间隔判定）→ 500 Hz（射频模式变化）：重新学习，不误触发失控 */
+static void TestRateRelearn(void)
+{
+    LinkTrace_t tr;
+    LinkReset();
+
+    const LinkSim_t r250 = {250, 95, 5};
+    SimRun(&r250, 1000, &tr);
+    PrintHealth("250 Hz:", &tr);
+    CHECK(crsf_health.learned == 1);
+    CHECK_NEAR(crsf_health.interval_ms, 4.0f, 0.05f);
+    CHECK(crsf_health.packet_rate == 250);
+    CHECK(crsf_health.timeout_ms == 44);
+    CHECK(crsf_health.level == CRSF_LINK_OK);
+    CHECK(tr.min_connected == 1);
+    uint16_t relearn = crsf_health.rate_changes;
+
+    // 50 Hz，射频模式不变：前几帧像丢帧（迟到等级可短暂下降），连续一致后判定速率改变
+    const LinkSim_t r50 = {50, 95, 5};
+    SimRun(&r50, 1000, &tr);
+    PrintHealth("250 -> 50 Hz:", &tr);
+    CHECK(tr.min_connected == 1);
+    CHECK(crsf_health.lost_events == 0);
+    CHECK(crsf_health.rate_changes == relearn + 1);
+    CHECK(crsf_health.learned == 1);
+    CHECK_NEAR(crsf_health.interval_ms, 20.0f, 0.2f);
+    CHECK(crsf_health.packet_rate == 50);
+    CHECK(crsf_health.timeout_ms == 220);
+    CHECK(crsf_health.level == CRSF_LINK_OK);
+
+    // 500 Hz，链路统计射频模式改变：立即重新学习，收敛前超时取上限
+    const LinkSim_t r500 = {500, 95, 7};
+    SimRun(&r500, 3, &tr);
+    CHECK(crsf_health.rate_changes == relearn + 2);
+    CHECK(crsf_health.learned == 0);
+    CHECK(crsf_health.timeout_ms == ELRS_TIMEOUT_MAX_MS);
+    SimRun(&r500, 1000, &tr);
+    PrintHealth("50 -> 500 Hz:", &tr);
+    CHECK(tr.min_connected == 1);
+    CHECK(crsf_health.lost_events == 0);
+    CHECK(crsf_health.rate_changes == relearn + 2);
+    CHECK_NEAR(crsf_health.interval_ms, 2.0f, 0.05f);
+    CHECK(crsf_health.packet_rate == 500);
+    CHECK(crsf_health.timeout_ms == 22);
+}
+
+/* 失控超时 = 间隔 × (ELRS_LOST_TOLERANCE + 1)，限制在 ELRS_TIMEOUT_MIN_MS ~ ELRS_TIMEOUT_MAX_MS */
+static void TestTimeoutClamp(void)
+{
+    LinkTrace_t tr;
+    LinkReset();
+    const LinkSim_t r250 = {250, 95, 5};
+    SimRun(&r250, 500, &tr);
+
+    static const struct { float interval; uint8_t learned; uint16_t timeout; } cases[] = {
+        {1.0f,  1, ELRS_TIMEOUT_MIN_MS},    // 1000 Hz：11ms → 下限
+        {4.0f,  1, 44},
+        {20.0f, 1, 220},
+        {40.0f, 1, ELRS_TIMEOUT_MAX_MS},    // 25 Hz：440ms → 上限
+        {4.0f,  0, ELRS_TIMEOUT_MAX_MS},    // 未收敛
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        crsf_health.interval_ms = cases[i].interval;
+        crsf_health.learned = cases[i].learned;
+        crsf_analysis_data();
+        CHECK(crsf_health.timeout_ms == cases[i].timeout);
+    }
+}
+
+/* 等级：LQ阈值与回差，回升需保持 CRSF_LEVEL_HOLD_MS，下降立即生效；完全丢失在超时后失控 */
+static void TestLinkLevel(void)
+{
+    LinkTrace_t tr;
+    LinkReset();
+    const LinkSim_t ok = {250, 95, 5};
+    SimRun(&ok, 1000, &tr);
+    CHECK(crsf_health.level == CRSF_LINK_OK);
+
+    const LinkSim_t warn = {250, CRSF_LQ_WARN - 10, 5};
+    SimRun(&warn, 10, &tr);
+    CHECK(crsf_health.level == CRSF_LINK_WARN);                     // 下降立即生效
+    CHECK(crsf_health.warn_events == 1);
+    CHECK(crsf_health.lq == CRSF_LQ_WARN - 10);
+
+    const LinkSim_t crit = {250, CRSF_LQ_CRIT - 10, 5};
+    SimRun(&crit, 10, &tr);
+    CHECK(crsf_health.level == CRSF_LINK_CRITICAL);
+    CHECK(crsf_health.crit_events == 1);
+
+    // 高于WARN阈值但在回差内：只回升到WARN，且需保持
+    const LinkSim_t hyst = {250, CRSF_LQ_WARN + CRSF_LQ_HYST - 2, 5};
+    SimRun(&hyst, CRSF_LEVEL_HOLD_MS - 100, &tr);
+    CHECK(crsf_health.level == CRSF_LINK_CRITICAL);
+    SimRun(&hyst, 200, &tr);
+    CHECK(crsf_health.level == CRSF_LINK_WARN);
+    SimRun(&hyst, 1000, &tr);
+    CHECK(crsf_health.level == CRSF_LINK_WARN);
+
+    const LinkSim_t good = {250, 95, 5};
+    SimRun(&good, CRSF_LEVEL_HOLD_MS - 100, &tr);
+    CHECK(crsf_health.level == CRSF_LINK_WARN);
+    SimRun(&good, 200, &tr);
+    CHECK(crsf_health.level == CRSF_LINK_OK);
+    CHECK(crsf_health.warn_events == 1 && crsf_health.crit_events == 1);
+
+    // 250 Hz 下完全丢失：迟到帧数先升级为 CRITICAL，约 44ms 后失控（旧逻辑约 144ms）
+    const LinkSim_t none = {0, 95, 5};
+    SimRun(&none, 300, &tr);
+    float latency = (tr.lost_us - last_rc_us) / 1000.0f;
+    printf("total loss @ 250 Hz: failsafe after %.1f ms (timeout %u ms)\n", latency, crsf_health.timeout_ms);
+    CHECK(tr.lost_us != 0);
+    CHECK(latency > 40.0f && latency <= 46.0f);
+    CHECK(crsf_health.lost_events == 1);
+    CHECK(crsf_health.crit_events == 2);
+    CHECK(crsf_health.level == CRSF_LINK_LOST);
+    CHECK_NEAR(rc_raw_channels.ch3, -100.0f, 1e-6f);
+
+    // 恢复：第一帧即重新连接，链路统计过期前等级按LQ判定
+    SimRun(&good, 1000, &tr);
+    CHECK(elrs_status.is_connected == 1);
+    CHECK(crsf_health.level == CRSF_LINK_OK);
+    CHECK(crsf_health.lost_events == 1);
+}
+
+/* ==================== 遥测下行 ==================== */
+
+/*
+ * telemetry.c 单独编译链接（强定义覆盖 ELRS.c 中的弱 crsf_telemetry_slot），
+ * 其依赖的电池/失控/飞行模式/解锁状态由以下替身提供，发送DMA在此截获
+ */
+imu_data_t imu;
+static float fake_vbat;
+static uint8_t fake_failsafe;
+static ArmState_t fake_state;
+static const FlightModeDesc_t fake_mode = {"ANGLE", MODE_ANGLE, 0, 0, FM_ANGLE, NULL};
+
+float Battery_GetVoltage(void) { return fake_vbat; }
+uint8_t Failsafe_IsActive(void) { return fake_failsafe; }
+ArmState_t FState_GetState(void) { return fake_state; }
+const FlightModeDesc_t *FMode_Active(void) { return &fake_mode; }
+
+static uint8_t tx_cap[CRSF_FRAME_SIZE_MAX];
+static uint16_t tx_len;
+static uint32_t tx_count;
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *buf, uint16_t size)
+{
+    CHECK(huart == &ELRS_HUART);
+    CHECK(size <= sizeof(tx_cap));
+    memcpy(tx_cap, buf, size);
+    tx_len = size;
+    tx_count++;
+    return HAL_OK;
+}
+
+static int16_t GetS16(const uint8_t *p)
+{
+    return (int16_t)((p[0] << 8) | p[1]);
+}
+
+static uint32_t GetU32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static void TlmReset(void)
+{
+    LinkReset();
+    Telemetry_Init();
+    ELRS_HUART.gState = HAL_UART_STATE_READY;
+    memset(&imu, 0, sizeof(imu));
+    fake_vbat = 0.0f;
+    fake_failsafe = 0;
+    fake_state = STATE_DISARMED;
+    tx_count = 0;
+}
+
+/**
+ * @brief 触发一个回复时隙，检查帧头/长度/CRC，并把发出的帧送回接收解析器（同一CRC实现往返）
+ * @return 负载指针（无发送返回NULL），type/plen 输出类型与负载长度
+ */
+static const uint8_t *SlotFrame(uint8_t *type, int *plen)
+{
+    uint32_t before = tx_count;
+    crsf_telemetry_slot();
+    if (tx_count == before) return NULL;
+
+    CHECK(tx_cap[0] == CRSF_ADDRESS_FLIGHT_CONTROLLER);
+    CHECK(tx_cap[1] == tx_len - 2);
+    CHECK(tx_cap[tx_len - 1] == ReferenceCrc8(&tx_cap[2], tx_len - 3));
+    *type = tx_cap[2];
+    *plen = tx_len - 4;
+
+    static uint8_t echo[CRSF_FRAME_SIZE_MAX];
+    memcpy(echo, tx_cap, tx_len);
+    uint32_t frames = crsf_stats.frames, crc = crsf_stats.crc_err;
+    RxNow(echo, tx_len);
+    CHECK(crsf_stats.frames == frames + 1 && crsf_stats.crc_err == crc);
+    return &tx_cap[3];
+}
+
+/* 重新开始计时后所有帧都已到期，最多 3 个时隙内发出指定类型 */
+static const uint8_t *FirstOfType(uint8_t want, int *plen)
+{
+    uint8_t type = 0;
+    Telemetry_Init();
+    for (int k = 0; k < 3; k++) {
+        const uint8_t *p = SlotFrame(&type, plen);
+        if (p && type == want) return p;
+    }
+    return NULL;
+}
+
+/* 姿态：int16 大端，弧度×10000 */
+static void TestTlmAttitude(void)
+{
+    static const float deg[][3] = {
+        {0.0f, 0.0f, 0.0f}, {10.0f, -20.0f, 170.0f}, {-89.9f, 179.9f, -179.9f},
+    };
+    int plen;
+    TlmReset();
+    for (size_t i = 0; i < sizeof(deg) / sizeof(deg[0]); i++) {
+        imu.pitch = deg[i][0];
+        imu.roll = deg[i][1];
+        imu.yaw = deg[i][2];
+        const uint8_t *p = FirstOfType(CRSF_FRAMETYPE_ATTITUDE, &plen);
+        CHECK(p != NULL && plen == 6);
+        if (!p) continue;
+        for (int a = 0; a < 3; a++) {
+            float rad = deg[i][a] * 3.14159265f / 180.0f;
+            CHECK(abs(GetS16(&p[2 * a]) - (int)(rad * 10000.0f)) <= 1);
+        }
+        printf("attitude: %.1f/%.1f/%.1f deg -> %d %d %d\n",
+               deg[i][0], deg[i][1], deg[i][2], GetS16(p), GetS16(p + 2), GetS16(p + 4));
+    }
+}
+
+/* 电池：电压0.1V大端，电流/容量为0，剩余按检测节数的单节电压线性估算 */
+static void TestTlmBattery(void)
+{
+    static const struct { float v; uint16_t dv; uint8_t pct; } cases[] = {
+        {0.0f,  0,   0},                    // 无电压
+        {12.6f, 126, 100},                  // 3S 满电
+        {11.1f, 111, 44},                   // 3S 3.7V/节
+        {9.9f,  99,  0},                    // 3S 3.3V/节
+        {16.8f, 168, 100},                  // 4S 满电
+        {14.8f, 148, 44},                   // 4S 3.7V/节
+        {7.4f,  74,  44},                   // 2S 3.7V/节
+    };
+    int plen;
+    TlmReset();
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        fake_vbat = cases[i].v;
+        const uint8_t *p = FirstOfType(CRSF_FRAMETYPE_BATTERY_SENSOR, &plen);
+        CHECK(p != NULL && plen == 8);
+        if (!p) continue;
+        CHECK((uint16_t)GetS16(p) == cases[i].dv);
+        CHECK(p[2] == 0 && p[3] == 0);
+        CHECK(p[4] == 0 && p[5] == 0 && p[6] == 0);
+        CHECK(abs((int)p[7] - cases[i].pct) <= 1);
+    }
+}
+
+/* 飞行模式：以0结尾，未解锁加 '*'，失控保护中为 "!FS!" 且不加 '*' */
+static void TestTlmFlightMode(void)
+{
+    static const struct { ArmState_t state; uint8_t fs; const char *text; } cases[] = {
+        {STATE_DISARMED, 0, "ANGLE*"},
+        {STATE_ARMED,    0, "ANGLE"},
+        {STATE_ARMED,    1, "!FS!"},
+        {STATE_EMERGENCY, 1, "!FS!"},
+    };
+    int plen;
+    TlmReset();
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        fake_state = cases[i].state;
+        fake_failsafe = cases[i].fs;
+        const uint8_t *p = FirstOfType(CRSF_FRAMETYPE_FLIGHT_MODE, &plen);
+        CHECK(p != NULL);
+        if (!p) continue;
+        CHECK(plen == (int)strlen(cases[i].text) + 1);
+        CHECK(memcmp(p, cases[i].text, plen) == 0);
+    }
+}
+
+/* 设备PING：下一时隙优先回复 DEVICE_INFO（扩展帧头为发起方/本机地址） */
+static void TestTlmDeviceInfo(void)
+{
+    uint8_t f[CRSF_FRAME_SIZE_MAX], type = 0;
+    uint8_t ping[2] = {CRSF_ADDRESS_BROADCAST, CRSF_ADDRESS_RADIO_TRANSMITTER};
+    int plen;
+
+    TlmReset();
+    RxNow(f, BuildFrame(f, CRSF_ADDRESS_CRSF_TRANSMITTER, CRSF_FRAMETYPE_DEVICE_PING, ping, 2));
+    CHECK(crsf_ext.ping_pending == 1);
+    CHECK(crsf_ext.ping_origin == CRSF_ADDRESS_RADIO_TRANSMITTER);
+
+    const uint8_t *p = SlotFrame(&type, &plen);                 // 其余帧也已到期，PING仍优先
+    CHECK(p != NULL && type == CRSF_FRAMETYPE_DEVICE_INFO);
+    CHECK(crsf_ext.ping_pending == 0);
+    CHECK(g_telemetry.sent[3] == 1);
+    if (!p) return;
+
+    int name_len = (int)strlen(TLM_DEVICE_NAME) + 1;
+    CHECK(plen == 2 + name_len + 14);
+    CHECK(p[0] == CRSF_ADDRESS_RADIO_TRANSMITTER);
+    CHECK(p[1] == CRSF_ADDRESS_FLIGHT_CONTROLLER);
+    CHECK(memcmp(&p[2], TLM_DEVICE_NAME, name_len) == 0);
+    const uint8_t *q = &p[2 + name_len];
+    CHECK(GetU32(q) == 0x59544643);                             // "YTFC"
+    CHECK(GetU32(q + 4) == 0);
+    CHECK(GetU32(q + 8) == 0x00010000);
+    CHECK(q[12] == 0 && q[13] == 0);
+
+    // 回复后恢复轮询
+    p = SlotFrame(&type, &plen);
+    CHECK(p != NULL && type == CRSF_FRAMETYPE_ATTITUDE);
+}
+
+/*
+ * 调度：250 Hz RC帧驱动时隙 10s，每个时隙按"到期帧中超期最多者（相同取后者）"独立推算期望，
+ * 与实际发出的类型逐时隙比对；检查各帧速率、最大发送间隔，DMA忙时不更新发送时刻、下一时隙补发
+ */
+static void TestTlmScheduler(void)
+{
+    static const uint8_t types[3] = {CRSF_FRAMETYPE_ATTITUDE, CRSF_FRAMETYPE_BATTERY_SENSOR, CRSF_FRAMETYPE_FLIGHT_MODE};
+    static const uint16_t period[3] = {TLM_ATTITUDE_MS, TLM_BATTERY_MS, TLM_FLIGHT_MODE_MS};
+    uint32_t last[3] = {0, 0, 0}, max_gap[3] = {0, 0, 0}, sent[3] = {0, 0, 0};
+    int mismatch = 0, busy_slots = 0;
+    uint8_t f[CRSF_FRAME_SIZE_MAX], type;
+    uint16_t ch[CRSF_CHAN_NUM];
+    int plen;
+
+    TlmReset();
+    for (int i = 0; i < CRSF_CHAN_NUM; i++) ch[i] = RC_MID;
+    int n = BuildRc(f, ch);
+    uint32_t t0 = hal_stub_tick;                                // Telemetry_Init 后各帧发送时刻为0
+
+    for (uint32_t k = 0; k < 2500; k++) {
+        SimSetTime(sim_us + 4000u);
+        uint32_t now = hal_stub_tick;
+        int expect = -1;
+        uint32_t most = 0;
+        for (int i = 0; i < 3; i++) {
+            uint32_t since = now - last[i];
+            if (since >= period[i] && since - period[i] >= most) {
+                most = since - period[i];
+                expect = i;
+            }
+        }
+        // 第5秒起 200ms DMA忙：不发送、不更新发送时刻
+        uint8_t busy = (now - t0 >= 5000 && now - t0 < 5200);
+        ELRS_HUART.gState = busy ? 0 : HAL_UART_STATE_READY;
+
+        uint32_t before = tx_count;
+        RxNow(f, n);                                            // RC帧 → 回复时隙
+        if (busy) {
+            if (expect >= 0) busy_slots++;
+            CHECK(tx_count == before);
+            continue;
+        }
+        if (tx_count == before) {
+            if (expect >= 0) mismatch++;
+            continue;
+        }
+        type = tx_cap[2];
+        plen = tx_len - 4;
+        CHECK(tx_cap[tx_len - 1] == ReferenceCrc8(&tx_cap[2], plen + 1));
+        if (expect < 0 || types[expect] != type) {
+            mismatch++;
+            continue;
+        }
+        if (last[expect] != 0 && now - last[expect] > max_gap[expect]) max_gap[expect] = now - last[expect];
+        last[expect] = now;
+        sent[expect]++;
+    }
+    ELRS_HUART.gState = HAL_UART_STATE_READY;
+
+    printf("scheduler 10 s @ 250 Hz: attitude %u (max gap %u ms), battery %u (%u ms), mode %u (%u ms), busy slots %d\n",
+           sent[0], max_gap[0], sent[1], max_gap[1], sent[2], max_gap[2], busy_slots);
+    CHECK(mismatch == 0);
+    CHECK(busy_slots > 0);
+    CHECK(crsf_stats.tx_busy >= (uint32_t)busy_slots);
+    for (int i = 0; i < 3; i++) {
+        CHECK(sent[i] == g_telemetry.sent[i]);
+        // 除DMA忙期间外，间隔不超过周期 + 两个时隙（三帧同时到期时最后一个等两个时隙）
+        CHECK(sent[i] >= 10000u / period[i] - 3u && sent[i] <= 10000u / period[i] + 1u);
+    }
+    CHECK(max_gap[0] <= TLM_ATTITUDE_MS + 200 + 8);
+    CHECK(max_gap[1] <= TLM_BATTERY_MS + 200 + 8);
+
+    // 关闭遥测：时隙不计数、不发送
+    g_telemetry.enabled = 0;
+    uint32_t slots = g_telemetry.slots, before = tx_count;
+    hal_stub_tick += 1000;
+    crsf_telemetry_slot();
+    CHECK(g_telemetry.slots == slots && tx_count == before);
+}
+
+/* ==================== 基准 ==================== */
+
+#define CRSF_BAUD           420000
+#define CRSF_BYTES_PER_S    (CRSF_BAUD / 10)        // 8N1
+
+static void BenchParser(void)
+{
+    Expect_t e;
+
+    // 满速链路：与回放相同的帧类型分布（约一半RC帧），帧首尾相接
+    int n = 0;
+    uint8_t f[CRSF_FRAME_SIZE_MAX];
+    memset(&e, 0, sizeof(e));
+    while (n < STREAM_MAX - 2 * CRSF_FRAME_SIZE_MAX) {
+        int k = GenFrame(f, &e, 0, 0);
+        memcpy(&stream[n], f, k);
+        n += k;
+    }
+
+    const int reps = 20;
+    double t_copy = 0.0, t_all = 0.0;
+
+    // 只写缓冲（DMA模拟开销），再测写缓冲+解析，两者相减
+    for (int pass = 0; pass < 2; pass++) {
+        Reset();
+        double t0 = test_now_ns();
+        for (int r = 0; r < reps; r++) {
+            for (int i = 0; i < n; i++) {
+                elrs_rx_buf[dma_pos++] = stream[i];
+                if ((dma_pos & (CRSF_RX_BUF_SIZE / 2 - 1)) == 0) {
+                    if (pass) crsf_receive_data(dma_pos);
+                    else test_sink += elrs_rx_buf[dma_pos - 1];
+                    if (dma_pos == CRSF_RX_BUF_SIZE) dma_pos = 0;
+                }
+            }
+        }
+        double dt = test_now_ns() - t0;
+        if (pass) t_all = dt; else t_copy = dt;
+    }
+    CHECK(crsf_stats.crc_err == 0);
+
+    double bytes = (double)n * reps;
+    double ns_byte = (t_all - t_copy) / bytes;
+    double ns_frame = (t_all - t_copy) / (double)crsf_stats.frames;
+    printf("bench crsf_receive_data: %.2f ns/byte, %.1f ns/frame (%u frames, %.1f B/frame)\n",
+           ns_byte, ns_frame, crsf_stats.frames, bytes / crsf_stats.frames);
+    printf("bench 420 kbaud saturation: %d B/s -> %.1f us/s parser time, host CPU %.3f %%\n",
+           CRSF_BYTES_PER_S, ns_byte * CRSF_BYTES_PER_S * 1e-3, ns_byte * CRSF_BYTES_PER_S * 1e-7);
+
+    // 单独的CRC：RC帧（类型+22字节负载）
+    const int N = 2000000;
+    uint8_t buf[CRSF_RC_PAYLOAD_LEN + 1];
+    for (int i = 0; i < (int)sizeof(buf); i++) buf[i] = (uint8_t)Rand();
+    uint8_t acc = 0;
+    double t0 = test_now_ns();
+    for (int k = 0; k < N; k++) {
+        buf[0] = (uint8_t)k;
+        acc ^= crsf_crc8(buf, sizeof(buf));
+    }
+    double ns_crc = (test_now_ns() - t0) / N;
+    test_sink += acc;
+    printf("bench crsf_crc8: %.1f ns per RC frame (%.2f ns/byte)\n", ns_crc, ns_crc / sizeof(buf));
+}
+
+int main(void)
+{
+    TestCrc();
+    TestRcDecode();
+    TestMixedStream();
+    TestRingWrapSplit();
+    TestCorrupted();
+    TestRateRelearn();
+    TestTimeoutClamp();
+    TestLinkLevel();
+    TestTlmAttitude();
+    TestTlmBattery();
+    TestTlmFlightMode();
+    TestTlmDeviceInfo();
+    TestTlmScheduler();
+    BenchParser();
+    return TEST_RESULT();
+}
@@ -0,0 +1,302 @@
+/**
+ * @file       test_dshot.c
+ * @author     lsl-sys
+ * @brief      DShot Encoder Tests (Built Twice: DSHOT_BIDIR=0 and DSHOT_BIDIR=1)
+ * @version    V1.0.0
+ * @date       2026-02-24
+ * @Encoding   UTF-8
+ * @note       直接包含 dshot.c 以检查内部电机组缓冲（g_group）。
+ *             帧：已知向量（含双向模式CRC取反）与按协议定义的全量比对；
+ *             数值映射：DShot_SpeedToValue 边界；
+ *             时序：stub时钟（PCLK1 40MHz，定时器80MHz）下 DShot300/600 的位宽与T0H/T1H计数，
+ *             以及 DShot_Update 写入DMA缓冲的逐位CCR值。
+ *             回传解码：按协议由12位eRPM数据构造GCR线路波形（边沿时刻/3倍过采样端口采样），
+ *             覆盖正常帧、时钟偏差、无效GCR码、CRC错误、位数错误与无回传。
+ */
+
+#include "dshot.c"
+#include "test_util.h"
+
+/* 与 Scheduler.c g_motors 相同的接线 */
+static const MotorHandle_t motors[MOTOR_COUNT] = {
+    {&htim4, TIM_CHANNEL_1, GPIOB, GPIO_PIN_6},
+    {&htim2, TIM_CHANNEL_4, GPIOB, GPIO_PIN_11},
+    {&htim2, TIM_CHANNEL_3, GPIOB, GPIO_PIN_10},
+    {&htim4, TIM_CHANNEL_2, GPIOB, GPIO_PIN_7},
+};
+
+/* 协议定义：12位包 + 4位CRC（双向模式取反） */
+static uint16_t ReferenceFrame(uint16_t value, uint8_t telem, uint8_t bidir)
+{
+    uint16_t packet = (uint16_t)(((value & 0x7FFu) << 1) | (telem ? 1u : 0u));
+    uint16_t crc = 0;
+    for (int shift = 0; shift < 12; shift += 4) crc ^= (packet >> shift) & 0xFu;
+    if (bidir) crc = ~crc & 0xFu;
+    return (uint16_t)((packet << 4) | crc);
+}
+
+/* ==================== 帧编码 ==================== */
+
+static void TestEncodeKnownFrames(void)
+{
+    // {数值, 遥测位, 普通帧, 双向帧}
+    static const uint16_t vec[][4] = {
+        {0,    0, 0x0000, 0x000F},
+        {1,    1, 0x0033, 0x003C},    // 命令1（蜂鸣），命令帧置遥测位
+        {48,   0, 0x0606, 0x0609},    // 最小油门
+        {1046, 0, 0x82C6, 0x82C9},
+        {2047, 0, 0xFFEE, 0xFFE1},    // 最大油门
+        {2047, 1, 0xFFFF, 0xFFF0},
+    };
+    for (size_t i = 0; i < sizeof(vec) / sizeof(vec[0]); i++) {
+        uint16_t expect = DSHOT_BIDIR ? vec[i][3] : vec[i][2];
+        uint16_t got = DShot_EncodeFrame(vec[i][0], (uint8_t)vec[i][1]);
+        if (got != expect) printf("value %u telem %u: 0x%04X expected 0x%04X\n", vec[i][0], vec[i][1], got, expect);
+        CHECK(got == expect);
+    }
+
+    // 全部数值与遥测位组合
+    int bad = 0;
+    for (uint16_t v = 0; v <= DSHOT_THROTTLE_MAX; v++) {
+        for (uint8_t t = 0; t < 2; t++) {
+            if (DShot_EncodeFrame(v, t) != ReferenceFrame(v, t, DSHOT_BIDIR)) bad++;
+        }
+    }
+    CHECK(bad == 0);
+    // 超出11位的数值只取低11位
+    CHECK(DShot_EncodeFrame(0x0FFF, 0) == DShot_EncodeFrame(0x07FF, 0));
+}
+
+static void TestSpeedToValue(void)
+{
+    CHECK(DShot_SpeedToValue(0.0f) == 0);
+    CHECK(DShot_SpeedToValue(-5.0f) == 0);
+    CHECK(DShot_SpeedToValue(0.001f) == DSHOT_THROTTLE_MIN);    // 非零速度不会落入命令区
+    CHECK(DShot_SpeedToValue(50.0f) == 1048);                    // 48 + 999.5 四舍五入
+    CHECK(DShot_SpeedToValue(100.0f) == DSHOT_THROTTLE_MAX);
+    CHECK(DShot_SpeedToValue(150.0f) == DSHOT_THROTTLE_MAX);
+
+    uint16_t prev = 0;
+    int bad = 0;
+    for (int i = 1; i <= 10000; i++) {
+        uint16_t v = DShot_SpeedToValue(i * 0.01f);
+        if (v < prev || v < DSHOT_THROTTLE_MIN || v > DSHOT_THROTTLE_MAX) bad++;
+        prev = v;
+    }
+    CHECK(bad == 0);    // 单调且在油门区间内
+}
+
+/* ==================== 时序与DMA缓冲 ==================== */
+
+static void CheckTiming(uint32_t bitrate, uint16_t bit_ticks, uint16_t t1h, uint16_t t0h)
+{
+    CHECK(DShot_Init(motors, bitrate) == 0);
+    printf("DShot%lu: bit %u ticks, T1H %u, T0H %u\n", (unsigned long)(bitrate / 1000U),
+           g_dshot.bit_ticks, g_dshot.t1h_ticks, g_dshot.t0h_ticks);
+    CHECK(g_dshot.bit_ticks == bit_ticks);
+    CHECK(g_dshot.t1h_ticks == t1h);
+    CHECK(g_dshot.t0h_ticks == t0h);
+    CHECK(htim2.Instance->ARR == bit_ticks - 1U);
+    CHECK(htim4.Instance->ARR == bit_ticks - 1U);
+    CHECK(htim2.Instance->PSC == 0);
+
+    // 每位时长与占空比（定时器80MHz）
+    double bit_ns = bit_ticks * 1e9 / 80e6;
+    CHECK_NEAR(bit_ns, 1e9 / bitrate, 1e9 / bitrate * 0.01);
+    CHECK_NEAR((double)t1h / bit_ticks, 0.75, 0.01);
+    CHECK_NEAR((double)t0h / bit_ticks, 0.375, 0.01);
+}
+
+static void TestTiming(void)
+{
+    CheckTiming(DSHOT600_BITRATE, 133, 99, 49);
+    CheckTiming(DSHOT300_BITRATE, 267, 200, 100);
+}
+
+/* 电机组与突发配置：TIM4 CH1~CH2、TIM2 CH3~CH4 */
+static void TestGroups(void)
+{
+    CHECK(DShot_Init(motors, DSHOT600_BITRATE) == 0);
+    CHECK(g_group_count == 2);
+    CHECK(g_group[0].htim == &htim4 && g_group[0].first_ch == 0 && g_group[0].burst == 2);
+    CHECK(g_group[1].htim == &htim2 && g_group[1].first_ch == 2 && g_group[1].burst == 2);
+    CHECK(htim4.Instance->DCR == (TIM_DMABASE_CCR1 + 0u) + (1u << TIM_DCR_DBL_Pos));
+    CHECK(htim2.Instance->DCR == (TIM_DMABASE_CCR1 + 2u) + (1u << TIM_DCR_DBL_Pos));
+    CHECK(g_dshot.slot[MOTOR_FL] == 0 && g_dshot.slot[MOTOR_BL] == 1);
+    CHECK(g_dshot.slot[MOTOR_BR] == 0 && g_dshot.slot[MOTOR_FR] == 1);
+#if DSHOT_BIDIR
+    // 输出反相：空闲为高
+    CHECK(htim2.Instance->CCER & (TIM_CCER_CC1P << TIM_CHANNEL_3));
+    CHECK(htim4.Instance->CCER & (TIM_CCER_CC1P << TIM_CHANNEL_1));
+#endif
+}
+
+/* DShot_Update 写入缓冲：[位][通道] 交错，逐位为T1H/T0H，帧尾间隔位为0 */
+static void TestUpdateBuffer(void)
+{
+    static const uint16_t values[MOTOR_COUNT] = {48, 1046, 2047, 300};
+    int bad = 0;
+
+    CHECK(DShot_Init(motors, DSHOT600_BITRATE) == 0);
+    for (int i = 0; i < MOTOR_COUNT; i++) DShot_Write((MotorID_t)i, values[i]);
+    DShot_Update();
+
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        const DShotGroup_t *g = &g_group[g_dshot.group[i]];
+        uint16_t frame = DShot_EncodeFrame(values[i], 0);
+        for (int b = 0; b < DSHOT_FRAME_SLOTS; b++) {
+            uint32_t expect = 0;
+            if (b < DSHOT_FRAME_BITS) expect = (frame & (0x8000u >> b)) ? g_dshot.t1h_ticks : g_dshot.t0h_ticks;
+            if (g->buf[b * g->burst + g_dshot.slot[i]] != expect) bad++;
+        }
+    }
+    CHECK(bad == 0);
+    CHECK(g_group[0].hdma.Instance->NDTR == DSHOT_FRAME_SLOTS * 2u);
+    CHECK(g_dshot.frames == 1);
+}
+
+/* ==================== 回传解码 ==================== */
+
+static const uint8_t gcr_encode[16] = {
+    0x19, 0x1B, 0x12, 0x13, 0x1D, 0x15, 0x16, 0x17,
+    0x1A, 0x09, 0x0A, 0x0B, 0x1E, 0x0D, 0x0E, 0x0F,
+};
+
+/* 12位数据 + 取反CRC → 20位GCR */
+static uint32_t TelemGcr(uint16_t data)
+{
+    uint16_t crc = (uint16_t)(~(data ^ (data >> 4) ^ (data >> 8)) & 0xFu);
+    uint16_t v = (uint16_t)((data << 4) | crc);
+    uint32_t gcr = 0;
+    for (int i = 3; i >= 0; i--) gcr = (gcr << 5) | gcr_encode[(v >> (i * 4)) & 0xFu];
+    return gcr;
+}
+
+/* 线路：起始位 + 20位GCR，每个1对应一次电平翻转；返回边沿数，edge[k] = 位序号 × ticks */
+static uint8_t GcrToEdges(uint32_t gcr, uint16_t ticks, uint16_t *edge)
+{
+    uint32_t line = (1u << 20) | gcr;
+    uint8_t n = 0;
+    for (int b = 0; b < DSHOT_GCR_BITS; b++) {
+        if (line & (1u << (20 - b))) edge[n++] = (uint16_t)(b * ticks);
+    }
+    return n;
+}
+
+/* 端口采样：lead个空闲（高）采样后开始回传，每位DSHOT_TELEM_OVERSAMPLE个采样，之后释放为高 */
+static uint16_t GcrToSamples(uint32_t gcr, uint16_t lead, uint16_t pin, uint16_t *samples)
+{
+    uint32_t line = (1u << 20) | gcr;
+    uint16_t n = 0, level = 1;
+    for (uint16_t i = 0; i < lead; i++) samples[n++] = 0xFFFFu;
+    for (int b = 0; b < DSHOT_GCR_BITS; b++) {
+        if (line & (1u << (20 - b))) level ^= 1u;
+        for (int k = 0; k < DSHOT_TELEM_OVERSAMPLE; k++) samples[n++] = level ? 0xFFFFu : (uint16_t)~pin;
+    }
+    for (int k = 0; k < 6; k++) samples[n++] = 0xFFFFu;
+    return n;
+}
+
+static void TestDecodeEdges(void)
+{
+    uint16_t edge[DSHOT_GCR_BITS + 2];
+    int bad = 0;
+
+    // 全部12位数据，每位10个时间单位；并叠加±10%位宽误差（ESC时钟偏差）
+    for (uint32_t d = 0; d < 4096; d++) {
+        uint8_t n = GcrToEdges(TelemGcr((uint16_t)d), 10, edge);
+        if (DShot_DecodeEdges(edge, n, 10) != d) bad++;
+        for (uint8_t i = 0; i < n; i++) edge[i] = (uint16_t)(edge[i] * 11 / 10);
+        if (DShot_DecodeEdges(edge, n, 10) != d) bad++;
+    }
+    CHECK(bad == 0);
+
+    // 时间单位回绕（16位计数器溢出）
+    uint8_t n = GcrToEdges(TelemGcr(0x3A5), 10, edge);
+    for (uint8_t i = 0; i < n; i++) edge[i] = (uint16_t)(edge[i] + 65500u);
+    CHECK(DShot_DecodeEdges(edge, n, 10) == 0x3A5);
+
+    CHECK(DShot_ValueToERPM(0x0FFF) == 0);                 // 停转
+    CHECK(DShot_ValueToERPM((2u << 9) | 250u) == 60000);   // 周期 250<<2 = 1000us
+}
+
+static void TestDecodeErrors(void)
+{
+    uint16_t edge[DSHOT_GCR_BITS + 2];
+    uint32_t gcr = TelemGcr(0x123);
+    uint8_t n;
+
+    CHECK(DShot_DecodeEdges(edge, 0, 10) == DSHOT_TELEM_INVALID);
+
+    // CRC错误：数据半字节替换为另一个合法GCR码
+    uint32_t bad_crc = (gcr & ~(0x1Fu << 10)) | ((uint32_t)gcr_encode[0x7] << 10);
+    n = GcrToEdges(bad_crc, 10, edge);
+    CHECK(DShot_DecodeEdges(edge, n, 10) == DSHOT_TELEM_INVALID);
+
+    // 无效GCR码：所有不在编码表中的5位码，替换到每个半字节位置
+    // （数据含0半字节：无效码若按0解码，CRC无法发现）
+    static const uint16_t data[] = {0x123, 0x100, 0x000, 0x0F0};
+    int missed = 0;
+    for (size_t d = 0; d < sizeof(data) / sizeof(data[0]); d++) {
+        uint32_t g0 = TelemGcr(data[d]);
+        for (uint32_t code = 0; code < 32; code++) {
+            int valid = 0;
+            for (int i = 0; i < 16; i++) valid |= (gcr_encode[i] == code);
+            if (valid) continue;
+            for (int pos = 0; pos < 4; pos++) {
+                uint32_t g = (g0 & ~(0x1Fu << (pos * 5))) | (code << (pos * 5));
+                n = GcrToEdges(g, 10, edge);
+                if (DShot_DecodeEdges(edge, n, 10) != DSHOT_TELEM_INVALID) missed++;
+            }
+        }
+    }
+    if (missed) printf("invalid GCR codes accepted: %d\n", missed);
+    CHECK(missed == 0);
+
+    // 位数错误：丢失一个边沿 / 间隔超出帧长 / 过窄脉冲
+    n = GcrToEdges(gcr, 10, edge);
+    CHECK(DShot_DecodeEdges(&edge[1], (uint8_t)(n - 1), 10) == DSHOT_TELEM_INVALID);
+    edge[n - 1] = (uint16_t)(edge[n - 1] + 200);
+    CHECK(DShot_DecodeEdges(edge, n, 10) == DSHOT_TELEM_INVALID);
+    n = GcrToEdges(gcr, 10, edge);
+    edge[1] = (uint16_t)(edge[0] + 2);
+    CHECK(DShot_DecodeEdges(edge, n, 10) == DSHOT_TELEM_INVALID);
+}
+
+static void TestDecodeSamples(void)
+{
+    uint16_t samples[DSHOT_RX_SAMPLES_MAX];
+    uint16_t n;
+    int bad = 0;
+
+    for (uint32_t d = 0; d < 4096; d += 7) {
+        n = GcrToSamples(TelemGcr((uint16_t)d), (uint16_t)(d % 40), GPIO_PIN_10, samples);
+        if (DShot_DecodeSamples(samples, n, GPIO_PIN_10) != d) bad++;
+        // 同一端口其他引脚无回传
+        if (DShot_DecodeSamples(samples, n, GPIO_PIN_6) != DSHOT_TELEM_NONE) bad++;
+    }
+    CHECK(bad == 0);
+
+    // 窗口内全高：无回传
+    for (int i = 0; i < DSHOT_RX_SAMPLES_MAX; i++) samples[i] = 0xFFFFu;
+    CHECK(DShot_DecodeSamples(samples, DSHOT_RX_SAMPLES_MAX, GPIO_PIN_6) == DSHOT_TELEM_NONE);
+    CHECK(DShot_DecodeSamples(samples, 0, GPIO_PIN_6) == DSHOT_TELEM_NONE);
+
+    // 窗口在回传中途截止
+    n = GcrToSamples(TelemGcr(0x555), 10, GPIO_PIN_7, samples);
+    CHECK(DShot_DecodeSamples(samples, 10 + 30, GPIO_PIN_7) == DSHOT_TELEM_INVALID);
+}
+
+int main(void)
+{
+    printf("DSHOT_BIDIR=%d\n", DSHOT_BIDIR);
+    TestEncodeKnownFrames();
+    TestSpeedToValue();
+    TestTiming();
+    TestGroups();
+    TestUpdateBuffer();
+    TestDecodeEdges();
+    TestDecodeErrors();
+    TestDecodeSamples();
+    return TEST_RESULT();
+}
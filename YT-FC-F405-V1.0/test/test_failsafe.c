@@ -0,0 +1,219 @@
+/**
+ * @file       test_failsafe.c
+ * @author     lsl-sys
+ * @brief      RC-loss Failsafe Descent and Touchdown Tests
+ * @version    V1.0.0
+ * @date       2026-02-24
+ * @Encoding   UTF-8
+ * @note       竖直对象：加速度与（油门 - 真实悬停油门）成正比，地面为起落架弹簧阻尼（1kHz子步积分），
+ *             触地时产生真实的冲击加速度。alt_est / g_fmode 由本文件替代：
+ *             激光有效时高度/爬升率取对象真值；激光无效时与估计器相同只积分（带零偏与噪声的）加速度。
+ *             检查：激光有效降落在地面上锁；高处丢失激光后盲降到地面才上锁（旧逻辑8s超时空中上锁）；
+ *             盲降中单点加速度尖峰不触发上锁；悬停油门估计偏差由积分修正；无冲击的软着陆由油门下限保持判定。
+ */
+
+#include "failsafe.h"
+#include "flight_mode.h"
+#include "alt_estimator.h"
+#include "test_util.h"
+
+alt_est_t alt_est;
+FlightModeMgr_t g_fmode;
+
+#define DT              (1.0f / PID_LOOP_HZ)
+#define SUBSTEPS        10
+#define HOVER_TRUE      45.0f       // 对象真实悬停油门
+#define THR_ACCEL       20.0f       // 每1%油门偏差的竖直加速度 (cm/s²)
+#define GEAR_K          2500.0f     // 起落架刚度 (1/s²)
+#define GEAR_C          70.0f       // 起落架阻尼 (1/s)
+
+typedef struct {
+    float z, v;                 // 真实离地高度/速度
+    float acc_bias;             // 盲降时加速度计零偏残差 (cm/s²)
+    float noise;                // 加速度噪声幅值 (cm/s²)
+    float spike;                // 非0时每 spike_every 周期注入一次单点尖峰
+    int spike_every;
+    uint8_t laser;              // 激光有效
+    uint32_t k;
+} Plant_t;
+
+static Plant_t pl;
+static uint32_t rng = 13579u;
+
+static float Rand1(void)
+{
+    rng = rng * 1664525u + 1013904223u;
+    return (float)(rng >> 8) / 8388608.0f - 1.0f;
+}
+
+/* 一个控制周期：对象积分，并按激光有效与否更新 alt_est */
+static void PlantStep(float thr)
+{
+    float acc_sum = 0.0f;
+    for (int s = 0; s < SUBSTEPS; s++) {
+        float a = (thr - HOVER_TRUE) * THR_ACCEL;
+        if (pl.z < 0.0f) a += -GEAR_K * pl.z - GEAR_C * pl.v;   // 起落架压缩
+        if (pl.z <= 0.0f && a < 0.0f && pl.v <= 0.0f && pl.z > -0.5f && pl.v > -1.0f) {
+            a = 0.0f;                                           // 静止在地面
+            pl.v = 0.0f;
+        }
+        pl.v += a * DT / SUBSTEPS;
+        pl.z += pl.v * DT / SUBSTEPS;
+        acc_sum += a;
+    }
+    pl.k++;
+
+    float acc = acc_sum / SUBSTEPS + pl.noise * Rand1();
+    if (pl.spike != 0.0f && pl.k % pl.spike_every == 0) acc += (pl.k / pl.spike_every % 2) ? pl.spike : -pl.spike;
+
+    if (pl.laser) {
+        alt_est.valid = 1;
+        alt_est.acc = acc;
+        alt_est.alt = alt_est.agl = pl.z;
+        alt_est.vel = pl.v;
+    } else {
+        alt_est.valid = 0;
+        alt_est.acc = acc + pl.acc_bias;
+        alt_est.alt += alt_est.vel * DT;
+        alt_est.vel += alt_est.acc * DT;
+        alt_est.agl = alt_est.alt;
+    }
+}
+
+/* 丢失遥控前在 z0 高度定高悬停，hover_est 为飞控认为的悬停油门 */
+static void Reset(float z0, float hover_est)
+{
+    memset(&pl, 0, sizeof(pl));
+    memset(&alt_est, 0, sizeof(alt_est));
+    memset(&g_fmode, 0, sizeof(g_fmode));
+    memset(&g_failsafe, 0, sizeof(g_failsafe));
+    pl.z = z0;
+    pl.laser = 1;
+    hal_stub_tick = 1000;
+
+    PID_InitAll(hover_est);
+    PID_SetAltHold(1, hover_est);
+    PlantStep(hover_est);
+    g_fmode.sp_throttle = hover_est;
+    Failsafe_Update(1, 1);
+}
+
+typedef struct {
+    int landed_k;               // 上锁周期（-1未上锁）
+    int ground_k;               // 首次触地周期
+    float landed_z;             // 上锁时真实高度
+    float min_thr;              // 最低油门（空中）
+} Result_t;
+
+/**
+ * @brief 遥控丢失后运行至上锁或超时
+ * @param laser_off_k 该周期起激光失效（-1不失效）
+ */
+static Result_t RunFailsafe(float seconds, int laser_off_k)
+{
+    Result_t r = {-1, -1, 0.0f, 100.0f};
+    for (int k = 0; k < (int)(seconds * PID_LOOP_HZ); k++) {
+        if (k == laser_off_k) pl.laser = 0;
+        hal_stub_tick += 1000 / PID_LOOP_HZ;
+        Failsafe_Update(0, 1);
+        if (g_failsafe.stage == FS_LANDED) {
+            r.landed_k = k;
+            r.landed_z = pl.z;
+            break;
+        }
+        float thr = Failsafe_Throttle();
+        if (pl.z > 1.0f && thr < r.min_thr) r.min_thr = thr;
+        PlantStep(thr);
+        if (r.ground_k < 0 && pl.z <= 0.0f) r.ground_k = k;
+    }
+    return r;
+}
+
+static void Report(const char *name, const Result_t *r)
+{
+    printf("%-22s ground %.2f s, landed %.2f s (%.2f s after contact), z at disarm %.2f cm\n", name,
+           r->ground_k * DT, r->landed_k * DT, (r->landed_k - r->ground_k) * DT, r->landed_z);
+}
+
+/* 激光有效：定高下降，接近地面减速，触地后上锁 */
+static void TestLaserLanding(void)
+{
+    Reset(150.0f, HOVER_TRUE);
+    Result_t r = RunFailsafe(30.0f, -1);
+    Report("laser landing:", &r);
+    CHECK(r.landed_k > 0);
+    CHECK(r.ground_k >= 0 && r.landed_k > r.ground_k);
+    CHECK(r.landed_z < 1.0f);
+    CHECK((r.landed_k - r.ground_k) * DT < 3.0f);
+}
+
+/* 3m高处保持阶段后丢失激光：盲降约10s，旧逻辑8s超时在空中上锁 */
+static void TestLaserLossAtHeight(void)
+{
+    Reset(300.0f, HOVER_TRUE);
+    pl.acc_bias = -1.0f;                                // 估计爬升率偏向下降：实际下降更慢
+    pl.noise = 30.0f;
+    Result_t r = RunFailsafe(40.0f, FS_HOLD_MS / 10 + 5);
+    Report("laser loss at 3 m:", &r);
+    CHECK(r.landed_k > 0);
+    CHECK(r.ground_k >= 0 && r.landed_k > r.ground_k);
+    CHECK(r.landed_z < 1.0f);
+    CHECK(r.landed_k * DT > FS_HOLD_MS / 1000.0f + 8.0f);
+    CHECK((r.landed_k - r.ground_k) * DT < 4.0f);
+}
+
+/* 盲降中周期性单点尖峰（振动/阵风）：空中不上锁 */
+static void TestAccelSpikes(void)
+{
+    Reset(300.0f, HOVER_TRUE);
+    pl.noise = 30.0f;
+    pl.spike = 800.0f;
+    pl.spike_every = 70;
+    Result_t r = RunFailsafe(40.0f, FS_HOLD_MS / 10 + 5);
+    Report("accel spikes:", &r);
+    CHECK(r.landed_k > 0);
+    CHECK(r.ground_k >= 0 && r.landed_k > r.ground_k);
+    CHECK(r.landed_z < 1.0f);
+}
+
+/* 悬停油门估计偏高/偏低3%：积分修正后仍以盲降速度下降，落地后才上锁 */
+static void TestHoverEstimateError(void)
+{
+    static const float offset[] = {3.0f, -3.0f};
+    for (size_t i = 0; i < sizeof(offset) / sizeof(offset[0]); i++) {
+        Reset(200.0f, HOVER_TRUE);
+        pl.laser = 0;                                   // 保持阶段前已丢失激光，悬停油门取上周期油门
+        pl.noise = 30.0f;
+        g_pid.altitude.enabled = 0;
+        g_fmode.sp_throttle = HOVER_TRUE + offset[i];
+        Result_t r = RunFailsafe(40.0f, -1);
+        printf("hover est %+.0f%%:        ground %.2f s, landed %.2f s, min air throttle %.1f\n",
+               offset[i], r.ground_k * DT, r.landed_k * DT, r.min_thr);
+        CHECK(r.landed_k > 0);
+        CHECK(r.ground_k >= 0 && r.landed_k > r.ground_k);
+        CHECK(r.landed_z < 1.0f);
+    }
+}
+
+/* 软着陆（无冲击）：油门下限保持 FS_BLIND_FLOOR_MS 判定触地 */
+static void TestSoftTouchdown(void)
+{
+    Reset(0.5f, HOVER_TRUE);
+    pl.laser = 0;
+    g_pid.altitude.enabled = 0;
+    Result_t r = RunFailsafe(20.0f, -1);
+    Report("soft touchdown:", &r);
+    CHECK(r.landed_k > 0);
+    CHECK(g_failsafe.impact == 0);
+    CHECK(r.landed_z < 1.0f);
+}
+
+int main(void)
+{
+    TestLaserLanding();
+    TestLaserLossAtHeight();
+    TestAccelSpikes();
+    TestHoverEstimateError();
+    TestSoftTouchdown();
+    return TEST_RESULT();
+}
@@ -0,0 +1,222 @@
+/**
+ * @file       test_filter.c
+ * @author     lsl-sys
+ * @brief      filter.c Correctness Checks and Per-sample Benchmarks
+ * @version    V1.0.0
+ * @date       2026-02-24
+ * @Encoding   UTF-8
+ * @note       正确性：median3/median5 与排序结果逐一比较（全排列+含重复值随机输入）；
+ *             movavg_update 均值/方差与按窗口暴力重算比较（含填充阶段与多种窗口长度）；
+ *             hampel_update 与按定义（窗口中值 + 1.4826·MAD）暴力实现逐样本比较。
+ *             基准：各滤波器单样本主机耗时，只打印。
+ */
+
+#include <stdlib.h>
+#include "filter.h"
+#include "test_util.h"
+
+static int CmpFloat(const void *a, const void *b)
+{
+    float x = *(const float *)a, y = *(const float *)b;
+    return (x > y) - (x < y);
+}
+
+static float SortedMedian(const float *v, int n)
+{
+    float s[16];
+    memcpy(s, v, n * sizeof(float));
+    qsort(s, n, sizeof(float), CmpFloat);
+    return (n & 1) ? s[n / 2] : 0.5f * (s[n / 2 - 1] + s[n / 2]);
+}
+
+/* ==================== 中值 ==================== */
+
+static void TestMedianNetworks(void)
+{
+    // 5个不同值的全部120种排列
+    int perm[5] = {0, 1, 2, 3, 4}, bad = 0;
+    for (int a = 0; a < 5; a++) for (int b = 0; b < 5; b++) for (int c = 0; c < 5; c++)
+    for (int d = 0; d < 5; d++) for (int e = 0; e < 5; e++) {
+        int p[5] = {a, b, c, d, e}, used = 0;
+        for (int i = 0; i < 5; i++) used |= 1 << p[i];
+        if (used != 0x1F) continue;
+        float v[5];
+        for (int i = 0; i < 5; i++) v[i] = (float)perm[p[i]] * 1.5f - 2.0f;
+        if (median5(v) != 1.0f) bad++;
+    }
+    CHECK(bad == 0);
+
+    // 含重复值的随机输入
+    srand(3);
+    bad = 0;
+    for (int k = 0; k < 100000; k++) {
+        float v[5];
+        for (int i = 0; i < 5; i++) v[i] = (float)(rand() % 8);
+        float in[5];
+        memcpy(in, v, sizeof(v));
+        if (median5(v) != SortedMedian(v, 5)) bad++;
+        if (median3(v[0], v[1], v[2]) != SortedMedian(v, 3)) bad++;
+        if (memcmp(in, v, sizeof(v)) != 0) bad++;   // 不修改输入
+    }
+    CHECK(bad == 0);
+}
+
+/* 滑动中值：窗口未满时按已有样本取中值，满后为最近n个样本的中值 */
+static void TestMedianFilter(void)
+{
+    for (uint8_t n = 3; n <= 5; n += 2) {
+        median_filter_t f;
+        float hist[64];
+        int bad = 0;
+        median_filter_init(&f, n);
+        for (int k = 0; k < 64; k++) {
+            hist[k] = (float)(rand() % 1000) - 500.0f;
+            int cnt = (k + 1 < n) ? k + 1 : n;
+            if (median_filter_update(&f, hist[k]) != SortedMedian(&hist[k + 1 - cnt], cnt)) bad++;
+        }
+        CHECK(bad == 0);
+    }
+}
+
+/* ==================== 滑动均值/方差 ==================== */
+
+static void TestMovavgBruteForce(void)
+{
+    static const uint8_t sizes[] = {1, 2, 5, 8, 16};
+    for (size_t s = 0; s < sizeof(sizes); s++) {
+        uint8_t n = sizes[s];
+        movavg_filter_t f;
+        float hist[20000];
+        double max_mean_err = 0.0, max_var_err = 0.0;
+
+        movavg_init(&f, n);
+        srand(7 + n);
+        for (int k = 0; k < 20000; k++) {
+            // 大偏置 + 小波动 + 偶发阶跃：考验增量更新的抵消误差
+            hist[k] = 1000.0f + (float)(rand() % 1000) / 100.0f + ((k / 3000) & 1) * 500.0f;
+            float mean = movavg_update(&f, hist[k]);
+
+            int cnt = (k + 1 < n) ? k + 1 : n;
+            double mu = 0.0, m2 = 0.0;
+            for (int i = k + 1 - cnt; i <= k; i++) mu += hist[i];
+            mu /= cnt;
+            for (int i = k + 1 - cnt; i <= k; i++) m2 += (hist[i] - mu) * (hist[i] - mu);
+            double var = (cnt > 1) ? m2 / (cnt - 1) : 0.0;
+
+            if (fabs(mean - mu) > max_mean_err) max_mean_err = fabs(mean - mu);
+            // 方差按相对误差比较（阶跃跨窗口时方差达数万）
+            double var_err = fabs(movavg_variance(&f) - var) / (var > 1.0 ? var : 1.0);
+            if (var_err > max_var_err) max_var_err = var_err;
+        }
+        printf("movavg n=%-2u max |mean err| %.2e, max var rel err %.2e\n", n, max_mean_err, max_var_err);
+        CHECK(max_mean_err < 1e-3);
+        CHECK(max_var_err < 0.05);
+    }
+}
+
+/* ==================== Hampel ==================== */
+
+/* 按定义的参考实现：最近 FILTER_HAMPEL_N 个原始样本（含当前）的中值与MAD */
+static float HampelReference(const float *hist, int k, float kk, float min_sigma, int *outlier)
+{
+    int cnt = (k + 1 < FILTER_HAMPEL_N) ? k + 1 : FILTER_HAMPEL_N;
+    *outlier = 0;
+    if (cnt < 3) return hist[k];
+
+    const float *w = &hist[k + 1 - cnt];
+    float med = SortedMedian(w, cnt);
+    float dev[FILTER_HAMPEL_N];
+    for (int i = 0; i < cnt; i++) dev[i] = fabsf(w[i] - med);
+    float sigma = FILTER_MAD_SCALE * SortedMedian(dev, cnt);
+    if (sigma < min_sigma) sigma = min_sigma;
+
+    if (fabsf(hist[k] - med) > kk * sigma) {
+        *outlier = 1;
+        return med;
+    }
+    return hist[k];
+}
+
+static void TestHampelReference(void)
+{
+    hampel_filter_t f;
+    static float hist[50000];
+    int bad = 0, ref_outliers = 0;
+
+    hampel_init(&f, 3.0f, 10.0f);
+    srand(5);
+    for (int k = 0; k < 50000; k++) {
+        float x = 300.0f * sinf(k * 0.04f) + (float)(rand() % 40) - 20.0f;
+        if (rand() % 33 == 0) x += (rand() % 2 ? 1000.0f : -1000.0f);
+        hist[k] = x;
+
+        int outlier;
+        float ref = HampelReference(hist, k, 3.0f, 10.0f, &outlier);
+        ref_outliers += outlier;
+        if (fabsf(hampel_update(&f, x) - ref) > 1e-3f) bad++;
+    }
+    printf("hampel: %u outliers replaced, %d mismatches vs reference\n", (unsigned)f.outliers, bad);
+    CHECK(bad == 0);
+    CHECK((int)f.outliers == ref_outliers);
+    CHECK(f.outliers > 1000);
+}
+
+/* 真实阶跃：过半窗口样本到达后中值跟随，不会被永久压制 */
+static void TestHampelStep(void)
+{
+    hampel_filter_t f;
+    float y = 0.0f;
+    hampel_init(&f, 3.0f, 10.0f);
+    for (int k = 0; k < 10; k++) hampel_update(&f, 100.0f);
+    for (int k = 0; k < 3; k++) y = hampel_update(&f, 800.0f);
+    CHECK(y == 800.0f);
+}
+
+/* ==================== 基准 ==================== */
+
+#define BENCH_N 5000000
+
+static void BenchFilters(void)
+{
+    float *in = malloc(BENCH_N * sizeof(float));
+    median_filter_t m3, m5;
+    movavg_filter_t ma;
+    hampel_filter_t h;
+    double t;
+
+    srand(11);
+    for (int i = 0; i < BENCH_N; i++) in[i] = (float)(rand() % 1000) + ((rand() % 50 == 0) ? 5000.0f : 0.0f);
+    median_filter_init(&m3, 3);
+    median_filter_init(&m5, 5);
+    movavg_init(&ma, 5);
+    hampel_init(&h, 3.0f, 10.0f);
+
+    t = test_now_ns();
+    for (int i = 0; i < BENCH_N; i++) test_sink = median_filter_update(&m3, in[i]);
+    printf("bench median3 filter: %.1f ns/sample\n", (test_now_ns() - t) / BENCH_N);
+
+    t = test_now_ns();
+    for (int i = 0; i < BENCH_N; i++) test_sink = median_filter_update(&m5, in[i]);
+    printf("bench median5 filter: %.1f ns/sample\n", (test_now_ns() - t) / BENCH_N);
+
+    t = test_now_ns();
+    for (int i = 0; i < BENCH_N; i++) test_sink = movavg_update(&ma, in[i]);
+    printf("bench movavg (n=5):   %.1f ns/sample\n", (test_now_ns() - t) / BENCH_N);
+
+    t = test_now_ns();
+    for (int i = 0; i < BENCH_N; i++) test_sink = hampel_update(&h, in[i]);
+    printf("bench hampel5:        %.1f ns/sample\n", (test_now_ns() - t) / BENCH_N);
+
+    free(in);
+}
+
+int main(void)
+{
+    TestMedianNetworks();
+    TestMedianFilter();
+    TestMovavgBruteForce();
+    TestHampelReference();
+    TestHampelStep();
+    BenchFilters();
+    return TEST_RESULT();
+}
@@ -0,0 +1,153 @@
+/**
+ * @file       test_flight_mode.c
+ * @author     lsl-sys
+ * @brief      Flight Mode Manager Tests (Switch Table, Fallback, Autotune Interlock)
+ * @version    V1.0.0
+ * @date       2026-02-24
+ * @Encoding   UTF-8
+ * @note       imu / alt_est / nav 由本文件替代，直接写前置条件标志；时间由 hal_stub_tick 推进。
+ *             检查：开关查表与降级链、前置条件丢失超时降级，
+ *             自整定运行中开关切手动时先中止自整定再切换姿态模式，
+ *             同为自稳的模式间切换（自稳→定高）不打断自整定。
+ */
+
+#include "flight_mode.h"
+#include "autotune.h"
+#include "imu.h"
+#include "nav_ekf.h"
+#include "alt_estimator.h"
+#include "test_util.h"
+
+imu_data_t imu;
+NavEKF_t nav;
+alt_est_t alt_est;
+
+#define SW_LOW      -100.0f
+#define SW_MID      0.0f
+#define SW_HIGH     100.0f
+
+static void Reset(void)
+{
+    memset(&imu, 0, sizeof(imu));
+    memset(&nav, 0, sizeof(nav));
+    memset(&alt_est, 0, sizeof(alt_est));
+    memset(&g_autotune, 0, sizeof(g_autotune));
+    imu.online = imu.valid = 1;
+    alt_est.valid = 1;
+    nav.horiz_valid = 1;
+    hal_stub_tick = 10000;
+
+    PID_InitAll(40.0f);
+    FMode_Init();
+    FMode_Reset();
+}
+
+/* 与 Loop_100Hz 相同的启动方式：自稳下切到自整定模式 */
+static void StartAutotune(void)
+{
+    PID_SetMode(MODE_AUTOTUNE);
+    AutoTune_Start(AT_AXIS_PITCH | AT_AXIS_ROLL);
+    for (int k = 0; k < 10; k++) {
+        hal_stub_tick += 10;
+        AutoTune_Update(0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+    }
+}
+
+/* ==================== 开关查表与降级 ==================== */
+
+static void TestSwitchTable(void)
+{
+    Reset();
+    FMode_Update(SW_LOW, SW_LOW, 40.0f);
+    CHECK(g_fmode.active == FM_ANGLE);
+    FMode_Update(SW_MID, SW_LOW, 40.0f);
+    CHECK(g_fmode.active == FM_ALT_HOLD);
+    CHECK(g_pid.altitude.enabled == 1);
+    FMode_Update(SW_HIGH, SW_MID, 40.0f);
+    CHECK(g_fmode.active == FM_POS_HOLD);
+    CHECK(g_pid.position.enabled == 1);
+    FMode_Update(SW_HIGH, SW_HIGH, 40.0f);
+    CHECK(g_fmode.active == FM_RATE);
+    CHECK(g_pid.attitude.mode == MODE_RATE);
+    CHECK(g_pid.altitude.enabled == 0 && g_pid.position.enabled == 0);
+
+    // 请求定点但光流无效：直接落到定高
+    Reset();
+    nav.horiz_valid = 0;
+    FMode_Update(SW_HIGH, SW_LOW, 40.0f);
+    CHECK(g_fmode.active == FM_ALT_HOLD);
+    CHECK(g_fmode.degraded == 1);
+}
+
+/* 飞行中前置条件短暂丢失保持当前模式，超过 FMODE_LOSS_MS 才降级 */
+static void TestLossTimeout(void)
+{
+    Reset();
+    FMode_Update(SW_HIGH, SW_LOW, 40.0f);
+    CHECK(g_fmode.active == FM_POS_HOLD);
+
+    nav.horiz_valid = 0;
+    for (int t = 0; t < FMODE_LOSS_MS - 10; t += 10) {
+        hal_stub_tick += 10;
+        FMode_Update(SW_HIGH, SW_LOW, 40.0f);
+    }
+    CHECK(g_fmode.active == FM_POS_HOLD);
+    hal_stub_tick += 20;
+    FMode_Update(SW_HIGH, SW_LOW, 40.0f);
+    CHECK(g_fmode.active == FM_ALT_HOLD);
+    CHECK(g_fmode.fallback_count == 1);
+}
+
+/* ==================== 自整定互锁 ==================== */
+
+/* 开关切手动：自整定中止，姿态环立即进入手动，整定轴参数保持原值 */
+static void TestAutotuneAbortOnRate(void)
+{
+    Reset();
+    FMode_Update(SW_LOW, SW_LOW, 40.0f);
+    PIDController before = g_pid.attitude.rate.pitch;
+    StartAutotune();
+    CHECK(AutoTune_IsActive());
+    CHECK(g_pid.attitude.mode == MODE_AUTOTUNE);
+
+    FMode_Update(SW_LOW, SW_HIGH, 40.0f);
+    CHECK(g_fmode.active == FM_RATE);
+    CHECK(!AutoTune_IsActive());
+    CHECK(g_autotune.state == AT_FAILED);
+    CHECK(g_pid.attitude.mode == MODE_RATE);
+    CHECK_NEAR(g_pid.attitude.rate.pitch.kp, before.kp, 1e-6f);
+    CHECK_NEAR(g_pid.attitude.rate.pitch.ki, before.ki, 1e-6f);
+    CHECK_NEAR(g_pid.attitude.rate.pitch.kd, before.kd, 1e-6f);
+
+    // 之后的周期不会被改回自稳（自整定已不在运行）
+    hal_stub_tick += 10;
+    FMode_Update(SW_LOW, SW_HIGH, 40.0f);
+    CHECK(g_pid.attitude.mode == MODE_RATE);
+}
+
+/* 自稳 → 定高：姿态模式不变，自整定继续 */
+static void TestAutotuneKeepsOnAltHold(void)
+{
+    Reset();
+    FMode_Update(SW_LOW, SW_LOW, 40.0f);
+    StartAutotune();
+
+    FMode_Update(SW_MID, SW_LOW, 40.0f);
+    CHECK(g_fmode.active == FM_ALT_HOLD);
+    CHECK(AutoTune_IsActive());
+    CHECK(g_pid.attitude.mode == MODE_AUTOTUNE);
+
+    // 中止后由模式管理器恢复当前模式的姿态环
+    AutoTune_Abort();
+    FMode_Update(SW_MID, SW_LOW, 40.0f);
+    CHECK(g_pid.attitude.mode == MODE_ANGLE);
+}
+
+int main(void)
+{
+    TestSwitchTable();
+    TestLossTimeout();
+    TestAutotuneAbortOnRate();
+    TestAutotuneKeepsOnAltHold();
+    return TEST_RESULT();
+}
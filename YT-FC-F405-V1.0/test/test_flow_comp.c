@@ -0,0 +1,122 @@
+/**
+ * @file       test_flow_comp.c
+ * @author     lsl-sys
+ * @brief      Optical-flow Gyro Compensation Replay Test
+ * @version    V1.0.0
+ * @date       2026-02-24
+ * @Encoding   UTF-8
+ * @note       以 OF_GYRO_COMP_ENABLE=1 编译 OpticalFlow.c，回放合成的T1Plus帧与100Hz陀螺：
+ *             匀速平移 + 横滚/俯仰摆动（±8°，1.5Hz），光流50Hz、20ms积分窗口、接收延时3ms。
+ *             传感器模型按 OF_COMP_X/Y_SIGN 约定的轴向生成转动光流（即假设符号已实测正确），
+ *             比较补偿后速度与未补偿速度（flow_rate × 高度）相对真实平移速度的误差。
+ *             T1Plus 驱动与 imu 由本文件替代，直接写 t1plus_data / imu。
+ */
+
+#include <stdlib.h>
+#include "OpticalFlow.h"
+#include "imu.h"
+#include "test_util.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+t1plus t1plus_data;
+imu_data_t imu;
+void T1Plus_init(void) {}
+
+#define SIM_HEIGHT_MM   1000.0
+#define SIM_VEL_X       150.0   // 真实平移速度 (mm/s)
+#define SIM_VEL_Y       -80.0
+#define SIM_SWAY_DEG    8.0
+#define SIM_SWAY_HZ     1.5
+
+typedef struct {
+    double rms_comp_x, rms_comp_y;  // 补偿后速度误差 (mm/s)
+    double rms_raw_x, rms_raw_y;    // 未补偿速度误差 (mm/s)
+} FlowReplay_t;
+
+static FlowReplay_t RunReplay(void)
+{
+    FlowReplay_t r = {0};
+    double flow_acc_x = 0.0, flow_acc_y = 0.0;
+    double roll_prev = 0.0, pitch_prev = 0.0;
+    int n = 0;
+
+    memset(&t1plus_data, 0, sizeof(t1plus_data));
+    memset(&imu, 0, sizeof(imu));
+    hal_stub_tick = 0;
+    optical_flow_init();
+    srand(1);
+
+    for (uint32_t ms = 0; ms < 10000; ms++) {
+        double ph = 2.0 * M_PI * SIM_SWAY_HZ * ms / 1000.0;
+        double roll = SIM_SWAY_DEG * sin(ph);
+        double pitch = 0.7 * SIM_SWAY_DEG * sin(1.3 * ph + 0.5);
+        double roll_rate = SIM_SWAY_DEG * 2.0 * M_PI * SIM_SWAY_HZ * cos(ph);
+        double pitch_rate = 0.7 * SIM_SWAY_DEG * 2.0 * M_PI * SIM_SWAY_HZ * 1.3 * cos(1.3 * ph + 0.5);
+        hal_stub_tick = ms;
+
+        // 光流角位移 = 平移/高度 + 机体转角（轴向按 OF_COMP_X/Y_SIGN 约定）
+        flow_acc_x += SIM_VEL_X * 0.001 / SIM_HEIGHT_MM + OF_COMP_X_SIGN * (roll - roll_prev) * M_PI / 180.0;
+        flow_acc_y += SIM_VEL_Y * 0.001 / SIM_HEIGHT_MM + OF_COMP_Y_SIGN * (pitch - pitch_prev) * M_PI / 180.0;
+        roll_prev = roll;
+        pitch_prev = pitch;
+
+        if (ms % 10 == 0) {
+            imu.gy = (float)roll_rate;
+            imu.gx = (float)pitch_rate;
+            imu.roll = (float)roll;
+            imu.pitch = (float)pitch;
+        }
+        if (ms % 20 == 17) {    // 积分窗口结束，3ms后帧到达
+            t1plus_data.flow_x_integral = (int16_t)lrint(flow_acc_x * 10000.0 + (rand() % 5 - 2));
+            t1plus_data.flow_y_integral = (int16_t)lrint(flow_acc_y * 10000.0 + (rand() % 5 - 2));
+            flow_acc_x = flow_acc_y = 0.0;
+            t1plus_data.integration_timespan = 20000;
+            t1plus_data.laser_distance = (uint16_t)lrint(SIM_HEIGHT_MM /
+                                         (cos(roll * M_PI / 180.0) * cos(pitch * M_PI / 180.0)));
+            t1plus_data.valid = T1PLUS_VALID_DATA;
+            t1plus_data.laser_confidence = 90;
+            t1plus_data.timestamp = ms + 3;
+            t1plus_data.frame_count++;
+        }
+        if (ms % 10 == 0) {
+            uint32_t frame = optflow.frame_count;
+            optical_flow_update();
+            if (ms > 1000 && optflow.frame_count != frame) {
+                double raw_x = optflow.flow_rate_x * optflow.height_tilt;
+                double raw_y = optflow.flow_rate_y * optflow.height_tilt;
+                r.rms_comp_x += pow(optflow.vel_x - SIM_VEL_X, 2);
+                r.rms_comp_y += pow(optflow.vel_y - SIM_VEL_Y, 2);
+                r.rms_raw_x += pow(raw_x - SIM_VEL_X, 2);
+                r.rms_raw_y += pow(raw_y - SIM_VEL_Y, 2);
+                n++;
+            }
+        }
+    }
+    CHECK(n > 400);
+    r.rms_comp_x = sqrt(r.rms_comp_x / n);
+    r.rms_comp_y = sqrt(r.rms_comp_y / n);
+    r.rms_raw_x = sqrt(r.rms_raw_x / n);
+    r.rms_raw_y = sqrt(r.rms_raw_y / n);
+    return r;
+}
+
+static void TestCompensationDuringSway(void)
+{
+    FlowReplay_t r = RunReplay();
+    printf("rms velocity error X (mm/s): uncompensated %.1f, compensated %.1f\n", r.rms_raw_x, r.rms_comp_x);
+    printf("rms velocity error Y (mm/s): uncompensated %.1f, compensated %.1f\n", r.rms_raw_y, r.rms_comp_y);
+
+    CHECK(r.rms_comp_x < r.rms_raw_x * 0.1);
+    CHECK(r.rms_comp_y < r.rms_raw_y * 0.1);
+    CHECK(r.rms_comp_x < 50.0);  // 残差来自100Hz陀螺零阶保持与延时估计偏差
+    CHECK(r.rms_comp_y < 50.0);  // 残差来自100Hz陀螺零阶保持与延时估计偏差
+}
+
+int main(void)
+{
+    TestCompensationDuringSway();
+    return TEST_RESULT();
+}
@@ -0,0 +1,102 @@
+/**
+ * @file       test_mixer.c
+ * @author     lsl-sys
+ * @brief      Mixer Desaturation and Airmode Latch Tests
+ * @version    V1.0.0
+ * @date       2026-02-24
+ * @Encoding   UTF-8
+ * @note       四轴X几何，输出上限 MOTOR_MAX_OUTPUT。
+ *             airmode锁存前：零油门下的力矩不能抬高油门转动电机，且置饱和标志（积分抗饱和生效）；
+ *             油门越过 MIXER_AIRMODE_START_THROTTLE 后锁存，低油门保留姿态权限；Mixer_ResetAirmode 清除。
+ */
+
+#include "mixer.h"
+#include "pid_core.h"
+#include "test_util.h"
+
+static float out[MOTOR_COUNT];
+static MixSaturation_t sat;
+
+static float MaxOut(void)
+{
+    float m = out[0];
+    for (int i = 1; i < MOTOR_COUNT; i++) if (out[i] > m) m = out[i];
+    return m;
+}
+
+/* 力矩在范围内时油门不变，电机差值保持力矩 */
+static void TestUnsaturated(void)
+{
+    CHECK(Mixer_Init(MIXER_QUAD_X) == 0);
+    Mixer_Compute(30.0f, 5.0f, -3.0f, 2.0f, out, &sat);
+    CHECK_NEAR(out[MOTOR_FL], 30.0f + 5.0f - 3.0f + 2.0f, 1e-4f);
+    CHECK_NEAR(out[MOTOR_BR], 30.0f - 5.0f + 3.0f + 2.0f, 1e-4f);
+    CHECK_NEAR(g_mixer.torque_scale, 1.0f, 1e-6f);
+    CHECK(sat.pitch == 0 && sat.roll == 0 && sat.yaw == 0);
+}
+
+/* 地面零油门：角速度环力矩（如倾斜地面积分）不得转动电机 */
+static void TestGroundNoSpinUp(void)
+{
+    CHECK(Mixer_Init(MIXER_QUAD_X) == 0);
+    CHECK(g_mixer.airmode_latched == 0);
+
+    Mixer_Compute(0.0f, 8.0f, -4.0f, 1.0f, out, &sat);
+    CHECK(MaxOut() <= MOTOR_MIN_OUTPUT + 1e-4f);
+    CHECK(sat.pitch == PID_SAT_UPPER);
+    CHECK(sat.roll == PID_SAT_LOWER);
+    CHECK(g_mixer.throttle_shift <= 0.0f);
+
+    // 起始值以下的低油门：油门不上移，力矩按比例缩小
+    Mixer_Compute(MIXER_AIRMODE_START_THROTTLE - 1.0f, 8.0f, 0.0f, 0.0f, out, &sat);
+    CHECK(g_mixer.throttle_shift <= 1e-4f);
+    CHECK(g_mixer.torque_scale < 1.0f);
+    CHECK(sat.pitch == PID_SAT_UPPER);
+    CHECK(g_mixer.airmode_latched == 0);
+}
+
+/* 越过起始油门后锁存：回到零油门仍保留力矩（油门上移），停转清除 */
+static void TestAirmodeLatch(void)
+{
+    CHECK(Mixer_Init(MIXER_QUAD_X) == 0);
+    Mixer_Compute(MIXER_AIRMODE_START_THROTTLE + 10.0f, 0.0f, 0.0f, 0.0f, out, &sat);
+    CHECK(g_mixer.airmode_latched == 1);
+
+    Mixer_Compute(0.0f, 8.0f, 0.0f, 0.0f, out, &sat);
+#if MIXER_AIRMODE
+    CHECK(g_mixer.throttle_shift > 0.0f);
+    CHECK_NEAR(g_mixer.torque_scale, 1.0f, 1e-6f);
+    CHECK_NEAR(out[MOTOR_FL] - out[MOTOR_FR], 16.0f, 1e-4f);
+    CHECK(sat.pitch == 0);
+#endif
+    CHECK(g_mixer.airmode_latched == 1);    // 锁存不随油门回落清除
+
+    Mixer_ResetAirmode();
+    Mixer_Compute(0.0f, 8.0f, 0.0f, 0.0f, out, &sat);
+    CHECK(MaxOut() <= MOTOR_MIN_OUTPUT + 1e-4f);
+    CHECK(sat.pitch == PID_SAT_UPPER);
+}
+
+/* 力矩跨度超出输出范围：三轴同比例缩小 */
+static void TestRatioPreserved(void)
+{
+    CHECK(Mixer_Init(MIXER_QUAD_X) == 0);
+    Mixer_Compute(50.0f, 40.0f, 20.0f, 0.0f, out, &sat);
+    float k = g_mixer.torque_scale;
+    CHECK(k < 1.0f);
+    CHECK(MaxOut() <= MOTOR_MAX_OUTPUT + 1e-4f);
+    // 俯仰/横滚力矩比例不变：(FL+BL-FR-BR)/(FL+FR-BR-BL) = 40/20
+    float p = out[MOTOR_FL] + out[MOTOR_BL] - out[MOTOR_FR] - out[MOTOR_BR];
+    float r = out[MOTOR_FL] + out[MOTOR_FR] - out[MOTOR_BR] - out[MOTOR_BL];
+    CHECK_NEAR(p / r, 2.0f, 1e-3f);
+    CHECK(sat.pitch == PID_SAT_UPPER && sat.roll == PID_SAT_UPPER);
+}
+
+int main(void)
+{
+    TestUnsaturated();
+    TestGroundNoSpinUp();
+    TestAirmodeLatch();
+    TestRatioPreserved();
+    return TEST_RESULT();
+}
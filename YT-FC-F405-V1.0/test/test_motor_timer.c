@@ -0,0 +1,195 @@
+/**
+ * @file       test_motor_timer.c
+ * @author     lsl-sys
+ * @brief      Motor Timer Register Tests (Master/Slave Sync, OneShot125/Multishot CCR/ARR/OPM)
+ * @version    V1.0.0
+ * @date       2026-02-24
+ * @Encoding   UTF-8
+ * @note       stub 中定时器为普通内存，HAL配置函数按参考手册位域写寄存器，检查写入值：
+ *             电机映射与 Scheduler.c 一致（TIM4 CH1/CH2，TIM2 CH3/CH4），APB1 /4 → 定时器时钟 80MHz。
+ *             检查：主从触发（TIM4 TRGO=CEN，TIM2 ITR3触发模式）、单脉冲模式的 PSC/ARR/OPM/ARPE/PWM2、
+ *             CCR 与脉宽换算（脉宽 = ARR+1-CCR，最长脉冲前留 ONESHOT_LEAD_NS）、限幅与单调、
+ *             触发时UG装载并只启动主定时器、上一个脉冲未结束时不触发、PWM下写CCR期间 UDIS。
+ */
+
+#include "motor_timer.h"
+#include "test_util.h"
+
+#define TIMER_CLK_HZ    80000000u
+
+static const MotorHandle_t motors[MOTOR_COUNT] = {
+    {&htim4, TIM_CHANNEL_1, NULL, 0},
+    {&htim2, TIM_CHANNEL_4, NULL, 0},
+    {&htim2, TIM_CHANNEL_3, NULL, 0},
+    {&htim4, TIM_CHANNEL_2, NULL, 0},
+};
+
+static void Reset(void)
+{
+    memset(htim2.Instance, 0, sizeof(TIM_TypeDef));
+    memset(htim4.Instance, 0, sizeof(TIM_TypeDef));
+}
+
+static uint32_t Ticks(uint32_t ns)
+{
+    return (uint32_t)((uint64_t)TIMER_CLK_HZ * ns / 1000000000ULL);
+}
+
+/* PWM2 单脉冲：CNT 从0计到ARR，CNT<CCR为低，脉宽 = ARR+1-CCR (ns) */
+static float PulseNs(const TIM_TypeDef *t, uint32_t ccr)
+{
+    return (float)(t->ARR + 1u - ccr) * 1e9f / TIMER_CLK_HZ;
+}
+
+static uint32_t OcMode(const TIM_TypeDef *t, uint32_t ch)
+{
+    uint32_t ccmr = (ch < TIM_CHANNEL_3) ? t->CCMR1 : t->CCMR2;
+    return (ccmr >> ((ch & 0x04u) ? 8u : 0u)) & (TIM_CCMR1_OC1M | TIM_CCMR1_OC1PE);
+}
+
+/* ==================== 主从触发 ==================== */
+
+static void TestMasterSlave(void)
+{
+    Reset();
+    CHECK(MotorTimer_Init(motors) == 0);
+    CHECK(g_motor_timer.count == 2);
+    CHECK(g_motor_timer.synced == 1);
+    CHECK(g_motor_timer.htim[0] == &htim4);                         // 第一个电机所在定时器为主
+    CHECK(g_motor_timer.htim[1] == &htim2);
+    CHECK((TIM4->CR2 & TIM_CR2_MMS) == TIM_TRGO_ENABLE);
+    CHECK(TIM4->SMCR & TIM_SMCR_MSM);
+    CHECK((TIM2->SMCR & TIM_SMCR_TS) == TIM_TS_ITR3);               // RM0090：TIM2 的 ITR3 = TIM4
+    CHECK((TIM2->SMCR & TIM_SMCR_SMS) == TIM_SLAVEMODE_TRIGGER);
+
+    // 同步启动：两个定时器停止、清零、UG，只置主定时器 CEN
+    TIM2->CNT = 123;
+    TIM4->CNT = 456;
+    TIM2->CR1 = TIM4->CR1 = TIM_CR1_CEN;
+    MotorTimer_SyncStart();
+    CHECK(TIM2->CNT == 0 && TIM4->CNT == 0);
+    CHECK(TIM2->EGR == TIM_EGR_UG && TIM4->EGR == TIM_EGR_UG);
+    CHECK(TIM4->CR1 & TIM_CR1_CEN);
+    CHECK(!(TIM2->CR1 & TIM_CR1_CEN));
+
+    // 无毛刺更新：写CCR期间两个定时器都禁止更新事件
+    MotorTimer_HoldUpdate(1);
+    CHECK((TIM2->CR1 & TIM_CR1_UDIS) && (TIM4->CR1 & TIM_CR1_UDIS));
+    MotorTimer_HoldUpdate(0);
+    CHECK(!(TIM2->CR1 & TIM_CR1_UDIS) && !(TIM4->CR1 & TIM_CR1_UDIS));
+
+    // 电机超过两个定时器：报错
+    static const MotorHandle_t three[MOTOR_COUNT] = {
+        {&htim4, TIM_CHANNEL_1, NULL, 0}, {&htim2, TIM_CHANNEL_4, NULL, 0},
+        {&htim3, TIM_CHANNEL_3, NULL, 0}, {&htim4, TIM_CHANNEL_2, NULL, 0},
+    };
+    CHECK(MotorTimer_Init(three) == 1);
+}
+
+/* ==================== 单脉冲模式 ==================== */
+
+static void CheckOneShot(const char *name, uint32_t min_ns, uint32_t max_ns)
+{
+    Reset();
+    MotorTimer_Init(motors);
+    TIM2->CR1 = TIM4->CR1 = TIM_CR1_CEN;                            // 配置前在运行（PWM）
+    MotorTimer_ConfigOneShot(motors, min_ns, max_ns);
+
+    uint32_t period = Ticks(max_ns) + Ticks(ONESHOT_LEAD_NS);
+    CHECK(g_motor_timer.min_ticks == Ticks(min_ns));
+    CHECK(g_motor_timer.max_ticks == Ticks(max_ns));
+    CHECK(g_motor_timer.period_ticks == period);
+
+    const TIM_TypeDef *timers[] = {TIM2, TIM4};
+    for (int i = 0; i < 2; i++) {
+        const TIM_TypeDef *t = timers[i];
+        CHECK(t->PSC == 0);
+        CHECK(t->ARR == period - 1u);
+        CHECK(t->CR1 & TIM_CR1_OPM);
+        CHECK(t->CR1 & TIM_CR1_ARPE);
+        CHECK(!(t->CR1 & TIM_CR1_CEN));                             // 停止，等待触发
+        CHECK(t->CNT == 0);
+        CHECK(t->EGR == TIM_EGR_UG);
+    }
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        const TIM_TypeDef *t = motors[i].htim->Instance;
+        CHECK(OcMode(t, motors[i].channel) == (TIM_OCMODE_PWM2 | TIM_CCMR1_OC1PE));
+        CHECK(__HAL_TIM_GET_COMPARE(motors[i].htim, motors[i].channel) == period);    // 初始无脉冲
+    }
+
+    // CCR 与脉宽：0% = min，100% = max，限幅
+    uint32_t ccr0 = MotorTimer_OneShotCCR(0.0f);
+    uint32_t ccr100 = MotorTimer_OneShotCCR(100.0f);
+    printf("%s: ARR %u, CCR 0%% %u (%.3f us), 100%% %u (%.3f us)\n",
+           name, TIM2->ARR, ccr0, PulseNs(TIM2, ccr0) / 1000.0f, ccr100, PulseNs(TIM2, ccr100) / 1000.0f);
+    CHECK_NEAR(PulseNs(TIM2, ccr0), (float)min_ns, 1e9f / TIMER_CLK_HZ);
+    CHECK_NEAR(PulseNs(TIM2, ccr100), (float)max_ns, 1e9f / TIMER_CLK_HZ);
+    CHECK_NEAR(PulseNs(TIM2, MotorTimer_OneShotCCR(50.0f)), 0.5f * (min_ns + max_ns), 2e9f / TIMER_CLK_HZ);
+    CHECK(MotorTimer_OneShotCCR(-10.0f) == ccr0);
+    CHECK(MotorTimer_OneShotCCR(150.0f) == ccr100);
+    CHECK(ccr100 == Ticks(ONESHOT_LEAD_NS));                        // 最长脉冲前仍有一段低电平
+    CHECK(ccr100 > 0);
+
+    // 油门越大CCR越小（脉宽越长），逐0.1%单调
+    int bad = 0;
+    uint32_t prev = ccr0;
+    for (int k = 1; k <= 1000; k++) {
+        uint32_t c = MotorTimer_OneShotCCR(k * 0.1f);
+        if (c > prev) bad++;
+        prev = c;
+    }
+    CHECK(bad == 0);
+}
+
+static void TestOneShot125(void)
+{
+    CheckOneShot("oneshot125", ONESHOT125_MIN_NS, ONESHOT125_MAX_NS);
+    CHECK(g_motor_timer.period_ticks == 20080);     // 250us + 1us @ 80MHz
+}
+
+static void TestMultishot(void)
+{
+    CheckOneShot("multishot", MULTISHOT_MIN_NS, MULTISHOT_MAX_NS);
+    CHECK(g_motor_timer.period_ticks == 2080);      // 25us + 1us @ 80MHz
+}
+
+/* ==================== 触发 ==================== */
+
+static void TestTrigger(void)
+{
+    Reset();
+    MotorTimer_Init(motors);
+    MotorTimer_ConfigOneShot(motors, ONESHOT125_MIN_NS, ONESHOT125_MAX_NS);
+
+    uint32_t ccr = MotorTimer_OneShotCCR(30.0f);
+    for (int i = 0; i < MOTOR_COUNT; i++) __HAL_TIM_SET_COMPARE(motors[i].htim, motors[i].channel, ccr);
+    TIM2->EGR = TIM4->EGR = 0;
+    MotorTimer_Trigger();
+    CHECK(TIM2->EGR == TIM_EGR_UG && TIM4->EGR == TIM_EGR_UG);      // 预装载CCR转入影子寄存器
+    CHECK(TIM4->CR1 & TIM_CR1_CEN);                                 // 只启动主定时器
+    CHECK(!(TIM2->CR1 & TIM_CR1_CEN));
+    CHECK(g_motor_timer.busy == 0);
+
+    // 主定时器脉冲未结束（从定时器已由TRGO启动）：不再触发
+    TIM2->CR1 |= TIM_CR1_CEN;
+    TIM2->EGR = TIM4->EGR = 0;
+    MotorTimer_Trigger();
+    CHECK(g_motor_timer.busy == 1);
+    CHECK(TIM2->EGR == 0 && TIM4->EGR == 0);
+
+    // OPM 计数结束硬件清 CEN 后可再次触发
+    TIM2->CR1 &= ~TIM_CR1_CEN;
+    TIM4->CR1 &= ~TIM_CR1_CEN;
+    MotorTimer_Trigger();
+    CHECK(g_motor_timer.busy == 1);
+    CHECK(TIM4->CR1 & TIM_CR1_CEN);
+}
+
+int main(void)
+{
+    TestMasterSlave();
+    TestOneShot125();
+    TestMultishot();
+    TestTrigger();
+    return TEST_RESULT();
+}
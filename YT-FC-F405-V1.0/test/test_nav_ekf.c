@@ -0,0 +1,157 @@
+/**
+ * @file       test_nav_ekf.c
+ * @author     lsl-sys
+ * @brief      Navigation Kalman Filter Accuracy Comparison and Benchmark
+ * @version    V1.0.0
+ * @date       2026-02-24
+ * @Encoding   UTF-8
+ * @note       仿真三轴正弦运动（带加速度计零偏与噪声），光流速度50Hz、延时15ms，激光高度延时5ms，
+ *             与未融合的估计比较RMS误差：
+ *             水平速度 ← 原始光流速度；高度 ← 一阶低通激光高度（水平位置只打印，无直接测量）。
+ *             imu / optflow 由本文件直接写入，只链接 nav_ekf.c。
+ *             基准：单次 nav_ekf_update（一半周期带融合）主机耗时，只打印。
+ */
+
+#include <stdlib.h>
+#include "nav_ekf.h"
+#include "imu.h"
+#include "OpticalFlow.h"
+#include "test_util.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+imu_data_t imu;
+optical_flow_t optflow;
+
+#define SIM_HIST        64
+#define SIM_ACC_NOISE   35.0    // cm/s^2
+#define SIM_VEL_NOISE   8.0     // cm/s
+#define SIM_RNG_NOISE   1.5     // cm
+
+static const double sim_bias[NAV_AXIS_COUNT] = {15.0, -10.0, 20.0};   // 加速度计零偏 (cm/s^2)
+
+static double Gauss(void)
+{
+    double u = (rand() + 1.0) / (RAND_MAX + 2.0);
+    double v = (rand() + 1.0) / (RAND_MAX + 2.0);
+    return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+}
+
+/* DWT计数器由ELRS/遥控插值共用，初始化只开启不清零 */
+static void TestInitKeepsCycleCounter(void)
+{
+    DWT->CYCCNT = 0x12345678u;
+    nav_ekf_init();
+    CHECK(DWT->CYCCNT == 0x12345678u);
+    CHECK(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk);
+}
+
+static void TestAccuracy(void)
+{
+    double p[NAV_AXIS_COUNT] = {0.0, 0.0, 100.0}, v[NAV_AXIS_COUNT] = {0};
+    double hv[SIM_HIST][NAV_AXIS_COUNT], hp[SIM_HIST][NAV_AXIS_COUNT];
+    double e_ekf_v = 0, e_raw_v = 0, e_ekf_h = 0, e_pt1_h = 0, e_ekf_p = 0, e_raw_p = 0;
+    double pt1 = 100.0, raw_v = 0.0, raw_pos = 0.0;
+    int n = 0;
+
+    srand(1);
+    memset(&imu, 0, sizeof(imu));
+    memset(&optflow, 0, sizeof(optflow));
+    imu.online = imu.valid = 1;
+    hal_stub_tick = 0;
+    nav_ekf_init();
+
+    for (uint32_t ms = 0; ms < 60000; ms++) {
+        hal_stub_tick = ms;
+        for (int i = 0; i < NAV_AXIS_COUNT; i++) {
+            double a = 80.0 * sin(2.0 * M_PI * (0.3 + 0.2 * i) * ms / 1000.0);
+            v[i] += a * 0.001;
+            p[i] += v[i] * 0.001;
+            hv[ms % SIM_HIST][i] = v[i];
+            hp[ms % SIM_HIST][i] = p[i];
+        }
+
+        // 50Hz光流帧：速度对应15ms前（积分窗口中点），高度对应5ms前
+        if (ms % 20 == 0 && ms > 100) {
+            uint32_t kd = (ms - 15) % SIM_HIST, kr = (ms - 5) % SIM_HIST;
+            optflow.valid = 1;
+            optflow.frame_count++;
+            optflow.vel_x = (float)((hv[kd][0] + Gauss() * SIM_VEL_NOISE) * 10.0);
+            optflow.vel_y = (float)((hv[kd][1] + Gauss() * SIM_VEL_NOISE) * 10.0);
+            optflow.height_tilt = (float)((hp[kr][2] + Gauss() * SIM_RNG_NOISE) * 10.0);
+            optflow.flow_tick = ms - 15;
+            optflow.range_tick = ms - 5;
+
+            pt1 += 0.15 * (optflow.height_tilt / 10.0 - pt1);
+            raw_v = optflow.vel_x / 10.0;
+            raw_pos += raw_v * 0.02;
+        }
+
+        if (ms % 10 == 0) {
+            double a[NAV_AXIS_COUNT];
+            for (int i = 0; i < NAV_AXIS_COUNT; i++) {
+                a[i] = 80.0 * sin(2.0 * M_PI * (0.3 + 0.2 * i) * ms / 1000.0) + sim_bias[i] + Gauss() * SIM_ACC_NOISE;
+            }
+            imu.ax = (float)(a[0] / NAV_GRAVITY_CMS2);
+            imu.ay = (float)(a[1] / NAV_GRAVITY_CMS2);
+            imu.az = (float)(1.0 + a[2] / NAV_GRAVITY_CMS2);
+            imu.roll = imu.pitch = 0.0f;
+            nav_ekf_update();
+
+            if (ms > 5000) {
+                e_ekf_v += pow(nav.vel[NAV_AXIS_X] - v[0], 2);
+                e_raw_v += pow(raw_v - v[0], 2);
+                e_ekf_h += pow(nav.pos[NAV_AXIS_Z] - p[2], 2);
+                e_pt1_h += pow(pt1 - p[2], 2);
+                e_ekf_p += pow(nav.pos[NAV_AXIS_X] - p[0], 2);
+                e_raw_p += pow(raw_pos - p[0], 2);
+                n++;
+            }
+        }
+    }
+
+    e_ekf_v = sqrt(e_ekf_v / n);  e_raw_v = sqrt(e_raw_v / n);
+    e_ekf_h = sqrt(e_ekf_h / n);  e_pt1_h = sqrt(e_pt1_h / n);
+    e_ekf_p = sqrt(e_ekf_p / n);  e_raw_p = sqrt(e_raw_p / n);
+    printf("vel_x RMS:  raw flow %.2f cm/s, EKF %.2f cm/s\n", e_raw_v, e_ekf_v);
+    printf("height RMS: PT1 %.2f cm, EKF %.2f cm\n", e_pt1_h, e_ekf_h);
+    printf("pos_x RMS:  raw integration %.2f cm, EKF %.2f cm\n", e_raw_p, e_ekf_p);
+    printf("bias est:   %.1f %.1f %.1f (true %.0f %.0f %.0f)\n",
+           nav.bias[0], nav.bias[1], nav.bias[2], sim_bias[0], sim_bias[1], sim_bias[2]);
+
+    CHECK(nav.horiz_valid && nav.vert_valid);
+    CHECK(e_ekf_v < e_raw_v);
+    CHECK(e_ekf_h < e_pt1_h);
+    // 水平位置无直接测量，两者都是速度积分随机游走，只打印不比较
+    for (int i = 0; i < NAV_AXIS_COUNT; i++) {
+        CHECK_NEAR(nav.bias[i], sim_bias[i], 5.0);
+    }
+}
+
+static void BenchUpdate(void)
+{
+    const int N = 1000000;
+    double t0 = test_now_ns();
+    for (int i = 0; i < N; i++) {
+        hal_stub_tick += 10;
+        if (i % 2 == 0) {
+            optflow.frame_count++;
+            optflow.flow_tick = hal_stub_tick - 15;
+            optflow.range_tick = hal_stub_tick - 5;
+        }
+        nav_ekf_update();
+    }
+    double t1 = test_now_ns();
+    test_sink = nav.pos[0];
+    printf("bench nav_ekf_update: %.1f ns/update on host (half with fusion)\n", (t1 - t0) / N);
+}
+
+int main(void)
+{
+    TestInitKeepsCycleCounter();
+    TestAccuracy();
+    BenchUpdate();
+    return TEST_RESULT();
+}
@@ -0,0 +1,265 @@
+/**
+ * @file       test_pid_core.c
+ * @author     lsl-sys
+ * @brief      pid_core Closed-loop Simulation Tests
+ * @version    V1.0.0
+ * @date       2026-02-24
+ * @Encoding   UTF-8
+ * @note       单轴角速度对象（力矩→角加速度，带阻尼），执行器按混控削顶限幅，
+ *             控制周期与 Loop_100Hz 一致。
+ *             抗饱和：满杆翻滚后回中，比较混控饱和反馈（PID_SetSaturation）开/关时的反向过冲。
+ *             I-term relax：翻转（400°/s 斜坡打杆-保持-回中），比较 ITERM_RELAX_* 默认参数开/关时的回弹。
+ *             前馈/抗重力经 pid_control.c（g_pid 俯仰角速度环，手动模式）：
+ *             斜坡打杆比较前馈开/关的跟踪延迟；油门猛推（重心偏置产生与推力成比例的俯仰力矩）
+ *             比较抗重力开/关的姿态偏移，并确认出厂参数（KI=0）下抗重力不起作用。
+ */
+
+#include "pid_core.h"
+#include "pid_control.h"
+#include "test_util.h"
+
+#define SIM_ACT_LIMIT       10.0f   // 执行器（混控削顶后）可用力矩
+#define SIM_GAIN            0.5f    // 力矩 → 每周期角速度增量
+#define SIM_DAMP            0.02f   // 空气阻尼
+
+typedef struct {
+    float max_rate;         // 打杆阶段最大角速度（超过200为进入时的过冲）
+    float overshoot;        // 回中后反向过冲峰值（°/s）
+    float peak_integ;       // 打杆阶段积分峰值
+} HardManoeuvre_t;
+
+/* 满杆 200°/s 保持3s后回中：混控在 SIM_ACT_LIMIT 削顶并按方向反馈饱和标志 */
+static HardManoeuvre_t RunHardManoeuvre(uint8_t feed_saturation)
+{
+    PIDController pid;
+    pidParam_t param = {0.5f, 0.05f, 0.0f, 0.0f};
+    HardManoeuvre_t r = {0};
+    float rate = 0.0f;
+    uint8_t sat = PID_SAT_NONE;
+
+    PID_Init(&pid, 0.0f, param);
+    PID_SetIntegralLimit(&pid, 1000.0f);
+    PID_SetOutputLimit(&pid, 100.0f);
+
+    for (int k = 0; k < 600; k++) {
+        float target = (k < 300) ? 200.0f : 0.0f;
+        if (feed_saturation) PID_SetSaturation(&pid, sat);
+
+        float u = PID_Calculate(&pid, rate, target);
+        sat = PID_SAT_NONE;
+        if (u > SIM_ACT_LIMIT)       { u = SIM_ACT_LIMIT;  sat = PID_SAT_UPPER; }
+        else if (u < -SIM_ACT_LIMIT) { u = -SIM_ACT_LIMIT; sat = PID_SAT_LOWER; }
+        rate += u * SIM_GAIN - rate * SIM_DAMP;
+
+        if (k < 300) {
+            if (rate > r.max_rate) r.max_rate = rate;
+            if (pid.integ > r.peak_integ) r.peak_integ = pid.integ;
+        } else if (-rate > r.overshoot) {
+            r.overshoot = -rate;
+        }
+    }
+    return r;
+}
+
+static void TestAntiWindupOvershoot(void)
+{
+    HardManoeuvre_t off = RunHardManoeuvre(0);
+    HardManoeuvre_t on = RunHardManoeuvre(1);
+    printf("hard manoeuvre overshoot (dps): no feedback %.1f, saturation feedback %.1f\n",
+           off.overshoot, on.overshoot);
+    printf("entry peak rate (dps):          no feedback %.1f, saturation feedback %.1f\n",
+           off.max_rate, on.max_rate);
+    printf("peak integrator during roll:     no feedback %.0f, saturation feedback %.0f\n",
+           off.peak_integ, on.peak_integ);
+
+    // 加速阶段执行器削顶：无反馈时积分累积，到达目标后冲过头
+    CHECK(on.max_rate < 200.0f * 1.02f);
+    CHECK(off.max_rate > on.max_rate);
+    // 饱和期间积分不再向削顶方向累积，回中后反向过冲明显减小
+    CHECK(on.peak_integ < off.peak_integ * 0.5f);
+    CHECK(on.overshoot < off.overshoot * 0.5f);
+}
+
+/* 自身输出限幅：反算增益使积分跟随限幅后的输出 */
+static void TestBackCalculation(void)
+{
+    PIDController pid;
+    pidParam_t param = {1.0f, 0.1f, 0.0f, 0.0f};
+    PID_Init(&pid, 0.0f, param);
+    PID_SetIntegralLimit(&pid, 1000.0f);
+    PID_SetOutputLimit(&pid, 10.0f);
+    PID_SetAntiWindupGain(&pid, 1.0f);
+
+    for (int k = 0; k < 100; k++) PID_Calculate(&pid, 0.0f, 50.0f);
+    CHECK_NEAR(pid.out, 10.0f, 1e-4f);
+    // P已超过限幅：积分被反算回退到使输出恰好等于限幅
+    CHECK(pid.outP + pid.outI <= 10.0f + 1e-3f);
+}
+
+/* 翻转：0.1s斜坡到400°/s，保持0.3s，0.1s斜坡回中；执行器一阶滞后，无阻尼（积分对象） */
+static float RunFlipBounceBack(uint8_t relax)
+{
+    PIDController pid;
+    pidParam_t param = {0.6f, 0.1f, 0.0f, 0.0f};
+    float rate = 0.0f, actuator = 0.0f, bounce = 0.0f;
+
+    PID_Init(&pid, 0.0f, param);
+    PID_SetIntegralLimit(&pid, 400.0f);
+    PID_SetOutputLimit(&pid, 100.0f);
+    if (relax) PID_SetITermRelax(&pid, ITERM_RELAX_ALPHA, ITERM_RELAX_THRESH_RP);
+
+    for (int k = 0; k < 300; k++) {
+        float target;
+        if (k < 10)      target = 0.0f;
+        else if (k < 20) target = (k - 10) * 40.0f;
+        else if (k < 50) target = 400.0f;
+        else if (k < 60) target = 400.0f - (k - 50) * 40.0f;
+        else             target = 0.0f;
+
+        float u = PID_Calculate(&pid, rate, target);
+        actuator += 0.3f * (u - actuator);
+        rate += actuator * SIM_GAIN;
+
+        // 回中后反向角速度峰值即回弹
+        if (k >= 60 && -rate > bounce) bounce = -rate;
+    }
+    return bounce;
+}
+
+static void TestITermRelaxBounceBack(void)
+{
+    float off = RunFlipBounceBack(0);
+    float on = RunFlipBounceBack(1);
+    printf("flip bounce-back peak reverse rate (dps): relax off %.1f, relax on %.1f\n", off, on);
+
+    CHECK(off > 20.0f);            // 场景确实存在回弹
+    CHECK(on < off * 0.7f);
+}
+
+/* 目标不变时 relax 不影响积分 */
+static void TestITermRelaxSteady(void)
+{
+    PIDController a, b;
+    pidParam_t param = {0.6f, 0.1f, 0.0f, 0.0f};
+    PID_Init(&a, 0.0f, param);
+    PID_Init(&b, 0.0f, param);
+    PID_SetITermRelax(&b, ITERM_RELAX_ALPHA, ITERM_RELAX_THRESH_RP);
+
+    for (int k = 0; k < 50; k++) {
+        PID_Calculate(&a, 5.0f, 30.0f);
+        PID_Calculate(&b, 5.0f, 30.0f);
+    }
+    CHECK_NEAR(b.integ, a.integ, 1e-3f);
+    CHECK_NEAR(b.relaxFactor, 1.0f, 1e-6f);
+}
+
+/* ==================== 前馈 ==================== */
+
+#define FF_RAMP_CYCLES      30      // 0.3s 斜坡打杆到 150°/s
+#define FF_TARGET_DPS       150.0f
+
+typedef struct {
+    float delay_ms;         // 目标与响应越过50%的时间差
+    float rms_err;          // 斜坡与保持阶段的跟踪误差RMS (°/s)
+} Tracking_t;
+
+/* 手动模式俯仰：执行器一阶滞后，目标为斜坡-保持 */
+static Tracking_t RunRampTracking(float kff)
+{
+    Tracking_t r = {0};
+    float rate = 0.0f, actuator = 0.0f, err2 = 0.0f;
+    int t_target = -1, t_rate = -1, n = 0;
+
+    PID_InitAll(40.0f);
+    PID_SetMode(MODE_RATE);
+    PID_SetRateFeedForward(AXIS_PITCH, kff);
+
+    for (int k = 0; k < 100; k++) {
+        float target = (k < FF_RAMP_CYCLES) ? FF_TARGET_DPS * k / FF_RAMP_CYCLES : FF_TARGET_DPS;
+        PID_UpdateAttitude(target, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, rate, 0.0f, 0.0f);
+        actuator += 0.3f * (g_pid.out.pitch - actuator);
+        rate += actuator * SIM_GAIN - rate * SIM_DAMP;
+
+        if (t_target < 0 && target >= 0.5f * FF_TARGET_DPS) t_target = k;
+        if (t_rate < 0 && rate >= 0.5f * FF_TARGET_DPS) t_rate = k;
+        if (k < 60) {
+            err2 += (target - rate) * (target - rate);
+            n++;
+        }
+    }
+    r.delay_ms = (float)(t_rate - t_target) * 1000.0f / PID_LOOP_HZ;
+    r.rms_err = sqrtf(err2 / n);
+    return r;
+}
+
+static void TestFeedForwardDelay(void)
+{
+    // 前馈增益取对象逆：每周期目标增量所需力矩 = 增量 / SIM_GAIN
+    Tracking_t off = RunRampTracking(0.0f);
+    Tracking_t on = RunRampTracking(1.0f / SIM_GAIN);
+    printf("ramp tracking delay (ms): ff off %.0f, ff on %.0f; rms error (dps) %.1f -> %.1f\n",
+           off.delay_ms, on.delay_ms, off.rms_err, on.rms_err);
+
+    CHECK(off.delay_ms > 0.0f);
+    CHECK(on.delay_ms < off.delay_ms);
+    CHECK(on.rms_err < off.rms_err * 0.7f);
+}
+
+/* ==================== 抗重力 ==================== */
+
+#define AG_CG_TORQUE        0.08f   // 重心偏置：每1%油门的俯仰扰动力矩
+
+/* 悬停40%，1s时0.1s内推到90%：返回推油门后1s内俯仰角偏移峰值（°） */
+static float RunThrottlePunch(float ki, float ag_gain)
+{
+    float rate = 0.0f, angle = 0.0f, peak = 0.0f;
+    pidParam_t param = {DEFAULT_PITCH_RATE_KP, ki, DEFAULT_PITCH_RATE_KD, DEFAULT_PITCH_RATE_ISEP};
+
+    PID_InitAll(40.0f);
+    PID_SetMode(MODE_RATE);
+    PID_SetRateParam(AXIS_PITCH, &param);
+    PID_SetIntegralLimit(&g_pid.attitude.rate.pitch, 1000.0f);
+    g_pid.attitude.anti_gravity.gain[AXIS_PITCH] = ag_gain;
+
+    for (int k = 0; k < 300; k++) {
+        float thr;
+        if (k < 100)      thr = 40.0f;
+        else if (k < 110) thr = 40.0f + (k - 100) * 5.0f;
+        else              thr = 90.0f;
+
+        PID_UpdateAntiGravity(thr);
+        PID_UpdateAttitude(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, rate, 0.0f, 0.0f);
+        rate += (g_pid.out.pitch - AG_CG_TORQUE * thr) * SIM_GAIN - rate * SIM_DAMP;
+        angle += rate / PID_LOOP_HZ;
+
+        if (k == 99) angle = 0.0f;  // 悬停段积分已抵消稳态扰动，从推油门开始计偏移
+        if (k >= 100 && k < 200 && fabsf(angle) > peak) peak = fabsf(angle);
+    }
+    return peak;
+}
+
+static void TestAntiGravity(void)
+{
+    const float ki = 0.05f;
+    float off = RunThrottlePunch(ki, 0.0f);
+    float on = RunThrottlePunch(ki, DEFAULT_PITCH_ANTI_GRAVITY);
+    printf("throttle punch pitch drift (deg, KI %.2f): anti-gravity off %.2f, on %.2f\n", ki, off, on);
+    CHECK(off > 0.5f);             // 无抗重力时积分追不上推油门的扰动
+    CHECK(on < off * 0.5f);
+
+    // 出厂 KI=0：积分不参与，抗重力无效果
+    float shipped_off = RunThrottlePunch(DEFAULT_PITCH_RATE_KI, 0.0f);
+    float shipped_on = RunThrottlePunch(DEFAULT_PITCH_RATE_KI, DEFAULT_PITCH_ANTI_GRAVITY);
+    CHECK_NEAR(shipped_on, shipped_off, 1e-4f);
+}
+
+int main(void)
+{
+    TestAntiWindupOvershoot();
+    TestBackCalculation();
+    TestITermRelaxBounceBack();
+    TestITermRelaxSteady();
+    TestFeedForwardDelay();
+    TestAntiGravity();
+    return TEST_RESULT();
+}
@@ -0,0 +1,137 @@
+/**
+ * @file       test_pos_hold.c
+ * @author     lsl-sys
+ * @brief      Optical-flow Position-hold Cascade Tests (Position → Velocity → Attitude)
+ * @version    V1.0.0
+ * @date       2026-02-24
+ * @Encoding   UTF-8
+ * @note       水平对象：姿态跟随目标角（一阶滞后），水平加速度 = g·tan(角)，测量直接取对象位置/速度。
+ *             检查：摇杆死区与速度指令、松杆先刹车再锁点（锁在刹停处，不被拉回松杆位置）、
+ *             光流无效（horiz_valid=0）时返回0且不改写目标角（调用方沿用摇杆角度）、恢复后重新刹车锁点。
+ */
+
+#include "pid_control.h"
+#include "test_util.h"
+
+#define DT              (1.0f / PID_LOOP_HZ)
+#define ATT_LAG         0.3f        // 姿态跟随目标角的一阶系数
+#define GRAVITY_CMS2    981.0f
+
+typedef struct {
+    float angle, vel, pos;
+} Axis_t;
+
+static Axis_t ax_x, ax_y;          // x: 横滚方向（右），y: 俯仰方向（前）
+
+static void AxisStep(Axis_t *a, float target_angle)
+{
+    a->angle += ATT_LAG * (target_angle - a->angle);
+    a->vel += GRAVITY_CMS2 * tanf(a->angle * 3.14159265f / 180.0f) * DT;
+    a->pos += a->vel * DT;
+}
+
+/* 一个控制周期，返回 PID_UpdatePosHold 的返回值；目标角初值为摇杆角度 */
+static uint8_t Step(float stick_roll, float stick_pitch, uint8_t valid, float *tp, float *tr)
+{
+    float target_pitch = PID_StickToAngle(stick_pitch);
+    float target_roll = PID_StickToAngle(stick_roll);
+    uint8_t ok = PID_UpdatePosHold(stick_roll, stick_pitch, ax_x.pos, ax_y.pos, ax_x.vel, ax_y.vel, valid,
+                                   &target_pitch, &target_roll);
+    AxisStep(&ax_x, target_roll);
+    AxisStep(&ax_y, target_pitch);
+    if (tp) *tp = target_pitch;
+    if (tr) *tr = target_roll;
+    return ok;
+}
+
+static void Reset(void)
+{
+    memset(&ax_x, 0, sizeof(ax_x));
+    memset(&ax_y, 0, sizeof(ax_y));
+    PID_InitAll(40.0f);
+    PID_SetPosHold(1);
+}
+
+/* 死区内为零速度指令（刹车/定点），死区外线性映射到 ±POS_MAX_VEL_CMS */
+static void TestStickDeadband(void)
+{
+    Reset();
+    Step(POS_STICK_DEADBAND - 0.1f, 0.0f, 1, NULL, NULL);
+    CHECK_NEAR(g_pid.velocity.target_x, 0.0f, 1e-6f);
+    CHECK(g_pid.position.locked == 1);                   // 静止时松杆立即锁点
+
+    Step(55.0f, -100.0f, 1, NULL, NULL);
+    CHECK(g_pid.position.locked == 0);
+    CHECK_NEAR(g_pid.velocity.target_x, 25.0f, 1e-4f);
+    CHECK_NEAR(g_pid.velocity.target_y, -POS_MAX_VEL_CMS, 1e-4f);
+}
+
+/* 满杆右飞后松杆：刹停前不锁点，锁在刹停处并保持 */
+static void TestBrakeThenLatch(void)
+{
+    Reset();
+    for (int k = 0; k < 3 * PID_LOOP_HZ; k++) Step(100.0f, 0.0f, 1, NULL, NULL);
+    printf("cruise: vel %.1f cm/s, angle %.1f deg\n", ax_x.vel, ax_x.angle);
+    CHECK_NEAR(ax_x.vel, POS_MAX_VEL_CMS, 5.0f);
+
+    float release = ax_x.pos;
+    int lock_k = -1;
+    float lock_pos = 0.0f;
+    for (int k = 0; k < 8 * PID_LOOP_HZ; k++) {
+        Step(0.0f, 0.0f, 1, NULL, NULL);
+        if (lock_k < 0 && g_pid.position.locked) {
+            lock_k = k;
+            lock_pos = ax_x.pos;
+            // 锁点条件：低通速度与刹车角都已回落
+            CHECK(fabsf(g_pid.velocity.meas_x) < POS_BRAKE_VEL_CMS);
+            CHECK(fabsf(g_pid.velocity.x.out) < POS_BRAKE_ANGLE);
+        }
+        if (lock_k < 0) CHECK(g_pid.position.locked == 0);
+    }
+    printf("brake: %.2f s to latch, brake distance %.1f cm, latched %.1f, target %.1f, final %.1f\n",
+           (float)lock_k / PID_LOOP_HZ, lock_pos - release, lock_pos, g_pid.position.target_x, ax_x.pos);
+
+    CHECK(lock_k > 0);
+    CHECK(lock_pos - release > 5.0f);                   // 有刹车距离
+    CHECK_NEAR(g_pid.position.target_x, lock_pos, 1.0f);
+    CHECK_NEAR(ax_x.pos, g_pid.position.target_x, 2.0f); // 保持锁点，不回到松杆位置
+    CHECK(fabsf(ax_x.pos - release) > 5.0f);
+    CHECK_NEAR(ax_y.pos, 0.0f, 0.5f);
+}
+
+/* 光流无效：返回0，目标角保持摇杆角度；恢复后重新刹车锁点 */
+static void TestFallbackOnInvalid(void)
+{
+    float tp, tr;
+
+    Reset();
+    for (int k = 0; k < PID_LOOP_HZ; k++) Step(0.0f, 0.0f, 1, NULL, NULL);
+    CHECK(g_pid.position.locked == 1);
+
+    // 无效期间摇杆角度直通（调用方沿用 PID_StickToAngle 结果）
+    uint8_t ok = Step(0.0f, 40.0f, 0, &tp, &tr);
+    CHECK(ok == 0);
+    CHECK(g_pid.position.locked == 0);
+    CHECK_NEAR(tp, PID_StickToAngle(40.0f), 1e-6f);
+    CHECK_NEAR(tr, 0.0f, 1e-6f);
+    for (int k = 0; k < PID_LOOP_HZ / 2; k++) Step(0.0f, 40.0f, 0, NULL, NULL);
+    CHECK(ax_y.vel > 20.0f);                            // 按摇杆角度前飞
+
+    // 恢复：松杆后先刹车，刹停处锁点
+    float resume = ax_y.pos;
+    for (int k = 0; k < 8 * PID_LOOP_HZ; k++) {
+        CHECK(Step(0.0f, 0.0f, 1, NULL, NULL) == 1);
+    }
+    printf("fallback: resumed at %.1f cm, latched %.1f, final %.1f\n", resume, g_pid.position.target_y, ax_y.pos);
+    CHECK(g_pid.position.locked == 1);
+    CHECK(g_pid.position.target_y > resume);
+    CHECK_NEAR(ax_y.pos, g_pid.position.target_y, 2.0f);
+}
+
+int main(void)
+{
+    TestStickDeadband();
+    TestBrakeThenLatch();
+    TestFallbackOnInvalid();
+    return TEST_RESULT();
+}
@@ -0,0 +1,285 @@
+/**
+ * @file       test_rc_smoothing.c
+ * @author     lsl-sys
+ * @brief      RC Frame Processing Latency A/B (RC_EVENT_DRIVEN 0/1) and Setpoint Interpolation Tests
+ * @version    V1.0.0
+ * @date       2026-02-24
+ * @Encoding   UTF-8
+ * @note       直接包含 ELRS.c（写DMA循环缓冲），RemoteControl.c / rc_smoothing.c 为真实代码，
+ *             按 RC_EVENT_DRIVEN=0（旧：100Hz控制周期轮询）与 =1（1kHz时隙逐帧）各编译一次作为A/B。
+ *             调度与 Scheduler.c 相同：1ms节拍，Loop_1000Hz 先于 Loop_100Hz，混控在节拍后 0.3ms；
+ *             帧按包速率在节拍间任意时刻到达（DWT时间戳到微秒）。
+ *             打印：处理帧数、多轴快速打杆跟踪误差、50Hz匀速打杆每周期步长离散度、阶跃到50%时间、
+ *             帧到达→混控输出延迟。只对两种模式都应满足、或本模式特有的结果做检查。
+ */
+
+#include "ELRS.c"
+#include "rc_smoothing.h"
+#include "pid_control.h"
+#include "test_util.h"
+
+#define CONTROL_MS      (1000 / PID_LOOP_HZ)
+#define MIX_DELAY_US    300u                    // 控制周期节拍到混控输出
+#define FRAME_PHASE_US  370u                    // 帧到达相对节拍的初始相位
+
+typedef float (*Stick_t)(uint32_t us);
+
+typedef struct {
+    uint32_t sent;              // 发送帧数
+    uint32_t filtered;          // 经过滤波的帧数
+    float rms;                  // 控制周期采样的摇杆设定值跟踪误差（相对帧内容）
+    float step_sd;              // 每周期设定值变化量（绝对值）的标准差
+    float t50_ms;               // 阶跃后设定值到50%的时间（-1未到）
+    float lat_avg_ms, lat_max_ms;
+} Result_t;
+
+static uint32_t sim_us;
+static uint16_t dma_pos;
+static bool smooth_on = RC_SMOOTH_ENABLE;   // 插值开关（VOFA "RSM"），场景开始时写入
+static float last_sent[4];      // 最近一帧的摇杆值（-100~100，量化后）
+
+static void SimSetTime(uint32_t us)
+{
+    sim_us = us;
+    hal_stub_tick = us / 1000u;
+    DWT->CYCCNT = (uint32_t)((uint64_t)us * (SystemCoreClock / 1000000u));
+}
+
+/* 与 remap_channel 互逆的量化 */
+static uint16_t ToTicks(float v)
+{
+    return (uint16_t)lroundf(RC_MID + v / RC_SCALE);
+}
+
+static void SendRc(const float v[4])
+{
+    uint16_t ch[CRSF_CHAN_NUM];
+    uint8_t p[CRSF_RC_PAYLOAD_LEN], f[CRSF_FRAME_SIZE_MAX];
+    uint32_t bits = 0;
+    int n = 0, k = 0;
+
+    for (int i = 0; i < CRSF_CHAN_NUM; i++) ch[i] = RC_MID;
+    ch[4] = ch[5] = ch[6] = RC_MIN;                             // 三段开关在下档
+    for (int i = 0; i < 4; i++) {
+        ch[i] = ToTicks(v[i]);
+        last_sent[i] = remap_channel(ch[i]);
+    }
+    memset(p, 0, sizeof(p));
+    for (int i = 0; i < CRSF_CHAN_NUM; i++) {
+        bits |= (uint32_t)(ch[i] & 0x7FF) << n;
+        for (n += 11; n >= 8; n -= 8) {
+            p[k++] = (uint8_t)bits;
+            bits >>= 8;
+        }
+    }
+    f[0] = CRSF_ADDRESS_FLIGHT_CONTROLLER;
+    f[1] = CRSF_RC_PAYLOAD_LEN + 2;
+    f[2] = CRSF_FRAMETYPE_RC_CHANNELS_PACKED;
+    memcpy(&f[3], p, CRSF_RC_PAYLOAD_LEN);
+    f[CRSF_RC_PAYLOAD_LEN + 3] = crsf_crc8(&f[2], CRSF_RC_PAYLOAD_LEN + 1);
+
+    for (int i = 0; i < CRSF_RC_PAYLOAD_LEN + 4; i++) {
+        elrs_rx_buf[dma_pos++] = f[i];
+        if (dma_pos == CRSF_RX_BUF_SIZE) {
+            crsf_receive_data(dma_pos);
+            dma_pos = 0;
+        }
+    }
+    if (dma_pos != 0) crsf_receive_data(dma_pos);
+}
+
+/* ==================== 摇杆轨迹（-100~100，t 为相对场景开始的微秒） ==================== */
+
+/* 四轴同时快速打杆：每400ms在 ±60 之间以 2/ms 来回 */
+static float StickFlick(uint32_t us)
+{
+    float t = (float)(us % 400000u) / 1000.0f;
+    if (t < 60.0f) return -60.0f + 2.0f * t;
+    if (t < 200.0f) return 60.0f;
+    if (t < 260.0f) return 60.0f - 2.0f * (t - 200.0f);
+    return -60.0f;
+}
+
+/* 匀速打杆：-80 ↔ 80 三角波，0.5/ms */
+static float StickRamp(uint32_t us)
+{
+    float t = (float)(us % 640000u) / 1000.0f;
+    return (t < 320.0f) ? -80.0f + 0.5f * t : 80.0f - 0.5f * (t - 320.0f);
+}
+
+/* 单轴阶跃 0 → 40（单通道跳变不构成整帧异常） */
+static uint32_t step_us;
+static float StickStep(uint32_t us)
+{
+    return (us >= step_us) ? 40.0f : 0.0f;
+}
+
+/**
+ * @brief 运行一个场景：rate_hz 包速率，stick 给出四个摇杆通道的轨迹，阶跃场景只看第一个通道
+ * @param all_axes 1：四通道同一轨迹；0：只有 RX 通道按轨迹，其余居中
+ */
+static Result_t RunScenario(uint16_t rate_hz, Stick_t stick, uint8_t all_axes, uint32_t ms)
+{
+    Result_t r;
+    memset(&r, 0, sizeof(r));
+    r.t50_ms = -1.0f;
+
+    memset(&elrs_status, 0, sizeof(elrs_status));
+    crsf_init();
+    crsf_health.interval_ms = 1000.0f / rate_hz;                // 与 ELRS_PACKET_RATE 配置一致
+    RcSmooth_Init();
+    g_rc_smooth.enabled = smooth_on;
+    dma_pos = 0;
+
+    uint32_t t0 = (sim_us / 1000000u + 2u) * 1000000u;           // 与上一场景间隔 >250ms：第一帧不计间隔
+    SimSetTime(t0);
+    RcSmooth_Process();                                         // 未连接：滤波器进入失控分支复位
+
+    uint32_t period = 1000000u / rate_hz;
+    uint32_t next_frame = t0 + FRAME_PHASE_US;
+    uint32_t frames_at_start = 0;
+    double err2 = 0.0, step_sum = 0.0, step_sum2 = 0.0;
+    uint32_t samples = 0, steps = 0;
+    float last_out = 0.0f;
+    uint8_t have_last = 0;
+    uint32_t warm_ms = 500;                                     // 间隔收敛、滤波器初始化期之后开始统计
+
+    for (uint32_t k = 1; k <= ms; k++) {
+        uint32_t tick_us = t0 + k * 1000u;
+
+        // 节拍间到达的帧：在到达时刻由接收中断解析
+        while (next_frame <= tick_us) {
+            SimSetTime(next_frame);
+            float v[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+            float s = stick(next_frame - t0);
+            for (int i = 0; i < 4; i++) v[i] = (all_axes || i == 0) ? s : 0.0f;
+            SendRc(v);
+            if (k > warm_ms) r.sent++;
+            next_frame += period;
+        }
+
+        SimSetTime(tick_us);
+        if (k == warm_ms) frames_at_start = g_rc_smooth.frames;
+#if RC_EVENT_DRIVEN
+        RcSmooth_Process();                                     // Loop_1000Hz
+#endif
+        if (k % CONTROL_MS != 0) continue;
+#if !RC_EVENT_DRIVEN
+        RcSmooth_Process();                                     // Loop_100Hz
+#endif
+        SimSetTime(tick_us + MIX_DELAY_US);
+        float out = g_rc_smooth.out[0];
+        RcSmooth_MarkOutput();
+        if (k <= warm_ms) {
+            g_rc_latency.samples = 0;
+            g_rc_latency.max_us = 0.0f;
+            last_out = out;
+            have_last = 1;
+            continue;
+        }
+
+        // 跟踪误差：相对最近一帧内容（不计传输本身的帧间隔延迟）
+        float e = out - last_sent[0];
+        err2 += (double)e * e;
+        samples++;
+        if (have_last) {
+            float d = fabsf(out - last_out);
+            step_sum += d;
+            step_sum2 += (double)d * d;
+            steps++;
+        }
+        last_out = out;
+        have_last = 1;
+        if (stick == StickStep && r.t50_ms < 0.0f && sim_us >= t0 + step_us && out >= 20.0f) {
+            r.t50_ms = (float)(sim_us - (t0 + step_us)) / 1000.0f;
+        }
+    }
+
+    r.filtered = g_rc_smooth.frames - frames_at_start;
+    r.rms = samples ? (float)sqrt(err2 / samples) : 0.0f;
+    if (steps > 1) {
+        double mean = step_sum / steps;
+        r.step_sd = (float)sqrt(step_sum2 / steps - mean * mean);
+    }
+    r.lat_avg_ms = g_rc_latency.avg_us / 1000.0f;
+    r.lat_max_ms = g_rc_latency.max_us / 1000.0f;
+    return r;
+}
+
+static void Print(const char *name, const Result_t *r)
+{
+    printf("[RC_EVENT_DRIVEN=%d] %-20s frames %4u/%4u, track rms %6.2f, step sd %5.2f, t50 %5.1f ms, "
+           "latency avg %.2f max %.2f ms\n", RC_EVENT_DRIVEN, name, r->filtered, r->sent, r->rms, r->step_sd,
+           r->t50_ms, r->lat_avg_ms, r->lat_max_ms);
+}
+
+/* ==================== 场景 ==================== */
+
+/* 250/150 Hz 多轴快速打杆：逐帧处理时每帧都经过滤波，整帧跳变检查不误判 */
+static void TestFlick(void)
+{
+    static const uint16_t rates[] = {250, 150, 50};
+    for (size_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+        char name[24];
+        snprintf(name, sizeof(name), "flick %u Hz:", rates[i]);
+        Result_t r = RunScenario(rates[i], StickFlick, 1, 3000);
+        Print(name, &r);
+
+        // 帧到达 → 混控输出延迟由100Hz控制周期决定，两种模式都不超过一个控制周期
+        CHECK(r.lat_max_ms <= CONTROL_MS + MIX_DELAY_US / 1000.0f + 0.05f);
+#if RC_EVENT_DRIVEN
+        CHECK(r.filtered == r.sent);
+        // 帧率不低于控制频率时直接取最新帧；50Hz 插值相对最新帧滞后，跳变阈值按间隔缩放后不丢帧
+        CHECK(r.rms < (rates[i] >= PID_LOOP_HZ ? 0.5f : 10.0f));
+#else
+        if (rates[i] > PID_LOOP_HZ) CHECK(r.filtered < r.sent);   // 控制周期内多帧只处理最后一帧
+#endif
+    }
+}
+
+/* 50 Hz 匀速打杆与阶跃，插值开/关对比：插值后每周期步长均匀，代价约半个帧间隔 */
+static void TestSlowLink(void)
+{
+    Result_t ramp[2], step[2];
+    for (int on = 0; on < 2; on++) {
+        smooth_on = on;
+        ramp[on] = RunScenario(50, StickRamp, 0, 3000);
+        Print(on ? "ramp 50 Hz, RSM on:" : "ramp 50 Hz, RSM off:", &ramp[on]);
+        step_us = 1500000u + 7300u;
+        step[on] = RunScenario(50, StickStep, 0, 2000);
+        Print(on ? "step 50 Hz, RSM on:" : "step 50 Hz, RSM off:", &step[on]);
+    }
+    smooth_on = RC_SMOOTH_ENABLE;
+
+    CHECK(ramp[0].filtered == ramp[0].sent && ramp[1].filtered == ramp[1].sent);
+    CHECK(ramp[1].step_sd < 0.5f * ramp[0].step_sd);            // 阶梯（10/0交替）→ 每周期均匀约5
+    CHECK(step[0].t50_ms > 0.0f && step[1].t50_ms > 0.0f);
+    CHECK(step[1].t50_ms - step[0].t50_ms <= 10.0f + CONTROL_MS + 0.5f);
+    CHECK(step[0].t50_ms <= 20.0f + CONTROL_MS);                // 不插值：帧到达后下一个控制周期
+}
+
+/* 低包速率错帧：单帧四通道同时跳变大于缩放后的阈值，仍整帧丢弃 */
+static void TestGlitchRejected(void)
+{
+    static const uint16_t rates[] = {250, 50};
+    for (size_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+        step_us = 1000000u;
+        RunScenario(rates[i], StickStep, 0, 900);               // 建立连接、间隔收敛、度过初始化期
+
+        float v[4] = {90.0f, 90.0f, 90.0f, 90.0f};              // 错位帧：四个摇杆同时 +90
+        SimSetTime(sim_us + 1000000u / rates[i]);
+        SendRc(v);
+        SimSetTime(sim_us + 1000u);
+        RcSmooth_Process();
+        CHECK(fabsf(filtered_rc.RX) < 1.0f && fabsf(filtered_rc.LY) < 1.0f);
+    }
+}
+
+int main(void)
+{
+    PID_InitAll(40.0f);
+    TestFlick();
+    TestSlowLink();
+    TestGlitchRejected();
+    return TEST_RESULT();
+}
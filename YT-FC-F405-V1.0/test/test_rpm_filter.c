@@ -0,0 +1,111 @@
+/**
+ * @file       test_rpm_filter.c
+ * @author     lsl-sys
+ * @brief      RPM Notch Bank Check and Per-cycle Benchmark
+ * @version    V1.0.0
+ * @date       2026-02-24
+ * @Encoding   UTF-8
+ * @note       电机转频由本文件的 Propulsion_GetMotorHz 提供（替代DShot回传）。
+ *             检查：混叠折叠后的中心频率、陀螺中电机振动的衰减、无回传时旁路；
+ *             基准：每个控制周期 RpmFilter_Update + RpmFilter_Apply（转频逐周期变化，12个陷波中9个启用）主机耗时，只打印。
+ */
+
+#include "rpm_filter.h"
+#include "test_util.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static float motor_hz[MOTOR_COUNT];
+static uint8_t motor_valid = 1;
+
+uint8_t Propulsion_GetMotorHz(MotorID_t id, float *hz)
+{
+    *hz = motor_hz[id];
+    return motor_valid;
+}
+
+/* 折叠后的中心频率：123Hz@100Hz采样 → 23Hz，2倍246Hz → 46Hz（超出0.45fs不启用），3倍369Hz → 31Hz */
+static void TestCenters(void)
+{
+    RpmFilter_Init();
+    motor_valid = 1;
+    for (int m = 0; m < MOTOR_COUNT; m++) motor_hz[m] = 123.0f;
+    RpmFilter_Update();
+    CHECK_NEAR(g_rpm_filter.center_hz[0][0], 23.0f, 1e-3f);
+    CHECK(g_rpm_filter.center_hz[0][1] == 0.0f);
+    CHECK_NEAR(g_rpm_filter.center_hz[0][2], 31.0f, 1e-3f);
+    CHECK(g_rpm_filter.active_count == 2 * MOTOR_COUNT);
+
+    motor_valid = 0;
+    RpmFilter_Update();
+    CHECK(g_rpm_filter.active_count == 0);
+    float gx = 1.0f, gy = 2.0f, gz = 3.0f;
+    RpmFilter_Apply(&gx, &gy, &gz);
+    CHECK(gx == 1.0f && gy == 2.0f && gz == 3.0f);     // 无回传时旁路
+}
+
+/* 陀螺 = 慢速姿态运动 + 电机振动（采样后出现在混叠频率）：振动被压制，姿态运动保留 */
+static void TestAttenuation(void)
+{
+    double vib_in = 0.0, vib_out = 0.0, slow_err = 0.0;
+    int n = 0;
+
+    RpmFilter_Init();
+    motor_valid = 1;
+    for (int m = 0; m < MOTOR_COUNT; m++) motor_hz[m] = 127.0f;    // 折叠到27Hz
+
+    for (int k = 0; k < 2000; k++) {
+        double t = k / (double)PID_LOOP_HZ;
+        double slow = 50.0 * sin(2.0 * M_PI * 0.5 * t);
+        double vib = 20.0 * sin(2.0 * M_PI * 127.0 * t);
+        float gx = (float)(slow + vib), gy = (float)slow, gz = 0.0f;
+
+        RpmFilter_Update();
+        RpmFilter_Apply(&gx, &gy, &gz);
+        if (k >= 500) {
+            vib_in += vib * vib;
+            vib_out += (gx - gy) * (gx - gy);   // gy为同一姿态运动无振动的通道
+            slow_err += (gy - slow) * (gy - slow);
+            n++;
+        }
+    }
+    double atten_db = 10.0 * log10(vib_in / vib_out);
+    printf("motor vibration attenuation: %.1f dB, slow-motion RMS change %.2f dps\n", atten_db, sqrt(slow_err / n));
+    CHECK(atten_db > 20.0);
+}
+
+static void BenchUpdateApply(void)
+{
+    const int N = 1000000;
+    static const float base[MOTOR_COUNT] = {130.0f, 133.0f, 137.0f, 140.0f};
+    float gx = 0.0f, gy = 0.0f, gz = 0.0f;
+
+    RpmFilter_Init();
+    motor_valid = 1;
+    for (int m = 0; m < MOTOR_COUNT; m++) motor_hz[m] = base[m];
+    RpmFilter_Update();
+    printf("bench notches active: %u of %u\n", g_rpm_filter.active_count, MOTOR_COUNT * RPM_FILTER_HARMONICS);
+
+    double t0 = test_now_ns();
+    for (int k = 0; k < N; k++) {
+        for (int m = 0; m < MOTOR_COUNT; m++) motor_hz[m] = base[m] + (float)(k & 7) * 0.1f;
+        gx = (float)(k & 15);
+        gy = -gx;
+        gz = 0.5f * gx;
+        RpmFilter_Update();
+        RpmFilter_Apply(&gx, &gy, &gz);
+    }
+    double t1 = test_now_ns();
+    test_sink = gx + gy + gz;
+    printf("bench RpmFilter_Update + Apply: %.1f ns/cycle on host\n", (t1 - t0) / N);
+}
+
+int main(void)
+{
+    TestCenters();
+    TestAttenuation();
+    BenchUpdateApply();
+    return TEST_RESULT();
+}
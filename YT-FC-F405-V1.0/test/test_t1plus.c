@@ -0,0 +1,382 @@
+/**
+ * @file       test_t1plus.c
+ * @author     lsl-sys
+ * @brief      T1Plus Optical-flow Byte-stream Replay Tests
+ * @version    V1.0.0
+ * @date       2026-02-24
+ * @Encoding   UTF-8
+ * @note       直接包含 T1Plus.c 以访问DMA循环缓冲（t1plus_rx_buf）。
+ *             DMA模拟：字节按写指针写入循环缓冲，与硬件相同在传输完成（回绕，半满中断已关闭）
+ *             与空闲（每段末尾）时调用 T1Plus_receive_data，帧可在任意位置跨越缓冲区末尾。
+ *             回放：随机空闲分段的好帧流（位移累加与帧计数逐帧对照）、帧间杂字节（含伪帧头）、
+ *             校验和/帧尾损坏后的重新同步、逐偏移的回绕切分、合并帧中的无效帧（不累加位移）、队列满丢帧。
+ */
+
+#include "T1Plus.c"
+#include "test_util.h"
+
+#define STREAM_MAX      60000
+
+static uint16_t dma_pos;                    // 模拟DMA写指针
+static uint8_t stream[STREAM_MAX];
+static uint32_t rng = 24680u;
+
+static uint32_t Rand(void)
+{
+    rng = rng * 1664525u + 1013904223u;
+    return rng >> 8;
+}
+
+static void Reset(void)
+{
+    memset(&t1plus_data, 0, sizeof(t1plus_data));
+    T1Plus_init();
+    dma_pos = 0;
+}
+
+typedef struct {
+    int16_t fx, fy;
+    uint16_t span, dist;
+    uint8_t valid, conf;
+} Frame_t;
+
+/* [0xFE, 0x0A, 10字节数据, 异或校验(数据), 0x55]，返回帧长 */
+static int BuildFrame(uint8_t *f, const Frame_t *fr)
+{
+    f[0] = T1PLUS_FRAME_HEADER_1;
+    f[1] = T1PLUS_FRAME_LENGTH;
+    f[2] = (uint8_t)fr->fx;
+    f[3] = (uint8_t)((uint16_t)fr->fx >> 8);
+    f[4] = (uint8_t)fr->fy;
+    f[5] = (uint8_t)((uint16_t)fr->fy >> 8);
+    f[6] = (uint8_t)fr->span;
+    f[7] = (uint8_t)(fr->span >> 8);
+    f[8] = (uint8_t)fr->dist;
+    f[9] = (uint8_t)(fr->dist >> 8);
+    f[10] = fr->valid;
+    f[11] = fr->conf;
+    f[12] = 0;
+    for (int i = 2; i < 12; i++) f[12] ^= f[i];
+    f[13] = T1PLUS_FRAME_TAIL;
+    return T1PLUS_FRAME_SIZE;
+}
+
+/* 随机有效帧；数据与校验中不含帧头字节，损坏后只能在下一帧帧头重新同步，期望计数确定 */
+static int RandFrame(uint8_t *f, Frame_t *fr)
+{
+    do {
+        fr->fx = (int16_t)((int)(Rand() % 2001) - 1000);
+        fr->fy = (int16_t)((int)(Rand() % 2001) - 1000);
+        fr->span = (uint16_t)(19000 + Rand() % 2000);
+        fr->dist = (uint16_t)(100 + Rand() % 3000);
+        fr->valid = T1PLUS_VALID_DATA;
+        fr->conf = (uint8_t)(Rand() % 101);
+        BuildFrame(f, fr);
+    } while (memchr(&f[2], T1PLUS_FRAME_HEADER_1, 11) != NULL);
+    return T1PLUS_FRAME_SIZE;
+}
+
+/* 每次取出后累加，对照逐帧的期望和 */
+typedef struct {
+    int32_t sum_x, sum_y;
+    uint32_t sum_span;
+    uint32_t polls;
+} Drain_t;
+
+static Drain_t drain;
+
+static void Poll(void)
+{
+    uint32_t before = t1plus_data.frame_count;
+    T1Plus_analysis_data();
+    if (t1plus_data.frame_count != before) {
+        drain.sum_x += t1plus_data.flow_x_integral;
+        drain.sum_y += t1plus_data.flow_y_integral;
+        drain.sum_span += t1plus_data.integration_timespan;
+        drain.polls++;
+    }
+}
+
+/**
+ * @brief 模拟DMA接收：逐字节写入循环缓冲，满（回绕）与每段末尾（空闲）触发接收事件，事件后主循环取帧
+ * @param chunk 空闲事件间的字节数，0 表示随机 1~30（不超过队列深度对应的字节数，避免丢帧）
+ */
+static void Deliver(const uint8_t *d, int n, int chunk)
+{
+    int left = chunk ? chunk : (int)(Rand() % 30) + 1;
+    for (int i = 0; i < n; i++) {
+        t1plus_rx_buf[dma_pos++] = d[i];
+        uint8_t event = 0;
+        if (dma_pos == T1PLUS_RX_BUF_SIZE) event = 1;
+        if (--left == 0) {
+            event = 1;
+            left = chunk ? chunk : (int)(Rand() % 30) + 1;
+        }
+        if (event) {
+            hal_stub_tick++;
+            T1Plus_receive_data(dma_pos);
+            Poll();
+        }
+        if (dma_pos == T1PLUS_RX_BUF_SIZE) dma_pos = 0;
+    }
+}
+
+/* 末尾未整段的字节：补一次空闲事件（写指针刚回绕时已在满中断中消费） */
+static void Flush(void)
+{
+    if (dma_pos != 0) T1Plus_receive_data(dma_pos);
+    Poll();
+}
+
+/* ==================== 单帧解码 ==================== */
+
+static void TestDecode(void)
+{
+    static const Frame_t fr = {-1234, 567, 20000, 1500, T1PLUS_VALID_DATA, 87};
+    uint8_t f[T1PLUS_FRAME_SIZE];
+
+    Reset();
+    hal_stub_tick = 1000;
+    BuildFrame(f, &fr);
+    Deliver(f, sizeof(f), sizeof(f));
+    CHECK(t1plus_stat.frame_ok == 1);
+    CHECK(t1plus_data.frame_count == 1);
+    CHECK(t1plus_data.flow_x_integral == -1234);
+    CHECK(t1plus_data.flow_y_integral == 567);
+    CHECK(t1plus_data.integration_timespan == 20000);
+    CHECK(t1plus_data.laser_distance == 1500);
+    CHECK(t1plus_data.valid == T1PLUS_VALID_DATA);
+    CHECK(t1plus_data.laser_confidence == 87);
+    CHECK(t1plus_data.timestamp == 1001);
+    CHECK_NEAR(t1plus_data.actual_flow_x, -1234.0f / 10000.0f * 1500.0f, 1e-3f);
+}
+
+/* ==================== 随机空闲分段 + 杂字节 ==================== */
+
+/* 生成帧流：每帧前 0~max_junk 个杂字节，约1/4为帧头0xFE，其中一半后跟长度0x0A（伪帧头） */
+static int GenStream(int frames, int max_junk, Drain_t *e, int *junk)
+{
+    uint8_t f[T1PLUS_FRAME_SIZE];
+    Frame_t fr;
+    int n = 0;
+
+    memset(e, 0, sizeof(*e));
+    *junk = 0;
+    for (int k = 0; k < frames; k++) {
+        int gap = max_junk ? (int)(Rand() % (max_junk + 1)) : 0;
+        for (int g = 0; g < gap; g++) {
+            uint8_t b = (uint8_t)Rand();
+            if (Rand() % 4 == 0) b = T1PLUS_FRAME_HEADER_1;
+            else if (b == T1PLUS_FRAME_HEADER_1) b = 0x00;
+            stream[n++] = b;
+            if (b == T1PLUS_FRAME_HEADER_1 && g + 1 < gap && (Rand() & 1)) {
+                stream[n++] = T1PLUS_FRAME_LENGTH;     // 伪帧头+长度：窗口要等满14字节校验失败后才前移
+                g++;
+            }
+        }
+        *junk += gap;
+        RandFrame(f, &fr);
+        memcpy(&stream[n], f, sizeof(f));
+        n += sizeof(f);
+        e->sum_x += fr.fx;
+        e->sum_y += fr.fy;
+        e->sum_span += fr.span;
+    }
+    return n;
+}
+
+static void TestStream(void)
+{
+    Drain_t e;
+    int junk;
+
+    // 无杂字节：随机分段，帧跨越空闲事件与回绕
+    Reset();
+    memset(&drain, 0, sizeof(drain));
+    int n = GenStream(2000, 0, &e, &junk);
+    Deliver(stream, n, 0);
+    Flush();
+    printf("clean: %d bytes, %u frames in %u polls, merged %u\n",
+           n, t1plus_stat.frame_ok, drain.polls, t1plus_stat.merged);
+    CHECK(t1plus_stat.frame_ok == 2000);
+    CHECK(t1plus_data.frame_count == 2000);
+    CHECK(t1plus_stat.resync == 0);
+    CHECK(t1plus_stat.overrun == 0);
+    CHECK(drain.sum_x == e.sum_x && drain.sum_y == e.sum_y && drain.sum_span == e.sum_span);
+
+    // 帧间杂字节（含伪帧头）：每个杂字节恰好丢弃一次，帧不丢
+    Reset();
+    memset(&drain, 0, sizeof(drain));
+    n = GenStream(2000, 4, &e, &junk);
+    Deliver(stream, n, 0);
+    Flush();
+    printf("junk: %d bytes, %d junk, resync %u, checksum_err %u, tail_err %u\n",
+           n, junk, t1plus_stat.resync, t1plus_stat.checksum_err, t1plus_stat.tail_err);
+    CHECK(t1plus_stat.frame_ok == 2000);
+    CHECK(t1plus_stat.resync == (uint32_t)junk);
+    CHECK(t1plus_stat.overrun == 0);
+    CHECK(drain.sum_x == e.sum_x && drain.sum_y == e.sum_y && drain.sum_span == e.sum_span);
+
+    // 每字节一个空闲事件、每帧一个空闲事件、空闲落在帧中间（一次事件最多完成3帧，不超过队列深度）
+    static const int chunks[] = {1, T1PLUS_FRAME_SIZE, 37};
+    for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); c++) {
+        Reset();
+        memset(&drain, 0, sizeof(drain));
+        n = GenStream(500, 3, &e, &junk);
+        Deliver(stream, n, chunks[c]);
+        Flush();
+        CHECK(t1plus_stat.frame_ok == 500);
+        CHECK(t1plus_stat.resync == (uint32_t)junk);
+        CHECK(drain.sum_x == e.sum_x && drain.sum_span == e.sum_span);
+    }
+}
+
+/* ==================== 回绕切分 ==================== */
+
+/* 帧起点逐个偏移，使缓冲末尾落在帧内每一个字节之后 */
+static void TestRingWrapSplit(void)
+{
+    static const Frame_t fr = {321, -654, 20000, 800, T1PLUS_VALID_DATA, 90};
+    uint8_t f[T1PLUS_FRAME_SIZE], pad[T1PLUS_RX_BUF_SIZE];
+    int fails = 0;
+
+    memset(pad, 0x00, sizeof(pad));
+    BuildFrame(f, &fr);
+
+    for (int split = 0; split <= T1PLUS_FRAME_SIZE; split++) {
+        Reset();
+        int start = T1PLUS_RX_BUF_SIZE - split;
+        // 杂字节推到帧起点，再整帧一段送入：满中断在帧内第split字节后，余下在空闲中断
+        Deliver(pad, start, start);
+        Deliver(f, sizeof(f), sizeof(f));
+        Flush();
+
+        int ok = t1plus_stat.frame_ok == 1 && t1plus_stat.resync == (uint32_t)start &&
+                 t1plus_data.flow_x_integral == 321 && t1plus_data.flow_y_integral == -654 &&
+                 t1plus_data.laser_distance == 800;
+        if (!ok) {
+            printf("wrap split %d: frame_ok %u resync %u\n", split, t1plus_stat.frame_ok, t1plus_stat.resync);
+            fails++;
+        }
+    }
+    CHECK(fails == 0);
+}
+
+/* ==================== 损坏与重新同步 ==================== */
+
+static void TestCorrupted(void)
+{
+    static const Frame_t fr = {100, 200, 20000, 1000, T1PLUS_VALID_DATA, 80};
+    uint8_t good[T1PLUS_FRAME_SIZE], bad[T1PLUS_FRAME_SIZE];
+    BuildFrame(good, &fr);
+
+    // 数据位翻转（校验和错误）后紧跟好帧（帧间无空闲）
+    Reset();
+    memcpy(bad, good, sizeof(bad));
+    bad[4] ^= 0x10;
+    Deliver(bad, sizeof(bad), 1 << 30);
+    Deliver(good, sizeof(good), 1 << 30);
+    Flush();
+    CHECK(t1plus_stat.checksum_err == 1);
+    CHECK(t1plus_stat.frame_ok == 1);
+    CHECK(t1plus_stat.resync == T1PLUS_FRAME_SIZE);
+    CHECK(t1plus_data.flow_y_integral == 200);
+
+    // 帧尾错误
+    Reset();
+    memcpy(bad, good, sizeof(bad));
+    bad[13] = 0x54;
+    Deliver(bad, sizeof(bad), 5);
+    Deliver(good, sizeof(good), 5);
+    Flush();
+    CHECK(t1plus_stat.tail_err == 1);
+    CHECK(t1plus_stat.frame_ok == 1);
+
+    // 截断帧（只有前半）后接好帧：伪帧在好帧内部校验失败，好帧仍被找到
+    Reset();
+    Deliver(good, 7, 7);
+    Deliver(good, sizeof(good), sizeof(good));
+    Flush();
+    CHECK(t1plus_stat.frame_ok == 1);
+    CHECK(t1plus_stat.resync == 7);
+    CHECK(t1plus_data.flow_x_integral == 100);
+
+    // 长度字节错误：帧头后立即丢弃
+    Reset();
+    memcpy(bad, good, sizeof(bad));
+    bad[1] = 0x0B;
+    Deliver(bad, sizeof(bad), 3);
+    Deliver(good, sizeof(good), 3);
+    Flush();
+    CHECK(t1plus_stat.checksum_err == 0);
+    CHECK(t1plus_stat.frame_ok == 1);
+}
+
+/* ==================== 合并帧中的无效帧 ==================== */
+
+static void TestInvalidMerge(void)
+{
+    Frame_t a = {100, -50, 20000, 1200, T1PLUS_VALID_DATA, 90};
+    Frame_t b = {30000, 30000, 20000, 0, 0x00, 0};          // 无效帧：积分为垃圾值
+    Frame_t c = {40, 10, 20000, 1210, T1PLUS_VALID_DATA, 95};
+    uint8_t f[3 * T1PLUS_FRAME_SIZE];
+
+    // 同一周期到达 有效/无效/有效：只累加两帧有效位移，状态取最新有效帧
+    Reset();
+    BuildFrame(&f[0], &a);
+    BuildFrame(&f[T1PLUS_FRAME_SIZE], &b);
+    BuildFrame(&f[2 * T1PLUS_FRAME_SIZE], &c);
+    for (int i = 0; i < (int)sizeof(f); i++) t1plus_rx_buf[i] = f[i];
+    T1Plus_receive_data(sizeof(f));
+    CHECK(t1plus_stat.frame_ok == 3);
+    T1Plus_analysis_data();
+    CHECK(t1plus_data.flow_x_integral == 140);
+    CHECK(t1plus_data.flow_y_integral == -40);
+    CHECK(t1plus_data.integration_timespan == 40000);
+    CHECK(t1plus_data.laser_distance == 1210);
+    CHECK(t1plus_data.valid == T1PLUS_VALID_DATA);
+    CHECK(t1plus_data.frame_count == 2);
+    CHECK(t1plus_stat.invalid == 1);
+    CHECK(t1plus_stat.merged == 1);
+
+    // 整批无效：发布无效状态，位移为0，有效帧计数不变
+    for (int i = 0; i < T1PLUS_FRAME_SIZE; i++) t1plus_rx_buf[sizeof(f) + i] = f[T1PLUS_FRAME_SIZE + i];
+    T1Plus_receive_data(sizeof(f) + T1PLUS_FRAME_SIZE);
+    T1Plus_analysis_data();
+    CHECK(t1plus_data.valid != T1PLUS_VALID_DATA);
+    CHECK(t1plus_data.flow_x_integral == 0 && t1plus_data.flow_y_integral == 0);
+    CHECK(t1plus_data.integration_timespan == 0);
+    CHECK(t1plus_data.frame_count == 2);
+    CHECK(t1plus_stat.invalid == 2);
+}
+
+/* ==================== 队列满 ==================== */
+
+static void TestOverrun(void)
+{
+    static const Frame_t fr = {1, 1, 20000, 1000, T1PLUS_VALID_DATA, 80};
+    uint8_t f[T1PLUS_FRAME_SIZE];
+
+    Reset();
+    BuildFrame(f, &fr);
+    for (int k = 0; k < T1PLUS_FIFO_LEN; k++) {     // 主循环未取：队列只能存 T1PLUS_FIFO_LEN-1 帧
+        for (int i = 0; i < T1PLUS_FRAME_SIZE; i++) t1plus_rx_buf[dma_pos++] = f[i];
+        T1Plus_receive_data(dma_pos);
+    }
+    CHECK(t1plus_stat.frame_ok == T1PLUS_FIFO_LEN - 1);
+    CHECK(t1plus_stat.overrun == 1);
+    T1Plus_analysis_data();
+    CHECK(t1plus_data.frame_count == T1PLUS_FIFO_LEN - 1);
+    CHECK(t1plus_data.flow_x_integral == T1PLUS_FIFO_LEN - 1);
+}
+
+int main(void)
+{
+    TestDecode();
+    TestStream();
+    TestRingWrapSplit();
+    TestCorrupted();
+    TestInvalidMerge();
+    TestOverrun();
+    return TEST_RESULT();
+}
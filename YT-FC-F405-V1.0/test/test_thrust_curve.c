@@ -0,0 +1,216 @@
+/**
+ * @file       test_thrust_curve.c
+ * @author     lsl-sys
+ * @brief      Thrust Linearisation and Battery Voltage Compensation Tests
+ * @version    V1.0.0
+ * @date       2026-02-24
+ * @Encoding   UTF-8
+ * @note       电池按 BATTERY_SOURCE_HOST 编译，电压经 host_voltage 写入（与台架调试相同路径）。
+ *             检查：默认表逼近 T = 0.4c + 0.6c²、推力→指令单调、推力↔指令往返一致（含区间缓存乱序访问）、
+ *             补偿系数在 THRUST_VCOMP_MIN/MAX 限幅、无电压/关闭补偿取1、电池电压 → 补偿系数链路，
+ *             VOFA 改出非单调断点后 Thrust_Rebuild 恢复单调。
+ */
+
+#include "thrust_curve.h"
+#include "propulsion.h"
+#include "Battery.h"
+#include "test_util.h"
+
+#define STEP    0.1f
+
+/* 推力→指令在 [0,100] 上单调不减，返回下降的点数 */
+static int CountNonMonotonic(void)
+{
+    int bad = 0;
+    float prev = Thrust_ToCommand(0.0f);
+    for (float t = STEP; t <= 100.0f; t += STEP) {
+        float c = Thrust_ToCommand(t);
+        if (c < prev - 1e-5f) bad++;
+        prev = c;
+    }
+    return bad;
+}
+
+/* 指令 → 推力 → 指令 往返最大误差（指令取 0 ~ cmd_max） */
+static float RoundTripCmdErr(float cmd_max)
+{
+    float err = 0.0f;
+    for (float c = 0.0f; c <= cmd_max; c += STEP) {
+        float e = fabsf(Thrust_ToCommand(Thrust_FromCommand(c)) - c);
+        if (e > err) err = e;
+    }
+    return err;
+}
+
+/* ==================== 线性化表 ==================== */
+
+static void TestDefaultTable(void)
+{
+    Thrust_Init();
+    const float x[THRUST_POINTS] = THRUST_DEFAULT_X;
+    const float y[THRUST_POINTS] = THRUST_DEFAULT_Y;
+
+    // 断点处精确取表值（未超过指令上限的点）
+    for (int i = 0; i < THRUST_POINTS; i++) {
+        if (y[i] <= MOTOR_MAX_OUTPUT) CHECK_NEAR(Thrust_ToCommand(x[i]), y[i], 1e-4f);
+    }
+
+    // 未限幅区间：插值相对默认模型（指令 c → 推力 0.4c + 0.6c²）误差小于1%，推力 → 指令 → 推力往返一致
+    float model_err = 0.0f;
+    for (float t = 0.0f; t <= 100.0f; t += STEP) {
+        float cmd = Thrust_ToCommand(t);
+        if (cmd >= MOTOR_MAX_OUTPUT) break;
+        float c = cmd / 100.0f;
+        float e = fabsf((0.4f * c + 0.6f * c * c) * 100.0f - t);
+        if (e > model_err) model_err = e;
+        CHECK_NEAR(Thrust_FromCommand(cmd), t, 1e-3f);
+    }
+    printf("default table: max model error %.3f %% thrust\n", model_err);
+    CHECK(model_err < 1.0f);
+    CHECK(CountNonMonotonic() == 0);
+
+    // 指令上限：MOTOR_MAX_OUTPUT 以上限幅，反查得到混控推力上限
+    float t_max = Thrust_FromCommand(MOTOR_MAX_OUTPUT);
+    CHECK(t_max > 50.0f && t_max < 75.0f);
+    CHECK_NEAR(Thrust_ToCommand(t_max), MOTOR_MAX_OUTPUT, 1e-3f);
+    CHECK_NEAR(Thrust_ToCommand(100.0f), MOTOR_MAX_OUTPUT, 1e-6f);
+    CHECK_NEAR(Thrust_ToCommand(-5.0f), MOTOR_MIN_OUTPUT, 1e-6f);
+    CHECK(RoundTripCmdErr(MOTOR_MAX_OUTPUT) < 1e-3f);
+
+    // 关闭线性化：推力 = 指令
+    g_thrust.lin_enabled = 0;
+    CHECK_NEAR(Thrust_ToCommand(42.0f), 42.0f, 1e-6f);
+    CHECK_NEAR(Thrust_FromCommand(42.0f), 42.0f, 1e-6f);
+}
+
+/* 区间缓存：乱序访问与顺序访问结果一致 */
+static void TestSegmentCache(void)
+{
+    Thrust_Init();
+    float ref[1001];
+    for (int k = 0; k <= 1000; k++) ref[k] = Thrust_ToCommand(k * STEP);
+
+    uint32_t rng = 24680u;
+    int bad = 0;
+    for (int n = 0; n < 5000; n++) {
+        rng = rng * 1664525u + 1013904223u;
+        int k = (int)(rng >> 8) % 1001;
+        if (fabsf(Thrust_ToCommand(k * STEP) - ref[k]) > 1e-6f) bad++;
+    }
+    CHECK(bad == 0);
+}
+
+/* ==================== 电压补偿 ==================== */
+
+static void TestVoltageComp(void)
+{
+    Thrust_Init();
+
+    Thrust_SetVoltage(THRUST_VREF);
+    CHECK_NEAR(g_thrust.vcomp, 1.0f, 1e-6f);
+    Thrust_SetVoltage(12.0f);
+    CHECK_NEAR(g_thrust.vcomp, THRUST_VREF / 12.0f, 1e-6f);
+
+    // 限幅：4S满电 16.8V → 0.66 取下限；3S过放 8V → 1.39 取上限
+    Thrust_SetVoltage(16.8f);
+    CHECK_NEAR(g_thrust.vcomp, THRUST_VCOMP_MIN, 1e-6f);
+    Thrust_SetVoltage(THRUST_VREF / THRUST_VCOMP_MIN + 0.01f);
+    CHECK_NEAR(g_thrust.vcomp, THRUST_VCOMP_MIN, 1e-6f);
+    Thrust_SetVoltage(THRUST_VREF / THRUST_VCOMP_MIN - 0.01f);
+    CHECK(g_thrust.vcomp > THRUST_VCOMP_MIN);
+    Thrust_SetVoltage(8.0f);
+    CHECK_NEAR(g_thrust.vcomp, THRUST_VCOMP_MAX, 1e-6f);
+    Thrust_SetVoltage(THRUST_VREF / THRUST_VCOMP_MAX - 0.01f);
+    CHECK_NEAR(g_thrust.vcomp, THRUST_VCOMP_MAX, 1e-6f);
+    Thrust_SetVoltage(THRUST_VREF / THRUST_VCOMP_MAX + 0.01f);
+    CHECK(g_thrust.vcomp < THRUST_VCOMP_MAX);
+
+    // 无电压数据 / 关闭补偿：取1
+    Thrust_SetVoltage(0.0f);
+    CHECK_NEAR(g_thrust.vcomp, 1.0f, 1e-6f);
+    g_thrust.vcomp_enabled = 0;
+    Thrust_SetVoltage(9.0f);
+    CHECK_NEAR(g_thrust.vcomp, 1.0f, 1e-6f);
+    g_thrust.vcomp_enabled = 1;
+
+    // 低电压：同一推力指令更大，推力上限更低；往返仍一致，单调
+    Thrust_SetVoltage(10.0f);
+    float vc = g_thrust.vcomp;
+    g_thrust.vcomp = 1.0f;
+    float cmd_nom = Thrust_ToCommand(30.0f);
+    float tmax_nom = Thrust_FromCommand(MOTOR_MAX_OUTPUT);
+    g_thrust.vcomp = vc;
+    CHECK_NEAR(Thrust_ToCommand(30.0f), cmd_nom * vc, 1e-4f);
+    CHECK(Thrust_FromCommand(MOTOR_MAX_OUTPUT) < tmax_nom);
+    CHECK(CountNonMonotonic() == 0);
+    CHECK(RoundTripCmdErr(MOTOR_MAX_OUTPUT) < 1e-3f);
+    printf("vcomp %.3f @ 10.0 V: thrust limit %.1f %% (nominal %.1f %%)\n",
+           vc, Thrust_FromCommand(MOTOR_MAX_OUTPUT), tmax_nom);
+}
+
+/* 电池电压 → 补偿系数：首次有效直接取值、低通、过低视为无效 */
+static void TestBatteryChain(void)
+{
+    Thrust_Init();
+    Battery_Init();
+
+    g_battery.host_voltage = 12.6f;
+    Battery_Update();
+    Thrust_SetVoltage(Battery_GetVoltage());
+    CHECK(g_battery.valid == 1);
+    CHECK_NEAR(g_thrust.vcomp, THRUST_VREF / 12.6f, 1e-5f);
+
+    // 压降：低通后逐步接近，不越过新电压
+    g_battery.host_voltage = 10.5f;
+    Battery_Update();
+    CHECK(Battery_GetVoltage() > 10.5f && Battery_GetVoltage() < 12.6f);
+    for (int k = 0; k < 100; k++) Battery_Update();
+    CHECK_NEAR(Battery_GetVoltage(), 10.5f, 1e-3f);
+    Thrust_SetVoltage(Battery_GetVoltage());
+    CHECK_NEAR(g_thrust.vcomp, THRUST_VREF / 10.5f, 1e-4f);
+
+    // 未接电池：无效，补偿取1
+    g_battery.host_voltage = BATTERY_MIN_VALID - 1.0f;
+    Battery_Update();
+    Thrust_SetVoltage(Battery_GetVoltage());
+    CHECK(g_battery.valid == 0);
+    CHECK_NEAR(Battery_GetVoltage(), 0.0f, 1e-6f);
+    CHECK_NEAR(g_thrust.vcomp, 1.0f, 1e-6f);
+}
+
+/* ==================== 在线修改 ==================== */
+
+/* VOFA 把 TC3 改到 TC2 以下：重建后指令断点单调，推力→指令不反向 */
+static void TestRebuildNonMonotonic(void)
+{
+    Thrust_Init();
+    g_thrust.y[3] = 30.0f;
+    Thrust_Rebuild();
+    for (int i = 0; i + 1 < THRUST_POINTS; i++) CHECK(g_thrust.y[i + 1] >= g_thrust.y[i]);
+    for (int i = 0; i + 1 < THRUST_POINTS; i++) CHECK(g_thrust.slope[i] >= 0.0f);
+    CHECK(CountNonMonotonic() == 0);
+    CHECK(RoundTripCmdErr(MOTOR_MAX_OUTPUT) < 1e-3f);
+    printf("TC3 = 30 -> %.1f after rebuild, T(39.3) = %.2f\n", g_thrust.y[3], Thrust_FromCommand(39.3f));
+
+    // 平段内反查取平段起点，不产生 NaN/越界
+    float t = Thrust_FromCommand(g_thrust.y[2]);
+    CHECK(t >= g_thrust.x[2] - 1e-4f && t <= g_thrust.x[3] + 1e-4f);
+
+    // 首点改大：其后断点全部抬平，仍单调
+    Thrust_Init();
+    g_thrust.y[0] = 50.0f;
+    Thrust_Rebuild();
+    CHECK(g_thrust.y[1] >= 50.0f && g_thrust.y[2] >= 50.0f);
+    CHECK(CountNonMonotonic() == 0);
+    CHECK(!isnan(Thrust_FromCommand(60.0f)));
+}
+
+int main(void)
+{
+    TestDefaultTable();
+    TestSegmentCache();
+    TestVoltageComp();
+    TestBatteryChain();
+    TestRebuildNonMonotonic();
+    return TEST_RESULT();
+}
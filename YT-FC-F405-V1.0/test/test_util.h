@@ -0,0 +1,49 @@
+/**
+ * @file       test_util.h
+ * @author     lsl-sys
+ * @brief      Minimal Check/Timing Helpers for Host Tests
+ * @version    V1.0.0
+ * @date       2026-02-24
+ * @Encoding   UTF-8
+ * @note       CHECK 失败只计数并打印位置，TEST_RESULT 作为 main 返回值交给 ctest。
+ *             基准测试只打印耗时（主机与F405相差一个数量级以上，只用于前后对比），不作为失败条件。
+ */
+
+#ifndef __TEST_UTIL_H
+#define __TEST_UTIL_H
+
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+
+static int test_failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+        test_failures++; \
+    } \
+} while (0)
+
+#define CHECK_NEAR(a, b, tol) do { \
+    double _a = (a), _b = (b); \
+    if (fabs(_a - _b) > (tol)) { \
+        printf("FAIL %s:%d: %s = %g, expected %g (tol %g)\n", __FILE__, __LINE__, #a, _a, _b, (double)(tol)); \
+        test_failures++; \
+    } \
+} while (0)
+
+#define TEST_RESULT() (printf(test_failures ? "%d check(s) failed\n" : "all checks passed\n", test_failures), test_failures != 0)
+
+/* 单调时钟 (ns) */
+static inline double test_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* 防止基准循环的结果被优化掉 */
+static volatile float test_sink;
+
+#endif